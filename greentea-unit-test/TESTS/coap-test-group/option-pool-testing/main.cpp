@@ -0,0 +1,159 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the allocations made when a CoAP message is parsed, its Uri-Path and Uri-Query segments held by the
+ *  option pool of the packet
+ *
+ *  Allocation checks need the heap statistics, enabled with "platform.heap-stats-enabled": true
+ *
+ *  @date 10/18/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "liblwm2m.h"
+extern "C"
+{
+#include "er-coap-13.h"
+}
+#include <string.h>
+
+using namespace utest::v1;
+
+#define LONG_PATH "/lwm2m/alt/path/3416/0/5850/1"
+#define LONG_PATH_SEGMENTS 7
+
+static uint8_t datagram[128];
+
+static size_t buildRequest(const char *path, const char *query)
+{
+    coap_packet_t request[1];
+    uint8_t token[2] = { 0x12, 0x34 };
+
+    coap_init_message(request, COAP_TYPE_CON, COAP_PUT, 0x4321);
+    coap_set_header_token(request, token, sizeof(token));
+    coap_set_header_uri_path(request, path);
+    if (query != nullptr)
+        coap_set_header_uri_query(request, query);
+    size_t length = coap_serialize_message(request, datagram);
+    coap_free_header(request);
+
+    return length;
+}
+
+static size_t countSegments(multi_option_t *option)
+{
+    size_t count = 0;
+
+    for (; option != nullptr; option = option->next)
+        count++;
+    return count;
+}
+
+static control_t pathWithoutAllocation(){
+#if MBED_HEAP_STATS_ENABLED
+    coap_packet_t packet[1];
+    mbed_stats_heap_t before;
+    mbed_stats_heap_t after;
+    size_t length = buildRequest("/3416/0/5850", nullptr);
+
+    utest_printf("coap_packet_t: %u bytes, %u segments pooled\n", (unsigned)sizeof(coap_packet_t), (unsigned)COAP_OPTION_POOL_SIZE);
+
+    // The segments point into the datagram, their nodes come from the packet
+    mbed_stats_heap_get(&before);
+    TEST_ASSERT_EQUAL(NO_ERROR, coap_parse_message(packet, datagram, length));
+    mbed_stats_heap_get(&after);
+    TEST_ASSERT_EQUAL(before.alloc_cnt, after.alloc_cnt);
+
+    TEST_ASSERT_EQUAL(3, countSegments(packet->uri_path));
+    TEST_ASSERT_EQUAL(4, packet->uri_path->len);
+    TEST_ASSERT_EQUAL(0, memcmp("3416", packet->uri_path->data, 4));
+    TEST_ASSERT_TRUE(packet->uri_path->data > datagram && packet->uri_path->data < datagram + length);
+
+    coap_free_header(packet);
+    mbed_stats_heap_get(&after);
+    TEST_ASSERT_EQUAL(before.current_size, after.current_size);
+#else
+    TEST_IGNORE_MESSAGE("heap statistics are disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t segmentsBeyondPool(){
+#if MBED_HEAP_STATS_ENABLED
+    coap_packet_t packet[1];
+    mbed_stats_heap_t before;
+    mbed_stats_heap_t after;
+    size_t length = buildRequest(LONG_PATH, "pmin=10&pmax=60");
+    size_t expected = LONG_PATH_SEGMENTS + 2 > COAP_OPTION_POOL_SIZE ? LONG_PATH_SEGMENTS + 2 - COAP_OPTION_POOL_SIZE : 0;
+
+    // One allocation for each segment the pool cannot hold, the data stays in the datagram
+    mbed_stats_heap_get(&before);
+    TEST_ASSERT_EQUAL(NO_ERROR, coap_parse_message(packet, datagram, length));
+    mbed_stats_heap_get(&after);
+    TEST_ASSERT_EQUAL(expected, after.alloc_cnt - before.alloc_cnt);
+
+    TEST_ASSERT_EQUAL(LONG_PATH_SEGMENTS, countSegments(packet->uri_path));
+    TEST_ASSERT_EQUAL(2, countSegments(packet->uri_query));
+
+    // Released with the packet, the pooled nodes left alone
+    coap_free_header(packet);
+    mbed_stats_heap_get(&after);
+    TEST_ASSERT_EQUAL(before.current_size, after.current_size);
+#else
+    TEST_IGNORE_MESSAGE("heap statistics are disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t copiedOptions(){
+#if MBED_HEAP_STATS_ENABLED
+    coap_packet_t packet[1];
+    multi_option_t *copy = nullptr;
+    mbed_stats_heap_t before;
+    mbed_stats_heap_t after;
+    size_t length = buildRequest("/3416/0/5850", nullptr);
+
+    mbed_stats_heap_get(&before);
+    TEST_ASSERT_EQUAL(NO_ERROR, coap_parse_message(packet, datagram, length));
+
+    // The lists kept beyond the packet are copied, not shared
+    coap_copy_multi_option(&copy, packet->uri_path);
+    coap_free_header(packet);
+    memset(datagram, 0, sizeof(datagram));
+
+    TEST_ASSERT_EQUAL(3, countSegments(copy));
+    TEST_ASSERT_EQUAL(0, memcmp("3416", copy->data, 4));
+    free_multi_option(copy);
+
+    mbed_stats_heap_get(&after);
+    TEST_ASSERT_EQUAL(before.current_size, after.current_size);
+#else
+    TEST_IGNORE_MESSAGE("heap statistics are disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Path of a request parsed without allocation", pathWithoutAllocation),
+    Case("Segments beyond the pool allocated and released", segmentsBeyondPool),
+    Case("Options copied out of a parsed packet", copiedOptions)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
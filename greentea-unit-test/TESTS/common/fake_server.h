@@ -0,0 +1,183 @@
+/**
+ *  @file fake_server.h
+ *  @brief Client context driven by the test without a network: a dimmer object (3311/x/5851) read by the core, and
+ *  a server already registered, reached through a connection capturing the datagrams sent to it
+ *
+ *  The requests of the server are serialized by the test and handed to lwm2m_handle_packet(), the datagrams sent to
+ *  the server are parsed and recorded in sent[] by captureSend(). Without LWM2M_CLIENT_MODE, only the dimmer object
+ *  and the capture are left, for the tests of a server.
+ *
+ *  @date 10/19/2026
+ */
+
+#ifndef FAKE_SERVER_H
+#define FAKE_SERVER_H
+
+#include "liblwm2m.h"
+extern "C"
+{
+#include "connection.h"
+#include "er-coap-13.h"
+}
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define OBJECT_ID 3311
+#define DIMMER_ID 5851
+#define SERVER_ID 1
+
+// Datagrams recorded by captureSend(), a test may record more by defining MAX_SENT first
+#ifndef MAX_SENT
+#define MAX_SENT 8
+#endif
+
+struct Sent
+{
+    coap_message_type_t type;
+    uint8_t code;
+    uint16_t mid;
+    uint8_t token[COAP_TOKEN_LEN];
+    uint8_t tokenLen;
+    uint32_t observe;
+    unsigned int format;
+    std::string path;
+    std::string payload;
+    // Payload read as a plain text integer
+    int value;
+    uint8_t etag[COAP_ETAG_LEN];
+    int etagLen;
+    size_t length;
+};
+
+static Sent sent[MAX_SENT];
+static size_t sentCount;
+static size_t sentBytes;
+
+// The values of the instances are read from the array given as userData of the object, indexed by instance ID
+static uint8_t readDimmer(lwm2m_context_t *contextP, uint16_t instanceId, int *numDataP, lwm2m_data_t **dataArrayP, lwm2m_object_t *objectP)
+{
+    int *values = (int *)objectP->userData;
+
+    if (*numDataP == 0)
+    {
+        *dataArrayP = lwm2m_data_new(1);
+        if (*dataArrayP == NULL)
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        *numDataP = 1;
+        (*dataArrayP)->id = DIMMER_ID;
+    }
+
+    for (int i = 0; i < *numDataP; ++i)
+    {
+        if ((*dataArrayP)[i].id != DIMMER_ID)
+            return COAP_404_NOT_FOUND;
+        lwm2m_data_encode_int(values[instanceId], *dataArrayP + i);
+    }
+    return COAP_205_CONTENT;
+}
+
+static void initDimmerObject(lwm2m_object_t *objectP, lwm2m_list_t *instanceList, int *values)
+{
+    memset(objectP, 0, sizeof(*objectP));
+    objectP->objID = OBJECT_ID;
+    objectP->readFunc = readDimmer;
+    objectP->instanceList = instanceList;
+    objectP->userData = values;
+}
+
+#if defined(LWM2M_CLIENT_MODE)
+// Reports the change of the dimmer of an instance, notified on the next step
+static void dimmerChanged(lwm2m_context_t *contextP, uint16_t instanceId)
+{
+    lwm2m_uri_t uri;
+
+    LWM2M_URI_RESET(&uri);
+    uri.objectId = OBJECT_ID;
+    uri.instanceId = instanceId;
+    uri.resourceId = DIMMER_ID;
+    lwm2m_resource_value_changed(contextP, &uri);
+}
+#endif
+
+static int captureSend(const uint8_t *buffer, size_t length, void *connP)
+{
+    coap_packet_t packet[1];
+    uint8_t *token;
+    const uint8_t *etag;
+    char *path;
+
+    if (sentCount == MAX_SENT || coap_parse_message(packet, (uint8_t *)buffer, length) != NO_ERROR)
+        return -1;
+
+    Sent &record = sent[sentCount++];
+    record.type = packet->type;
+    record.code = packet->code;
+    record.mid = packet->mid;
+    record.tokenLen = coap_get_header_token(packet, &token);
+    if (record.tokenLen > 0)
+        memcpy(record.token, token, record.tokenLen);
+    record.observe = 0;
+    coap_get_header_observe(packet, &record.observe);
+    record.format = coap_get_header_content_type(packet);
+    path = coap_get_multi_option_as_path_string(packet->uri_path);
+    record.path = (path != NULL) ? path : "";
+    lwm2m_free(path);
+    record.payload = std::string((char *)packet->payload, packet->payload_len);
+    record.value = atoi(record.payload.c_str());
+    record.etagLen = coap_get_header_etag(packet, &etag);
+    if (record.etagLen > 0)
+        memcpy(record.etag, etag, record.etagLen);
+    record.length = length;
+    sentBytes += length;
+    coap_free_header(packet);
+
+    return (int)length;
+}
+
+#if defined(LWM2M_CLIENT_MODE)
+// The server registered through sessionH, as once the registration succeeded
+static void registerServer(lwm2m_context_t *contextP, lwm2m_server_t *serverP, void *sessionH)
+{
+    memset(serverP, 0, sizeof(*serverP));
+    serverP->shortID = SERVER_ID;
+    serverP->lifetime = 86400;
+    serverP->registration = lwm2m_gettime();
+    serverP->binding = BINDING_U;
+    serverP->sessionH = sessionH;
+    serverP->status = STATE_REGISTERED;
+    contextP->serverList = serverP;
+    contextP->state = STATE_READY;
+}
+
+// The server registered through a connection handing the datagrams to sendFunc, captureSend() by default
+static void registerFakeServer(lwm2m_context_t *contextP, lwm2m_server_t *serverP, connection_t *connP,
+                               connection_send_func_t sendFunc = captureSend)
+{
+    memset(connP, 0, sizeof(*connP));
+    connP->sendFunc = sendFunc;
+    registerServer(contextP, serverP, connP);
+    sentCount = 0;
+    sentBytes = 0;
+}
+
+// Hands a request or a reply of the server to the context, the packet is freed
+static void handleFromServer(lwm2m_context_t *contextP, connection_t *connP, coap_packet_t *packet)
+{
+    uint8_t buffer[256];
+    size_t length = coap_serialize_message(packet, buffer);
+
+    coap_free_header(packet);
+    lwm2m_handle_packet(contextP, buffer, length, connP);
+}
+
+// Lets the context go without freeing the object and the server owned by the test
+static void closeFakeServerContext(lwm2m_context_t *contextP)
+{
+    contextP->objectList = NULL;
+    contextP->serverList = NULL;
+    lwm2m_close(contextP);
+}
+#endif
+
+#endif
@@ -0,0 +1,264 @@
+/**
+ *  @file loopback.h
+ *  @brief Datagrams looped back through the stack between the socket of a client and the socket of a server run by
+ *  the test, and the mbedTLS server ending the DTLS sessions of the client
+ *
+ *  The socket callbacks queue the datagrams from the thread of the stack, the test hands them to the server and to
+ *  the connection layer from its own thread.
+ *
+ *  @date 10/19/2026
+ */
+
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+#include "mbed.h"
+#include "unity/unity.h"
+
+#include "connection.h"
+#if defined(USE_DTLS)
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ssl.h"
+#if defined(MBEDTLS_SSL_CACHE_C)
+#include "mbedtls/ssl_cache.h"
+#endif
+#endif
+#include <string.h>
+
+#define LOOPBACK_HOST "::1"
+#define LOOPBACK_DATAGRAM_SIZE 512
+#define LOOPBACK_DATAGRAM_COUNT 8
+
+struct LoopbackDatagram
+{
+    bool toServer;
+    ns_address_t addr;
+    size_t length;
+    uint8_t buffer[LOOPBACK_DATAGRAM_SIZE];
+};
+
+static Mail<LoopbackDatagram, LOOPBACK_DATAGRAM_COUNT> loopbackDatagrams;
+
+static void loopbackReceived(void *socket_cb, bool toServer)
+{
+    socket_callback_t *socket_callback = (socket_callback_t *)socket_cb;
+
+    if (socket_callback->event_type != SOCKET_DATA)
+        return;
+
+    while (true)
+    {
+        LoopbackDatagram *datagramP = loopbackDatagrams.try_alloc();
+        if (datagramP == nullptr)
+            return;
+        int length = socket_recvfrom(socket_callback->socket_id, datagramP->buffer, sizeof(datagramP->buffer), 0, &datagramP->addr);
+        if (length <= 0)
+        {
+            loopbackDatagrams.free(datagramP);
+            return;
+        }
+        datagramP->toServer = toServer;
+        datagramP->length = length;
+        loopbackDatagrams.put(datagramP);
+    }
+}
+
+static void loopbackClientReceived(void *socket_cb)
+{
+    loopbackReceived(socket_cb, false);
+}
+
+static void loopbackServerReceived(void *socket_cb)
+{
+    loopbackReceived(socket_cb, true);
+}
+
+// Drops the datagrams left by a failed case
+static void loopbackFlush()
+{
+    while (LoopbackDatagram *datagramP = loopbackDatagrams.try_get())
+        loopbackDatagrams.free(datagramP);
+}
+
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C)
+// DTLS record header, followed by the handshake header in the clear before the ChangeCipherSpec
+#define LOOPBACK_RECORD_HEADER_LEN 13
+#define LOOPBACK_RECORD_HANDSHAKE 22
+#define LOOPBACK_HANDSHAKE_CLIENT_KEY_EXCHANGE 16
+
+// Server side of the DTLS sessions, one at a time. It resumes the sessions it cached when MBEDTLS_SSL_CACHE_C is set.
+class DtlsLoopbackServer
+{
+public:
+    int fullHandshakes = 0;
+    int resumedHandshakes = 0;
+    bool handshakeOver = false;
+
+    void start(int sock, const char *pskId, const uint8_t *psk, size_t pskLen)
+    {
+        static const int ciphersuites[] = { MBEDTLS_TLS_PSK_WITH_AES_128_CCM, 0 };
+
+        _sock = sock;
+        mbedtls_entropy_init(&_entropy);
+        mbedtls_ctr_drbg_init(&_ctrDrbg);
+        mbedtls_ssl_config_init(&_conf);
+        mbedtls_ssl_init(&_ssl);
+        TEST_ASSERT_EQUAL(0, mbedtls_ctr_drbg_seed(&_ctrDrbg, mbedtls_entropy_func, &_entropy, NULL, 0));
+        TEST_ASSERT_EQUAL(0, mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_DATAGRAM, MBEDTLS_SSL_PRESET_DEFAULT));
+        TEST_ASSERT_EQUAL(0, mbedtls_ssl_conf_psk(&_conf, psk, pskLen, (const unsigned char *)pskId, strlen(pskId)));
+        mbedtls_ssl_conf_ciphersuites(&_conf, ciphersuites);
+        mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_ctrDrbg);
+#if defined(MBEDTLS_SSL_CACHE_C)
+        // Sessions are resumed from their ID
+        mbedtls_ssl_cache_init(&_cache);
+        mbedtls_ssl_conf_session_cache(&_conf, &_cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+#endif
+#if defined(MBEDTLS_SSL_DTLS_HELLO_VERIFY)
+        // Both ends are in the same device: no HelloVerifyRequest
+        mbedtls_ssl_conf_dtls_cookies(&_conf, NULL, NULL, NULL);
+#endif
+        TEST_ASSERT_EQUAL(0, mbedtls_ssl_setup(&_ssl, &_conf));
+        mbedtls_ssl_set_bio(&_ssl, this, bioSend, bioRecv, NULL);
+        mbedtls_ssl_set_timer_cb(&_ssl, this, setDelay, getDelay);
+        _finMs = 0;
+        reset();
+    }
+
+    void stop()
+    {
+        mbedtls_ssl_free(&_ssl);
+        mbedtls_ssl_config_free(&_conf);
+#if defined(MBEDTLS_SSL_CACHE_C)
+        mbedtls_ssl_cache_free(&_cache);
+#endif
+        mbedtls_ctr_drbg_free(&_ctrDrbg);
+        mbedtls_entropy_free(&_entropy);
+    }
+
+    // Answers from another socket, as another server sharing the session cache
+    void rebind(int sock)
+    {
+        _sock = sock;
+    }
+
+    // Next handshake, the session cache kept
+    void reset()
+    {
+        mbedtls_ssl_session_reset(&_ssl);
+        _input = nullptr;
+        handshakeOver = false;
+        _keyExchanged = false;
+    }
+
+    // Runs the handshake with the datagram, or reads the application data it carries into buffer. Returns the length
+    // of the application data, 0 when there is none.
+    int handle(LoopbackDatagram *datagramP, uint8_t *buffer, size_t size)
+    {
+        _peerAddr = datagramP->addr;
+        _input = datagramP;
+        inspectRecords(datagramP);
+
+        if (!handshakeOver)
+        {
+            if (mbedtls_ssl_handshake(&_ssl) == 0)
+            {
+                handshakeOver = true;
+                if (_keyExchanged)
+                    fullHandshakes++;
+                else
+                    resumedHandshakes++;
+            }
+            return 0;
+        }
+        int length = mbedtls_ssl_read(&_ssl, buffer, size);
+        return length > 0 ? length : 0;
+    }
+
+    // Sends application data through the session
+    int write(const uint8_t *buffer, size_t length)
+    {
+        return mbedtls_ssl_write(&_ssl, buffer, length);
+    }
+
+private:
+    int _sock = -1;
+    mbedtls_entropy_context _entropy;
+    mbedtls_ctr_drbg_context _ctrDrbg;
+#if defined(MBEDTLS_SSL_CACHE_C)
+    mbedtls_ssl_cache_context _cache;
+#endif
+    mbedtls_ssl_config _conf;
+    mbedtls_ssl_context _ssl;
+    ns_address_t _peerAddr;
+    LoopbackDatagram *_input = nullptr;
+    bool _keyExchanged = false;
+    Kernel::Clock::time_point _timerStart;
+    uint32_t _intMs = 0;
+    uint32_t _finMs = 0;
+
+    // A ClientKeyExchange is only sent by the full handshakes
+    void inspectRecords(LoopbackDatagram *datagramP)
+    {
+        size_t offset = 0;
+
+        while (offset + LOOPBACK_RECORD_HEADER_LEN < datagramP->length)
+        {
+            uint8_t *record = datagramP->buffer + offset;
+            bool clearEpoch = record[3] == 0 && record[4] == 0;
+
+            if (record[0] == LOOPBACK_RECORD_HANDSHAKE && clearEpoch && record[LOOPBACK_RECORD_HEADER_LEN] == LOOPBACK_HANDSHAKE_CLIENT_KEY_EXCHANGE)
+                _keyExchanged = true;
+            offset += LOOPBACK_RECORD_HEADER_LEN + (record[11] << 8 | record[12]);
+        }
+    }
+
+    static int bioSend(void *ctx, const unsigned char *buffer, size_t length)
+    {
+        DtlsLoopbackServer *server = (DtlsLoopbackServer *)ctx;
+
+        if (socket_sendto(server->_sock, &server->_peerAddr, (void *)buffer, length) != 0)
+            return -1;
+        return (int)length;
+    }
+
+    static int bioRecv(void *ctx, unsigned char *buffer, size_t length)
+    {
+        DtlsLoopbackServer *server = (DtlsLoopbackServer *)ctx;
+
+        if (server->_input == nullptr)
+            return MBEDTLS_ERR_SSL_WANT_READ;
+
+        size_t copied = server->_input->length < length ? server->_input->length : length;
+        memcpy(buffer, server->_input->buffer, copied);
+        server->_input = nullptr;
+        return (int)copied;
+    }
+
+    static void setDelay(void *ctx, uint32_t intMs, uint32_t finMs)
+    {
+        DtlsLoopbackServer *server = (DtlsLoopbackServer *)ctx;
+
+        server->_timerStart = Kernel::Clock::now();
+        server->_intMs = intMs;
+        server->_finMs = finMs;
+    }
+
+    static int getDelay(void *ctx)
+    {
+        DtlsLoopbackServer *server = (DtlsLoopbackServer *)ctx;
+
+        if (server->_finMs == 0)
+            return -1;
+
+        uint32_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Kernel::Clock::now() - server->_timerStart).count();
+        if (elapsed >= server->_finMs)
+            return 2;
+        if (elapsed >= server->_intMs)
+            return 1;
+        return 0;
+    }
+};
+#endif
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the DTLS connections closed while their handshake runs, and of the datagrams sent meanwhile
+ *
+ *  DTLS is enabled with USE_DTLS, heap measurements need "platform.heap-stats-enabled": true. No server answers:
+ *  the handshakes never complete.
+ *
+ *  @date 10/18/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "node_client.h"
+#include "dtlsconnection.h"
+#include <string.h>
+
+using namespace utest::v1;
+
+#define SERVER_HOST "::1"
+#define SERVER_PORT "5684"
+#define NO_TIMEOUT 60000
+
+static char pskId[] = "greentea";
+static char psk[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+static uint8_t datagram[] = { 0x40, 0x01, 0x12, 0x34 };
+
+static lwm2m_context_t *lwm2mH;
+static client_data_t data;
+
+static size_t heapUsed()
+{
+#if MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    return stats.current_size;
+#else
+    return 0;
+#endif
+}
+
+static size_t layerSize()
+{
+    size_t count = 0;
+
+    for (connection_t *connP = data.connLayer->connList; connP != NULL; connP = connP->next)
+        count++;
+    return count;
+}
+
+static connection_t *connectServer()
+{
+    connection_t *connP = dtlsconnection_create(data.connLayer, 0, -1, (char *)SERVER_HOST, (char *)SERVER_PORT, 0);
+
+    data.connList = data.connLayer->connList;
+    return connP;
+}
+
+static utest::v1::status_t setupContext(const Case *const source, const size_t index_of_case)
+{
+    memset(&data, 0, sizeof(data));
+    data.sock = -1;
+    lwm2mH = lwm2m_init(&data);
+    data.ctx = lwm2mH;
+    data.securityObjP = get_security_object(1, "coaps://[" SERVER_HOST "]:" SERVER_PORT, pskId, psk, sizeof(psk), false);
+    lwm2mH->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(lwm2mH->objectList, data.securityObjP);
+    data.connLayer = connectionlayer_create(lwm2mH);
+
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+static utest::v1::status_t teardownContext(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    connectionlayer_free(data.connLayer);
+    lwm2mH->objectList = NULL;
+    lwm2m_close(lwm2mH);
+    free_security_object(data.securityObjP);
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+static control_t stepAfterClose(){
+#if defined(USE_DTLS)
+    uint32_t timeoutMs = NO_TIMEOUT;
+    size_t before = heapUsed();
+
+    connection_t *closedP = connectServer();
+    connection_t *keptP = connectServer();
+    TEST_ASSERT_NOT_NULL(closedP);
+    TEST_ASSERT_NOT_NULL(keptP);
+
+    // Both handshakes start with a datagram waiting for them
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_buffer_send(closedP, datagram, sizeof(datagram), NULL));
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_buffer_send(keptP, datagram, sizeof(datagram), NULL));
+
+    // The step only walks the connection left in the layer
+    lwm2m_close_connection(closedP, &data);
+    TEST_ASSERT_EQUAL(1, layerSize());
+    TEST_ASSERT_EQUAL_PTR(keptP, data.connList);
+    dtlsconnection_step(data.connLayer, &timeoutMs);
+    TEST_ASSERT_TRUE(timeoutMs < NO_TIMEOUT);
+
+    // Its handshake, its datagram and the shared crypto released with the last connection
+    lwm2m_close_connection(keptP, &data);
+    TEST_ASSERT_EQUAL(0, layerSize());
+    TEST_ASSERT_NULL(data.connList);
+    timeoutMs = NO_TIMEOUT;
+    dtlsconnection_step(data.connLayer, &timeoutMs);
+    TEST_ASSERT_EQUAL(NO_TIMEOUT, timeoutMs);
+#if MBED_HEAP_STATS_ENABLED
+    TEST_ASSERT_EQUAL(before, heapUsed());
+#endif
+    (void)before;
+#else
+    TEST_IGNORE_MESSAGE("DTLS is disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t datagramsQueuedDuringHandshake(){
+#if defined(USE_DTLS)
+    connection_t *connP = connectServer();
+    TEST_ASSERT_NOT_NULL(connP);
+
+    // Kept in order for the end of the handshake, none replaced by the next one
+    for (int i = 0; i < DTLS_PENDING_MAX; ++i)
+    {
+        datagram[3] = i;
+        TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_buffer_send(connP, datagram, sizeof(datagram), NULL));
+    }
+
+    // Refused rather than lost once the queue is full, the transaction sends it again later
+    TEST_ASSERT_EQUAL(COAP_500_INTERNAL_SERVER_ERROR, lwm2m_buffer_send(connP, datagram, sizeof(datagram), NULL));
+    TEST_ASSERT_EQUAL(-1, (*connP->sendFunc)(datagram, sizeof(datagram), connP));
+
+    lwm2m_close_connection(connP, &data);
+    TEST_ASSERT_EQUAL(0, layerSize());
+#else
+    TEST_IGNORE_MESSAGE("DTLS is disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Step after a connection is closed", setupContext, stepAfterClose, teardownContext),
+    Case("Datagrams queued during the handshake", setupContext, datagramsQueuedDuringHandshake, teardownContext)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
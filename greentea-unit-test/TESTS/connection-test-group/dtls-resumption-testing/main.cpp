@@ -0,0 +1,278 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the resumption of the DTLS sessions: the connections made after the first handshake with a server,
+ *  as when the client wakes up or after a reboot, get their first notification through sooner than the first
+ *  connection, and a session is not resumed once the server URI changed
+ *
+ *  DTLS is enabled with USE_DTLS. The server is run in-process by mbedTLS (see loopback.h), which needs
+ *  MBEDTLS_SSL_SRV_C and MBEDTLS_SSL_CACHE_C: greentea-unit-test/configs/dtls_server.json sets them. Each datagram is
+ *  delayed by the latency of the link, the round trips of the handshake dominate the time to the first notification.
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "node_client.h"
+#include "dtlsconnection.h"
+#include "../../common/loopback.h"
+#include <string.h>
+
+using namespace utest::v1;
+using namespace std::chrono;
+
+#define SERVER_PORT "5684"
+#define SERVER_PORT_NUM 5684
+#define OTHER_SERVER_PORT "5685"
+#define OTHER_SERVER_PORT_NUM 5685
+#define SECURITY_INSTANCE 0
+#define STEP_MS 100
+#define EXCHANGE_TIMEOUT 10s
+#define LINK_LATENCY 50ms
+#define SLEEP_CYCLES 3
+
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_SSL_CACHE_C)
+static char pskId[] = "greentea";
+static char psk[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+// Non-confirmable 2.05 Content, as sent for an observation
+static uint8_t notification[] = { 0x50, 0x45, 0x12, 0x34 };
+
+static lwm2m_context_t *lwm2mH;
+static client_data_t data;
+static int clientSock;
+static int serverSock;
+static int otherServerSock;
+static DtlsLoopbackServer server;
+static int received;
+
+static uint8_t stored[DTLS_SESSION_BUFFER_SIZE];
+static size_t storedLength;
+static dtlsconnection_session_storage_t storage;
+
+static void serverStart()
+{
+    server.start(serverSock, pskId, (const uint8_t *)psk, sizeof(psk));
+}
+
+static int loadSession(uint16_t securityInstance, uint8_t *buffer, size_t length, size_t *outLengthP, void *userData)
+{
+    if (storedLength > length)
+        return -1;
+    memcpy(buffer, stored, storedLength);
+    *outLengthP = storedLength;
+    return 0;
+}
+
+static int storeSession(uint16_t securityInstance, uint8_t const *buffer, size_t length, void *userData)
+{
+    if (length > sizeof(stored))
+        return -1;
+    memcpy(stored, buffer, length);
+    storedLength = length;
+    return 0;
+}
+
+static connection_t *connectServer(const char *port = SERVER_PORT)
+{
+    connection_t *connP = dtlsconnection_create(data.connLayer, SECURITY_INSTANCE, clientSock, (char *)LOOPBACK_HOST, (char *)port, 0);
+
+    data.connList = data.connLayer->connList;
+    server.reset();
+    return connP;
+}
+
+// Hands the datagrams to the server and to the connection layer until the server received count datagrams through
+// the sessions
+static bool exchange(int count)
+{
+    Timer timer;
+
+    timer.start();
+    while (received < count && timer.elapsed_time() < EXCHANGE_TIMEOUT)
+    {
+        uint32_t timeoutMs = STEP_MS;
+
+        dtlsconnection_step(data.connLayer, &timeoutMs);
+        LoopbackDatagram *datagramP = loopbackDatagrams.try_get_for(milliseconds(timeoutMs));
+        if (datagramP == nullptr)
+            continue;
+        ThisThread::sleep_for(LINK_LATENCY);
+        if (datagramP->toServer)
+        {
+            uint8_t buffer[LOOPBACK_DATAGRAM_SIZE];
+
+            if (server.handle(datagramP, buffer, sizeof(buffer)) > 0)
+                received++;
+        }
+        else
+            connectionlayer_handle_packet(data.connLayer, &datagramP->addr, datagramP->buffer, datagramP->length);
+        loopbackDatagrams.free(datagramP);
+    }
+    return received == count;
+}
+
+// Handshake run by the connection for the notification, then the notification read by the server. Returns the time
+// to the first notification.
+static milliseconds notifyThroughSession(connection_t *connP, int count)
+{
+    Timer timer;
+
+    TEST_ASSERT_NOT_NULL(connP);
+    timer.start();
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_buffer_send(connP, notification, sizeof(notification), NULL));
+    TEST_ASSERT_TRUE(exchange(count));
+    return duration_cast<milliseconds>(timer.elapsed_time());
+}
+
+static utest::v1::status_t setupContext(const Case *const source, const size_t index_of_case)
+{
+    mesh_system_init();
+    memset(&data, 0, sizeof(data));
+    clientSock = socket_open(SOCKET_UDP, 0, loopbackClientReceived);
+    serverSock = socket_open(SOCKET_UDP, SERVER_PORT_NUM, loopbackServerReceived);
+    otherServerSock = socket_open(SOCKET_UDP, OTHER_SERVER_PORT_NUM, loopbackServerReceived);
+    data.sock = clientSock;
+    lwm2mH = lwm2m_init(&data);
+    data.ctx = lwm2mH;
+    data.securityObjP = get_security_object(1, "coaps://[" LOOPBACK_HOST "]:" SERVER_PORT, pskId, psk, sizeof(psk), false);
+    lwm2mH->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(lwm2mH->objectList, data.securityObjP);
+    data.connLayer = connectionlayer_create(lwm2mH);
+    storage = { loadSession, storeSession, NULL };
+    storedLength = 0;
+    server.fullHandshakes = 0;
+    server.resumedHandshakes = 0;
+    received = 0;
+
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+static utest::v1::status_t teardownContext(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    connectionlayer_free(data.connLayer);
+    lwm2mH->objectList = NULL;
+    lwm2m_close(lwm2mH);
+    free_security_object(data.securityObjP);
+    server.stop();
+    socket_close(clientSock);
+    socket_close(serverSock);
+    socket_close(otherServerSock);
+    loopbackFlush();
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+#endif
+
+static control_t resumedOnWakeUp(){
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_SSL_CACHE_C)
+    serverStart();
+    connection_t *connP = connectServer();
+    milliseconds fullTime = notifyThroughSession(connP, 1);
+    utest_printf("first notification after a full handshake: %lld ms\n", (long long)fullTime.count());
+
+    // Each time the client wakes up, the session cached by the layer saves a round trip
+    for (int cycle = 1; cycle <= SLEEP_CYCLES; cycle++)
+    {
+        lwm2m_close_connection(connP, &data);
+        connP = connectServer();
+        milliseconds resumedTime = notifyThroughSession(connP, 1 + cycle);
+        utest_printf("first notification after wake up %d: %lld ms\n", cycle, (long long)resumedTime.count());
+        TEST_ASSERT_TRUE(resumedTime < fullTime);
+    }
+    lwm2m_close_connection(connP, &data);
+#else
+    TEST_IGNORE_MESSAGE("DTLS or the mbedTLS server is disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t resumedAfterReboot(){
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_SSL_CACHE_C)
+    serverStart();
+    dtlsconnection_set_session_storage(data.connLayer, &storage);
+    milliseconds fullTime = notifyThroughSession(connectServer(), 1);
+    TEST_ASSERT_TRUE(storedLength > 0);
+
+    // Nothing cached by the new layer, the session is loaded from the storage
+    connectionlayer_free(data.connLayer);
+    data.connLayer = connectionlayer_create(lwm2mH);
+    dtlsconnection_set_session_storage(data.connLayer, &storage);
+    milliseconds resumedTime = notifyThroughSession(connectServer(), 2);
+    utest_printf("first notification: %lld ms, after a reboot: %lld ms\n", (long long)fullTime.count(), (long long)resumedTime.count());
+    TEST_ASSERT_TRUE(resumedTime < fullTime);
+
+    // Forgotten: the next connection runs a full handshake
+    dtlsconnection_session_forget(data.connLayer, SECURITY_INSTANCE);
+    TEST_ASSERT_EQUAL(0, storedLength);
+    lwm2m_close_connection(data.connLayer->connList, &data);
+    milliseconds forgottenTime = notifyThroughSession(connectServer(), 3);
+    TEST_ASSERT_TRUE(resumedTime < forgottenTime);
+#else
+    TEST_IGNORE_MESSAGE("DTLS or the mbedTLS server is disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t notResumedWithOtherServer(){
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_SSL_CACHE_C)
+    serverStart();
+    dtlsconnection_set_session_storage(data.connLayer, &storage);
+    connection_t *connP = connectServer();
+    notifyThroughSession(connP, 1);
+    TEST_ASSERT_EQUAL(1, server.fullHandshakes);
+
+    // The server URI of the instance changed: the server would resume the session from its cache, the client runs a
+    // full handshake instead
+    lwm2m_close_connection(connP, &data);
+    server.rebind(otherServerSock);
+    connP = connectServer(OTHER_SERVER_PORT);
+    notifyThroughSession(connP, 2);
+    TEST_ASSERT_EQUAL(2, server.fullHandshakes);
+    TEST_ASSERT_EQUAL(0, server.resumedHandshakes);
+
+    // After a reboot, the session stored for the new server is not resumed with the former one
+    lwm2m_close_connection(connP, &data);
+    connectionlayer_free(data.connLayer);
+    data.connLayer = connectionlayer_create(lwm2mH);
+    dtlsconnection_set_session_storage(data.connLayer, &storage);
+    server.rebind(serverSock);
+    notifyThroughSession(connectServer(), 3);
+    TEST_ASSERT_EQUAL(3, server.fullHandshakes);
+    TEST_ASSERT_EQUAL(0, server.resumedHandshakes);
+#else
+    TEST_IGNORE_MESSAGE("DTLS or the mbedTLS server is disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_SSL_CACHE_C)
+Case cases[] = {
+    Case("Session resumed on each wake up", setupContext, resumedOnWakeUp, teardownContext),
+    Case("Session resumed from the storage after a reboot", setupContext, resumedAfterReboot, teardownContext),
+    Case("Session not resumed with another server", setupContext, notResumedWithOtherServer, teardownContext)
+};
+#else
+Case cases[] = {
+    Case("Session resumed on each wake up", resumedOnWakeUp),
+    Case("Session resumed from the storage after a reboot", resumedAfterReboot),
+    Case("Session not resumed with another server", notResumedWithOtherServer)
+};
+#endif
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,527 @@
+/**
+ *  @file main.cpp
+ *  @brief Benchmark of OSCORE against DTLS and plain CoAP: bytes of a notification on the wire, and time from the
+ *  creation of the connection to the first request received by the server
+ *
+ *  The client and the server run in-process, their datagrams loop back through the stack (see loopback.h). The server
+ *  end of OSCORE is a connection layer of a second context holding the security context of the server, which sends
+ *  its requests as transactions. The server end of DTLS is run by mbedTLS, which needs MBEDTLS_SSL_SRV_C. OSCORE needs
+ *  LWM2M_SUPPORT_OSCORE.
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "node_client.h"
+#include "dtlsconnection.h"
+#if defined(LWM2M_SUPPORT_OSCORE)
+#include "oscoreconnection.h"
+#endif
+#include "../../common/loopback.h"
+#include "../../common/fake_server.h"
+extern "C"
+{
+#include "internals.h"
+}
+#include <string.h>
+
+using namespace utest::v1;
+using namespace std::chrono;
+
+#define SECURITY_INSTANCE 0
+#define CLIENT_PORT "5690"
+#define CLIENT_PORT_NUM 5690
+#define SERVER_PORT "5683"
+#define SERVER_PORT_NUM 5683
+// Instances of the OSCORE object holding the security contexts of both ends
+#define CLIENT_OSCORE_INSTANCE 0
+#define SERVER_OSCORE_INSTANCE 1
+#define NOTIFY_COUNT 10
+#define STEP_MS 100
+#define EXCHANGE_TIMEOUT 10s
+
+enum Mode
+{
+    MODE_PLAIN,
+    MODE_OSCORE,
+    MODE_DTLS
+};
+
+static const char *modeNames[] = { "CoAP", "OSCORE", "DTLS" };
+
+static char pskId[] = "greentea";
+static char psk[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+static const uint8_t masterSecret[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10 };
+static const uint8_t clientId[] = { 0x01 };
+static const uint8_t serverId[] = { 0x02 };
+
+static Mode mode;
+static int clientSock;
+static int serverSock;
+
+// Client
+static lwm2m_context_t *lwm2mH;
+static client_data_t data;
+static lwm2m_object_t object;
+static lwm2m_list_t instance;
+static int value;
+static lwm2m_server_t server;
+static connection_t *connP;
+
+// Server
+static lwm2m_context_t *peerH;
+static client_data_t peerData;
+static connection_t *peerConnP;
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C)
+static DtlsLoopbackServer dtlsServer;
+#endif
+static uint16_t peerMid = 1;
+static uint8_t responseCode;
+static uint8_t echo[8];
+static size_t echoLen;
+
+// Application messages received by the server and their size on the wire
+static int serverReceived;
+static size_t serverBytes;
+static int responses;
+
+#if defined(LWM2M_SUPPORT_OSCORE)
+static lwm2m_object_t clientOscore;
+static lwm2m_object_t serverOscore;
+static lwm2m_list_t clientOscoreInstance;
+static lwm2m_list_t serverOscoreInstance;
+#endif
+
+#if defined(LWM2M_SUPPORT_OSCORE)
+// The Sender ID of an end is the Recipient ID of the other one
+static uint8_t readOscore(lwm2m_context_t *contextP, uint16_t instanceId, int *numDataP, lwm2m_data_t **dataArrayP, lwm2m_object_t *objectP)
+{
+    bool isClient = instanceId == CLIENT_OSCORE_INSTANCE;
+
+    for (int i = 0; i < *numDataP; ++i)
+    {
+        lwm2m_data_t *dataP = *dataArrayP + i;
+
+        switch (dataP->id)
+        {
+        case LWM2M_OSCORE_MASTER_SECRET_ID:
+            lwm2m_data_encode_opaque((uint8_t *)masterSecret, sizeof(masterSecret), dataP);
+            break;
+        case LWM2M_OSCORE_SENDER_ID_ID:
+            lwm2m_data_encode_opaque((uint8_t *)(isClient ? clientId : serverId), 1, dataP);
+            break;
+        case LWM2M_OSCORE_RECIPIENT_ID_ID:
+            lwm2m_data_encode_opaque((uint8_t *)(isClient ? serverId : clientId), 1, dataP);
+            break;
+        default:
+            return COAP_404_NOT_FOUND;
+        }
+    }
+    return COAP_205_CONTENT;
+}
+
+// Nothing was sent with the keys before the benchmark
+static int loadSsn(uint16_t oscoreInstance, uint64_t *ssnP, void *userData)
+{
+    *ssnP = 0;
+    return 0;
+}
+
+static int storeSsn(uint16_t oscoreInstance, uint64_t ssn, void *userData)
+{
+    return 0;
+}
+
+static oscoreconnection_ssn_storage_t ssnStorage = { loadSsn, storeSsn, NULL };
+
+static void initOscoreObject(lwm2m_object_t *objectP, lwm2m_list_t *instanceP, uint16_t instanceId)
+{
+    memset(objectP, 0, sizeof(lwm2m_object_t));
+    memset(instanceP, 0, sizeof(lwm2m_list_t));
+    objectP->objID = LWM2M_OSCORE_OBJECT_ID;
+    objectP->readFunc = readOscore;
+    instanceP->id = instanceId;
+    objectP->instanceList = instanceP;
+}
+#endif
+
+static void peerResponded(lwm2m_context_t *contextP, lwm2m_transaction_t *transacP, void *message)
+{
+    coap_packet_t *packet = (coap_packet_t *)message;
+
+    responses++;
+    responseCode = packet != NULL ? packet->code : COAP_503_SERVICE_UNAVAILABLE;
+    echoLen = 0;
+#if defined(LWM2M_SUPPORT_OSCORE)
+    const uint8_t *echoP;
+    int length = packet != NULL ? coap_get_header_echo(packet, &echoP) : -1;
+    if (length > 0 && (size_t)length <= sizeof(echo))
+    {
+        memcpy(echo, echoP, length);
+        echoLen = length;
+    }
+#endif
+}
+
+// Hands the datagrams to both ends until the counter, of the application messages received by the server or of the
+// responses to its transactions, reaches count
+static bool exchange(int *counterP, int count)
+{
+    Timer timer;
+
+    timer.start();
+    while (*counterP < count && timer.elapsed_time() < EXCHANGE_TIMEOUT)
+    {
+        uint32_t timeoutMs = STEP_MS;
+
+#if defined(USE_DTLS)
+        dtlsconnection_step(data.connLayer, &timeoutMs);
+#endif
+        LoopbackDatagram *datagramP = loopbackDatagrams.try_get_for(milliseconds(timeoutMs));
+        if (datagramP == nullptr)
+            continue;
+        if (!datagramP->toServer)
+        {
+            connectionlayer_handle_packet(data.connLayer, &datagramP->addr, datagramP->buffer, datagramP->length);
+        }
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C)
+        else if (mode == MODE_DTLS)
+        {
+            uint8_t buffer[LOOPBACK_DATAGRAM_SIZE];
+
+            if (dtlsServer.handle(datagramP, buffer, sizeof(buffer)) > 0)
+            {
+                serverReceived++;
+                serverBytes += datagramP->length;
+            }
+        }
+#endif
+        else
+        {
+            serverReceived++;
+            serverBytes += datagramP->length;
+            connectionlayer_handle_packet(peerData.connLayer, &datagramP->addr, datagramP->buffer, datagramP->length);
+        }
+        loopbackDatagrams.free(datagramP);
+    }
+    return *counterP >= count;
+}
+
+static void openSockets()
+{
+    mesh_system_init();
+    clientSock = socket_open(SOCKET_UDP, CLIENT_PORT_NUM, loopbackClientReceived);
+    serverSock = socket_open(SOCKET_UDP, SERVER_PORT_NUM, loopbackServerReceived);
+    serverReceived = 0;
+    serverBytes = 0;
+    responses = 0;
+    echoLen = 0;
+}
+
+// The client context, its connection to the server not created yet
+static void openClient()
+{
+    bool withPsk = mode == MODE_DTLS;
+
+    memset(&data, 0, sizeof(data));
+    data.sock = clientSock;
+    lwm2mH = lwm2m_init(&data);
+    data.ctx = lwm2mH;
+    data.securityObjP = get_security_object(SERVER_ID, "coap://[" LOOPBACK_HOST "]:" SERVER_PORT, withPsk ? pskId : NULL, withPsk ? psk : NULL, withPsk ? sizeof(psk) : 0, false);
+    lwm2mH->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(lwm2mH->objectList, data.securityObjP);
+
+    memset(&instance, 0, sizeof(instance));
+    initDimmerObject(&object, &instance, &value);
+    lwm2mH->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(lwm2mH->objectList, &object);
+    value = 100;
+
+    data.connLayer = connectionlayer_create(lwm2mH);
+#if defined(LWM2M_SUPPORT_OSCORE)
+    if (mode == MODE_OSCORE)
+    {
+        initOscoreObject(&clientOscore, &clientOscoreInstance, CLIENT_OSCORE_INSTANCE);
+        lwm2mH->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(lwm2mH->objectList, &clientOscore);
+        set_security_oscore_instance(data.securityObjP, SECURITY_INSTANCE, CLIENT_OSCORE_INSTANCE);
+        oscoreconnection_set_ssn_storage(data.connLayer, &ssnStorage);
+    }
+#endif
+    connP = NULL;
+}
+
+// Created like lwm2m_connect_server() does, then reached by the requests of the server as a registered server
+static void connectClient()
+{
+    switch (mode)
+    {
+    case MODE_PLAIN:
+        connP = connection_create(data.connLayer, clientSock, (char *)LOOPBACK_HOST, (char *)SERVER_PORT, 0);
+        break;
+    case MODE_OSCORE:
+#if defined(LWM2M_SUPPORT_OSCORE)
+        connP = oscoreconnection_create(data.connLayer, SECURITY_INSTANCE, clientSock, (char *)LOOPBACK_HOST, (char *)SERVER_PORT, 0);
+#endif
+        break;
+    case MODE_DTLS:
+#if defined(USE_DTLS)
+        connP = dtlsconnection_create(data.connLayer, SECURITY_INSTANCE, clientSock, (char *)LOOPBACK_HOST, (char *)SERVER_PORT, 0);
+#endif
+        break;
+    }
+    TEST_ASSERT_NOT_NULL(connP);
+    data.connList = data.connLayer->connList;
+
+    registerServer(lwm2mH, &server, connP);
+}
+
+static void openServer()
+{
+    if (mode == MODE_DTLS)
+    {
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C)
+        dtlsServer.start(serverSock, pskId, (const uint8_t *)psk, sizeof(psk));
+#endif
+        return;
+    }
+
+    memset(&peerData, 0, sizeof(peerData));
+    peerData.sock = serverSock;
+    peerH = lwm2m_init(&peerData);
+    peerData.ctx = peerH;
+    peerData.securityObjP = get_security_object(SERVER_ID, "coap://[" LOOPBACK_HOST "]:" CLIENT_PORT, NULL, NULL, 0, false);
+    peerH->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(peerH->objectList, peerData.securityObjP);
+    peerData.connLayer = connectionlayer_create(peerH);
+#if defined(LWM2M_SUPPORT_OSCORE)
+    if (mode == MODE_OSCORE)
+    {
+        initOscoreObject(&serverOscore, &serverOscoreInstance, SERVER_OSCORE_INSTANCE);
+        peerH->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(peerH->objectList, &serverOscore);
+        set_security_oscore_instance(peerData.securityObjP, SECURITY_INSTANCE, SERVER_OSCORE_INSTANCE);
+        oscoreconnection_set_ssn_storage(peerData.connLayer, &ssnStorage);
+        peerConnP = oscoreconnection_create(peerData.connLayer, SECURITY_INSTANCE, serverSock, (char *)LOOPBACK_HOST, (char *)CLIENT_PORT, 0);
+    }
+    else
+#endif
+    {
+        peerConnP = connection_create(peerData.connLayer, serverSock, (char *)LOOPBACK_HOST, (char *)CLIENT_PORT, 0);
+    }
+    TEST_ASSERT_NOT_NULL(peerConnP);
+    peerData.connList = peerData.connLayer->connList;
+}
+
+static void closeAll()
+{
+    if (mode == MODE_DTLS)
+    {
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C)
+        dtlsServer.stop();
+#endif
+    }
+    else if (peerH != NULL)
+    {
+        connectionlayer_free(peerData.connLayer);
+        peerH->objectList = NULL;
+        lwm2m_close(peerH);
+        free_security_object(peerData.securityObjP);
+        peerH = NULL;
+    }
+    if (lwm2mH != NULL)
+    {
+        connectionlayer_free(data.connLayer);
+        lwm2mH->serverList = NULL;
+        lwm2mH->objectList = NULL;
+        lwm2m_close(lwm2mH);
+        free_security_object(data.securityObjP);
+        lwm2mH = NULL;
+    }
+    socket_close(clientSock);
+    socket_close(serverSock);
+    loopbackFlush();
+}
+
+// The request a client sends first
+static size_t serializeRegister(uint8_t *buffer)
+{
+    coap_packet_t request[1];
+    uint8_t token[4] = { 0xA0, 0x00, 0x00, 0x01 };
+
+    coap_init_message(request, COAP_TYPE_CON, COAP_POST, 1);
+    coap_set_header_token(request, token, sizeof(token));
+    coap_set_header_uri_path(request, "/rd");
+    coap_set_header_uri_query(request, "ep=greentea&lt=86400&lwm2m=1.1");
+    coap_set_header_content_type(request, LWM2M_CONTENT_LINK);
+    coap_set_payload(request, (uint8_t *)"</3311/0>", 9);
+    size_t length = coap_serialize_message(request, buffer);
+    coap_free_header(request);
+
+    return length;
+}
+
+// Observe request of the server, answered with an Echo challenge by a client protected with OSCORE after a reboot
+static void observe()
+{
+    uint8_t token[2] = { 0xB0, 0x00 };
+
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C)
+    if (mode == MODE_DTLS)
+    {
+        coap_packet_t request[1];
+        uint8_t buffer[64];
+        char path[24];
+
+        // The handshake is run by the first datagram of the client
+        TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_buffer_send(connP, buffer, serializeRegister(buffer), NULL));
+        TEST_ASSERT_TRUE(exchange(&serverReceived, 1));
+
+        snprintf(path, sizeof(path), "/%d/0/%d", OBJECT_ID, DIMMER_ID);
+        coap_init_message(request, COAP_TYPE_CON, COAP_GET, peerMid++);
+        coap_set_header_token(request, token, sizeof(token));
+        coap_set_header_uri_path(request, path);
+        coap_set_header_accept(request, LWM2M_CONTENT_TEXT);
+        coap_set_header_observe(request, 0);
+        size_t length = coap_serialize_message(request, buffer);
+        coap_free_header(request);
+        TEST_ASSERT_EQUAL(length, dtlsServer.write(buffer, length));
+        TEST_ASSERT_TRUE(exchange(&serverReceived, 2));
+        return;
+    }
+#endif
+
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        lwm2m_uri_t uri;
+
+        LWM2M_URI_RESET(&uri);
+        uri.objectId = OBJECT_ID;
+        uri.instanceId = 0;
+        uri.resourceId = DIMMER_ID;
+        token[1] = (uint8_t)attempt;
+        lwm2m_transaction_t *transactionP = transaction_new(peerConnP, COAP_GET, NULL, &uri, peerMid++, sizeof(token), token);
+        TEST_ASSERT_NOT_NULL(transactionP);
+        coap_set_header_accept(transactionP->message, LWM2M_CONTENT_TEXT);
+        coap_set_header_observe(transactionP->message, 0);
+#if defined(LWM2M_SUPPORT_OSCORE)
+        if (echoLen > 0)
+            coap_set_header_echo(transactionP->message, echo, echoLen);
+#endif
+        transactionP->callback = peerResponded;
+        peerH->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(peerH->transactionList, transactionP);
+        TEST_ASSERT_EQUAL(0, transaction_send(peerH, transactionP));
+        // A 4.01 reaches the callback with its Echo instead of being retransmitted unchanged
+        transactionP->retrans_counter = COAP_MAX_RETRANSMIT;
+        TEST_ASSERT_TRUE(exchange(&responses, attempt + 1));
+
+        if (responseCode != COAP_401_UNAUTHORIZED || echoLen == 0)
+            break;
+    }
+    TEST_ASSERT_EQUAL(COAP_205_CONTENT, responseCode);
+}
+
+static void benchmarkNotifications(Mode benchmarked)
+{
+    mode = benchmarked;
+    openSockets();
+    openServer();
+    openClient();
+    connectClient();
+    observe();
+
+    serverReceived = 0;
+    serverBytes = 0;
+    for (int n = 1; n <= NOTIFY_COUNT; ++n)
+    {
+        time_t timeout = 60;
+
+        value = 100 + n;
+        dimmerChanged(lwm2mH, 0);
+        lwm2m_step(lwm2mH, &timeout);
+        TEST_ASSERT_TRUE(exchange(&serverReceived, n));
+    }
+    utest_printf("%s: %u bytes per notification of a 3 digit value\n", modeNames[mode], (unsigned)(serverBytes / NOTIFY_COUNT));
+    closeAll();
+}
+
+static void benchmarkFirstRequest(Mode benchmarked)
+{
+    uint8_t buffer[64];
+    size_t length = serializeRegister(buffer);
+    Timer timer;
+
+    mode = benchmarked;
+    openSockets();
+    openServer();
+    openClient();
+
+    // From the creation of the connection: the key derivation of OSCORE, the handshake of DTLS
+    timer.start();
+    connectClient();
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_buffer_send(connP, buffer, length, NULL));
+    TEST_ASSERT_TRUE(exchange(&serverReceived, 1));
+    timer.stop();
+
+    utest_printf("%s: first request received after %d us\n", modeNames[mode], (int)duration_cast<microseconds>(timer.elapsed_time()).count());
+    closeAll();
+}
+
+static control_t bytesPerNotification(){
+    benchmarkNotifications(MODE_PLAIN);
+#if defined(LWM2M_SUPPORT_OSCORE)
+    benchmarkNotifications(MODE_OSCORE);
+#else
+    utest_printf("OSCORE is disabled\n");
+#endif
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C)
+    benchmarkNotifications(MODE_DTLS);
+#else
+    utest_printf("DTLS or the mbedTLS server is disabled\n");
+#endif
+    return CaseNext;
+}
+
+static control_t timeToFirstRequest(){
+    benchmarkFirstRequest(MODE_PLAIN);
+#if defined(LWM2M_SUPPORT_OSCORE)
+    benchmarkFirstRequest(MODE_OSCORE);
+#else
+    utest_printf("OSCORE is disabled\n");
+#endif
+#if defined(USE_DTLS) && defined(MBEDTLS_SSL_SRV_C)
+    benchmarkFirstRequest(MODE_DTLS);
+#else
+    utest_printf("DTLS or the mbedTLS server is disabled\n");
+#endif
+    return CaseNext;
+}
+
+static utest::v1::status_t teardownCase(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    // Left open by a failed case
+    if (lwm2mH != NULL)
+        closeAll();
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (120s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(120, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Bytes per notification", greentea_case_setup_handler, bytesPerNotification, teardownCase),
+    Case("Time to the first request", greentea_case_setup_handler, timeToFirstRequest, teardownCase)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,199 @@
+/**
+ *  @file main.cpp
+ *  @brief Stress test of several contexts driven at the same time from their own thread: each one handles reads and
+ *  observations of its server, the responses and notifications must only carry its own values and tokens
+ *
+ *  The requests are handled by the core, the datagrams sent to each server are captured by the connection of the
+ *  server. Threads do not assert: they count the mismatches, checked once they are joined.
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "../../common/fake_server.h"
+
+using namespace utest::v1;
+
+#define CONTEXT_COUNT 4
+#define ROUND_COUNT 200
+#define THREAD_STACK_SIZE 8192
+
+struct Client
+{
+    // First member: the object given to the read callback is the client
+    lwm2m_object_t object;
+    lwm2m_list_t instance;
+    lwm2m_server_t server;
+    connection_t serverConn;
+    lwm2m_context_t *lwm2mH;
+    uint8_t index;
+    int value;
+    uint16_t mid;
+    // Expected in the next datagram sent to the server
+    uint8_t expectedToken;
+    int expectedValue;
+    size_t responses;
+    size_t notifications;
+    size_t mismatches;
+};
+
+static Client clients[CONTEXT_COUNT];
+
+static uint8_t readChecked(lwm2m_context_t *contextP, uint16_t instanceId, int *numDataP, lwm2m_data_t **dataArrayP, lwm2m_object_t *objectP)
+{
+    Client *client = (Client *)objectP;
+
+    if (contextP != client->lwm2mH)
+        client->mismatches++;
+
+    return readDimmer(contextP, instanceId, numDataP, dataArrayP, objectP);
+}
+
+static int checkSend(const uint8_t *buffer, size_t length, void *connP)
+{
+    Client *client = nullptr;
+    coap_packet_t packet[1];
+    uint8_t *token;
+
+    for (Client &candidate : clients)
+    {
+        if (&candidate.serverConn == connP)
+            client = &candidate;
+    }
+    if (client == nullptr || coap_parse_message(packet, (uint8_t *)buffer, length) != NO_ERROR)
+        return -1;
+
+    // Token made of the index of the context and of the request
+    uint8_t tokenLen = coap_get_header_token(packet, &token);
+    int value = atoi(std::string((char *)packet->payload, packet->payload_len).c_str());
+    if (packet->code != COAP_205_CONTENT || tokenLen != 2 || token[0] != client->index
+        || token[1] != client->expectedToken || value != client->expectedValue)
+        client->mismatches++;
+    else if (packet->type == COAP_TYPE_ACK)
+        client->responses++;
+    else
+        client->notifications++;
+    coap_free_header(packet);
+
+    return (int)length;
+}
+
+static void request(Client *client, uint8_t tokenId, bool observe)
+{
+    coap_packet_t request[1];
+    uint8_t buffer[64];
+    uint8_t token[2] = { client->index, tokenId };
+
+    coap_init_message(request, COAP_TYPE_CON, COAP_GET, client->mid++);
+    coap_set_header_token(request, token, sizeof(token));
+    coap_set_header_uri_path(request, "/3311/0/5851");
+    coap_set_header_accept(request, LWM2M_CONTENT_TEXT);
+    if (observe)
+        coap_set_header_observe(request, 0);
+    size_t length = coap_serialize_message(request, buffer);
+    coap_free_header(request);
+
+    client->expectedToken = tokenId;
+    client->expectedValue = client->value;
+    lwm2m_handle_packet(client->lwm2mH, buffer, length, &client->serverConn);
+}
+
+static void change(Client *client, int value)
+{
+    time_t timeout = 60;
+
+    client->value = value;
+    dimmerChanged(client->lwm2mH, 0);
+
+    // Notified on the step, with the token of the observation
+    client->expectedValue = value;
+    lwm2m_step(client->lwm2mH, &timeout);
+}
+
+static void drive(Client *client)
+{
+    const uint8_t observeToken = 0xFF;
+
+    request(client, observeToken, true);
+    for (int round = 0; round < ROUND_COUNT; ++round)
+    {
+        // Values differ between the contexts
+        client->value = client->index * 100000 + round;
+        request(client, (uint8_t)round, false);
+
+        client->expectedToken = observeToken;
+        change(client, client->index * 100000 + ROUND_COUNT + round);
+    }
+}
+
+static void setupClient(Client *client, uint8_t index)
+{
+    memset(client, 0, sizeof(*client));
+    client->index = index;
+    client->mid = 1;
+    client->lwm2mH = lwm2m_init(NULL);
+
+    initDimmerObject(&client->object, &client->instance, &client->value);
+    client->object.readFunc = readChecked;
+    client->lwm2mH->objectList = &client->object;
+    registerFakeServer(client->lwm2mH, &client->server, &client->serverConn, checkSend);
+}
+
+static void closeClient(Client *client)
+{
+    closeFakeServerContext(client->lwm2mH);
+}
+
+static control_t contextsDrivenConcurrently(){
+    Thread *threads[CONTEXT_COUNT];
+
+    for (uint8_t i = 0; i < CONTEXT_COUNT; ++i)
+        setupClient(&clients[i], i);
+
+    for (uint8_t i = 0; i < CONTEXT_COUNT; ++i)
+    {
+        threads[i] = new Thread(osPriorityNormal, THREAD_STACK_SIZE, nullptr, "contextThread");
+        threads[i]->start(callback(drive, &clients[i]));
+    }
+    for (uint8_t i = 0; i < CONTEXT_COUNT; ++i)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    // Every request answered and every change notified on the connection of its own context
+    for (uint8_t i = 0; i < CONTEXT_COUNT; ++i)
+    {
+        utest_printf("Context %d: %u responses, %u notifications\n", i, (unsigned)clients[i].responses, (unsigned)clients[i].notifications);
+        TEST_ASSERT_EQUAL(0, clients[i].mismatches);
+        TEST_ASSERT_EQUAL(ROUND_COUNT + 1, clients[i].responses);
+        TEST_ASSERT_EQUAL(ROUND_COUNT, clients[i].notifications);
+        closeClient(&clients[i]);
+    }
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Contexts driven concurrently from their own thread", contextsDrivenConcurrently)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
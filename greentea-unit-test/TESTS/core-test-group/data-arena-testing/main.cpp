@@ -0,0 +1,234 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the arena held by each context with LWM2M_DATA_ARENA: the data trees and payloads of a request are
+ *  carved from the arena of the context handling it, also when a context is handled from the callback of another one
+ *
+ *  Allocation checks need the heap statistics, enabled with "platform.heap-stats-enabled": true
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "liblwm2m.h"
+#include "connection.h"
+extern "C"
+{
+#include "er-coap-13.h"
+}
+#include <string.h>
+#include <string>
+
+using namespace utest::v1;
+
+#define OBJECT_ID 3341
+#define TEXT_ID 5527
+#define SERVER_ID 1
+
+struct Client
+{
+    // First member: the object given to the read callback is the client
+    lwm2m_object_t object;
+    lwm2m_list_t instance;
+    lwm2m_server_t server;
+    connection_t serverConn;
+    lwm2m_context_t *lwm2mH;
+    const char *text;
+    // Handled from the read callback when set
+    Client *nested;
+    std::string sent;
+};
+
+static Client outer;
+static Client inner;
+static uint16_t mid = 1;
+
+static void request(Client *client);
+
+static uint8_t readText(lwm2m_context_t *contextP, uint16_t instanceId, int *numDataP, lwm2m_data_t **dataArrayP, lwm2m_object_t *objectP)
+{
+    Client *client = (Client *)objectP;
+
+    if (*numDataP == 0)
+    {
+        *dataArrayP = lwm2m_data_new(1);
+        if (*dataArrayP == NULL)
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        *numDataP = 1;
+        (*dataArrayP)->id = TEXT_ID;
+    }
+    lwm2m_data_encode_string(client->text, *dataArrayP);
+
+    // The blocks of this request stay in use while the other context handles its own
+    if (client->nested != nullptr)
+        request(client->nested);
+    return COAP_205_CONTENT;
+}
+
+static int captureSend(const uint8_t *buffer, size_t length, void *connP)
+{
+    Client *client = &outer.serverConn == connP ? &outer : &inner;
+    coap_packet_t packet[1];
+
+    if (coap_parse_message(packet, (uint8_t *)buffer, length) != NO_ERROR)
+        return -1;
+    client->sent = std::string((char *)packet->payload, packet->payload_len);
+    coap_free_header(packet);
+
+    return (int)length;
+}
+
+static size_t buildRequest(uint8_t *buffer)
+{
+    coap_packet_t request[1];
+    uint8_t token[2] = { 0xA0, 0x01 };
+
+    coap_init_message(request, COAP_TYPE_CON, COAP_GET, mid++);
+    coap_set_header_token(request, token, sizeof(token));
+    coap_set_header_uri_path(request, "/3341/0/5527");
+    coap_set_header_accept(request, LWM2M_CONTENT_TEXT);
+    size_t length = coap_serialize_message(request, buffer);
+    coap_free_header(request);
+
+    return length;
+}
+
+static void handle(Client *client, uint8_t *buffer, size_t length)
+{
+    client->sent.clear();
+    lwm2m_handle_packet(client->lwm2mH, buffer, length, &client->serverConn);
+}
+
+static void request(Client *client)
+{
+    uint8_t buffer[64];
+
+    handle(client, buffer, buildRequest(buffer));
+}
+
+static void setupClient(Client *client, const char *text)
+{
+    client->object = lwm2m_object_t();
+    client->instance = lwm2m_list_t();
+    client->server = lwm2m_server_t();
+    client->serverConn = connection_t();
+    client->text = text;
+    client->nested = nullptr;
+    client->lwm2mH = lwm2m_init(NULL);
+
+    client->object.objID = OBJECT_ID;
+    client->object.readFunc = readText;
+    client->object.instanceList = &client->instance;
+    client->lwm2mH->objectList = &client->object;
+
+    // Registered server reached through the capturing connection
+    client->serverConn.sendFunc = captureSend;
+    client->server.shortID = SERVER_ID;
+    client->server.lifetime = 86400;
+    client->server.registration = lwm2m_gettime();
+    client->server.binding = BINDING_U;
+    client->server.sessionH = &client->serverConn;
+    client->server.status = STATE_REGISTERED;
+    client->lwm2mH->serverList = &client->server;
+    client->lwm2mH->state = STATE_READY;
+}
+
+static void closeClient(Client *client)
+{
+    client->lwm2mH->objectList = NULL;
+    client->lwm2mH->serverList = NULL;
+    lwm2m_close(client->lwm2mH);
+}
+
+static utest::v1::status_t setupContexts(const Case *const source, const size_t index_of_case)
+{
+    setupClient(&outer, "outer");
+    setupClient(&inner, "inner");
+
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+static utest::v1::status_t teardownContexts(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    closeClient(&outer);
+    closeClient(&inner);
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+static control_t readWithoutAllocation(){
+#if defined(LWM2M_DATA_ARENA) && MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t before;
+    mbed_stats_heap_t after;
+    uint8_t buffer[64];
+    size_t length = buildRequest(buffer);
+
+    // The array, the string and the response are carved from the arena
+    mbed_stats_heap_get(&before);
+    handle(&outer, buffer, length);
+    mbed_stats_heap_get(&after);
+    TEST_ASSERT_EQUAL_STRING("outer", outer.sent.c_str());
+    TEST_ASSERT_EQUAL(0, after.alloc_cnt - before.alloc_cnt);
+
+    // Rewound once the request is handled
+    TEST_ASSERT_EQUAL(0, outer.lwm2mH->dataArena.live);
+    TEST_ASSERT_EQUAL(0, outer.lwm2mH->dataArena.used);
+#else
+    TEST_IGNORE_MESSAGE("data arena or heap statistics are disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t nestedContexts(){
+#if defined(LWM2M_DATA_ARENA)
+    size_t before = 0;
+#if MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    before = stats.current_size;
+#endif
+
+    // Each context answers from its own arena, the blocks of the outer one released after the inner one is left
+    outer.nested = &inner;
+    request(&outer);
+    TEST_ASSERT_EQUAL_STRING("outer", outer.sent.c_str());
+    TEST_ASSERT_EQUAL_STRING("inner", inner.sent.c_str());
+    TEST_ASSERT_EQUAL(0, outer.lwm2mH->dataArena.live);
+    TEST_ASSERT_EQUAL(0, inner.lwm2mH->dataArena.live);
+    TEST_ASSERT_NULL(outer.lwm2mH->dataArena.previousP);
+    TEST_ASSERT_NULL(inner.lwm2mH->dataArena.previousP);
+
+#if MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_get(&stats);
+    TEST_ASSERT_EQUAL(before, stats.current_size);
+#endif
+    (void)before;
+#else
+    TEST_IGNORE_MESSAGE("data arena is disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Read answered from the arena without allocation", setupContexts, readWithoutAllocation, teardownContexts),
+    Case("Context handled from the callback of another one", setupContexts, nestedContexts, teardownContexts)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,151 @@
+/**
+ *  @file main.cpp
+ *  @brief Benchmark of the dispatch of a request to its object: time per Read of a resource handled by
+ *  lwm2m_handle_packet(), the objects found by a walk of the object list or by a binary search of the object index
+ *
+ *  The client holds OBJECT_COUNT objects of INSTANCE_COUNT instances each, the Read targets the last instance of the
+ *  last object. The index is built by lwm2m_add_object(), objects chained to the object list by the application are
+ *  found by a walk of the list. The responses sent to the server are captured by the connection of the server.
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "../../common/fake_server.h"
+
+using namespace utest::v1;
+using namespace std::chrono;
+
+#define OBJECT_COUNT 200
+#define INSTANCE_COUNT 32
+#define FIRST_OBJECT_ID 10000
+#define REQUEST_COUNT 10000
+
+#if defined(LWM2M_CLIENT_MODE)
+static lwm2m_context_t *lwm2mH;
+static lwm2m_object_t objects[OBJECT_COUNT];
+static lwm2m_list_t instances[OBJECT_COUNT][INSTANCE_COUNT];
+static int values[INSTANCE_COUNT];
+static lwm2m_server_t server;
+static connection_t serverConn;
+static uint16_t mid = 1;
+
+static void initObjects()
+{
+    for (int i = 0; i < OBJECT_COUNT; ++i)
+    {
+        for (int j = 0; j < INSTANCE_COUNT; ++j)
+        {
+            instances[i][j].id = j;
+            instances[i][j].next = (j + 1 < INSTANCE_COUNT) ? &instances[i][j + 1] : NULL;
+        }
+        initDimmerObject(&objects[i], instances[i], values);
+        objects[i].objID = FIRST_OBJECT_ID + i;
+    }
+}
+
+// Reads the dimmer of the last instance of the last object REQUEST_COUNT times, time per request in microseconds
+static double readLast()
+{
+    char path[32];
+    Timer timer;
+
+    snprintf(path, sizeof(path), "/%d/%d/%d", FIRST_OBJECT_ID + OBJECT_COUNT - 1, INSTANCE_COUNT - 1, DIMMER_ID);
+    values[INSTANCE_COUNT - 1] = 42;
+
+    timer.start();
+    for (int i = 0; i < REQUEST_COUNT; ++i)
+    {
+        coap_packet_t request[1];
+
+        coap_init_message(request, COAP_TYPE_CON, COAP_GET, mid++);
+        coap_set_header_uri_path(request, path);
+        coap_set_header_accept(request, LWM2M_CONTENT_TEXT);
+        sentCount = 0;
+        handleFromServer(lwm2mH, &serverConn, request);
+    }
+    timer.stop();
+
+    TEST_ASSERT_EQUAL(1, sentCount);
+    TEST_ASSERT_EQUAL(COAP_205_CONTENT, sent[0].code);
+    TEST_ASSERT_EQUAL(42, sent[0].value);
+
+    return duration_cast<nanoseconds>(timer.elapsed_time()).count() / 1000.0 / REQUEST_COUNT;
+}
+
+static utest::v1::status_t setupContext(const Case *const source, const size_t index_of_case)
+{
+    lwm2mH = lwm2m_init(NULL);
+    initObjects();
+
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+static utest::v1::status_t teardownContext(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    closeFakeServerContext(lwm2mH);
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+#endif
+
+static control_t dispatchThroughList(){
+#if defined(LWM2M_CLIENT_MODE)
+    // Chained by the application, no index built
+    for (int i = 0; i + 1 < OBJECT_COUNT; ++i)
+        objects[i].next = &objects[i + 1];
+    lwm2mH->objectList = &objects[0];
+    registerFakeServer(lwm2mH, &server, &serverConn);
+
+    utest_printf("Object list: %.2f us per request\n", readLast());
+#else
+    TEST_IGNORE_MESSAGE("The client mode is disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t dispatchThroughIndex(){
+#if defined(LWM2M_CLIENT_MODE)
+    // Added before the registration, no update sent
+    for (int i = 0; i < OBJECT_COUNT; ++i)
+        TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_add_object(lwm2mH, &objects[i]));
+    registerFakeServer(lwm2mH, &server, &serverConn);
+
+    utest_printf("Object index: %.2f us per request\n", readLast());
+#else
+    TEST_IGNORE_MESSAGE("The client mode is disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+#if defined(LWM2M_CLIENT_MODE)
+Case cases[] = {
+    Case("Dispatch through the object list", setupContext, dispatchThroughList, teardownContext),
+    Case("Dispatch through the object index", setupContext, dispatchThroughIndex, teardownContext)
+};
+#else
+Case cases[] = {
+    Case("Dispatch through the object list", dispatchThroughList),
+    Case("Dispatch through the object index", dispatchThroughIndex)
+};
+#endif
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
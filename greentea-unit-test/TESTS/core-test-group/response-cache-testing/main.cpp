@@ -0,0 +1,184 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the response cache: a repeated Read presenting the ETag of the last response is answered with 2.03
+ *  Valid without reading the object again, until a change of the object is reported
+ *
+ *  The cache is enabled with LWM2M_RESPONSE_CACHE. The requests are handled by the core, the responses sent to the
+ *  server are captured by the connection of the server.
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "../../common/fake_server.h"
+
+using namespace utest::v1;
+
+#define SEED 0x5EED0000
+
+#if defined(LWM2M_RESPONSE_CACHE)
+static lwm2m_context_t *lwm2mH;
+static lwm2m_object_t object;
+static lwm2m_list_t *instanceList;
+static int value;
+static int readCount;
+static lwm2m_server_t server;
+static connection_t serverConn;
+static uint16_t mid = 1;
+
+static uint8_t readCounted(lwm2m_context_t *contextP, uint16_t instanceId, int *numDataP, lwm2m_data_t **dataArrayP, lwm2m_object_t *objectP)
+{
+    readCount++;
+    return readDimmer(contextP, instanceId, numDataP, dataArrayP, objectP);
+}
+
+// Last response sent to the server
+static const Sent &response()
+{
+    TEST_ASSERT_TRUE(sentCount > 0);
+    return sent[sentCount - 1];
+}
+
+// Reads the resource, presenting the ETag of the last response when etag is set
+static void getResource(bool etag)
+{
+    coap_packet_t request[1];
+    size_t count = sentCount;
+
+    coap_init_message(request, COAP_TYPE_CON, COAP_GET, mid++);
+    coap_set_header_uri_path(request, "/3311/0/5851");
+    if (etag)
+        coap_set_header_etag(request, response().etag, response().etagLen);
+    handleFromServer(lwm2mH, &serverConn, request);
+    TEST_ASSERT_EQUAL(count + 1, sentCount);
+}
+
+static void change(int newValue)
+{
+    value = newValue;
+    dimmerChanged(lwm2mH, 0);
+}
+
+static uint32_t lastEtag()
+{
+    const uint8_t *etag = response().etag;
+
+    return (uint32_t)etag[0] << 24 | etag[1] << 16 | etag[2] << 8 | etag[3];
+}
+
+static utest::v1::status_t setupContext(const Case *const source, const size_t index_of_case)
+{
+    lwm2mH = lwm2m_init(NULL);
+
+    instanceList = (lwm2m_list_t *)lwm2m_malloc(sizeof(lwm2m_list_t));
+    memset(instanceList, 0, sizeof(lwm2m_list_t));
+    initDimmerObject(&object, instanceList, &value);
+    object.readFunc = readCounted;
+    object.cacheable = true;
+    lwm2mH->objectList = &object;
+    value = 0;
+    readCount = 0;
+    registerFakeServer(lwm2mH, &server, &serverConn);
+
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+static utest::v1::status_t teardownContext(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    LWM2M_LIST_FREE(object.instanceList);
+    closeFakeServerContext(lwm2mH);
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+#endif
+
+static control_t validOnRepeatedRead(){
+#if defined(LWM2M_RESPONSE_CACHE)
+    lwm2m_set_cache_seed(lwm2mH, SEED);
+
+    getResource(false);
+    TEST_ASSERT_EQUAL(COAP_205_CONTENT, response().code);
+    TEST_ASSERT_EQUAL(4, response().etagLen);
+    TEST_ASSERT_EQUAL_HEX32(SEED + 1, lastEtag());
+    TEST_ASSERT_EQUAL(1, readCount);
+
+    // Same ETag presented: nothing read nor sent again
+    getResource(true);
+    TEST_ASSERT_EQUAL(COAP_203_VALID, response().code);
+    TEST_ASSERT_EQUAL(4, response().etagLen);
+    TEST_ASSERT_EQUAL_HEX32(SEED + 1, lastEtag());
+    TEST_ASSERT_EQUAL(0, response().payload.size());
+    TEST_ASSERT_EQUAL(1, readCount);
+#else
+    TEST_IGNORE_MESSAGE("The response cache is disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t readAgainOnChange(){
+#if defined(LWM2M_RESPONSE_CACHE)
+    lwm2m_set_cache_seed(lwm2mH, SEED);
+    getResource(false);
+    uint32_t etag = lastEtag();
+
+    // The reported change drops the cached response, the old ETag gets the new value
+    change(1);
+    getResource(true);
+    TEST_ASSERT_EQUAL(COAP_205_CONTENT, response().code);
+    TEST_ASSERT_TRUE(response().payload.size() > 0);
+    TEST_ASSERT_TRUE(lastEtag() != etag);
+    TEST_ASSERT_EQUAL(2, readCount);
+#else
+    TEST_IGNORE_MESSAGE("The response cache is disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t notCachedWithoutSeed(){
+#if defined(LWM2M_RESPONSE_CACHE)
+    getResource(false);
+    TEST_ASSERT_EQUAL(COAP_205_CONTENT, response().code);
+    TEST_ASSERT_EQUAL(0, response().etagLen);
+
+    getResource(false);
+    TEST_ASSERT_EQUAL(COAP_205_CONTENT, response().code);
+    TEST_ASSERT_EQUAL(2, readCount);
+#else
+    TEST_IGNORE_MESSAGE("The response cache is disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (20s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(20, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+#if defined(LWM2M_RESPONSE_CACHE)
+Case cases[] = {
+    Case("Repeated Read answered with 2.03 Valid", setupContext, validOnRepeatedRead, teardownContext),
+    Case("Read again once a change is reported", setupContext, readAgainOnChange, teardownContext),
+    Case("Nothing cached before the seed is set", setupContext, notCachedWithoutSeed, teardownContext)
+};
+#else
+Case cases[] = {
+    Case("Repeated Read answered with 2.03 Valid", validOnRepeatedRead),
+    Case("Read again once a change is reported", readAgainOnChange),
+    Case("Nothing cached before the seed is set", notCachedWithoutSeed)
+};
+#endif
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,276 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the Observe-Composite operation: the Minimum and Maximum Periods written on its paths apply to its
+ *  notifications, and the observation is cleared with the instances it observes
+ *
+ *  Composite operations need LwM2M 1.1 and LWM2M_SUPPORT_SENML_JSON, the cases are ignored otherwise: run with
+ *  greentea-unit-test/configs/lwm2m_1_1.json, which also defines LWM2M_QUEUE_MODE. The requests are handled by the
+ *  core, the datagrams sent to the server are captured by the connection of the server. With LWM2M_QUEUE_MODE, the
+ *  queue mode scheduler is checked to wake up for the composite observation.
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "../../common/fake_server.h"
+
+using namespace utest::v1;
+using namespace std::chrono;
+
+// Periods in seconds, long enough for the clock of the core not to tick between two steps
+#define PERIOD 2
+
+#if defined(LWM2M_SUPPORT_COMPOSITE)
+static lwm2m_context_t *lwm2mH;
+static lwm2m_object_t object;
+static int value;
+static lwm2m_server_t server;
+static connection_t serverConn;
+static uint16_t mid = 1;
+static const uint8_t compositeToken[] = { 0xC0, 0x05 };
+
+static uint8_t deleteInstance(lwm2m_context_t *contextP, uint16_t instanceId, lwm2m_object_t *objectP)
+{
+    lwm2m_list_t *instanceP;
+
+    objectP->instanceList = lwm2m_list_remove(objectP->instanceList, instanceId, &instanceP);
+    if (instanceP == NULL)
+        return COAP_404_NOT_FOUND;
+    lwm2m_free(instanceP);
+    return COAP_202_DELETED;
+}
+
+// Notifications of the composite observation among the datagrams sent, the first one in firstP
+static size_t notified(const Sent **firstP = nullptr)
+{
+    size_t count = 0;
+
+    for (size_t n = 0; n < sentCount; ++n)
+    {
+        if (sent[n].type != COAP_TYPE_NON || sent[n].tokenLen != sizeof(compositeToken)
+         || memcmp(sent[n].token, compositeToken, sizeof(compositeToken)) != 0)
+            continue;
+        if (count++ == 0 && firstP != nullptr)
+            *firstP = &sent[n];
+    }
+    return count;
+}
+
+static void handle(coap_packet_t *packet)
+{
+    handleFromServer(lwm2mH, &serverConn, packet);
+}
+
+static void writePeriod(const char *attribute)
+{
+    coap_packet_t request[1];
+
+    coap_init_message(request, COAP_TYPE_CON, COAP_PUT, mid++);
+    coap_set_header_uri_path(request, "/3311/0/5851");
+    coap_set_header_uri_query(request, attribute);
+    handle(request);
+}
+
+static void observeComposite()
+{
+    coap_packet_t request[1];
+    const char paths[] = "[{\"n\":\"/3311/0/5851\"}]";
+
+    coap_init_message(request, COAP_TYPE_CON, COAP_FETCH, mid++);
+    coap_set_header_token(request, compositeToken, sizeof(compositeToken));
+    coap_set_header_content_type(request, LWM2M_CONTENT_SENML_JSON);
+    coap_set_header_accept(request, LWM2M_CONTENT_SENML_JSON);
+    coap_set_header_observe(request, 0);
+    coap_set_payload(request, paths, sizeof(paths) - 1);
+    handle(request);
+}
+
+static time_t step()
+{
+    time_t timeout = 60;
+
+    lwm2m_step(lwm2mH, &timeout);
+    return timeout;
+}
+
+static void change(int newValue)
+{
+    value = newValue;
+    dimmerChanged(lwm2mH, 0);
+}
+
+static utest::v1::status_t setupContext(const Case *const source, const size_t index_of_case)
+{
+    lwm2mH = lwm2m_init(NULL);
+
+    lwm2m_list_t *instanceP = (lwm2m_list_t *)lwm2m_malloc(sizeof(lwm2m_list_t));
+    memset(instanceP, 0, sizeof(lwm2m_list_t));
+    initDimmerObject(&object, instanceP, &value);
+    object.deleteFunc = deleteInstance;
+    lwm2mH->objectList = &object;
+    value = 0;
+    registerFakeServer(lwm2mH, &server, &serverConn);
+
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+static utest::v1::status_t teardownContext(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    LWM2M_LIST_FREE(object.instanceList);
+    closeFakeServerContext(lwm2mH);
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+#endif
+
+static control_t heldForMinimumPeriod(){
+#if defined(LWM2M_SUPPORT_COMPOSITE)
+    writePeriod("pmin=2");
+    observeComposite();
+    TEST_ASSERT_NOT_NULL(lwm2mH->compositeObservedList);
+
+    // The change waits for the Minimum Period of the path
+    change(1);
+    TEST_ASSERT_TRUE(step() <= PERIOD);
+    TEST_ASSERT_EQUAL(0, notified());
+
+    ThisThread::sleep_for(milliseconds(PERIOD * 1000 + 100));
+    step();
+    const Sent *notification;
+    TEST_ASSERT_EQUAL(1, notified(&notification));
+    TEST_ASSERT_EQUAL(COAP_205_CONTENT, notification->code);
+#else
+    TEST_IGNORE_MESSAGE("Composite operations are disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t notifiedOnMaximumPeriod(){
+#if defined(LWM2M_SUPPORT_COMPOSITE)
+    writePeriod("pmax=2");
+    observeComposite();
+
+    // Nothing changed, the step wakes up for the Maximum Period
+    TEST_ASSERT_TRUE(step() <= PERIOD);
+    TEST_ASSERT_EQUAL(0, notified());
+
+    ThisThread::sleep_for(milliseconds(PERIOD * 1000 + 100));
+    step();
+    TEST_ASSERT_EQUAL(1, notified());
+#else
+    TEST_IGNORE_MESSAGE("Composite operations are disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t clearedWithInstance(){
+#if defined(LWM2M_SUPPORT_COMPOSITE)
+    coap_packet_t request[1];
+
+    observeComposite();
+    TEST_ASSERT_NOT_NULL(lwm2mH->compositeObservedList);
+
+    // The observed instance is deleted by the server
+    coap_init_message(request, COAP_TYPE_CON, COAP_DELETE, mid++);
+    coap_set_header_uri_path(request, "/3311/0");
+    handle(request);
+    TEST_ASSERT_NULL(object.instanceList);
+    TEST_ASSERT_NULL(lwm2mH->compositeObservedList);
+
+    // The registration update asked for by the deletion is not sent to the capturing connection
+    server.status = STATE_REGISTERED;
+    change(1);
+    step();
+    TEST_ASSERT_EQUAL(0, notified());
+#else
+    TEST_IGNORE_MESSAGE("Composite operations are disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t wokenForMaximumPeriod(){
+#if defined(LWM2M_SUPPORT_COMPOSITE) && defined(LWM2M_QUEUE_MODE)
+    time_t nextWakeup;
+
+    server.binding = BINDING_UQ;
+    writePeriod("pmax=3");
+    observeComposite();
+    TEST_ASSERT_EQUAL(0, lwm2m_set_queue_mode(lwm2mH, 1));
+
+    // The client goes to sleep after the awake time, until the Maximum Period of the composite observation
+    ThisThread::sleep_for(milliseconds(1100));
+    step();
+    TEST_ASSERT_TRUE(lwm2m_queue_is_sleeping(lwm2mH, &nextWakeup));
+    TEST_ASSERT_TRUE(nextWakeup <= lwm2mH->compositeObservedList->watcher.lastTime + 3);
+    TEST_ASSERT_EQUAL(0, notified());
+
+    ThisThread::sleep_for(milliseconds((nextWakeup - lwm2m_gettime()) * 1000 + 100));
+    step();
+    TEST_ASSERT_FALSE(lwm2m_queue_is_sleeping(lwm2mH, NULL));
+    TEST_ASSERT_EQUAL(1, notified());
+#else
+    TEST_IGNORE_MESSAGE("Composite operations or queue mode are disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t awakeForDueChange(){
+#if defined(LWM2M_SUPPORT_COMPOSITE) && defined(LWM2M_QUEUE_MODE)
+    server.binding = BINDING_UQ;
+    observeComposite();
+    TEST_ASSERT_EQUAL(0, lwm2m_set_queue_mode(lwm2mH, 1));
+
+    // The change is notified before the client goes to sleep
+    ThisThread::sleep_for(milliseconds(1100));
+    change(1);
+    step();
+    TEST_ASSERT_FALSE(lwm2m_queue_is_sleeping(lwm2mH, NULL));
+    TEST_ASSERT_EQUAL(1, notified());
+
+    // The notification keeps the client awake for another awake time
+    ThisThread::sleep_for(milliseconds(1100));
+    step();
+    TEST_ASSERT_TRUE(lwm2m_queue_is_sleeping(lwm2mH, NULL));
+#else
+    TEST_IGNORE_MESSAGE("Composite operations or queue mode are disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+#if defined(LWM2M_SUPPORT_COMPOSITE)
+Case cases[] = {
+    Case("Change held for the Minimum Period", setupContext, heldForMinimumPeriod, teardownContext),
+    Case("Notified on the Maximum Period", setupContext, notifiedOnMaximumPeriod, teardownContext),
+    Case("Observation cleared with the instance", setupContext, clearedWithInstance, teardownContext),
+    Case("Sleeping client woken for the Maximum Period", setupContext, wokenForMaximumPeriod, teardownContext),
+    Case("Client kept awake for a due change", setupContext, awakeForDueChange, teardownContext)
+};
+#else
+Case cases[] = {
+    Case("Change held for the Minimum Period", heldForMinimumPeriod),
+    Case("Notified on the Maximum Period", notifiedOnMaximumPeriod),
+    Case("Observation cleared with the instance", clearedWithInstance),
+    Case("Sleeping client woken for the Maximum Period", wokenForMaximumPeriod),
+    Case("Client kept awake for a due change", awakeForDueChange)
+};
+#endif
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,150 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the notifications sent as confirmable with lwm2m_set_notify_confirmable(): same token, Observe
+ *  number, content format and payload as the non-confirmable ones, and the watcher removed when the server resets it
+ *
+ *  The observation is made by a GET request handled by the core, the datagrams sent to the server are captured by
+ *  the connection of the server.
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "../../common/fake_server.h"
+
+using namespace utest::v1;
+
+#define CON_COUNT 3
+
+static lwm2m_context_t *lwm2mH;
+static lwm2m_object_t object;
+static lwm2m_list_t instance;
+static int value;
+static lwm2m_server_t server;
+static connection_t serverConn;
+static uint16_t mid = 1;
+static const uint8_t observeToken[] = { 0xC0, 0x01, 0x02 };
+
+static void handle(coap_packet_t *packet)
+{
+    handleFromServer(lwm2mH, &serverConn, packet);
+}
+
+static void observe()
+{
+    coap_packet_t request[1];
+
+    coap_init_message(request, COAP_TYPE_CON, COAP_GET, mid++);
+    coap_set_header_token(request, observeToken, sizeof(observeToken));
+    coap_set_header_uri_path(request, "/3311/0/5851");
+    coap_set_header_accept(request, LWM2M_CONTENT_TEXT);
+    coap_set_header_observe(request, 0);
+    handle(request);
+}
+
+static void answer(coap_message_type_t type, uint16_t messageId)
+{
+    coap_packet_t reply[1];
+
+    coap_init_message(reply, type, 0, messageId);
+    handle(reply);
+}
+
+static void change(int newValue)
+{
+    time_t timeout = 60;
+
+    value = newValue;
+    dimmerChanged(lwm2mH, 0);
+    lwm2m_step(lwm2mH, &timeout);
+}
+
+static utest::v1::status_t setupContext(const Case *const source, const size_t index_of_case)
+{
+    lwm2mH = lwm2m_init(NULL);
+
+    memset(&instance, 0, sizeof(instance));
+    initDimmerObject(&object, &instance, &value);
+    lwm2mH->objectList = &object;
+    value = 0;
+    registerFakeServer(lwm2mH, &server, &serverConn);
+
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_set_notify_confirmable(lwm2mH, CON_COUNT, 0));
+    observe();
+    TEST_ASSERT_EQUAL(1, sentCount);
+    TEST_ASSERT_EQUAL(COAP_TYPE_ACK, sent[0].type);
+
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+static utest::v1::status_t teardownContext(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    closeFakeServerContext(lwm2mH);
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+static control_t confirmableLikeTheOthers(){
+    for (int i = 1; i <= CON_COUNT; ++i)
+        change(i * 10);
+    TEST_ASSERT_EQUAL(1 + CON_COUNT, sentCount);
+
+    // Only the last one is confirmable, every one is a notification of the same observation
+    for (size_t n = 1; n < sentCount; ++n)
+    {
+        TEST_ASSERT_EQUAL(n == CON_COUNT ? COAP_TYPE_CON : COAP_TYPE_NON, sent[n].type);
+        TEST_ASSERT_EQUAL(sizeof(observeToken), sent[n].tokenLen);
+        TEST_ASSERT_EQUAL(0, memcmp(observeToken, sent[n].token, sizeof(observeToken)));
+        TEST_ASSERT_TRUE(sent[n].observe > sent[n - 1].observe);
+        TEST_ASSERT_EQUAL(LWM2M_CONTENT_TEXT, sent[n].format);
+        TEST_ASSERT_EQUAL(n * 10, sent[n].value);
+    }
+
+    // Acknowledged: the observation goes on
+    answer(COAP_TYPE_ACK, sent[CON_COUNT].mid);
+    change(100);
+    TEST_ASSERT_EQUAL(2 + CON_COUNT, sentCount);
+    TEST_ASSERT_EQUAL(COAP_TYPE_NON, sent[CON_COUNT + 1].type);
+    TEST_ASSERT_EQUAL(100, sent[CON_COUNT + 1].value);
+
+    return CaseNext;
+}
+
+static control_t resetRemovesWatcher(){
+    for (int i = 1; i <= CON_COUNT; ++i)
+        change(i);
+    TEST_ASSERT_EQUAL(COAP_TYPE_CON, sent[CON_COUNT].type);
+
+    // The server forgot the observation
+    answer(COAP_TYPE_RST, sent[CON_COUNT].mid);
+    change(100);
+    TEST_ASSERT_EQUAL(1 + CON_COUNT, sentCount);
+    TEST_ASSERT_NULL(lwm2mH->observedList);
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Confirmable notification like the others", setupContext, confirmableLikeTheOthers, teardownContext),
+    Case("Watcher removed when the notification is reset", setupContext, resetRemovesWatcher, teardownContext)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
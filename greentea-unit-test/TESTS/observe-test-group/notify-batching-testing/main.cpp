@@ -0,0 +1,289 @@
+/**
+ *  @file main.cpp
+ *  @brief Benchmark of the notifications held by LWM2M_NOTIFY_BATCHING: datagrams and bytes sent to the server and
+ *  delay of the notifications, with and without a window. The notifications due within a window are sent as one
+ *  SenML JSON pack with the Send operation, split at the maximum size of the pack.
+ *
+ *  The observations are made by GET requests handled by the core, the datagrams sent to the server are captured by
+ *  the connection of the server.
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#define INSTANCE_COUNT 4
+// Changes of each value between two notifications of the batch
+#define CHANGE_COUNT 5
+#define BATCH_WINDOW 1
+#define MAX_SENT (INSTANCE_COUNT * CHANGE_COUNT)
+
+#include "../../common/fake_server.h"
+
+using namespace utest::v1;
+using namespace std::chrono;
+
+static lwm2m_context_t *lwm2mH;
+static lwm2m_object_t object;
+static lwm2m_list_t instances[INSTANCE_COUNT];
+static int values[INSTANCE_COUNT];
+static lwm2m_server_t server;
+static connection_t serverConn;
+// Delay of each datagram recorded in sent[]
+static milliseconds delays[MAX_SENT];
+static Timer timer;
+static uint16_t mid = 1;
+static uint32_t lastObserve[INSTANCE_COUNT];
+
+static int captureTimed(const uint8_t *buffer, size_t length, void *connP)
+{
+    int res = captureSend(buffer, length, connP);
+
+    if (res > 0)
+        delays[sentCount - 1] = duration_cast<milliseconds>(timer.elapsed_time());
+    return res;
+}
+
+static void observe(uint16_t instanceId)
+{
+    coap_packet_t request[1];
+    uint8_t token[2] = { 0xB0, (uint8_t)instanceId };
+    char path[24];
+
+    snprintf(path, sizeof(path), "/%d/%d/%d", OBJECT_ID, instanceId, DIMMER_ID);
+    coap_init_message(request, COAP_TYPE_CON, COAP_GET, mid++);
+    coap_set_header_token(request, token, sizeof(token));
+    coap_set_header_uri_path(request, path);
+    coap_set_header_accept(request, LWM2M_CONTENT_TEXT);
+    coap_set_header_observe(request, 0);
+    handleFromServer(lwm2mH, &serverConn, request);
+}
+
+// Acknowledges a Send, which is a confirmable request
+static void acknowledge(const Sent &record)
+{
+    coap_packet_t response[1];
+
+    coap_init_message(response, COAP_TYPE_ACK, COAP_204_CHANGED, record.mid);
+    coap_set_header_token(response, record.token, record.tokenLen);
+    handleFromServer(lwm2mH, &serverConn, response);
+}
+
+static void change(uint16_t instanceId, int value)
+{
+    values[instanceId] = value;
+    dimmerChanged(lwm2mH, instanceId);
+}
+
+static void step()
+{
+    time_t timeout = 60;
+
+    lwm2m_step(lwm2mH, &timeout);
+}
+
+static void resetCapture()
+{
+    sentCount = 0;
+    sentBytes = 0;
+    timer.stop();
+    timer.reset();
+    timer.start();
+}
+
+static utest::v1::status_t setupContext(const Case *const source, const size_t index_of_case)
+{
+    lwm2mH = lwm2m_init(NULL);
+
+    memset(instances, 0, sizeof(instances));
+    initDimmerObject(&object, NULL, values);
+    for (int i = INSTANCE_COUNT - 1; i >= 0; --i)
+    {
+        instances[i].id = i;
+        object.instanceList = LWM2M_LIST_ADD(object.instanceList, &instances[i]);
+        values[i] = 0;
+    }
+    lwm2mH->objectList = &object;
+    registerFakeServer(lwm2mH, &server, &serverConn, captureTimed);
+
+    resetCapture();
+    for (uint16_t i = 0; i < INSTANCE_COUNT; ++i)
+        observe(i);
+    TEST_ASSERT_EQUAL(INSTANCE_COUNT, sentCount);
+    for (uint16_t i = 0; i < INSTANCE_COUNT; ++i)
+        lastObserve[sent[i].token[1]] = sent[i].observe;
+
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+static utest::v1::status_t teardownContext(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    closeFakeServerContext(lwm2mH);
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+// Checks the token and the Observe number of a notification, returns the instance observed
+static uint16_t checkObservation(const Sent &record)
+{
+    TEST_ASSERT_EQUAL(2, record.tokenLen);
+    TEST_ASSERT_EQUAL_HEX8(0xB0, record.token[0]);
+    TEST_ASSERT_TRUE(record.token[1] < INSTANCE_COUNT);
+
+    // The Observe number of each observation grows on its own
+    uint16_t instanceId = record.token[1];
+    TEST_ASSERT_TRUE(record.observe > lastObserve[instanceId]);
+    lastObserve[instanceId] = record.observe;
+
+    return instanceId;
+}
+
+// Checks a Send of the batch, returns the number of records it carries
+static int checkBatch(const Sent &record, int value)
+{
+    char name[32];
+    char entry[64];
+    int count = 0;
+
+    TEST_ASSERT_EQUAL(COAP_TYPE_CON, record.type);
+    TEST_ASSERT_EQUAL(COAP_POST, record.code);
+    TEST_ASSERT_EQUAL_STRING("/dp", record.path.c_str());
+    TEST_ASSERT_EQUAL(LWM2M_CONTENT_SENML_JSON, record.format);
+
+    // Each record names its path and carries the latest value of the resource
+    for (uint16_t i = 0; i < INSTANCE_COUNT; ++i)
+    {
+        snprintf(name, sizeof(name), "\"/%d/%d/%d\"", OBJECT_ID, i, DIMMER_ID);
+        size_t found = record.payload.find(name);
+        if (found == std::string::npos)
+            continue;
+        snprintf(entry, sizeof(entry), "\"v\":%d", value);
+        TEST_ASSERT_TRUE(record.payload.find(entry, found) != std::string::npos);
+        count++;
+    }
+    return count;
+}
+
+static control_t notifiedAtOnce(){
+#if defined(LWM2M_NOTIFY_BATCHING)
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_set_notify_batching(lwm2mH, 0, 0));
+#endif
+
+    // Every change is a notification sent on the step following it
+    resetCapture();
+    for (int value = 1; value <= CHANGE_COUNT; ++value)
+    {
+        for (uint16_t i = 0; i < INSTANCE_COUNT; ++i)
+            change(i, value);
+        step();
+    }
+
+    TEST_ASSERT_EQUAL(INSTANCE_COUNT * CHANGE_COUNT, sentCount);
+    for (size_t n = 0; n < sentCount; ++n)
+    {
+        checkObservation(sent[n]);
+        TEST_ASSERT_EQUAL(n / INSTANCE_COUNT + 1, sent[n].value);
+    }
+    utest_printf("Without window: %u datagrams, %u bytes, last notification after %d ms\n", (unsigned)sentCount, (unsigned)sentBytes, (int)delays[sentCount - 1].count());
+
+    return CaseNext;
+}
+
+static control_t sentOncePerWindow(){
+#if defined(LWM2M_NOTIFY_BATCHING)
+    TEST_ASSERT_EQUAL(COAP_400_BAD_REQUEST, lwm2m_set_notify_batching(lwm2mH, -1, 0));
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_set_notify_batching(lwm2mH, BATCH_WINDOW, 0));
+
+    for (int round = 0; round < 2; ++round)
+    {
+        // Held while the window is open, whatever the number of changes
+        resetCapture();
+        for (int value = 1; value <= CHANGE_COUNT; ++value)
+        {
+            for (uint16_t i = 0; i < INSTANCE_COUNT; ++i)
+                change(i, round * CHANGE_COUNT + value);
+            step();
+        }
+        TEST_ASSERT_EQUAL(0, sentCount);
+
+        // Exactly one datagram carrying the latest value of every observation
+        ThisThread::sleep_for(milliseconds(BATCH_WINDOW * 1000 + 100));
+        step();
+        TEST_ASSERT_EQUAL(1, sentCount);
+        TEST_ASSERT_EQUAL(INSTANCE_COUNT, checkBatch(sent[0], (round + 1) * CHANGE_COUNT));
+        acknowledge(sent[0]);
+        step();
+        TEST_ASSERT_EQUAL(1, sentCount);
+    }
+    utest_printf("Window of %d s: %u datagrams, %u bytes, notifications after %d ms\n", BATCH_WINDOW, (unsigned)sentCount, (unsigned)sentBytes, (int)delays[sentCount - 1].count());
+#else
+    TEST_IGNORE_MESSAGE("Notification batching is disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t splitAtMaxSize(){
+#if defined(LWM2M_NOTIFY_BATCHING)
+    size_t itemSize;
+
+    // Size of the pack of one observation, all of them have the same length
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_set_notify_batching(lwm2mH, BATCH_WINDOW, 1));
+    resetCapture();
+    for (uint16_t i = 0; i < INSTANCE_COUNT; ++i)
+        change(i, 1);
+    step();
+    ThisThread::sleep_for(milliseconds(BATCH_WINDOW * 1000 + 100));
+    step();
+    TEST_ASSERT_EQUAL(INSTANCE_COUNT, sentCount);
+    itemSize = sent[0].payload.size();
+    for (size_t n = 0; n < sentCount; ++n)
+    {
+        TEST_ASSERT_EQUAL(1, checkBatch(sent[n], 1));
+        acknowledge(sent[n]);
+    }
+
+    // Two observations fit in a pack, a third one starts the next pack
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_set_notify_batching(lwm2mH, BATCH_WINDOW, 2 * itemSize));
+    resetCapture();
+    for (uint16_t i = 0; i < INSTANCE_COUNT; ++i)
+        change(i, 2);
+    step();
+    ThisThread::sleep_for(milliseconds(BATCH_WINDOW * 1000 + 100));
+    step();
+    TEST_ASSERT_EQUAL(INSTANCE_COUNT / 2, sentCount);
+    for (size_t n = 0; n < sentCount; ++n)
+    {
+        TEST_ASSERT_TRUE(sent[n].payload.size() <= 2 * itemSize);
+        TEST_ASSERT_EQUAL(2, checkBatch(sent[n], 2));
+        acknowledge(sent[n]);
+    }
+#else
+    TEST_IGNORE_MESSAGE("Notification batching is disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Every change notified without a window", setupContext, notifiedAtOnce, teardownContext),
+    Case("One datagram per window", setupContext, sentOncePerWindow, teardownContext),
+    Case("Packs split at their maximum size", setupContext, splitAtMaxSize, teardownContext)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
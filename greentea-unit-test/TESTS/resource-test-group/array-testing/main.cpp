@@ -0,0 +1,202 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the multiple instances resources stored in a ResourceArray, and of their encoding by an object
+ *
+ *  Allocation checks need the heap statistics, enabled with "platform.heap-stats-enabled": true
+ *
+ *  @date 10/18/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "node_object.h"
+#include <string>
+
+using namespace utest::v1;
+using namespace std;
+
+#define OBJECT_ID 3412
+#define ADDRESSES_RESOURCE_ID 2
+#define SOURCES_RESOURCE_ID 6
+#define INSTANCE_COUNT 64
+
+static const ResourceDescriptor addressesDescriptor = { ADDRESSES_RESOURCE_ID, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, true, "IPv4 Address" };
+
+static NodeObject *newObject()
+{
+    vector<Resource *> resources;
+
+    resources.push_back(new Resource(addressesDescriptor));
+    resources.push_back(new Resource(ResourceArray<int>({ 1, 5 }), ResourceOp::RES_RD, "Available Power Sources", Units::NA, SOURCES_RESOURCE_ID));
+
+    return new NodeObject(OBJECT_ID, 0, resources);
+}
+
+static void deleteObject(NodeObject *object, lwm2m_object_t *objectP)
+{
+    lwm2m_free(objectP->instanceList);
+    lwm2m_free(objectP);
+    delete object;
+}
+
+static control_t instancesSortedById(){
+    ResourceArray<string> instances;
+
+    instances.Set(4, "10.10.10.54");
+    instances.Set(1, "192.168.0.1");
+    instances.Set(9, "178.129.0.3");
+    instances.Set(4, "10.10.10.55");
+
+    TEST_ASSERT_EQUAL(3, instances.Size());
+    TEST_ASSERT_EQUAL(1, instances[0].id);
+    TEST_ASSERT_EQUAL(4, instances[1].id);
+    TEST_ASSERT_EQUAL(9, instances[2].id);
+    TEST_ASSERT_EQUAL_STRING("10.10.10.55", (*instances.Find(4)).c_str());
+    TEST_ASSERT_TRUE(instances.Find(5) == nullptr);
+
+    TEST_ASSERT_TRUE(instances.Remove(4));
+    TEST_ASSERT_FALSE(instances.Remove(4));
+    TEST_ASSERT_EQUAL(2, instances.Size());
+
+    // Initializer list instances get the IDs 0 to n - 1
+    ResourceArray<bool> flags({ true, false });
+    TEST_ASSERT_EQUAL(1, flags[1].id);
+    TEST_ASSERT_FALSE(*flags.Find(1));
+
+    return CaseNext;
+}
+
+static control_t resourceHoldsArray(){
+    Resource fromDescriptor(addressesDescriptor);
+    Resource legacy(ResourceArray<float>({ 0.5f }), ResourceOp::RES_RD);
+
+    // The value type follows the descriptor type, the descriptor of a legacy resource follows the value type
+    TEST_ASSERT_TRUE(fromDescriptor.Type() == typeid(ResourceArray<string>));
+    TEST_ASSERT_TRUE((*fromDescriptor.GetValue<ResourceArray<string>>()).Empty());
+    TEST_ASSERT_TRUE((*legacy.GetDescriptor()).multiple);
+    TEST_ASSERT_EQUAL((int)ResourceType::FLOAT, (int)(*legacy.GetDescriptor()).type);
+
+    return CaseNext;
+}
+
+static control_t readEncodesInstances(){
+    NodeObject *object = newObject();
+    lwm2m_object_t *objectP = object->Get();
+    lwm2m_data_t *dataP = lwm2m_data_new(1);
+    int numData = 1;
+    size_t reads = 0;
+
+    (*object->GetResource(SOURCES_RESOURCE_ID)).BindOnRead<ResourceArray<int>>([&reads](const ResourceArray<int> &instances){ reads++; });
+
+    dataP->id = SOURCES_RESOURCE_ID;
+    TEST_ASSERT_EQUAL(COAP_205_CONTENT, objectP->readFunc(nullptr, 0, &numData, &dataP, objectP));
+    TEST_ASSERT_EQUAL(LWM2M_TYPE_MULTIPLE_RESOURCE, dataP->type);
+    TEST_ASSERT_EQUAL(2, dataP->value.asChildren.count);
+    TEST_ASSERT_EQUAL(1, dataP->value.asChildren.array[1].id);
+    TEST_ASSERT_EQUAL(5, dataP->value.asChildren.array[1].value.asInteger);
+    TEST_ASSERT_EQUAL(1, reads);
+    lwm2m_data_free(numData, dataP);
+
+    deleteObject(object, objectP);
+    return CaseNext;
+}
+
+static control_t writeReplacesOrUpdates(){
+    NodeObject *object = newObject();
+    lwm2m_object_t *objectP = object->Get();
+    Resource *res = object->GetResource(ADDRESSES_RESOURCE_ID);
+    ResourceArray<string> *instances = (*res).GetValue<ResourceArray<string>>();
+    lwm2m_data_t *dataP = lwm2m_data_new(1);
+    lwm2m_data_t *subData = lwm2m_data_new(2);
+    size_t writes = 0;
+
+    (*instances).Set(0, "192.168.0.1");
+    (*instances).Set(3, "10.0.0.3");
+    (*res).BindOnWrite<ResourceArray<string>>([&writes](const ResourceArray<string> &value){ writes++; });
+
+    dataP->id = ADDRESSES_RESOURCE_ID;
+    subData[0].id = 1;
+    lwm2m_data_encode_string("10.0.0.1", subData);
+    subData[1].id = 3;
+    lwm2m_data_encode_string("10.0.0.30", subData + 1);
+    lwm2m_data_encode_instances(subData, 2, dataP);
+
+    // A partial update keeps the instances not written
+    TEST_ASSERT_EQUAL(COAP_204_CHANGED, objectP->writeFunc(nullptr, 0, 1, dataP, objectP, LWM2M_WRITE_PARTIAL_UPDATE));
+    TEST_ASSERT_EQUAL(3, (*instances).Size());
+    TEST_ASSERT_EQUAL_STRING("192.168.0.1", (*(*instances).Find(0)).c_str());
+    TEST_ASSERT_EQUAL_STRING("10.0.0.30", (*(*instances).Find(3)).c_str());
+
+    // Replacing the resource drops them
+    TEST_ASSERT_EQUAL(COAP_204_CHANGED, objectP->writeFunc(nullptr, 0, 1, dataP, objectP, LWM2M_WRITE_REPLACE_RESOURCES));
+    TEST_ASSERT_EQUAL(2, (*instances).Size());
+    TEST_ASSERT_TRUE((*instances).Find(0) == nullptr);
+    TEST_ASSERT_EQUAL(2, writes);
+
+    // A single value is not a valid write of a multiple resource
+    lwm2m_data_free(1, dataP);
+    dataP = lwm2m_data_new(1);
+    dataP->id = ADDRESSES_RESOURCE_ID;
+    lwm2m_data_encode_string("10.0.0.1", dataP);
+    TEST_ASSERT_EQUAL(COAP_400_BAD_REQUEST, objectP->writeFunc(nullptr, 0, 1, dataP, objectP, LWM2M_WRITE_REPLACE_RESOURCES));
+    lwm2m_data_free(1, dataP);
+
+    deleteObject(object, objectP);
+    return CaseNext;
+}
+
+static control_t readAllocations(){
+#if MBED_HEAP_STATS_ENABLED
+    NodeObject *object = newObject();
+    lwm2m_object_t *objectP = object->Get();
+    ResourceArray<int> *instances = (*object->GetResource(SOURCES_RESOURCE_ID)).GetValue<ResourceArray<int>>();
+    lwm2m_data_t *dataP = lwm2m_data_new(1);
+    int numData = 1;
+    mbed_stats_heap_t before;
+    mbed_stats_heap_t after;
+
+    for (uint16_t id = 0; id < INSTANCE_COUNT; ++id)
+        (*instances).Set(id, id);
+
+    // One array for every instance, whatever their number
+    dataP->id = SOURCES_RESOURCE_ID;
+    mbed_stats_heap_get(&before);
+    TEST_ASSERT_EQUAL(COAP_205_CONTENT, objectP->readFunc(nullptr, 0, &numData, &dataP, objectP));
+    mbed_stats_heap_get(&after);
+    TEST_ASSERT_EQUAL(INSTANCE_COUNT, dataP->value.asChildren.count);
+    TEST_ASSERT_EQUAL(1, after.alloc_cnt - before.alloc_cnt);
+    lwm2m_data_free(numData, dataP);
+
+    deleteObject(object, objectP);
+#else
+    TEST_IGNORE_MESSAGE("heap statistics are disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Instances sorted by ID", instancesSortedById),
+    Case("Multiple resource holding an array", resourceHoldsArray),
+    Case("Read encodes every instance", readEncodesInstances),
+    Case("Write replaces or updates the instances", writeReplacesOrUpdates),
+    Case("Read allocates one array", readAllocations)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,385 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the asynchronous Write and Exec callbacks and of their completion token, and of the separate
+ *  responses of the core: deadline and duplicate requests
+ *
+ *  @date 10/18/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "resource.h"
+#include "connection.h"
+extern "C"
+{
+#include "er-coap-13.h"
+}
+#include <string>
+#include <string.h>
+
+using namespace utest::v1;
+using namespace std;
+
+#define RESPONSE_ID 42
+#define OBJECT_ID 3311
+#define ON_OFF_ID 5850
+#define REQUEST_MID 0x1234
+#define MAX_SENT 8
+
+class FakeCompleter : public ResponseCompleter
+{
+public:
+    int CompleteResponse(lwm2m_context_t *contextP, int responseId, uint8_t status) override
+    {
+        calls++;
+        lastContext = contextP;
+        lastId = responseId;
+        lastStatus = status;
+        // The first completion sends the response
+        return calls == 1 ? COAP_NO_ERROR : COAP_404_NOT_FOUND;
+    }
+
+    int calls = 0;
+    lwm2m_context_t *lastContext = nullptr;
+    int lastId = -1;
+    uint8_t lastStatus = 0;
+};
+
+static control_t asyncOutsideRequest(){
+    size_t calls = 0;
+    Resource res(0, ResourceOp::RES_E);
+    Resource resWr(string(""), ResourceOp::RES_RDWR);
+
+    // Not called for a request of the server, the token is invalid and the value is still delivered
+    ResListener listener = res.BindOnExecAsync<int>([&calls](const int &value, ResponseToken token){
+        TEST_ASSERT_FALSE((bool)token);
+        TEST_ASSERT_FALSE(token.Complete());
+        calls++;
+    });
+    TEST_ASSERT_TRUE((bool)listener);
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.Exec<int>());
+
+    resWr.BindOnWriteAsync<string>([&calls](const string &value, ResponseToken token){
+        TEST_ASSERT_EQUAL_STRING("dim", value.c_str());
+        TEST_ASSERT_EQUAL(-1, token.GetId());
+        calls++;
+    });
+    TEST_ASSERT_EQUAL(RES_SUCCESS, resWr.Write<string>("dim"));
+    TEST_ASSERT_EQUAL(2, calls);
+
+    // Unbound with the handle returned, as synchronous callbacks
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.UnbindOnExec<int>(listener));
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.Exec<int>());
+    TEST_ASSERT_EQUAL(2, calls);
+
+    // Same access rights as synchronous callbacks
+    TEST_ASSERT_FALSE((bool)resWr.BindOnExecAsync<string>([](const string &value, ResponseToken token){}));
+
+    return CaseNext;
+}
+
+static control_t tokenCompletion(){
+    FakeCompleter completer;
+    lwm2m_context_t *contextP = reinterpret_cast<lwm2m_context_t *>(&completer);
+    ResponseToken token(&completer, contextP, RESPONSE_ID);
+    ResponseToken copy(token);
+
+    TEST_ASSERT_TRUE((bool)token);
+    TEST_ASSERT_EQUAL(RESPONSE_ID, copy.GetId());
+
+#ifdef LWM2M_SEPARATE_RESPONSE
+    TEST_ASSERT_TRUE(copy.Complete(COAP_500_INTERNAL_SERVER_ERROR));
+    TEST_ASSERT_EQUAL_PTR(contextP, completer.lastContext);
+    TEST_ASSERT_EQUAL(RESPONSE_ID, completer.lastId);
+    TEST_ASSERT_EQUAL(COAP_500_INTERNAL_SERVER_ERROR, completer.lastStatus);
+
+    // Copies complete the same response, which is sent once
+    TEST_ASSERT_FALSE(token.Complete());
+    TEST_ASSERT_EQUAL(2, completer.calls);
+    TEST_ASSERT_EQUAL(RESPONSE_ID, completer.lastId);
+#else
+    TEST_ASSERT_FALSE(token.Complete());
+    TEST_ASSERT_EQUAL(0, completer.calls);
+#endif
+
+    return CaseNext;
+}
+
+static void completeLater(ResponseToken *token)
+{
+    ThisThread::sleep_for(10ms);
+    (*token).Complete(COAP_204_CHANGED);
+}
+
+static control_t completionFromAnotherThread(){
+#ifdef LWM2M_SEPARATE_RESPONSE
+    FakeCompleter completer;
+    ResponseToken token(&completer, nullptr, RESPONSE_ID);
+    Thread worker;
+
+    // The callback returns at once, the slow action completes the token later
+    worker.start(callback(completeLater, &token));
+    worker.join();
+
+    TEST_ASSERT_EQUAL(1, completer.calls);
+    TEST_ASSERT_EQUAL(RESPONSE_ID, completer.lastId);
+#else
+    TEST_IGNORE_MESSAGE("separate responses are disabled");
+#endif
+    return CaseNext;
+}
+
+struct Sent
+{
+    uint8_t type;
+    uint8_t code;
+    uint16_t mid;
+    uint8_t token;
+};
+
+static lwm2m_context_t *lwm2mH;
+static lwm2m_object_t object;
+static lwm2m_list_t instance;
+static lwm2m_server_t server;
+static connection_t serverConn;
+static Sent sent[MAX_SENT];
+static size_t sentCount;
+static size_t execCount;
+static int responseId;
+static ResponseToken deferred;
+
+static uint8_t deferExec(lwm2m_context_t *contextP, uint16_t instanceId, uint16_t resourceId, uint8_t *buffer, int length, lwm2m_object_t *objectP)
+{
+    execCount++;
+#ifdef LWM2M_SEPARATE_RESPONSE
+    responseId = lwm2m_defer_response(contextP);
+#endif
+    return COAP_204_CHANGED;
+}
+
+static uint8_t deferExecToken(lwm2m_context_t *contextP, uint16_t instanceId, uint16_t resourceId, uint8_t *buffer, int length, lwm2m_object_t *objectP)
+{
+    execCount++;
+    deferred = ResponseToken::Defer();
+    return COAP_204_CHANGED;
+}
+
+static int captureSend(const uint8_t *buffer, size_t length, void *connP)
+{
+    coap_packet_t packet[1];
+
+    if (sentCount == MAX_SENT || coap_parse_message(packet, (uint8_t *)buffer, length) != NO_ERROR)
+        return -1;
+
+    Sent &record = sent[sentCount++];
+    record.type = packet->type;
+    record.code = packet->code;
+    record.mid = packet->mid;
+    record.token = packet->token_len == 1 ? packet->token[0] : 0;
+    coap_free_header(packet);
+
+    return (int)length;
+}
+
+static void receive(coap_message_type_t type, uint8_t code, uint16_t mid)
+{
+    coap_packet_t message[1];
+    uint8_t buffer[64];
+    uint8_t token = 0xA5;
+
+    coap_init_message(message, type, code, mid);
+    if (code == COAP_POST)
+    {
+        coap_set_header_token(message, &token, sizeof(token));
+        coap_set_header_uri_path(message, "/3311/0/5850");
+    }
+    size_t length = coap_serialize_message(message, buffer);
+    coap_free_header(message);
+
+    lwm2m_handle_packet(lwm2mH, buffer, length, &serverConn);
+}
+
+static void step()
+{
+    time_t timeout = 60;
+
+    lwm2m_step(lwm2mH, &timeout);
+}
+
+static utest::v1::status_t setupContext(const Case *const source, const size_t index_of_case)
+{
+    lwm2mH = lwm2m_init(NULL);
+
+    memset(&object, 0, sizeof(object));
+    memset(&instance, 0, sizeof(instance));
+    object.objID = OBJECT_ID;
+    object.executeFunc = deferExec;
+    object.instanceList = &instance;
+    lwm2mH->objectList = &object;
+
+    // Registered server reached through the capturing connection
+    memset(&serverConn, 0, sizeof(serverConn));
+    serverConn.sendFunc = captureSend;
+    memset(&server, 0, sizeof(server));
+    server.shortID = 1;
+    server.lifetime = 86400;
+    server.registration = lwm2m_gettime();
+    server.binding = BINDING_U;
+    server.sessionH = &serverConn;
+    server.status = STATE_REGISTERED;
+    lwm2mH->serverList = &server;
+    lwm2mH->state = STATE_READY;
+
+    sentCount = 0;
+    execCount = 0;
+
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+static utest::v1::status_t teardownContext(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    lwm2mH->objectList = NULL;
+    lwm2mH->serverList = NULL;
+    lwm2m_close(lwm2mH);
+
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+static control_t responseDeadline(){
+#ifdef LWM2M_SEPARATE_RESPONSE
+    // Acknowledged at once, the response waits for the application
+    receive(COAP_TYPE_CON, COAP_POST, REQUEST_MID);
+    TEST_ASSERT_EQUAL(1, sentCount);
+    TEST_ASSERT_EQUAL(COAP_TYPE_ACK, sent[0].type);
+    TEST_ASSERT_EQUAL(0, sent[0].code);
+    TEST_ASSERT_TRUE(responseId >= 0);
+    step();
+    TEST_ASSERT_EQUAL(1, sentCount);
+
+    // Past its deadline, answered 5.03 by the client
+    TEST_ASSERT_NOT_NULL(lwm2mH->transactionList);
+    lwm2mH->transactionList->retrans_time = lwm2m_gettime();
+    step();
+    TEST_ASSERT_EQUAL(2, sentCount);
+    TEST_ASSERT_EQUAL(COAP_TYPE_CON, sent[1].type);
+    TEST_ASSERT_EQUAL(COAP_503_SERVICE_UNAVAILABLE, sent[1].code);
+    TEST_ASSERT_EQUAL(0xA5, sent[1].token);
+    TEST_ASSERT_EQUAL(COAP_404_NOT_FOUND, lwm2m_complete_response(lwm2mH, responseId, COAP_204_CHANGED));
+
+    // Released once acknowledged, nothing keeps the client awake
+    receive(COAP_TYPE_ACK, 0, sent[1].mid);
+    TEST_ASSERT_NULL(lwm2mH->transactionList);
+    TEST_ASSERT_EQUAL(1, execCount);
+#else
+    TEST_IGNORE_MESSAGE("separate responses are disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t duplicateAfterCompletion(){
+#ifdef LWM2M_SEPARATE_RESPONSE
+    receive(COAP_TYPE_CON, COAP_POST, REQUEST_MID);
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_complete_response(lwm2mH, responseId, COAP_204_CHANGED));
+    TEST_ASSERT_EQUAL(2, sentCount);
+    TEST_ASSERT_EQUAL(COAP_204_CHANGED, sent[1].code);
+    receive(COAP_TYPE_ACK, 0, sent[1].mid);
+    TEST_ASSERT_NULL(lwm2mH->transactionList);
+
+    // The empty ACK was lost: the retransmitted request gets the response, it is not executed again
+    receive(COAP_TYPE_CON, COAP_POST, REQUEST_MID);
+    TEST_ASSERT_EQUAL(3, sentCount);
+    TEST_ASSERT_EQUAL(COAP_TYPE_ACK, sent[2].type);
+    TEST_ASSERT_EQUAL(REQUEST_MID, sent[2].mid);
+    TEST_ASSERT_EQUAL(COAP_204_CHANGED, sent[2].code);
+    TEST_ASSERT_EQUAL(0xA5, sent[2].token);
+    TEST_ASSERT_EQUAL(1, execCount);
+
+    // Another request is executed
+    receive(COAP_TYPE_CON, COAP_POST, REQUEST_MID + 1);
+    TEST_ASSERT_EQUAL(2, execCount);
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_complete_response(lwm2mH, responseId, COAP_204_CHANGED));
+#else
+    TEST_IGNORE_MESSAGE("separate responses are disabled");
+#endif
+    return CaseNext;
+}
+
+struct OtherDispatch
+{
+    FakeCompleter completer;
+    Semaphore entered{0};
+    Semaphore leave{0};
+};
+
+// Another client handling a packet on its own thread meanwhile
+static void dispatchOther(OtherDispatch *other)
+{
+    ResponseToken::Scope scope(&other->completer, reinterpret_cast<lwm2m_context_t *>(other));
+
+    other->entered.release();
+    other->leave.acquire();
+}
+
+static control_t concurrentScopes(){
+#ifdef LWM2M_SEPARATE_RESPONSE
+    FakeCompleter completer;
+    OtherDispatch other;
+    Thread worker;
+
+    object.executeFunc = deferExecToken;
+    worker.start(callback(dispatchOther, &other));
+    other.entered.acquire();
+
+    // The scope of the other thread does not apply to this one
+    deferred = ResponseToken();
+    receive(COAP_TYPE_CON, COAP_POST, REQUEST_MID);
+    TEST_ASSERT_FALSE((bool)deferred);
+    TEST_ASSERT_EQUAL(COAP_204_CHANGED, sent[0].code);
+
+    {
+        ResponseToken::Scope scope(&completer, lwm2mH);
+        receive(COAP_TYPE_CON, COAP_POST, REQUEST_MID + 1);
+    }
+    other.leave.release();
+    worker.join();
+
+    TEST_ASSERT_EQUAL(2, execCount);
+    TEST_ASSERT_TRUE((bool)deferred);
+    TEST_ASSERT_TRUE(deferred.Complete());
+    TEST_ASSERT_EQUAL(1, completer.calls);
+    TEST_ASSERT_EQUAL_PTR(lwm2mH, completer.lastContext);
+    TEST_ASSERT_EQUAL(0, other.completer.calls);
+    TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_complete_response(lwm2mH, deferred.GetId(), COAP_204_CHANGED));
+#else
+    TEST_IGNORE_MESSAGE("separate responses are disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Asynchronous callbacks outside a request", asyncOutsideRequest),
+    Case("Completion of a token and of its copies", tokenCompletion),
+    Case("Completion from another thread", completionFromAnotherThread),
+    Case("Response sent with 5.03 past its deadline", setupContext, responseDeadline, teardownContext),
+    Case("Duplicate of a completed request", setupContext, duplicateAfterCompletion, teardownContext),
+    Case("Tokens of clients dispatching concurrently", setupContext, concurrentScopes, teardownContext)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
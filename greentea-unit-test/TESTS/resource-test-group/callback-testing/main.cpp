@@ -0,0 +1,124 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the callback functions bound to a resource, and measure of their cost on read, write and copy
+ *
+ *  @date 10/18/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "resource.h"
+#include <string>
+
+using namespace utest::v1;
+using namespace std;
+
+#define BENCHMARK_ITERATIONS 10000
+#define BENCHMARK_VALUE "Europe/Zurich, a value longer than the small string buffer"
+
+static control_t callbackOrderAndUnbind(){
+    string calls;
+    Resource res(0, ResourceOp::RES_RDWR);
+
+    // Third listener goes past the inline storage
+    auto first = res.BindOnWrite<int>([&calls](const int &a){ calls += 'a'; });
+    auto second = res.BindOnWrite<int>([&calls](const int &a){ calls += 'b'; });
+    auto third = res.BindOnWrite<int>([&calls](const int &a){ calls += 'c'; });
+
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.Write<int>(1));
+    TEST_ASSERT_EQUAL_STRING("abc", calls.c_str());
+
+    calls.clear();
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.UnbindOnWrite<int>(first));
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.Write<int>(2));
+    TEST_ASSERT_EQUAL_STRING("bc", calls.c_str());
+
+    calls.clear();
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.UnbindOnWrite<int>(third));
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.UnbindOnWrite<int>(third));
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.Write<int>(3));
+    TEST_ASSERT_EQUAL_STRING("b", calls.c_str());
+
+    // A copy keeps the listeners and their handles
+    calls.clear();
+    Resource copy(res);
+    TEST_ASSERT_EQUAL(RES_SUCCESS, copy.Write<int>(4));
+    TEST_ASSERT_EQUAL_STRING("b", calls.c_str());
+    TEST_ASSERT_EQUAL(RES_SUCCESS, copy.UnbindOnWrite<int>(second));
+    TEST_ASSERT_EQUAL(RES_SUCCESS, copy.Write<int>(5));
+    TEST_ASSERT_EQUAL_STRING("b", calls.c_str());
+
+    return CaseNext;
+}
+
+static control_t callbackGetsStoredValue(){
+    const string *received = nullptr;
+    Resource res(string(BENCHMARK_VALUE), ResourceOp::RES_RD);
+
+    res.BindOnRead<string>([&received](const string &value){ received = &value; });
+
+    // The listener sees the value stored in the resource, not a copy
+    const string *stored = res.Read<string>();
+    TEST_ASSERT_EQUAL_PTR(stored, received);
+
+    return CaseNext;
+}
+
+static control_t callbackBenchmark(){
+    size_t calls = 0;
+    string value(BENCHMARK_VALUE);
+    Resource res(value, ResourceOp::RES_RDWR);
+    Timer timer;
+
+    res.BindOnRead<string>([&calls](const string &value){ calls += value.size(); });
+    res.BindOnWrite<string>([&calls](const string &value){ calls += value.size(); });
+
+    timer.start();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        res.Read<string>();
+    timer.stop();
+    utest_printf("read with a listener: %lld ns\n", (long long)(timer.elapsed_time().count() * 1000 / BENCHMARK_ITERATIONS));
+
+    timer.reset();
+    timer.start();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        res.Write<string>(value);
+    timer.stop();
+    utest_printf("write with a listener: %lld ns\n", (long long)(timer.elapsed_time().count() * 1000 / BENCHMARK_ITERATIONS));
+
+    timer.reset();
+    timer.start();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        Resource copy(res);
+    timer.stop();
+    utest_printf("copy with two listeners: %lld ns\n", (long long)(timer.elapsed_time().count() * 1000 / BENCHMARK_ITERATIONS));
+
+    TEST_ASSERT_EQUAL(2 * BENCHMARK_ITERATIONS * value.size(), calls);
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Listeners are called in order and unbound", callbackOrderAndUnbind),
+    Case("Listeners get the stored value", callbackGetsStoredValue),
+    Case("Cost of the listeners on read, write and copy", callbackBenchmark)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,128 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the Execute operation dispatched by an object on its resources, and measure of its latency
+ *
+ *  Allocation checks need the heap statistics, enabled with "platform.heap-stats-enabled": true
+ *
+ *  @date 10/18/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "node_object.h"
+#include <string>
+
+using namespace utest::v1;
+using namespace std;
+
+#define BENCHMARK_ITERATIONS 10000
+#define OBJECT_ID 3416
+#define EXEC_RESOURCE_ID 24
+#define READ_RESOURCE_ID 25
+
+static NodeObject *newObject()
+{
+    vector<Resource *> resources;
+
+    resources.push_back(new Resource(0, ResourceOp::RES_E, "Control gear thermal derating counter reset", Units::NA, EXEC_RESOURCE_ID));
+    resources.push_back(new Resource(0, ResourceOp::RES_RD, "Control gear thermal derating counter", Units::NA, READ_RESOURCE_ID));
+
+    return new NodeObject(OBJECT_ID, 0, resources);
+}
+
+static void deleteObject(NodeObject *object, lwm2m_object_t *objectP)
+{
+    lwm2m_free(objectP->instanceList);
+    lwm2m_free(objectP);
+    delete object;
+}
+
+static control_t executeStoredResource(){
+    const int *received = nullptr;
+    NodeObject *object = newObject();
+    lwm2m_object_t *objectP = object->Get();
+    Resource *res = object->GetResource(EXEC_RESOURCE_ID);
+
+    (*res).BindOnExec<int>([&received](const int &value){ received = &value; });
+
+    // The listener sees the value stored in the object, not the value of a copy
+    TEST_ASSERT_EQUAL(COAP_204_CHANGED, objectP->executeFunc(nullptr, 0, EXEC_RESOURCE_ID, nullptr, 0, objectP));
+    TEST_ASSERT_EQUAL_PTR((*res).GetValue<int>(), received);
+
+    TEST_ASSERT_EQUAL(COAP_405_METHOD_NOT_ALLOWED, objectP->executeFunc(nullptr, 0, READ_RESOURCE_ID, nullptr, 0, objectP));
+    TEST_ASSERT_EQUAL(COAP_404_NOT_FOUND, objectP->executeFunc(nullptr, 0, 0, nullptr, 0, objectP));
+    TEST_ASSERT_EQUAL(COAP_404_NOT_FOUND, objectP->executeFunc(nullptr, 1, EXEC_RESOURCE_ID, nullptr, 0, objectP));
+
+    deleteObject(object, objectP);
+    return CaseNext;
+}
+
+static control_t executeWithoutAllocation(){
+#if MBED_HEAP_STATS_ENABLED
+    size_t calls = 0;
+    NodeObject *object = newObject();
+    lwm2m_object_t *objectP = object->Get();
+    mbed_stats_heap_t before;
+    mbed_stats_heap_t after;
+
+    (*object->GetResource(EXEC_RESOURCE_ID)).BindOnExec<int>([&calls](const int &value){ calls++; });
+
+    mbed_stats_heap_get(&before);
+    TEST_ASSERT_EQUAL(COAP_204_CHANGED, objectP->executeFunc(nullptr, 0, EXEC_RESOURCE_ID, nullptr, 0, objectP));
+    mbed_stats_heap_get(&after);
+
+    TEST_ASSERT_EQUAL(1, calls);
+    TEST_ASSERT_EQUAL(before.alloc_cnt, after.alloc_cnt);
+
+    deleteObject(object, objectP);
+#else
+    TEST_IGNORE_MESSAGE("heap statistics are disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t executeBenchmark(){
+    size_t calls = 0;
+    NodeObject *object = newObject();
+    lwm2m_object_t *objectP = object->Get();
+    Timer timer;
+
+    (*object->GetResource(EXEC_RESOURCE_ID)).BindOnExec<int>([&calls](const int &value){ calls++; });
+
+    // From the object callback called by the core for an Execute request, through the listener, back to the core
+    timer.start();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        objectP->executeFunc(nullptr, 0, EXEC_RESOURCE_ID, nullptr, 0, objectP);
+    timer.stop();
+    utest_printf("execute with a listener: %lld ns\n", (long long)(timer.elapsed_time().count() * 1000 / BENCHMARK_ITERATIONS));
+
+    TEST_ASSERT_EQUAL(BENCHMARK_ITERATIONS, calls);
+
+    deleteObject(object, objectP);
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Execute calls the listeners of the stored resource", executeStoredResource),
+    Case("Execute does not allocate", executeWithoutAllocation),
+    Case("Latency of an Execute", executeBenchmark)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
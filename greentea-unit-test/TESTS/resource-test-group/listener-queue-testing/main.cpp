@@ -0,0 +1,220 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the callbacks run on a ListenerQueue instead of the thread calling Read, Write or Exec
+ *
+ *  @date 10/18/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "node_object.h"
+#include <string>
+
+using namespace utest::v1;
+using namespace std;
+
+#define SLOW_LISTENER_DELAY 100ms
+#define MAX_CALLER_DELAY_US 10000
+#define OBJECT_ID 3311
+#define DIMMER_ID 5851
+#define ON_OFF_ID 5850
+
+static control_t callbacksOnQueue(){
+    ListenerQueue queue;
+    Semaphore done(0);
+    osThreadId_t caller = ThisThread::get_id();
+    osThreadId_t callee = caller;
+    string received;
+    string order;
+    Resource res(string(""), ResourceOp::RES_RDWR);
+
+    res.SetListenerQueue(&queue);
+    TEST_ASSERT_EQUAL_PTR(&queue, res.GetListenerQueue());
+    TEST_ASSERT_EQUAL_PTR(&queue, Resource(res).GetListenerQueue());
+
+    res.BindOnWrite<string>([&](const string &value){
+        callee = ThisThread::get_id();
+        received = value;
+        order += "1";
+    });
+    res.BindOnWrite<string>([&](const string &value){
+        order += "2";
+        done.release();
+    });
+    res.BindOnRead<string>([&](const string &value){
+        order += "R";
+        done.release();
+    });
+
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.Write<string>("on"));
+    // The callbacks get the value written, not the value stored when they run
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.SetValue<string>("off"));
+    TEST_ASSERT_NOT_NULL(res.Read<string>());
+
+    TEST_ASSERT_TRUE(done.try_acquire_for(1s));
+    TEST_ASSERT_TRUE(done.try_acquire_for(1s));
+    TEST_ASSERT_TRUE(callee != caller);
+    TEST_ASSERT_EQUAL_STRING("on", received.c_str());
+    TEST_ASSERT_EQUAL_STRING("12R", order.c_str());
+
+    // Back to inline callbacks
+    res.SetListenerQueue(nullptr);
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.Write<string>("dim"));
+    TEST_ASSERT_TRUE(callee == caller);
+
+    return CaseNext;
+}
+
+static control_t callerNotDelayed(){
+    ListenerQueue queue;
+    Semaphore done(0);
+    Timer timer;
+    Resource res(0, ResourceOp::RES_E);
+
+    res.SetListenerQueue(&queue);
+    res.BindOnExec<int>([&done](const int &value){
+        ThisThread::sleep_for(SLOW_LISTENER_DELAY);
+        done.release();
+    });
+
+    // The thread executing the resource does not wait for the slow callback
+    timer.start();
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.Exec<int>());
+    timer.stop();
+    utest_printf("exec with a slow listener: %lld us\n", (long long)timer.elapsed_time().count());
+    TEST_ASSERT_TRUE(timer.elapsed_time().count() < MAX_CALLER_DELAY_US);
+
+    TEST_ASSERT_TRUE(done.try_acquire_for(1s));
+
+    return CaseNext;
+}
+
+static control_t backpressure(){
+    ListenerQueue queue(2);
+    Semaphore gate(0);
+    Resource res(0, ResourceOp::RES_RDWR);
+    ListenerQueueStats stats;
+
+    res.SetListenerQueue(&queue);
+    res.BindOnWrite<int>([&gate](const int &value){ gate.acquire(); });
+
+    // A call counts as pending until it has run, the queue is full after two writes
+    for (int i = 0; i < 4; ++i)
+        TEST_ASSERT_EQUAL(i < 2 ? RES_SUCCESS : LISTENER_QUEUE_FULL, res.Write<int>(i));
+
+    // The value is written anyway
+    TEST_ASSERT_EQUAL(3, *res.GetValue<int>());
+    TEST_ASSERT_EQUAL(LISTENER_QUEUE_FULL, res.GetErrorCode());
+
+    stats = queue.GetStats();
+    TEST_ASSERT_EQUAL(2, queue.GetCapacity());
+    TEST_ASSERT_EQUAL(2, stats.posted);
+    TEST_ASSERT_EQUAL(2, stats.dropped);
+    TEST_ASSERT_EQUAL(2, stats.pending);
+    TEST_ASSERT_EQUAL(2, stats.maxPending);
+
+    gate.release();
+    gate.release();
+    for (int i = 0; i < 100 && queue.GetStats().executed < 2; ++i)
+        ThisThread::sleep_for(10ms);
+
+    stats = queue.GetStats();
+    TEST_ASSERT_EQUAL(2, stats.executed);
+    TEST_ASSERT_EQUAL(0, stats.pending);
+
+    queue.ResetStats();
+    stats = queue.GetStats();
+    TEST_ASSERT_EQUAL(0, stats.posted);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+    TEST_ASSERT_EQUAL(0, stats.maxPending);
+
+    return CaseNext;
+}
+
+static control_t multipleResourceInstances(){
+    ListenerQueue queue;
+    Semaphore done(0);
+    size_t received = 0;
+    Resource res(ResourceArray<int>({ 2, 4 }), ResourceOp::RES_RDWR);
+
+    res.SetListenerQueue(&queue);
+    res.BindOnWrite<ResourceArray<int>>([&](const ResourceArray<int> &instances){
+        received = instances.Size();
+        done.release();
+    });
+
+    // Every instance is handed over in one call, the resource can change meanwhile
+    ResourceArray<int> instances = *res.GetValue<ResourceArray<int>>();
+    instances.Set(7, 1);
+    TEST_ASSERT_EQUAL(RES_SUCCESS, res.Write<ResourceArray<int>>(instances));
+    (*res.GetValue<ResourceArray<int>>()).Clear();
+
+    TEST_ASSERT_TRUE(done.try_acquire_for(1s));
+    TEST_ASSERT_EQUAL(3, received);
+
+    return CaseNext;
+}
+
+static control_t serviceUnavailableWhenFull(){
+    ListenerQueue queue(1);
+    Semaphore gate(0);
+    vector<Resource *> resources;
+    lwm2m_data_t data;
+
+    resources.push_back(new Resource(0, ResourceOp::RES_RDWR, "Dimmer", Units::NA, DIMMER_ID));
+    resources.push_back(new Resource(0, ResourceOp::RES_E, "On/Off", Units::NA, ON_OFF_ID));
+    NodeObject *object = new NodeObject(OBJECT_ID, 0, resources);
+    lwm2m_object_t *objectP = object->Get();
+    object->SetListenerQueue(&queue);
+    (*object->GetResource(DIMMER_ID)).BindOnWrite<int>([&gate](const int &value){ gate.acquire(); });
+    (*object->GetResource(ON_OFF_ID)).BindOnExec<int>([](const int &value){});
+
+    memset(&data, 0, sizeof(data));
+    data.id = DIMMER_ID;
+    lwm2m_data_encode_int(40, &data);
+
+    // The server is asked to try again rather than told the callbacks ran
+    TEST_ASSERT_EQUAL(COAP_204_CHANGED, objectP->writeFunc(nullptr, 0, 1, &data, objectP, LWM2M_WRITE_PARTIAL_UPDATE));
+    TEST_ASSERT_EQUAL(COAP_503_SERVICE_UNAVAILABLE, objectP->writeFunc(nullptr, 0, 1, &data, objectP, LWM2M_WRITE_PARTIAL_UPDATE));
+    TEST_ASSERT_EQUAL(COAP_503_SERVICE_UNAVAILABLE, objectP->executeFunc(nullptr, 0, ON_OFF_ID, nullptr, 0, objectP));
+
+    gate.release();
+    for (int i = 0; i < 100 && queue.GetStats().pending > 0; ++i)
+        ThisThread::sleep_for(10ms);
+    TEST_ASSERT_EQUAL(COAP_204_CHANGED, objectP->executeFunc(nullptr, 0, ON_OFF_ID, nullptr, 0, objectP));
+
+    for (int i = 0; i < 100 && queue.GetStats().pending > 0; ++i)
+        ThisThread::sleep_for(10ms);
+    lwm2m_free(objectP->instanceList);
+    lwm2m_free(objectP);
+    delete object;
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Callbacks run in order on the queue with the value of the operation", callbacksOnQueue),
+    Case("Caller not delayed by a slow callback", callerNotDelayed),
+    Case("Calls dropped when the queue is full", backpressure),
+    Case("Instances of a multiple resource handed over at once", multipleResourceInstances),
+    Case("Write and Execute answered 5.03 when the queue is full", serviceUnavailableWhenFull)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,129 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the memory used by each resource instance, with and without descriptor
+ *
+ *  Heap measurements need the heap statistics, enabled with "platform.heap-stats-enabled": true
+ *
+ *  @date 10/18/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "resource.h"
+#include <string>
+
+using namespace utest::v1;
+using namespace std;
+
+#define LONG_NAME "Notification storing when disabled or offline"
+
+static const ResourceDescriptor descriptor = { 6, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, LONG_NAME };
+
+static size_t heapUsed()
+{
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    return stats.current_size;
+}
+
+static control_t resourceSize(){
+    // Value, descriptor, error code and callbacks: no name, unit, rights or id per instance
+    TEST_ASSERT_TRUE(sizeof(Resource) <= 2 * sizeof(void *) + 2 * sizeof(int) + 3 * sizeof(ResCallbackBase *));
+    utest_printf("sizeof(Resource) = %u bytes\n", (unsigned)sizeof(Resource));
+    return CaseNext;
+}
+
+static control_t copySharesDescriptor(){
+    Resource resLegacy(0, ResourceOp::RES_RDWR, LONG_NAME, Units::NA, 6);
+    Resource resLegacyCopy(resLegacy);
+    Resource resDescr(descriptor, 0);
+    Resource resDescrCopy(resDescr);
+
+    TEST_ASSERT_EQUAL_STRING(LONG_NAME, resLegacyCopy.GetName());
+    TEST_ASSERT_EQUAL_PTR(resLegacy.GetName(), resLegacyCopy.GetName());
+    TEST_ASSERT_EQUAL_PTR(resLegacy.GetDescriptor(), resLegacyCopy.GetDescriptor());
+    TEST_ASSERT_EQUAL_PTR(descriptor.name, resDescr.GetName());
+    TEST_ASSERT_EQUAL_PTR(&descriptor, resDescrCopy.GetDescriptor());
+    TEST_ASSERT_EQUAL(6, resDescrCopy.GetId());
+    TEST_ASSERT_EQUAL(ResourceOp::RES_RDWR, resDescrCopy.GetOp());
+    return CaseNext;
+}
+
+static control_t bytesPerInstance(){
+#if MBED_HEAP_STATS_ENABLED
+    size_t valueBytes;
+    size_t legacyBytes;
+    size_t descrBytes;
+    size_t copyBytes;
+    size_t start;
+    size_t before;
+
+    // Value only, as a reference
+    before = heapUsed();
+    Resource *resValue = new Resource(descriptor, 0);
+    valueBytes = heapUsed() - before;
+    delete resValue;
+
+    start = heapUsed();
+
+    // Metadata held by the resource itself
+    before = heapUsed();
+    Resource *resLegacy = new Resource(0, ResourceOp::RES_RDWR, LONG_NAME, Units::NA, 6);
+    legacyBytes = heapUsed() - before;
+
+    before = heapUsed();
+    Resource *resDescr = new Resource(descriptor, 0);
+    descrBytes = heapUsed() - before;
+
+    // A copy only duplicates the value, whatever the resource was built from
+    before = heapUsed();
+    Resource *resLegacyCopy = new Resource(*resLegacy);
+    copyBytes = heapUsed() - before;
+    TEST_ASSERT_EQUAL(valueBytes, copyBytes);
+
+    before = heapUsed();
+    Resource *resDescrCopy = new Resource(*resDescr);
+    copyBytes = heapUsed() - before;
+    TEST_ASSERT_EQUAL(valueBytes, copyBytes);
+
+    TEST_ASSERT_TRUE(legacyBytes > descrBytes);
+    utest_printf("bytes per instance: %u with its own metadata, %u with a descriptor, %u per copy\n",
+                 (unsigned)legacyBytes, (unsigned)descrBytes, (unsigned)copyBytes);
+
+    delete resDescrCopy;
+    delete resLegacyCopy;
+    delete resDescr;
+    delete resLegacy;
+
+    // Last copy gone, the shared metadata is freed
+    TEST_ASSERT_EQUAL(start, heapUsed());
+#else
+    TEST_IGNORE_MESSAGE("heap statistics are disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Size of a resource instance", resourceSize),
+    Case("Copies share the descriptor", copySharesDescriptor),
+    Case("Heap bytes per resource instance", bytesPerInstance)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,232 @@
+/**
+ *  @file main.cpp
+ *  @brief Test of the timestamped values of a resource stored in a TimeSeries and uploaded as a SenML JSON pack
+ *
+ *  Packs are built with SenML JSON, enabled with LwM2M 1.1 and LWM2M_SUPPORT_SENML_JSON
+ *
+ *  @date 10/18/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "time_series.h"
+#include <string>
+
+using namespace utest::v1;
+using namespace std;
+
+#define OBJECT_ID 3303
+#define SENSOR_VALUE_ID 5700
+#define BASE_TIME 1700000000
+
+static control_t ringOverwritesOldest(){
+    Resource res(0.0f, ResourceOp::RES_RD, "Sensor Value", Units::NA, SENSOR_VALUE_ID);
+    TimeSeries<float> series(res, OBJECT_ID, 0, 4);
+
+    // Timestamp and value side by side, no padding
+    TEST_ASSERT_EQUAL(8, sizeof(TimeSeries<float>::Sample));
+
+    for (int i = 0; i < 6; ++i)
+        TEST_ASSERT_EQUAL(RES_SUCCESS, series.Record(i * 1.5f, BASE_TIME + i));
+
+    TimeSeriesStats stats = series.GetStats();
+    TEST_ASSERT_EQUAL(4, series.Size());
+    TEST_ASSERT_EQUAL(6, stats.recorded);
+    TEST_ASSERT_EQUAL(2, stats.overwritten);
+    TEST_ASSERT_EQUAL(BASE_TIME + 2, series.Get(0).time);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, series.Get(0).value);
+    TEST_ASSERT_EQUAL_FLOAT(7.5f, series.Get(3).value);
+
+    // The resource holds the last value
+    TEST_ASSERT_EQUAL_FLOAT(7.5f, *res.GetValue<float>());
+    TEST_ASSERT_EQUAL(SENSOR_VALUE_ID, series.GetUri().resourceId);
+
+    return CaseNext;
+}
+
+static control_t policyTriggersUpload(){
+    Resource res(0, ResourceOp::RES_RD, "Counter", Units::NA, SENSOR_VALUE_ID);
+    TimeSeriesPolicy byCount = { 3, 0, 0 };
+    TimeSeriesPolicy byAge = { 0, 60, 0 };
+    TimeSeries<int> counted(res, OBJECT_ID, 0, 8, byCount);
+    TimeSeries<int> aged(res, OBJECT_ID, 0, 8, byAge);
+    size_t due = 0;
+    time_t delay = -1;
+
+    counted.SetDueCallback([&due](){ due++; });
+    TEST_ASSERT_FALSE(counted.FlushDue(BASE_TIME));
+
+    counted.Record(1, BASE_TIME);
+    counted.Record(2, BASE_TIME + 1);
+    TEST_ASSERT_FALSE(counted.FlushDue(BASE_TIME + 1, &delay));
+    TEST_ASSERT_EQUAL(-1, delay);
+    TEST_ASSERT_EQUAL(0, due);
+
+    // The sample reaching the count calls the client at once
+    counted.Record(3, BASE_TIME + 2);
+    TEST_ASSERT_TRUE(counted.FlushDue(BASE_TIME + 2));
+    TEST_ASSERT_EQUAL(1, due);
+
+    // A failed upload is tried again after a delay
+    counted.Retry(BASE_TIME + 2);
+    TEST_ASSERT_FALSE(counted.FlushDue(BASE_TIME + 3, &delay));
+    TEST_ASSERT_EQUAL(TIME_SERIES_RETRY_DELAY - 1, delay);
+    TEST_ASSERT_TRUE(counted.FlushDue(BASE_TIME + 2 + TIME_SERIES_RETRY_DELAY));
+    TEST_ASSERT_EQUAL(1, counted.GetStats().failures);
+
+    // The age counts from the oldest sample
+    aged.Record(1, BASE_TIME);
+    aged.Record(2, BASE_TIME + 50);
+    TEST_ASSERT_FALSE(aged.FlushDue(BASE_TIME + 45, &delay));
+    TEST_ASSERT_EQUAL(15, delay);
+    TEST_ASSERT_TRUE(aged.FlushDue(BASE_TIME + 60));
+
+    return CaseNext;
+}
+
+static control_t packWithBaseTime(){
+#if defined(LWM2M_SUPPORT_SENML_JSON)
+    Resource res(0, ResourceOp::RES_RD, "Counter", Units::NA, SENSOR_VALUE_ID);
+    TimeSeries<int> series(res, OBJECT_ID, 0, 8);
+    uint8_t pack[128];
+    uint32_t end;
+
+    series.Record(21, BASE_TIME);
+    series.Record(22, BASE_TIME + 10);
+    series.Record(-3, BASE_TIME + 25);
+
+    int length = series.BuildPack(pack, sizeof(pack), &end);
+    TEST_ASSERT_TRUE(length > 0);
+    TEST_ASSERT_EQUAL_STRING("[{\"bn\":\"/3303/0/5700\",\"bt\":1700000000,\"v\":21},{\"t\":10,\"v\":22},{\"t\":25,\"v\":-3}]",
+                             string((char *)pack, length).c_str());
+
+    // Samples recorded meanwhile stay for the next pack
+    series.Record(4, BASE_TIME + 30);
+    series.Release(end);
+    TEST_ASSERT_EQUAL(1, series.Size());
+    TEST_ASSERT_EQUAL(3, series.GetStats().uploaded);
+    TEST_ASSERT_EQUAL(1, series.GetStats().packs);
+
+    length = series.BuildPack(pack, sizeof(pack), &end);
+    TEST_ASSERT_EQUAL_STRING("[{\"bn\":\"/3303/0/5700\",\"bt\":1700000030,\"v\":4}]", string((char *)pack, length).c_str());
+#else
+    TEST_IGNORE_MESSAGE("SenML JSON is disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t packSizeLimited(){
+#if defined(LWM2M_SUPPORT_SENML_JSON)
+    Resource res(0.0f, ResourceOp::RES_RD, "Sensor Value", Units::NA, SENSOR_VALUE_ID);
+    TimeSeriesPolicy bySize = { 0, 0, 200 };
+    TimeSeries<float> series(res, OBJECT_ID, 0, 32, bySize);
+    uint8_t pack[200];
+    uint32_t end;
+    size_t recorded = 0;
+
+    // Due before the next sample may overflow the pack, far before the series is full
+    while (!series.FlushDue(BASE_TIME + recorded))
+    {
+        series.Record(20.25f + recorded, BASE_TIME + recorded);
+        recorded++;
+    }
+    TEST_ASSERT_TRUE(recorded > 1);
+    TEST_ASSERT_TRUE(recorded < series.Capacity());
+
+    // Every sample fits in one pack
+    int length = series.BuildPack(pack, sizeof(pack), &end);
+    TEST_ASSERT_TRUE(length > 0 && length <= (int)sizeof(pack));
+    TEST_ASSERT_EQUAL(']', pack[length - 1]);
+    series.Release(end);
+    TEST_ASSERT_EQUAL(0, series.Size());
+#else
+    TEST_IGNORE_MESSAGE("SenML JSON is disabled");
+#endif
+    return CaseNext;
+}
+
+static control_t clockNotSet(){
+    Resource res(0, ResourceOp::RES_RD, "Counter", Units::NA, SENSOR_VALUE_ID);
+    TimeSeries<int> series(res, OBJECT_ID, 0, 4);
+
+    // Counted from the boot, the RTC is not set: the resource is updated, the sample is not recorded
+    TEST_ASSERT_EQUAL(TIME_SERIES_CLOCK_NOT_SET, series.Record(7, 120));
+    TEST_ASSERT_EQUAL(TIME_SERIES_CLOCK_NOT_SET, series.Record(8, TIME_SERIES_MIN_TIME - 1));
+    TEST_ASSERT_EQUAL(8, *res.GetValue<int>());
+    TEST_ASSERT_EQUAL(0, series.Size());
+    TEST_ASSERT_EQUAL(2, series.GetStats().rejected);
+    TEST_ASSERT_EQUAL(0, series.GetStats().recorded);
+
+    TEST_ASSERT_EQUAL(RES_SUCCESS, series.Record(9, TIME_SERIES_MIN_TIME));
+    TEST_ASSERT_EQUAL(1, series.Size());
+
+    return CaseNext;
+}
+
+struct HeldMutex
+{
+    Mutex mutex;
+    Semaphore locked{0};
+    bool released = false;
+};
+
+// The client reading the context meanwhile
+static void holdMutex(HeldMutex *held)
+{
+    held->mutex.lock();
+    held->locked.release();
+    ThisThread::sleep_for(50ms);
+    held->released = true;
+    held->mutex.unlock();
+}
+
+static control_t resourceUpdatedUnderMutex(){
+    Resource res(0, ResourceOp::RES_RD, "Counter", Units::NA, SENSOR_VALUE_ID);
+    TimeSeries<int> series(res, OBJECT_ID, 0, 4);
+    HeldMutex held;
+    Thread client;
+
+    series.SetResourceMutex(&held.mutex);
+    client.start(callback(holdMutex, &held));
+    held.locked.acquire();
+
+    // Waits for the mutex before updating the resource
+    TEST_ASSERT_EQUAL(RES_SUCCESS, series.Record(5, BASE_TIME));
+    TEST_ASSERT_TRUE(held.released);
+    TEST_ASSERT_EQUAL(5, *res.GetValue<int>());
+    client.join();
+
+    series.SetResourceMutex(nullptr);
+    TEST_ASSERT_EQUAL(RES_SUCCESS, series.Record(6, BASE_TIME + 1));
+    TEST_ASSERT_EQUAL(2, series.Size());
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Oldest samples overwritten when full", ringOverwritesOldest),
+    Case("Upload due by count, by age, retried", policyTriggersUpload),
+    Case("Pack with a base time and relative times", packWithBaseTime),
+    Case("Pack size limited by the policy", packSizeLimited),
+    Case("Samples refused until the clock is set", clockNotSet),
+    Case("Resource updated under the mutex of the client", resourceUpdatedUnderMutex)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,272 @@
+/**
+ *  @file main.cpp
+ *  @brief Benchmark of the notification throughput of the sharded LWM2M Server of examples/shared/server_shards.c
+ *  against the number of shards: peers registered and observed by the server send non-confirmable notifications,
+ *  read back from the event queue of the shards
+ *
+ *  Needs LWM2M_SERVER_MODE. The datagrams of the peers are handed to the shards in-process by a single receiving
+ *  thread, as the receive callback of the socket would, and those of the server are captured from its connections.
+ *
+ *  @date 10/19/2026
+ */
+
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+#include "../../common/fake_server.h"
+extern "C"
+{
+#include "server_shards.h"
+}
+#include <stdio.h>
+#include <atomic>
+
+using namespace utest::v1;
+using namespace std::chrono;
+
+#define PEER_COUNT 16
+#define NOTIFY_COUNT 500
+// Notifications sent and not read yet, no more than the event queue holds
+#define WINDOW SERVER_SHARDS_QUEUE_SIZE
+#define EVENT_TIMEOUT_MS 2000
+#define THREAD_STACK_SIZE 4096
+
+#if defined(LWM2M_SERVER_MODE)
+struct Peer
+{
+    ns_address_t addr;
+    uint8_t shard;
+    uint16_t clientID;
+    uint16_t mid;
+    // Token of the observation made by the server
+    uint8_t token[COAP_TOKEN_LEN];
+    uint8_t tokenLen;
+    uint16_t observeMid;
+};
+
+static server_shards_t shards;
+static Peer peers[PEER_COUNT];
+static Semaphore observed(0);
+static std::atomic<uint32_t> notifiedCount;
+static std::atomic<uint32_t> readCount;
+
+static Peer *findPeer(ns_address_t const *addr)
+{
+    for (Peer &peer : peers)
+    {
+        if (memcmp(peer.addr.address, addr->address, sizeof(peer.addr.address)) == 0)
+            return &peer;
+    }
+    return nullptr;
+}
+
+// Called from the thread of the shard of the peer
+static int capturePeerSend(const uint8_t *buffer, size_t length, void *connP)
+{
+    Peer *peer = findPeer(&((connection_t *)connP)->addr);
+    coap_packet_t packet[1];
+    uint8_t *token;
+
+    if (peer == nullptr || coap_parse_message(packet, (uint8_t *)buffer, length) != NO_ERROR)
+        return -1;
+
+    if (packet->code == COAP_GET)
+    {
+        peer->tokenLen = coap_get_header_token(packet, &token);
+        memcpy(peer->token, token, peer->tokenLen);
+        peer->observeMid = packet->mid;
+        observed.release();
+    }
+    coap_free_header(packet);
+
+    return (int)length;
+}
+
+static void receive(Peer *peer, coap_packet_t *packet)
+{
+    uint8_t buffer[128];
+    size_t length = coap_serialize_message(packet, buffer);
+
+    coap_free_header(packet);
+    // The queue of the shard is full: retried once its thread made room
+    while (server_shards_handle_packet(&shards, &peer->addr, buffer, length) != 0)
+        ThisThread::sleep_for(1ms);
+}
+
+static void registerPeer(Peer *peer, int index)
+{
+    coap_packet_t request[1];
+    char query[48];
+    const char links[] = "</3311/0>";
+
+    snprintf(query, sizeof(query), "ep=peer%d&lt=86400&lwm2m=%s&b=U", index,
+#if defined(LWM2M_VERSION_1_0)
+             "1.0");
+#else
+             "1.1");
+#endif
+    coap_init_message(request, COAP_TYPE_CON, COAP_POST, peer->mid++);
+    coap_set_header_uri_path(request, "/rd");
+    coap_set_header_uri_query(request, query);
+    coap_set_header_content_type(request, LWM2M_CONTENT_LINK);
+    coap_set_payload(request, links, sizeof(links) - 1);
+    receive(peer, request);
+}
+
+static void notify(Peer *peer, uint32_t count)
+{
+    coap_packet_t notification[1];
+    char payload[12];
+    int length = snprintf(payload, sizeof(payload), "%u", (unsigned)count);
+
+    coap_init_message(notification, count == 0 ? COAP_TYPE_ACK : COAP_TYPE_NON, COAP_205_CONTENT,
+                      count == 0 ? peer->observeMid : peer->mid++);
+    coap_set_header_token(notification, peer->token, peer->tokenLen);
+    coap_set_header_observe(notification, count);
+    coap_set_header_content_type(notification, LWM2M_CONTENT_TEXT);
+    coap_set_payload(notification, payload, length);
+    receive(peer, notification);
+}
+
+static bool readEvent(server_shard_event_type_t type, server_shard_event_t *eventP)
+{
+    uint32_t timeout = (uint32_t)(EVENT_TIMEOUT_MS * osKernelGetTickFreq() / 1000);
+
+    if (!server_shards_get_event(&shards, eventP, timeout))
+        return false;
+    server_shards_event_free(eventP);
+    return eventP->type == type;
+}
+
+static void produce()
+{
+    for (uint32_t count = 1; count <= NOTIFY_COUNT; ++count)
+    {
+        for (Peer &peer : peers)
+        {
+            while (notifiedCount - readCount >= WINDOW)
+                ThisThread::yield();
+            notify(&peer, count);
+            notifiedCount++;
+        }
+    }
+}
+
+static void setupPeers()
+{
+    memset(peers, 0, sizeof(peers));
+    for (int i = 0; i < PEER_COUNT; ++i)
+    {
+        // fd00::<i + 1>, the shard is chosen from the address only
+        peers[i].addr.type = ADDRESS_IPV6;
+        peers[i].addr.address[0] = 0xFD;
+        peers[i].addr.address[15] = (uint8_t)(i + 1);
+        peers[i].addr.identifier = LWM2M_STANDARD_PORT;
+        peers[i].mid = 1;
+    }
+}
+
+// Notifications read per second, or 0 when one of them went missing
+static uint32_t measure(uint8_t shardCount)
+{
+    server_shard_event_t event;
+    lwm2m_uri_t uri;
+    Timer timer;
+    Thread producer(osPriorityNormal, THREAD_STACK_SIZE, nullptr, "peerThread");
+    uint32_t total = PEER_COUNT * NOTIFY_COUNT;
+
+    setupPeers();
+    // Nothing is sent on the socket: the connections are captured once the peers are registered
+    TEST_ASSERT_EQUAL(0, server_shards_start(&shards, shardCount, -1));
+
+    for (int i = 0; i < PEER_COUNT; ++i)
+    {
+        registerPeer(&peers[i], i);
+        TEST_ASSERT_TRUE(readEvent(SERVER_SHARD_EVENT_MONITOR, &event));
+        TEST_ASSERT_EQUAL(COAP_201_CREATED, event.status);
+        peers[i].shard = event.shard;
+        peers[i].clientID = event.clientID;
+    }
+
+    LWM2M_URI_RESET(&uri);
+    uri.objectId = OBJECT_ID;
+    uri.instanceId = 0;
+    uri.resourceId = DIMMER_ID;
+    for (Peer &peer : peers)
+    {
+        lwm2m_context_t *contextP = server_shards_lock(&shards, peer.shard);
+        connection_t *connP = connectionlayer_find_connection(shards.shards[peer.shard].connLayer, &peer.addr);
+
+        TEST_ASSERT_NOT_NULL(connP);
+        connP->sendFunc = capturePeerSend;
+#ifdef LWM2M_VECTORED_SEND
+        connP->sendvFunc = NULL;
+#endif
+        TEST_ASSERT_EQUAL(COAP_NO_ERROR, lwm2m_observe(contextP, peer.clientID, &uri, server_shards_result_callback, &peer));
+        server_shards_unlock(&shards, peer.shard);
+    }
+    for (int i = 0; i < PEER_COUNT; ++i)
+        TEST_ASSERT_TRUE(observed.try_acquire_for(milliseconds(EVENT_TIMEOUT_MS)));
+
+    // The responses to the observations are the first results
+    for (Peer &peer : peers)
+    {
+        notify(&peer, 0);
+        TEST_ASSERT_TRUE(readEvent(SERVER_SHARD_EVENT_RESULT, &event));
+        TEST_ASSERT_EQUAL_PTR(&peer, event.userData);
+    }
+
+    notifiedCount = 0;
+    readCount = 0;
+    timer.start();
+    producer.start(callback(produce));
+    while (readCount < total && readEvent(SERVER_SHARD_EVENT_RESULT, &event))
+        readCount++;
+    timer.stop();
+    producer.join();
+
+    server_shards_stop(&shards);
+
+    long long elapsed = duration_cast<microseconds>(timer.elapsed_time()).count();
+    if (readCount < total || elapsed == 0)
+        return 0;
+    return (uint32_t)(total * 1000000LL / elapsed);
+}
+#endif
+
+static control_t notificationThroughput(){
+#if defined(LWM2M_SERVER_MODE)
+    for (uint8_t shardCount = 1; shardCount <= SERVER_SHARDS_MAX; shardCount *= 2)
+    {
+        uint32_t rate = measure(shardCount);
+
+        utest_printf("%d shards: %u notifications/s\n", shardCount, (unsigned)rate);
+        TEST_ASSERT_NOT_EQUAL(0, rate);
+    }
+#else
+    TEST_IGNORE_MESSAGE("Server mode is disabled");
+#endif
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (120s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(120, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] = {
+    Case("Notification throughput against the number of shards", notificationThroughput)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
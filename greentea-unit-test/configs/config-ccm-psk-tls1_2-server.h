@@ -0,0 +1,11 @@
+/**
+ * \file config-ccm-psk-tls1_2-server.h
+ *
+ * \brief Configuration of the DTLS tests: the Client configuration, with the mbedTLS server and its session cache
+ * ending the sessions of the Client in-process
+ */
+
+#include "config-ccm-psk-tls1_2.h"
+
+#define MBEDTLS_SSL_SRV_C
+#define MBEDTLS_SSL_CACHE_C
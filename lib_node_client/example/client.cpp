@@ -91,6 +91,10 @@ int main(int argc, char *argv[])
 
     NodeClient client = { objects, nullptr, M2M_SERVER_URL, SERVER_DTLS_PORT, CLIENT_KEYSTR, CLIENT_ENDPOINT_NAME, CLIENT_IDENTITY };
 
+    // The callbacks printing on the console run on their own thread, not on the LwM2M one
+    static ListenerQueue listenerQueue;
+    client.SetListenerQueue(&listenerQueue);
+
     client.InitNetwork();
     client.StartClient();
     return 0;
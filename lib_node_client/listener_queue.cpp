@@ -0,0 +1,87 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file listener_queue.cpp
+ *  @brief This source file contain the definition of the ListenerQueue class.
+ *
+ *  @author Bastien Pillonel <bastien.pillonel@heig-vd.ch>
+ *
+ */
+
+#include "listener_queue.h"
+
+// The event header and the Job, rounded up as equeue_alloc() does
+const size_t ListenerQueue::_jobEventSize = (EQUEUE_EVENT_SIZE - 2 * sizeof(void *)) + ((sizeof(ListenerQueue::Job) + sizeof(void *) - 1) & ~(sizeof(void *) - 1));
+
+ListenerQueue::ListenerQueue(size_t capacity, osPriority priority, uint32_t stackSize) : _capacity(capacity), _queue(capacity * _jobEventSize), _worker(priority, stackSize, nullptr, "listenerQueue")
+{
+    _worker.start(callback(&_queue, &EventQueue::dispatch_forever));
+}
+
+ListenerQueue::~ListenerQueue()
+{
+    _queue.break_dispatch();
+    _worker.join();
+}
+
+bool ListenerQueue::Post(std::function<void()> job)
+{
+    _statsMutex.lock();
+    // Counted before the call, the worker may run the job before call() returns
+    if (_stats.pending >= _capacity)
+    {
+        _stats.dropped++;
+        _statsMutex.unlock();
+        return false;
+    }
+    _stats.pending++;
+    if (_stats.pending > _stats.maxPending)
+        _stats.maxPending = _stats.pending;
+    _statsMutex.unlock();
+
+    bool queued = _queue.call(Job{ this, std::move(job) }) != 0;
+
+    _statsMutex.lock();
+    if (queued)
+    {
+        _stats.posted++;
+    }
+    else
+    {
+        // Out of event memory
+        _stats.pending--;
+        _stats.dropped++;
+    }
+    _statsMutex.unlock();
+
+    return queued;
+}
+
+ListenerQueueStats ListenerQueue::GetStats() const
+{
+    _statsMutex.lock();
+    ListenerQueueStats stats = _stats;
+    _statsMutex.unlock();
+
+    return stats;
+}
+
+void ListenerQueue::ResetStats()
+{
+    _statsMutex.lock();
+    _stats.posted = 0;
+    _stats.executed = 0;
+    _stats.dropped = 0;
+    _stats.maxPending = _stats.pending;
+    _statsMutex.unlock();
+}
+
+void ListenerQueue::_run(std::function<void()> job)
+{
+    job();
+
+    _statsMutex.lock();
+    _stats.pending--;
+    _stats.executed++;
+    _statsMutex.unlock();
+}
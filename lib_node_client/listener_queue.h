@@ -0,0 +1,122 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file listener_queue.h
+ *  @brief This header file contain the declaration of the ListenerQueue class, a bounded queue of listener invocations
+ *  drained by an application thread so that the callbacks of the resources never run on the LwM2M thread.
+ *
+ *  @author Bastien Pillonel <bastien.pillonel@heig-vd.ch>
+ *
+ */
+
+#ifndef LISTENER_QUEUE_H
+#define LISTENER_QUEUE_H
+
+#include <functional>
+#include <stdint.h>
+
+#include "mbed.h"
+
+#define LISTENER_QUEUE_CAPACITY 16
+
+/**
+ * @brief Backpressure metrics of a ListenerQueue
+ *
+ */
+struct ListenerQueueStats
+{
+    uint32_t posted;     // invocations accepted by the queue
+    uint32_t executed;   // invocations run by the worker thread
+    uint32_t dropped;    // invocations refused because the queue was full
+    uint32_t pending;    // invocations waiting to run
+    uint32_t maxPending; // highest number of invocations waiting at once
+};
+
+/**
+ * @brief Bounded queue of listener invocations, drained in posting order by a worker thread it owns.
+ *
+ * The thread posting an invocation never waits for the application: when the queue holds capacity invocations, the new
+ * one is dropped and counted.
+ *
+ */
+class ListenerQueue
+{
+public:
+    /**
+     * @brief Construct a new Listener Queue object and start its worker thread
+     *
+     * @param capacity maximum number of invocations waiting to run
+     * @param priority priority of the worker thread
+     * @param stackSize stack size of the worker thread, the listeners run on this stack
+     */
+    ListenerQueue(size_t capacity = LISTENER_QUEUE_CAPACITY, osPriority priority = osPriorityBelowNormal, uint32_t stackSize = OS_STACK_SIZE);
+
+    ListenerQueue(const ListenerQueue &) = delete;
+    ListenerQueue &operator=(const ListenerQueue &) = delete;
+
+    /**
+     * @brief Destroy the Listener Queue object, the invocations still waiting are discarded
+     *
+     */
+    ~ListenerQueue();
+
+    /**
+     * @brief Queue an invocation, may be called from any thread
+     *
+     * @param job invocation to run on the worker thread
+     * @return true the invocation is queued
+     * @return false the queue is full, the invocation is dropped
+     */
+    bool Post(std::function<void()> job);
+
+    /**
+     * @brief Get the backpressure metrics
+     *
+     * @return ListenerQueueStats
+     */
+    ListenerQueueStats GetStats() const;
+
+    /**
+     * @brief Reset the counters, pending is kept and maxPending restarts from it
+     *
+     */
+    void ResetStats();
+
+    /**
+     * @brief Get the maximum number of invocations waiting to run
+     *
+     * @return size_t
+     */
+    size_t GetCapacity() const { return _capacity; }
+
+private:
+    /**
+     * @brief Invocation stored in the event queue, its size sets the room allocated for the queue
+     *
+     */
+    struct Job
+    {
+        ListenerQueue *owner;
+        std::function<void()> function;
+
+        void operator()() { (*owner)._run(std::move(function)); }
+    };
+
+    // Room taken by an invocation in the event queue
+    static const size_t _jobEventSize;
+
+    size_t _capacity;
+    EventQueue _queue;
+    Thread _worker;
+    mutable Mutex _statsMutex;
+    ListenerQueueStats _stats = {};
+
+    /**
+     * @brief Run an invocation on the worker thread
+     *
+     * @param job invocation posted
+     */
+    void _run(std::function<void()> job);
+};
+
+#endif
@@ -31,8 +31,9 @@
 
 #include "node_client.h"
 
-client_data_t data;
-lwm2m_context_t *lwm2mH = NULL;
+std::vector<NodeClient *> NodeClient::_startedClients;
+Mutex NodeClient::_startedClientsMutex;
+ConditionVariable NodeClient::_dispatchDone(NodeClient::_startedClientsMutex);
 
 int NodeClient::InitNetwork()
 {
@@ -204,15 +205,14 @@ void NodeClient::_printstate(lwm2m_context_t *lwm2mH)
 
 int NodeClient::StartClient()
 {
-    // Ensure only one client instance is started 
-    static bool clientStarted = false;
-    if (clientStarted == true)
+    // Ensure this client instance is started only once
+    if (_started == true)
         return -1;
-    clientStarted = true;
+    _started = true;
 
     lwm2m_object_t **objArray = new lwm2m_object_t * [_objects->size() + 1];
-    memset(&data, 0, sizeof(client_data_t));
-    data.addressFamily = ADDRESS_IPV6;
+    memset(&_data, 0, sizeof(client_data_t));
+    _data.addressFamily = ADDRESS_IPV6;
     int result;
 
 #ifdef USE_DTLS
@@ -229,9 +229,9 @@ int NodeClient::StartClient()
     char *pskBuffer = NULL;
 #endif
 
-    fprintf(stderr, "Trying to bind LWM2M Client to port %d\r\n", CLIENT_LOCAL_PORT);
-    data.sock = create_socket(CLIENT_LOCAL_PORT, data.addressFamily);
-    if (data.sock < 0)
+    fprintf(stderr, "Trying to bind LWM2M Client to port %d\r\n", _localPort);
+    _data.sock = create_socket(_localPort, _data.addressFamily);
+    if (_data.sock < 0)
     {
         fprintf(stderr, "Failed to open socket: %d %s\r\n", errno, strerror(errno));
         return -1;
@@ -278,7 +278,10 @@ int NodeClient::StartClient()
 
     // Get object security from object_security.c file 
     objArray[0] = get_security_object(serverId, serverUri, pskId, pskBuffer, pskLen, false);
-    data.securityObjP = objArray[0];
+    _data.securityObjP = objArray[0];
+#if defined(LWM2M_SUPPORT_OSCORE)
+    set_security_oscore_instance(objArray[0], 0, _oscoreInstanceId);
+#endif
 
     // Get object from NodeObject instance stored in the client
     for (unsigned long i = 0; i < _objects->size(); ++i)
@@ -289,30 +292,52 @@ int NodeClient::StartClient()
             fprintf(stderr, "Failed to create object %lu\r\n", i);
             return -1;
         }
+#if defined(LWM2M_RESPONSE_CACHE)
+        objArray[i + 1]->cacheable = std::find(_cacheableObjects.begin(), _cacheableObjects.end(), objArray[i + 1]->objID) != _cacheableObjects.end();
+#endif
     }
 
     // Init connection context structure
     printf("lwm2m_init\n");
-    lwm2mH = lwm2m_init(&data);
-    if (NULL == lwm2mH)
+    _lwm2mH = lwm2m_init(&_data);
+    if (NULL == _lwm2mH)
     {
         fprintf(stderr, "lwm2m_init() failed\r\n");
         return -1;
     }
 
-    data.ctx = lwm2mH;
-    data.connLayer = connectionlayer_create(lwm2mH);
+    _data.ctx = _lwm2mH;
+    _data.connLayer = connectionlayer_create(_lwm2mH);
+#if defined(LWM2M_RESPONSE_CACHE)
+    if (!_cacheableObjects.empty())
+        lwm2m_set_cache_seed(_lwm2mH, _cacheSeed);
+#endif
+#if defined(LWM2M_SUPPORT_OSCORE)
+    _ssnStorage = {_loadSsnCppWrap, _storeSsnCppWrap, this};
+    oscoreconnection_set_ssn_storage(_data.connLayer, &_ssnStorage);
+#endif
+#if defined(USE_DTLS)
+    _dtlsStorage = {_loadDtlsSessionCppWrap, _storeDtlsSessionCppWrap, this};
+    dtlsconnection_set_session_storage(_data.connLayer, &_dtlsStorage);
+#endif
 
     printf("lwm2m_configure\n");
-    result = lwm2m_configure(lwm2mH, _endpointName, NULL, NULL, _objects->size() + 1, objArray);
+    result = lwm2m_configure(_lwm2mH, _endpointName, NULL, NULL, _objects->size() + 1, objArray);
     if (result != 0)
     {
         fprintf(stderr, "lwm2m_configure() failed: 0x%X\r\n", result);
         return -1;
     }
-    fprintf(stdout, "LWM2M Client \"%s\" started on port %d.\r\nUse Ctrl-C to exit.\r\n\n", _endpointName, CLIENT_LOCAL_PORT);
+#if defined(LWM2M_QUEUE_MODE)
+    lwm2m_set_queue_mode(_lwm2mH, _queueAwakeTime);
+#endif
+    fprintf(stdout, "LWM2M Client \"%s\" started on port %d.\r\nUse Ctrl-C to exit.\r\n\n", _endpointName, _localPort);
+
+    _startedClientsMutex.lock();
+    _startedClients.push_back(this);
+    _startedClientsMutex.unlock();
 
-    lwm2mMainThread.start(&NodeClient::_lwm2mMainThreadTask);
+    _lwm2mMainThread.start(callback(this, &NodeClient::_lwm2mMainThreadTask));
 
     while (1)
     {
@@ -320,7 +345,7 @@ int NodeClient::StartClient()
     }
 
     delete objArray;
-    clientStarted = false;
+    _started = false;
 
     return 0;
 }
@@ -334,7 +359,9 @@ void NodeClient::_lwm2mMainThreadTask()
         tv.tv_sec = 60;
         tv.tv_usec = 0;
 
-        NodeClient::_printstate(lwm2mH);
+        _lwm2mMutex.lock();
+
+        NodeClient::_printstate(_lwm2mH);
 
         /*
          * This function does two things:
@@ -342,30 +369,109 @@ void NodeClient::_lwm2mMainThreadTask()
          *  - Secondly it adjusts the timeout value (default 60s) depending on the state of the transaction
          *    (eg. retransmission) and the time before the next operation
          */
-        int result = lwm2m_step(lwm2mH, &(tv.tv_sec));
+        int result = lwm2m_step(_lwm2mH, &(tv.tv_sec));
+        uint32_t timeoutMs = (uint32_t)tv.tv_sec * 1000;
+#if defined(USE_DTLS)
+        // Retransmit the DTLS handshake flights on time and wake up for the next one
+        dtlsconnection_step(_data.connLayer, &timeoutMs);
+#endif
+#if defined(LWM2M_QUEUE_MODE)
+        time_t nextWakeup = 0;
+        bool sleeping = lwm2m_queue_is_sleeping(_lwm2mH, &nextWakeup);
+        time_t wakeupDelay = sleeping ? nextWakeup - lwm2m_gettime() : 0;
+#endif
+        _stepTimeSeries(&timeoutMs);
+        _lwm2mMutex.unlock();
         if (result != 0)
         {
             fprintf(stderr, "lwm2m_step() failed: 0x%X\r\n", result);
         }
-        ThisThread::flags_wait_any_for(0x1, std::chrono::seconds(tv.tv_sec));
+#if defined(LWM2M_QUEUE_MODE)
+        // Report the transitions only, the application powers the radio down and up
+        if (sleeping != _sleeping)
+        {
+            _sleeping = sleeping;
+            printf("lwm2m client %s\n", sleeping ? "sleeping" : "awake");
+            if (_queueCallback)
+            {
+                _queueCallback(sleeping, wakeupDelay);
+            }
+        }
+#endif
+        ThisThread::flags_wait_any_for(0x1, std::chrono::milliseconds(timeoutMs));
     }
 }
 
-void NodeClient::Lwm2mHandleIncomingSocketDataCppWrap(ns_address_t *addr, uint8_t *buf, size_t len)
+void NodeClient::Lwm2mHandleIncomingSocketDataCppWrap(int sock, ns_address_t *addr, uint8_t *buf, size_t len)
 {
+    NodeClient *client = nullptr;
+
     printf("New packet arrived !\n");
-    if (connectionlayer_handle_packet(data.connLayer, addr, buf, len) == -1)
+
+    _startedClientsMutex.lock();
+    for (NodeClient *candidate : _startedClients)
+    {
+        if (candidate->_data.sock == sock)
+        {
+            client = candidate;
+            break;
+        }
+    }
+
+    if (client == nullptr)
+    {
+        fprintf(stderr, "received bytes on unknown socket ignored!\r\n");
+        _startedClientsMutex.unlock();
+        return;
+    }
+    // Not destroyed before the dispatch ends, other clients are dispatched meanwhile
+    client->_dispatching++;
+    _startedClientsMutex.unlock();
+
+    client->_lwm2mMutex.lock();
+    int result;
+    {
+        // Asynchronous callbacks of the resources get tokens completed through this client
+        ResponseToken::Scope scope(client, client->_lwm2mH);
+        result = connectionlayer_handle_packet(client->_data.connLayer, addr, buf, len);
+    }
+    client->_lwm2mMutex.unlock();
+    if (result == -1)
     {
         // This packet comes from an unknown peer
         fprintf(stderr, "received bytes ignored!\r\n");
     }
 
-    lwm2mMainThreadTimeoutTimer.detach();
-    lwm2mMainThread.flags_set(0x1);
+    client->_lwm2mMainThread.flags_set(0x1);
+
+    _startedClientsMutex.lock();
+    if (--client->_dispatching == 0)
+        _dispatchDone.notify_all();
+    _startedClientsMutex.unlock();
 }
 
 NodeClient::~NodeClient()
 {
+    _startedClientsMutex.lock();
+    for (auto it = _startedClients.begin(); it != _startedClients.end(); ++it)
+    {
+        if (*it == this)
+        {
+            _startedClients.erase(it);
+            break;
+        }
+    }
+    // No packet is dispatched to this client anymore once the current ones are handled
+    while (_dispatching > 0)
+        _dispatchDone.wait();
+    _startedClientsMutex.unlock();
+
+    for (TimeSeriesBase *series : _timeSeries)
+    {
+        (*series).SetDueCallback(nullptr);
+        (*series).SetResourceMutex(nullptr);
+    }
+
     for (NodeObject *object : *_objects)
     {
         delete object;
@@ -400,14 +506,223 @@ void NodeClient::SetClientIdentity(char *clientIdentity) {
     _clientIdentity = clientIdentity;
 }
 
-void lwm2m_main_thread_timeout_timer_cb()
-{
-    lwm2mMainThread.flags_set(0x1);
+void NodeClient::SetLocalPort(uint16_t localPort) {
+    _localPort = localPort;
+}
+
+void NodeClient::SetOscoreInstance(uint16_t oscoreInstanceId) {
+    _oscoreInstanceId = oscoreInstanceId;
+}
+
+void NodeClient::SetOscoreSsnStorage(Callback<int(uint16_t oscoreInstance, uint64_t *ssn)> load, Callback<int(uint16_t oscoreInstance, uint64_t ssn)> store) {
+    _ssnLoad = load;
+    _ssnStore = store;
+}
+
+int NodeClient::_loadSsnCppWrap(uint16_t oscoreInstance, uint64_t *ssn, void *userData) {
+    NodeClient *client = (NodeClient *)userData;
+
+    if (!(*client)._ssnLoad)
+        return -1;
+    return (*client)._ssnLoad(oscoreInstance, ssn);
+}
+
+int NodeClient::_storeSsnCppWrap(uint16_t oscoreInstance, uint64_t ssn, void *userData) {
+    NodeClient *client = (NodeClient *)userData;
+
+    if (!(*client)._ssnStore)
+        return -1;
+    return (*client)._ssnStore(oscoreInstance, ssn);
+}
+
+void NodeClient::SetDtlsSessionStorage(Callback<int(uint16_t securityInstance, uint8_t *buffer, size_t length, size_t *outLength)> load, Callback<int(uint16_t securityInstance, const uint8_t *buffer, size_t length)> store) {
+    _dtlsLoad = load;
+    _dtlsStore = store;
+}
+
+int NodeClient::_loadDtlsSessionCppWrap(uint16_t securityInstance, uint8_t *buffer, size_t length, size_t *outLength, void *userData) {
+    NodeClient *client = (NodeClient *)userData;
+
+    // Nothing stored: full handshake
+    if (!(*client)._dtlsLoad)
+    {
+        *outLength = 0;
+        return 0;
+    }
+    return (*client)._dtlsLoad(securityInstance, buffer, length, outLength);
+}
+
+int NodeClient::_storeDtlsSessionCppWrap(uint16_t securityInstance, const uint8_t *buffer, size_t length, void *userData) {
+    NodeClient *client = (NodeClient *)userData;
+
+    if (!(*client)._dtlsStore)
+        return 0;
+    return (*client)._dtlsStore(securityInstance, buffer, length);
 }
 
-extern "C" void lwm2m_handle_incoming_socket_data(ns_address_t *addr, uint8_t *buf, size_t len)
+void NodeClient::SetQueueMode(time_t awakeTime, Callback<void(bool sleeping, time_t wakeupDelay)> callback) {
+    _queueAwakeTime = awakeTime;
+    _queueCallback = callback;
+}
+
+void NodeClient::SetCacheableObjects(const std::vector<uint16_t> &objectIds, uint32_t etagSeed) {
+    _cacheableObjects = objectIds;
+    _cacheSeed = etagSeed;
+}
+
+void NodeClient::SetListenerQueue(ListenerQueue *queue) {
+    // Resources are read by the main thread for the notifications
+    _lwm2mMutex.lock();
+    for (NodeObject *object : *_objects)
+    {
+        (*object).SetListenerQueue(queue);
+    }
+    _lwm2mMutex.unlock();
+}
+
+void NodeClient::Wakeup() {
+#if defined(LWM2M_QUEUE_MODE)
+    _lwm2mMutex.lock();
+    if (_lwm2mH != nullptr)
+    {
+        lwm2m_queue_wakeup(_lwm2mH);
+    }
+    _lwm2mMutex.unlock();
+    _lwm2mMainThread.flags_set(0x1);
+#endif
+}
+
+int NodeClient::CompleteResponse(lwm2m_context_t *contextP, int responseId, uint8_t status) {
+#if defined(LWM2M_SEPARATE_RESPONSE)
+    int result = COAP_404_NOT_FOUND;
+
+    // The mutex is recursive, a callback may complete its token before returning
+    _lwm2mMutex.lock();
+    if (_lwm2mH != nullptr && contextP == _lwm2mH)
+    {
+        result = lwm2m_complete_response(_lwm2mH, responseId, status);
+    }
+    _lwm2mMutex.unlock();
+
+    // Let the main thread schedule the retransmissions of the response
+    _lwm2mMainThread.flags_set(0x1);
+    return result;
+#else
+    return COAP_404_NOT_FOUND;
+#endif
+}
+
+void NodeClient::AddTimeSeries(TimeSeriesBase *series) {
+    _lwm2mMutex.lock();
+    _timeSeries.push_back(series);
+    _lwm2mMutex.unlock();
+
+    // A series full or too big for another sample is uploaded without waiting for the next step
+    (*series).SetDueCallback(callback(this, &NodeClient::_timeSeriesDue));
+    // The resource is not updated while the context reads it
+    (*series).SetResourceMutex(&_lwm2mMutex);
+}
+
+void NodeClient::RemoveTimeSeries(TimeSeriesBase *series) {
+    (*series).SetDueCallback(nullptr);
+    (*series).SetResourceMutex(nullptr);
+
+    _lwm2mMutex.lock();
+    _timeSeries.erase(std::remove(_timeSeries.begin(), _timeSeries.end(), series), _timeSeries.end());
+    _lwm2mMutex.unlock();
+}
+
+void NodeClient::FlushTimeSeries(TimeSeriesBase *series) {
+    _lwm2mMutex.lock();
+    if (_lwm2mH != nullptr)
+    {
+        _uploadTimeSeries(series, time(nullptr));
+    }
+    _lwm2mMutex.unlock();
+
+    // Let the main thread schedule the retransmissions of a Send
+    _lwm2mMainThread.flags_set(0x1);
+}
+
+void NodeClient::_timeSeriesDue() {
+    _lwm2mMainThread.flags_set(0x1);
+}
+
+void NodeClient::_stepTimeSeries(uint32_t *timeoutMs) {
+    time_t now = time(nullptr);
+
+    for (TimeSeriesBase *series : _timeSeries)
+    {
+        time_t delay = -1;
+
+        if ((*series).FlushDue(now, &delay))
+        {
+            _uploadTimeSeries(series, now);
+        }
+        else if (delay >= 0 && (uint32_t)delay * 1000 < *timeoutMs)
+        {
+            *timeoutMs = (uint32_t)delay * 1000;
+        }
+    }
+}
+
+void NodeClient::_uploadTimeSeries(TimeSeriesBase *series, time_t now) {
+#if defined(LWM2M_SUPPORT_SENML_JSON)
+    size_t maxSize = (*series).GetMaxPackSize();
+    lwm2m_uri_t uri = (*series).GetUri();
+    // One buffer for every pack, the samples recorded meanwhile wait for the next upload
+    uint8_t *pack = (uint8_t *)lwm2m_malloc(maxSize);
+
+    if (pack == nullptr)
+    {
+        (*series).Retry(now);
+        return;
+    }
+
+    for (size_t packs = 0; packs < (*series).Capacity() && (*series).Size() > 0; ++packs)
+    {
+        uint32_t end;
+        int length = (*series).BuildPack(pack, maxSize, &end);
+        int result;
+
+        if (length <= 0)
+        {
+            fprintf(stderr, "time series sample does not fit in %u bytes\r\n", (unsigned)maxSize);
+            (*series).Retry(now);
+            break;
+        }
+
+        if ((*series).GetTransport() == TimeSeriesTransport::SEND)
+        {
+#if defined(LWM2M_SUPPORT_COMPOSITE)
+            result = lwm2m_send_pack(_lwm2mH, 0, pack, length, nullptr, nullptr);
+#else
+            result = COAP_501_NOT_IMPLEMENTED;
+#endif
+        }
+        else
+        {
+            result = lwm2m_notify_pack(_lwm2mH, &uri, pack, length);
+        }
+
+        if (result != COAP_NO_ERROR)
+        {
+            // Not observed yet, not registered or asleep: the samples are kept
+            (*series).Retry(now);
+            break;
+        }
+        (*series).Release(end);
+    }
+
+    lwm2m_free(pack);
+#else
+    (*series).Retry(now);
+#endif
+}
+
+extern "C" void lwm2m_handle_incoming_socket_data(int sock, ns_address_t *addr, uint8_t *buf, size_t len)
 {
-    NodeClient::Lwm2mHandleIncomingSocketDataCppWrap(addr, buf, len);
+    NodeClient::Lwm2mHandleIncomingSocketDataCppWrap(sock, addr, buf, len);
 }
 
 /**
@@ -466,14 +781,26 @@ void *lwm2m_connect_server(uint16_t secObjInstID,
     *port = 0;
     port++;
 
+#if defined(LWM2M_SUPPORT_OSCORE)
+    uint16_t oscoreInstID;
+    if (security_get_oscore_instance(dataP->connLayer->ctx, secObjInstID, &oscoreInstID))
+    {
+        // Create connection protected with OSCORE, never falling back to a weaker mode
+        newConnP = oscoreconnection_create(dataP->connLayer, secObjInstID, dataP->sock, host, port,
+            dataP->addressFamily);
+    }
+    else
+#endif
+    {
 #if defined(USE_DTLS)
-    // Create connection with dtls use
-    newConnP = (connection_t *)dtlsconnection_create(dataP->connLayer, secObjInstID, dataP->sock, host, port,
-        dataP->addressFamily);
+        // Create connection with dtls use
+        newConnP = (connection_t *)dtlsconnection_create(dataP->connLayer, secObjInstID, dataP->sock, host, port,
+            dataP->addressFamily);
 #else
-    // Create connection without dtls
-    newConnP = connection_create(dataP->connLayer, dataP->sock, host, port, dataP->addressFamily);
+        // Create connection without dtls
+        newConnP = connection_create(dataP->connLayer, dataP->sock, host, port, dataP->addressFamily);
 #endif
+    }
 
     if (newConnP == NULL)
     {
@@ -504,24 +831,11 @@ void lwm2m_close_connection(void *sessionH,
     app_data = (client_data_t *)userData;
     targetP = (connection_t *)sessionH;
 
-    if (targetP == app_data->connList)
-    {
-        app_data->connList = targetP->next;
-        lwm2m_free(targetP);
-    }
-    else
-    {
-        connection_t *parentP;
+    if (targetP == NULL)
+        return;
 
-        parentP = app_data->connList;
-        while (parentP != NULL && parentP->next != targetP)
-        {
-            parentP = parentP->next;
-        }
-        if (parentP != NULL)
-        {
-            parentP->next = targetP->next;
-            lwm2m_free(targetP);
-        }
-    }
+    // Unlinked from the list of the connection layer, the one walked by its step and receive functions, then
+    // released once with its DTLS or OSCORE state
+    connectionlayer_free_connection(app_data->connLayer, targetP);
+    app_data->connList = app_data->connLayer->connList;
 }
@@ -37,6 +37,9 @@
 
 #include "mbed.h"
 #include "node_object.h"
+#include "response_token.h"
+#include "listener_queue.h"
+#include "time_series.h"
 #include "NetworkInterface.h"
 #include "EthernetInterface.h"
 #include "UDPSocket.h"
@@ -52,18 +55,20 @@ extern "C"
 #if defined(USE_DTLS)
 #include "dtlsconnection.h"
 #endif
+#if defined(LWM2M_SUPPORT_OSCORE)
+#include "oscoreconnection.h"
+#endif
 #include "object_utils.h"
 
 #define CLIENT_LOCAL_PORT 0 // Let OS decide
+#define CLIENT_QUEUE_AWAKE_TIME 93 // MAX_TRANSMIT_WAIT, recommended awake time in queue mode
 
     lwm2m_object_t *get_security_object(int serverId, const char *serverUri, char *bsPskId, char *psk, uint16_t pskLen, bool isBootstrap);
     extern void free_security_object(lwm2m_object_t *objectP);
     extern char *get_server_uri(lwm2m_object_t *objectP, uint16_t secObjInstID);
+    extern void set_security_oscore_instance(lwm2m_object_t *objectP, uint16_t secObjInstID, uint16_t oscoreInstanceId);
 }
 
-static Thread lwm2mMainThread(osPriorityNormal, OS_STACK_SIZE, nullptr, "lwm2mMainThread");
-static Timeout lwm2mMainThreadTimeoutTimer;
-
 typedef struct
 {
     lwm2m_object_t *securityObjP;
@@ -76,9 +81,10 @@ typedef struct
 
 /**
  * @brief NodeClient represent a LwM2M client storing every object and resource associated.
+ * It completes the ResponseToken given to asynchronous callbacks of its resources.
  *
  */
-class NodeClient
+class NodeClient : public ResponseCompleter
 {
 public:
     /**
@@ -92,14 +98,14 @@ public:
      *
      * @param src
      */
-    NodeClient(const NodeClient &src) : _objects(src._objects), _eth(src._eth), _url(src._url), _port(src._port), _clientKey(src._clientKey), _endpointName(src._endpointName), _clientIdentity(src._clientIdentity) {}
+    NodeClient(const NodeClient &src) : ResponseCompleter(), _objects(src._objects), _eth(src._eth), _url(src._url), _port(src._port), _clientKey(src._clientKey), _endpointName(src._endpointName), _clientIdentity(src._clientIdentity), _localPort(src._localPort), _oscoreInstanceId(src._oscoreInstanceId), _ssnLoad(src._ssnLoad), _ssnStore(src._ssnStore), _dtlsLoad(src._dtlsLoad), _dtlsStore(src._dtlsStore), _queueAwakeTime(src._queueAwakeTime), _queueCallback(src._queueCallback), _cacheableObjects(src._cacheableObjects), _cacheSeed(src._cacheSeed) {}
 
     /**
      * @brief Construct a new Node Client object by moving
      *
      * @param src
      */
-    NodeClient(NodeClient &&src) : _objects(std::move(src._objects)), _eth(src._eth), _url(src._url), _port(src._port), _clientKey(src._clientKey), _endpointName(src._endpointName), _clientIdentity(src._clientIdentity) {
+    NodeClient(NodeClient &&src) : ResponseCompleter(), _objects(std::move(src._objects)), _eth(src._eth), _url(src._url), _port(src._port), _clientKey(src._clientKey), _endpointName(src._endpointName), _clientIdentity(src._clientIdentity), _localPort(src._localPort), _oscoreInstanceId(src._oscoreInstanceId), _ssnLoad(src._ssnLoad), _ssnStore(src._ssnStore), _dtlsLoad(src._dtlsLoad), _dtlsStore(src._dtlsStore), _queueAwakeTime(src._queueAwakeTime), _queueCallback(src._queueCallback), _cacheableObjects(src._cacheableObjects), _cacheSeed(src._cacheSeed) {
         src._eth = nullptr;
         src._url = nullptr;
         src._port = nullptr;
@@ -150,13 +156,14 @@ public:
     int StartClient();
 
     /**
-     * @brief Wrapper for incoming packet handler function
+     * @brief Wrapper for incoming packet handler function, dispatches the packet to the client owning the socket
      *
+     * @param sock socket the packet was received on
      * @param addr address from incoming packet
      * @param buf payload
      * @param len payload length
      */
-    static void Lwm2mHandleIncomingSocketDataCppWrap(ns_address_t *addr, uint8_t *buf, size_t len);
+    static void Lwm2mHandleIncomingSocketDataCppWrap(int sock, ns_address_t *addr, uint8_t *buf, size_t len);
 
     /**
      * @brief Set the Objects attribute
@@ -207,6 +214,108 @@ public:
      */
     void SetClientIdentity(char *clientIdentity);
 
+    /**
+     * @brief Set the local port the socket of the client is bound to
+     *
+     * @param localPort UDP port, CLIENT_LOCAL_PORT (0) lets the stack pick a free one. Clients running side by side
+     * need distinct ports, a port already bound makes StartClient fail.
+     */
+    void SetLocalPort(uint16_t localPort);
+
+    /**
+     * @brief Protect the messages with OSCORE instead of DTLS (requires LWM2M_SUPPORT_OSCORE)
+     *
+     * @param oscoreInstanceId instance of the OSCORE object (21) holding the security context,
+     * the object must be part of the objects of the client
+     */
+    void SetOscoreInstance(uint16_t oscoreInstanceId);
+
+    /**
+     * @brief Persist the OSCORE Sender Sequence Numbers, required with SetOscoreInstance: without them no message is
+     * protected, as the numbers restarting from 0 at each boot would reuse nonces with the same keys
+     *
+     * @param load reads the last value stored for an OSCORE instance, 0 when nothing was stored yet, returns 0 on success
+     * @param store writes the value before the Sender Sequence Numbers below it are used, returns 0 on success
+     */
+    void SetOscoreSsnStorage(Callback<int(uint16_t oscoreInstance, uint64_t *ssn)> load, Callback<int(uint16_t oscoreInstance, uint64_t ssn)> store);
+
+    /**
+     * @brief Persist the DTLS sessions (requires USE_DTLS): after a reboot the first connection to a server resumes its
+     * session with an abbreviated handshake instead of a full one
+     *
+     * @param load copies the session stored for a security instance into buffer, of size length, and sets outLength, 0
+     * when nothing was stored, returns 0 on success
+     * @param store writes the session of a security instance, erases it when length is 0, returns 0 on success
+     */
+    void SetDtlsSessionStorage(Callback<int(uint16_t securityInstance, uint8_t *buffer, size_t length, size_t *outLength)> load, Callback<int(uint16_t securityInstance, const uint8_t *buffer, size_t length)> store);
+
+    /**
+     * @brief Set the queue mode behaviour of the client (requires LWM2M_QUEUE_MODE and a binding with Q)
+     *
+     * @param awakeTime seconds the client stays awake after its last exchange with the server, 0 disables queue mode
+     * @param callback called when the client falls asleep, with the number of seconds until it wakes up so that the
+     * radio can be powered down, and when it wakes up, with 0
+     */
+    void SetQueueMode(time_t awakeTime, Callback<void(bool sleeping, time_t wakeupDelay)> callback = nullptr);
+
+    /**
+     * @brief Cache the Read and Discover responses of objects whose values only change through the server, like Device
+     * (3) and Device Extension (3410): a server presenting the ETag of the last response gets a 2.03 Valid without
+     * payload (requires LWM2M_RESPONSE_CACHE). The application must not change their values. Call it before StartClient.
+     *
+     * @param objectIds objects whose responses are cached
+     * @param etagSeed first ETag, a random value or a value persisted and advanced at each boot, so that an ETag is not
+     * reused for another payload after a reboot
+     */
+    void SetCacheableObjects(const std::vector<uint16_t> &objectIds, uint32_t etagSeed);
+
+    /**
+     * @brief Wake the client up to send the pending notifications and Sends without waiting for the next scheduled wake up
+     *
+     */
+    void Wakeup();
+
+    /**
+     * @brief Run the callbacks of the resources of every object on the thread draining a queue, so that a slow callback
+     * never delays the LwM2M thread. Resources may instead be given their own queue with Resource::SetListenerQueue.
+     *
+     * @param queue queue of the application thread, must outlive the client, nullptr to call the callbacks inline
+     */
+    void SetListenerQueue(ListenerQueue *queue);
+
+    /**
+     * @brief Upload the samples of a series when its policy tells so, as SenML JSON packs (requires LwM2M 1.1 and
+     * LWM2M_SUPPORT_SENML_JSON, the samples are only stored otherwise)
+     *
+     * @param series series of a resource of the objects of the client, must stay alive until removed or the client
+     * is destroyed
+     */
+    void AddTimeSeries(TimeSeriesBase *series);
+
+    /**
+     * @brief Stop uploading the samples of a series, the ones stored are kept
+     *
+     * @param series series added with AddTimeSeries
+     */
+    void RemoveTimeSeries(TimeSeriesBase *series);
+
+    /**
+     * @brief Upload at once every sample stored in a series, whatever its policy
+     *
+     * @param series series added with AddTimeSeries
+     */
+    void FlushTimeSeries(TimeSeriesBase *series);
+
+    /**
+     * @brief Send the response of a deferred Write or Execute request, called by ResponseToken::Complete from any thread
+     *
+     * @param contextP context the request was received on
+     * @param responseId identifier of the deferred response
+     * @param status CoAP status code of the response
+     * @return int COAP_NO_ERROR, COAP_404_NOT_FOUND if the response was already sent or the client is stopped
+     */
+    int CompleteResponse(lwm2m_context_t *contextP, int responseId, uint8_t status) override;
+
 private:
     std::vector<NodeObject *> *_objects;
     NetworkInterface *_eth;
@@ -215,6 +324,39 @@ private:
     char *_clientKey;
     char *_endpointName;
     char *_clientIdentity;
+    uint16_t _localPort = CLIENT_LOCAL_PORT;
+    uint16_t _oscoreInstanceId = LWM2M_MAX_ID;
+    Callback<int(uint16_t, uint64_t *)> _ssnLoad;
+    Callback<int(uint16_t, uint64_t)> _ssnStore;
+#if defined(LWM2M_SUPPORT_OSCORE)
+    oscoreconnection_ssn_storage_t _ssnStorage = {};
+#endif
+    Callback<int(uint16_t, uint8_t *, size_t, size_t *)> _dtlsLoad;
+    Callback<int(uint16_t, const uint8_t *, size_t)> _dtlsStore;
+#if defined(USE_DTLS)
+    dtlsconnection_session_storage_t _dtlsStorage = {};
+#endif
+    time_t _queueAwakeTime = CLIENT_QUEUE_AWAKE_TIME;
+    Callback<void(bool, time_t)> _queueCallback;
+    bool _sleeping = false;
+    std::vector<uint16_t> _cacheableObjects;
+    uint32_t _cacheSeed = 0;
+
+    client_data_t _data = {};
+    lwm2m_context_t *_lwm2mH = nullptr;
+    bool _started = false;
+    Thread _lwm2mMainThread{osPriorityNormal, OS_STACK_SIZE, nullptr, "lwm2mMainThread"};
+    // The LwM2M context is not thread-safe: every call into it holds this mutex
+    Mutex _lwm2mMutex;
+
+    std::vector<TimeSeriesBase *> _timeSeries;
+
+    // Started clients, used to dispatch incoming packets by socket
+    static std::vector<NodeClient *> _startedClients;
+    static Mutex _startedClientsMutex;
+    // Packets being dispatched to this client, under _startedClientsMutex
+    int _dispatching = 0;
+    static ConditionVariable _dispatchDone;
 
     /**
      * @brief Display interface addr infos
@@ -230,11 +372,75 @@ private:
      */
     static void _printstate(lwm2m_context_t *lwm2mH);
 
+    /**
+     * @brief Wrapper for the load of the OSCORE Sender Sequence Number, dispatches to the client given as user data
+     *
+     * @param oscoreInstance instance of the OSCORE object
+     * @param ssn receives the value stored
+     * @param userData client
+     * @return int 0 on success
+     */
+    static int _loadSsnCppWrap(uint16_t oscoreInstance, uint64_t *ssn, void *userData);
+
+    /**
+     * @brief Wrapper for the store of the OSCORE Sender Sequence Number, dispatches to the client given as user data
+     *
+     * @param oscoreInstance instance of the OSCORE object
+     * @param ssn value to store
+     * @param userData client
+     * @return int 0 on success
+     */
+    static int _storeSsnCppWrap(uint16_t oscoreInstance, uint64_t ssn, void *userData);
+
+    /**
+     * @brief Wrapper for the load of a DTLS session, dispatches to the client given as user data
+     *
+     * @param securityInstance instance of the Security object
+     * @param buffer receives the serialized session
+     * @param length size of buffer
+     * @param outLength receives the length of the session, 0 when none was stored
+     * @param userData client
+     * @return int 0 on success
+     */
+    static int _loadDtlsSessionCppWrap(uint16_t securityInstance, uint8_t *buffer, size_t length, size_t *outLength, void *userData);
+
+    /**
+     * @brief Wrapper for the store of a DTLS session, dispatches to the client given as user data
+     *
+     * @param securityInstance instance of the Security object
+     * @param buffer serialized session
+     * @param length length of the session, 0 to erase it
+     * @param userData client
+     * @return int 0 on success
+     */
+    static int _storeDtlsSessionCppWrap(uint16_t securityInstance, const uint8_t *buffer, size_t length, void *userData);
+
     /**
      * @brief Main thread task, send packet to the server and handle timeout depanding on connection state
      *
      */
-    static void _lwm2mMainThreadTask();
+    void _lwm2mMainThreadTask();
+
+    /**
+     * @brief Wake the main thread up for a series whose upload became due
+     *
+     */
+    void _timeSeriesDue();
+
+    /**
+     * @brief Upload the series whose upload is due, under the LwM2M mutex
+     *
+     * @param timeoutMs shortened to the time until the next upload due because of the age of the samples
+     */
+    void _stepTimeSeries(uint32_t *timeoutMs);
+
+    /**
+     * @brief Upload every sample of a series, in as many packs as needed, under the LwM2M mutex
+     *
+     * @param series series to upload
+     * @param now current time, in the time base of the samples
+     */
+    void _uploadTimeSeries(TimeSeriesBase *series, time_t now);
 };
 
 #endif
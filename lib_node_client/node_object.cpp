@@ -51,6 +51,7 @@ uint8_t NodeObject::_objectCreate(lwm2m_context_t *contextP,
     objectInstance->next = nullptr;
     objectInstance->objectInstance = this;
     objectP->instanceList = LWM2M_LIST_ADD(objectP->instanceList, objectInstance);
+    _indexInstance(objectP, instanceId, this);
 
     // Write value from server side
     result = _objectWrite(contextP, instanceId, numData, dataArray, objectP, LWM2M_WRITE_REPLACE_RESOURCES);
@@ -81,6 +82,7 @@ uint8_t NodeObject::_objectDelete(lwm2m_context_t *contextP,
         return COAP_404_NOT_FOUND;
 
     lwm2m_free(objectInstance);
+    _unindexInstance(objectP, instanceId);
 
     return COAP_202_DELETED;
 }
@@ -131,23 +133,115 @@ uint8_t NodeObject::_objectDiscover(lwm2m_context_t *contextP,
     return result;
 }
 
+// Encoding of the value of a resource instance
+static void encodeValue(int value, lwm2m_data_t *dataP) { lwm2m_data_encode_int(value, dataP); }
+static void encodeValue(bool value, lwm2m_data_t *dataP) { lwm2m_data_encode_bool(value, dataP); }
+static void encodeValue(float value, lwm2m_data_t *dataP) { lwm2m_data_encode_float(value, dataP); }
+static void encodeValue(double value, lwm2m_data_t *dataP) { lwm2m_data_encode_float(value, dataP); }
+static void encodeValue(const std::string &value, lwm2m_data_t *dataP)
+{
+    // The value is owned by the resource and outlives the request: serialized in place
+    lwm2m_data_encode_borrowed_nstring(value.c_str(), value.size(), dataP);
+}
+
+// Decoding of the value of a resource instance, false if the data does not hold a value of this type
+static bool decodeValue(lwm2m_data_t *dataP, int &value)
+{
+    int64_t valI;
+
+    if (!lwm2m_data_decode_int(dataP, &valI))
+        return false;
+    value = (int)valI;
+    return true;
+}
+static bool decodeValue(lwm2m_data_t *dataP, bool &value) { return lwm2m_data_decode_bool(dataP, &value) != 0; }
+static bool decodeValue(lwm2m_data_t *dataP, float &value)
+{
+    double valF;
+
+    if (!lwm2m_data_decode_float(dataP, &valF))
+        return false;
+    value = (float)valF;
+    return true;
+}
+static bool decodeValue(lwm2m_data_t *dataP, double &value) { return lwm2m_data_decode_float(dataP, &value) != 0; }
+static bool decodeValue(lwm2m_data_t *dataP, std::string &value)
+{
+    if (dataP->type != LWM2M_TYPE_STRING && dataP->type != LWM2M_TYPE_OPAQUE)
+        return false;
+    value.assign((const char *)dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
+    return true;
+}
+
+// Status of a Write or an Execute from the error code of the resource, 5.03 when its listener queue is full so that the
+// server tries again later
+static uint8_t changedStatus(int errorCode, uint8_t failure)
+{
+    if (errorCode == RES_SUCCESS)
+        return COAP_204_CHANGED;
+    if (errorCode == LISTENER_QUEUE_FULL)
+        return COAP_503_SERVICE_UNAVAILABLE;
+    return failure;
+}
+
+// Encode every instance of a multiple instances resource in one pass over the contiguous instances
+template <class T>
+static uint8_t encodeInstances(const ResourceArray<T> &instances, lwm2m_data_t *dataP)
+{
+    lwm2m_data_t *subData = lwm2m_data_new(instances.Size());
+    if (subData == nullptr && !instances.Empty())
+        return COAP_500_INTERNAL_SERVER_ERROR;
+
+    for (size_t idx = 0; idx < instances.Size(); ++idx)
+    {
+        subData[idx].id = instances[idx].id;
+        encodeValue(instances[idx].value, subData + idx);
+    }
+    lwm2m_data_encode_instances(subData, instances.Size(), dataP);
+
+    return COAP_205_CONTENT;
+}
+
+// Write the instances received for a multiple instances resource, they replace the previous ones unless the write is
+// a partial update. The callbacks of the resource are called once with every instance.
+template <class T>
+static uint8_t writeInstances(Resource &resource, lwm2m_data_t *dataP, lwm2m_write_type_t writeType)
+{
+    ResourceArray<T> instances;
+    size_t count = dataP->value.asChildren.count;
+
+    if (dataP->type != LWM2M_TYPE_MULTIPLE_RESOURCE)
+        return COAP_400_BAD_REQUEST;
+
+    if (writeType == LWM2M_WRITE_PARTIAL_UPDATE)
+        instances = *(resource.GetValue<ResourceArray<T>>());
+    instances.Reserve(instances.Size() + count);
+
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        lwm2m_data_t *subData = dataP->value.asChildren.array + idx;
+        T value;
+
+        if (!decodeValue(subData, value))
+            return COAP_400_BAD_REQUEST;
+        instances.Set(subData->id, value);
+    }
+
+    return changedStatus(resource.Write<ResourceArray<T>>(instances), COAP_404_NOT_FOUND);
+}
+
 uint8_t NodeObject::_objectRead(lwm2m_context_t *contextP,
     uint16_t instanceId,
     int *numDataP,
     lwm2m_data_t **dataArrayP,
     lwm2m_object_t *objectP)
 {
-    ObjectList *objectInstance;
     uint8_t result;
     int i = 0;
 
     /* Unused parameter */
     (void)contextP;
 
-    objectInstance = (ObjectList *)lwm2m_list_find(objectP->instanceList, instanceId);
-    if (!objectInstance)
-        return COAP_404_NOT_FOUND;
-
     // Is the server asking for the full instance ?
     if (*numDataP == 0)
     {
@@ -206,53 +300,21 @@ uint8_t NodeObject::_objectRead(lwm2m_context_t *contextP,
                     lwm2m_data_encode_float(*((*objectRes).Read<double>()), (*dataArrayP) + i);
                 else if ((*objectRes).Type() == typeid(std::string))
                 {
-                    lwm2m_data_encode_string((*((*objectRes).Read<std::string>())).c_str(), (*dataArrayP) + i);
+                    // The value is owned by the resource and outlives the request: serialized in place
+                    const std::string *str = (*objectRes).Read<std::string>();
+                    lwm2m_data_encode_borrowed_nstring((*str).c_str(), (*str).size(), (*dataArrayP) + i);
                 }
                 // Resources type is multiple instances
-                else if ((*objectRes).Type() == typeid(std::map<size_t, Resource *>))
-                {
-                    const std::map<size_t, Resource *> *resourcesInstList = ((*objectRes).GetValue<std::map<size_t, Resource *>>());
-                    size_t count;
-                    lwm2m_data_t *subData;
-
-                    // Prepare subData array to get every resource instances value and id
-                    if ((*dataArrayP)[i].type == LWM2M_TYPE_MULTIPLE_RESOURCE)
-                    {
-                        count = (*dataArrayP)->value.asChildren.count;
-                        subData = (*dataArrayP)->value.asChildren.array;
-                    }
-                    else
-                    {
-                        count = resourcesInstList->size();
-                        subData = lwm2m_data_new(count);
-                        size_t idx = 0;
-                        for (auto pair : (*resourcesInstList))
-                        {
-                            subData[idx].id = pair.first;
-                            idx++;
-                        }
-                        lwm2m_data_encode_instances(subData, count, (*dataArrayP) + i);
-                    }
-
-                    // For every resources in the resource encode the value with corresponding function
-                    Resource *resourceInstance;
-                    for (size_t idx = 0; idx < count; ++idx)
-                    {
-                        std::cout << "Sub id is " << subData[idx].id << std::endl;
-                        auto resourceInstIt = resourcesInstList->find(subData[idx].id);
-                        resourceInstance = (*resourceInstIt).second;
-                        if ((*resourceInstance).Type() == typeid(int))
-                            lwm2m_data_encode_int(*((*resourceInstance).Read<int>()), subData + idx);
-                        else if ((*resourceInstance).Type() == typeid(bool))
-                            lwm2m_data_encode_bool(*((*resourceInstance).Read<bool>()), subData + idx);
-                        else if ((*resourceInstance).Type() == typeid(float))
-                            lwm2m_data_encode_float(*((*resourceInstance).Read<float>()), subData + idx);
-                        else if ((*resourceInstance).Type() == typeid(double))
-                            lwm2m_data_encode_float(*((*resourceInstance).Read<double>()), subData + idx);
-                        else if ((*resourceInstance).Type() == typeid(std::string))
-                            lwm2m_data_encode_string((*((*resourceInstance).Read<std::string>())).c_str(), subData + idx);
-                    }
-                }
+                else if ((*objectRes).Type() == typeid(ResourceArray<int>))
+                    result = encodeInstances(*((*objectRes).Read<ResourceArray<int>>()), (*dataArrayP) + i);
+                else if ((*objectRes).Type() == typeid(ResourceArray<bool>))
+                    result = encodeInstances(*((*objectRes).Read<ResourceArray<bool>>()), (*dataArrayP) + i);
+                else if ((*objectRes).Type() == typeid(ResourceArray<float>))
+                    result = encodeInstances(*((*objectRes).Read<ResourceArray<float>>()), (*dataArrayP) + i);
+                else if ((*objectRes).Type() == typeid(ResourceArray<double>))
+                    result = encodeInstances(*((*objectRes).Read<ResourceArray<double>>()), (*dataArrayP) + i);
+                else if ((*objectRes).Type() == typeid(ResourceArray<std::string>))
+                    result = encodeInstances(*((*objectRes).Read<ResourceArray<std::string>>()), (*dataArrayP) + i);
                 else
                     result = COAP_404_NOT_FOUND;
             }
@@ -269,14 +331,9 @@ uint8_t NodeObject::_objectWrite(lwm2m_context_t *contextP,
     lwm2m_object_t *objectP,
     lwm2m_write_type_t writeType)
 {
-    ObjectList *objectInstance;
     int i;
     uint8_t result;
 
-    objectInstance = (ObjectList *)lwm2m_list_find(objectP->instanceList, instanceId);
-    if (!objectInstance)
-        return COAP_404_NOT_FOUND;
-
     // If replace action is asked from server side, delete and recreate the object
     if (writeType == LWM2M_WRITE_REPLACE_INSTANCE)
     {
@@ -310,93 +367,43 @@ uint8_t NodeObject::_objectWrite(lwm2m_context_t *contextP,
             {
                 int64_t valI;
                 lwm2m_data_decode_int(dataArray + i, &valI);
-                result = ((*objectRes).Write<int>((int)valI) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
+                result = changedStatus((*objectRes).Write<int>((int)valI), COAP_404_NOT_FOUND);
             }
             else if ((*objectRes).Type() == typeid(bool))
             {
                 bool valB;
                 lwm2m_data_decode_bool(dataArray + i, &valB);
-                result = ((*objectRes).Write<bool>(valB) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
+                result = changedStatus((*objectRes).Write<bool>(valB), COAP_404_NOT_FOUND);
             }
             else if ((*objectRes).Type() == typeid(float))
             {
                 double valF;
                 lwm2m_data_decode_float(dataArray + i, &valF);
-                result = ((*objectRes).Write<float>((float)valF) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
+                result = changedStatus((*objectRes).Write<float>((float)valF), COAP_404_NOT_FOUND);
             }
             else if ((*objectRes).Type() == typeid(double))
             {
                 double valD;
                 lwm2m_data_decode_float(dataArray + i, &valD);
-                result = ((*objectRes).Write<double>(valD) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
+                result = changedStatus((*objectRes).Write<double>(valD), COAP_404_NOT_FOUND);
             }
             else if ((*objectRes).Type() == typeid(std::string))
             {
                 std::string stringValue = std::string((char *)(dataArray[i].value.asBuffer.buffer));
                 stringValue.resize(dataArray[i].value.asBuffer.length);
-                result = ((*objectRes).Write<std::string>(stringValue) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
+                result = changedStatus((*objectRes).Write<std::string>(stringValue), COAP_404_NOT_FOUND);
             }
             // Multiple instance resource
-            else if ((*objectRes).Type() == typeid(std::map<size_t, Resource *>))
-            {
-                // Create subData array to store id and value of resources inside the resource
-                size_t count = dataArray[i].value.asChildren.count;
-                lwm2m_data_t *subData = dataArray[i].value.asChildren.array;
-
-                std::map<size_t, Resource *> *resourcesInstList = ((*objectRes).GetValue<std::map<size_t, Resource *>>());
-                Resource *resourceInstance;
-
-                // Ensure resource id asked for creating new resource instance isn't already taken
-                auto resourceInstIt = resourcesInstList->find(subData[0].id);
-                if (resourceInstIt != resourcesInstList->end())
-                    return COAP_405_METHOD_NOT_ALLOWED;
-
-                // Ensure resource map isn't empty
-                resourceInstIt = resourcesInstList->find(0);
-                if (resourceInstIt == resourcesInstList->end())
-                    return COAP_405_METHOD_NOT_ALLOWED;
-
-                // For every resource instances inside the resource, write corresponding value inside correct resource instance
-                resourceInstance = (*resourceInstIt).second;
-                for (size_t idx = 0; idx < count; ++idx)
-                {
-                    if ((*resourceInstance).Type() == typeid(int))
-                    {
-                        int64_t valI;
-                        lwm2m_data_decode_int(subData + idx, &valI);
-                        (*resourcesInstList)[subData[idx].id] = new Resource(*resourceInstance);
-                        result = (((*resourcesInstList)[subData[idx].id])->Write<int>(valI) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
-                    }
-                    else if ((*resourceInstance).Type() == typeid(bool))
-                    {
-                        bool valB;
-                        lwm2m_data_decode_bool(subData + idx, &valB);
-                        (*resourcesInstList)[subData[idx].id] = new Resource(*resourceInstance);
-                        result = (((*resourcesInstList)[subData[idx].id])->Write<bool>(valB) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
-                    }
-                    else if ((*resourceInstance).Type() == typeid(float))
-                    {
-                        double valF;
-                        lwm2m_data_decode_float(subData + idx, &valF);
-                        (*resourcesInstList)[subData[idx].id] = new Resource(*resourceInstance);
-                        result = (((*resourcesInstList)[subData[idx].id])->Write<float>(valF) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
-                    }
-                    else if ((*resourceInstance).Type() == typeid(double))
-                    {
-                        double valD;
-                        lwm2m_data_decode_float(subData + idx, &valD);
-                        (*resourcesInstList)[subData[idx].id] = new Resource(*resourceInstance);
-                        result = (((*resourcesInstList)[subData[idx].id])->Write<double>(valD) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
-                    }
-                    else if ((*resourceInstance).Type() == typeid(std::string))
-                    {
-                        std::string stringValue = std::string((char *)(subData[idx].value.asBuffer.buffer));
-                        stringValue.resize(subData[idx].value.asBuffer.length);
-                        (*resourcesInstList)[subData[idx].id] = new Resource(*resourceInstance);
-                        result = (((*resourcesInstList)[subData[idx].id])->Write<std::string>(stringValue) == RES_SUCCESS ? COAP_204_CHANGED : COAP_404_NOT_FOUND);
-                    }
-                }
-            }
+            else if ((*objectRes).Type() == typeid(ResourceArray<int>))
+                result = writeInstances<int>(*objectRes, dataArray + i, writeType);
+            else if ((*objectRes).Type() == typeid(ResourceArray<bool>))
+                result = writeInstances<bool>(*objectRes, dataArray + i, writeType);
+            else if ((*objectRes).Type() == typeid(ResourceArray<float>))
+                result = writeInstances<float>(*objectRes, dataArray + i, writeType);
+            else if ((*objectRes).Type() == typeid(ResourceArray<double>))
+                result = writeInstances<double>(*objectRes, dataArray + i, writeType);
+            else if ((*objectRes).Type() == typeid(ResourceArray<std::string>))
+                result = writeInstances<std::string>(*objectRes, dataArray + i, writeType);
             else
                 result = COAP_404_NOT_FOUND;
         }
@@ -414,18 +421,11 @@ uint8_t NodeObject::_objectExec(lwm2m_context_t *contextP,
     int length,
     lwm2m_object_t *objectP)
 {
-    ObjectList *objectInstance;
     uint8_t result;
 
     /* Unused parameter */
     (void)contextP;
 
-    objectInstance = (ObjectList *)lwm2m_list_find(objectP->instanceList, instanceId);
-    if (!objectInstance)
-    {
-        return COAP_404_NOT_FOUND;
-    }
-
     // Find corresponding resource from id
     auto resourceIt = _resources.find(static_cast<size_t>(resourceId));
     if (resourceIt == _resources.end())
@@ -434,19 +434,19 @@ uint8_t NodeObject::_objectExec(lwm2m_context_t *contextP,
     }
     else
     {
-        // For each resource to execute, call resource's execute method
-        Resource objectRes(*((*resourceIt).second));
-
-        if (objectRes.Type() == typeid(int))
-            result = (objectRes.Exec<int>() == RES_SUCCESS ? COAP_204_CHANGED : COAP_405_METHOD_NOT_ALLOWED);
-        else if (objectRes.Type() == typeid(bool))
-            result = (objectRes.Exec<bool>() == RES_SUCCESS ? COAP_204_CHANGED : COAP_405_METHOD_NOT_ALLOWED);
-        else if (objectRes.Type() == typeid(float))
-            result = (objectRes.Exec<float>() == RES_SUCCESS ? COAP_204_CHANGED : COAP_405_METHOD_NOT_ALLOWED);
-        else if (objectRes.Type() == typeid(double))
-            result = (objectRes.Exec<double>() == RES_SUCCESS ? COAP_204_CHANGED : COAP_405_METHOD_NOT_ALLOWED);
-        else if (objectRes.Type() == typeid(std::string))
-            result = (objectRes.Exec<std::string>() == RES_SUCCESS ? COAP_204_CHANGED : COAP_405_METHOD_NOT_ALLOWED);
+        // Execute on the stored resource, copying it would allocate its value and callbacks on every request
+        Resource *objectRes = (*resourceIt).second;
+
+        if ((*objectRes).Type() == typeid(int))
+            result = changedStatus((*objectRes).Exec<int>(), COAP_405_METHOD_NOT_ALLOWED);
+        else if ((*objectRes).Type() == typeid(bool))
+            result = changedStatus((*objectRes).Exec<bool>(), COAP_405_METHOD_NOT_ALLOWED);
+        else if ((*objectRes).Type() == typeid(float))
+            result = changedStatus((*objectRes).Exec<float>(), COAP_405_METHOD_NOT_ALLOWED);
+        else if ((*objectRes).Type() == typeid(double))
+            result = changedStatus((*objectRes).Exec<double>(), COAP_405_METHOD_NOT_ALLOWED);
+        else if ((*objectRes).Type() == typeid(std::string))
+            result = changedStatus((*objectRes).Exec<std::string>(), COAP_405_METHOD_NOT_ALLOWED);
         else
             result = COAP_405_METHOD_NOT_ALLOWED;
     }
@@ -454,6 +454,41 @@ uint8_t NodeObject::_objectExec(lwm2m_context_t *contextP,
     return result;
 }
 
+// First entry of a sorted instance index whose id is not less than instanceId
+static std::vector<std::pair<uint16_t, NodeObject *>>::iterator instanceLowerBound(std::vector<std::pair<uint16_t, NodeObject *>> &index, uint16_t instanceId)
+{
+    return std::lower_bound(index.begin(), index.end(), instanceId,
+        [](const std::pair<uint16_t, NodeObject *> &entry, uint16_t id) { return entry.first < id; });
+}
+
+NodeObject *NodeObject::_findInstance(lwm2m_object_t *objectP, uint16_t instanceId)
+{
+    auto &index = static_cast<NodeObject *>(objectP->userData)->_instanceIndex;
+
+    auto it = instanceLowerBound(index, instanceId);
+    if (it == index.end() || it->first != instanceId)
+        return nullptr;
+
+    return it->second;
+}
+
+void NodeObject::_indexInstance(lwm2m_object_t *objectP, uint16_t instanceId, NodeObject *instance)
+{
+    auto &index = static_cast<NodeObject *>(objectP->userData)->_instanceIndex;
+
+    auto it = instanceLowerBound(index, instanceId);
+    index.insert(it, std::make_pair(instanceId, instance));
+}
+
+void NodeObject::_unindexInstance(lwm2m_object_t *objectP, uint16_t instanceId)
+{
+    auto &index = static_cast<NodeObject *>(objectP->userData)->_instanceIndex;
+
+    auto it = instanceLowerBound(index, instanceId);
+    if (it != index.end() && it->first == instanceId)
+        index.erase(it);
+}
+
 uint8_t NodeObject::objectCreateStatic(lwm2m_context_t *contextP,
     uint16_t instanceId,
     int numData,
@@ -476,21 +511,16 @@ uint8_t NodeObject::objectDeleteStatic(lwm2m_context_t *contextP,
         return COAP_405_METHOD_NOT_ALLOWED;
     }
 
-    // Find corresponding object instance from id
-    NodeObject *instance = nullptr;
-    for (ObjectList *objectInstance = (ObjectList *)objectP->instanceList; objectInstance != nullptr; objectInstance = (ObjectList *)objectInstance->next)
+    // Find object instance from id
+    NodeObject *instance = _findInstance(objectP, instanceId);
+    if (!instance)
     {
-        if (objectInstance->instanceId == instanceId)
-        {
-            instance = static_cast<NodeObject *>(objectInstance->objectInstance);
-            break;
-        }
+        return COAP_404_NOT_FOUND;
     }
 
     // Call delete callback on founded instance, and free memory
     uint8_t result = instance->_objectDelete(contextP, instanceId, objectP);
-    if (instance)
-        delete instance;
+    delete instance;
     return result;
 }
 
@@ -501,14 +531,10 @@ uint8_t NodeObject::objectDiscoverStatic(lwm2m_context_t *contextP,
     lwm2m_object_t *objectP)
 {
     // Find object instance from id
-    NodeObject *instance = nullptr;
-    for (ObjectList *objectInstance = (ObjectList *)objectP->instanceList; objectInstance != nullptr; objectInstance = (ObjectList *)objectInstance->next)
+    NodeObject *instance = _findInstance(objectP, instanceId);
+    if (!instance)
     {
-        if (objectInstance->instanceId == instanceId)
-        {
-            instance = static_cast<NodeObject *>(objectInstance->objectInstance);
-            break;
-        }
+        return COAP_404_NOT_FOUND;
     }
 
     // Call discover callback on founded instance
@@ -522,14 +548,10 @@ uint8_t NodeObject::objectReadStatic(lwm2m_context_t *contextP,
     lwm2m_object_t *objectP)
 {
     // Find object instance from id
-    NodeObject *instance = nullptr;
-    for (ObjectList *objectInstance = (ObjectList *)objectP->instanceList; objectInstance != nullptr; objectInstance = (ObjectList *)objectInstance->next)
+    NodeObject *instance = _findInstance(objectP, instanceId);
+    if (!instance)
     {
-        if (objectInstance->instanceId == instanceId)
-        {
-            instance = static_cast<NodeObject *>(objectInstance->objectInstance);
-            break;
-        }
+        return COAP_404_NOT_FOUND;
     }
 
     // Call read callback on founded instance
@@ -544,15 +566,11 @@ uint8_t NodeObject::objectWriteStatic(lwm2m_context_t *contextP,
     lwm2m_object_t *objectP,
     lwm2m_write_type_t writeType)
 {
-    // Find object from id
-    NodeObject *instance = nullptr;
-    for (ObjectList *objectInstance = (ObjectList *)objectP->instanceList; objectInstance != nullptr; objectInstance = (ObjectList *)objectInstance->next)
+    // Find object instance from id
+    NodeObject *instance = _findInstance(objectP, instanceId);
+    if (!instance)
     {
-        if (objectInstance->instanceId == instanceId)
-        {
-            instance = static_cast<NodeObject *>(objectInstance->objectInstance);
-            break;
-        }
+        return COAP_404_NOT_FOUND;
     }
 
     // Call write callback on founded instance
@@ -566,15 +584,11 @@ uint8_t NodeObject::objectExecStatic(lwm2m_context_t *contextP,
     int length,
     lwm2m_object_t *objectP)
 {
-    // Find object from id
-    NodeObject *instance = nullptr;
-    for (ObjectList *objectInstance = (ObjectList *)objectP->instanceList; objectInstance != nullptr; objectInstance = (ObjectList *)objectInstance->next)
+    // Find object instance from id
+    NodeObject *instance = _findInstance(objectP, instanceId);
+    if (!instance)
     {
-        if (objectInstance->instanceId == instanceId)
-        {
-            instance = static_cast<NodeObject *>(objectInstance->objectInstance);
-            break;
-        }
+        return COAP_404_NOT_FOUND;
     }
 
     // Call execute callback on founded instance
@@ -604,6 +618,7 @@ lwm2m_object_t *NodeObject::Get()
         objectInstance->next = nullptr;
         objectInstance->objectInstance = this;
         objectDescr->instanceList = LWM2M_LIST_ADD(objectDescr->instanceList, objectInstance);
+        _instanceIndex.assign(1, std::make_pair(static_cast<uint16_t>(_instanceId), this));
 
         // Bind action callback
         objectDescr->createFunc = &NodeObject::objectCreateStatic;
@@ -627,6 +642,12 @@ Resource *NodeObject::GetResource(size_t id)
         return nullptr;
 }
 
+void NodeObject::SetListenerQueue(ListenerQueue *queue)
+{
+    for (auto pair : _resources)
+        (*pair.second).SetListenerQueue(queue);
+}
+
 NodeObject::~NodeObject()
 {
     // Delete every resource dynamically allocated
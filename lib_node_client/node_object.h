@@ -31,6 +31,7 @@
 #ifndef NODE_OBJECT_H
 #define NODE_OBJECT_H
 
+#include <algorithm>
 #include <cstdio>
 #include <iostream>
 #include <map>
@@ -40,6 +41,7 @@
 #include <string>
 #include <cstring>
 #include <functional>
+#include <utility>
 #include "liblwm2m.h"
 
 #include "resource.h"
@@ -65,6 +67,38 @@ private:
         NodeObject *objectInstance;
     };
 
+    /**
+     * @brief Instances of the object sorted by ID, only filled in the original instance (userData of lwm2m_object_t)
+     * so that static callbacks find their instance with a binary search instead of walking the instance list
+     */
+    std::vector<std::pair<uint16_t, NodeObject *>> _instanceIndex;
+
+    /**
+     * @brief Find an object instance in the index of the original instance
+     *
+     * @param objectP structure representing the object
+     * @param instanceId object instance id
+     * @return NodeObject* object instance, nullptr if not found
+     */
+    static NodeObject *_findInstance(lwm2m_object_t *objectP, uint16_t instanceId);
+
+    /**
+     * @brief Add an object instance to the index of the original instance
+     *
+     * @param objectP structure representing the object
+     * @param instanceId object instance id
+     * @param instance object instance
+     */
+    static void _indexInstance(lwm2m_object_t *objectP, uint16_t instanceId, NodeObject *instance);
+
+    /**
+     * @brief Remove an object instance from the index of the original instance
+     *
+     * @param objectP structure representing the object
+     * @param instanceId object instance id
+     */
+    static void _unindexInstance(lwm2m_object_t *objectP, uint16_t instanceId);
+
     /**
      * @brief Read callback used when read action is taken on a resource belonging to an object
      *
@@ -303,6 +337,21 @@ public:
         }
     }
 
+    /**
+     * @brief Construct a new Node Object object holding the default value of every resource of its descriptor
+     *
+     * @param descriptor object descriptor, must outlive the object
+     * @param instId object instance id
+     */
+    NodeObject(const ObjectDescriptor &descriptor, uint16_t instId) : _objectId(descriptor.id), _instanceId(instId)
+    {
+        // Descriptors are sorted by ID, every resource goes at the end of the map
+        for (size_t i = 0; i < descriptor.resourceCount; ++i)
+        {
+            _resources.emplace_hint(_resources.end(), descriptor.resources[i].id, new Resource(descriptor.resources[i]));
+        }
+    }
+
     /**
      * @brief Get the Resource object
      *
@@ -311,6 +360,13 @@ public:
      */
     Resource *GetResource(size_t id);
 
+    /**
+     * @brief Run the callbacks of every resource of the object on the thread draining a queue
+     *
+     * @param queue queue of the application thread, must outlive the object, nullptr to call the callbacks inline
+     */
+    void SetListenerQueue(ListenerQueue *queue);
+
     /**
      * @brief Destroy the Node Object object
      *
@@ -0,0 +1,306 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file object_model.cpp
+ *  @brief This source file contain the descriptors of every object and resource known by the client.
+ *
+ *  Generated by tools/generate_object_model.py from the object definitions in objects/, do not edit.
+ *
+ */
+
+#include "object_model.h"
+
+static constexpr ResourceDescriptor LWM2M_SERVER_RESOURCES[] = {
+    { 0, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Short server id" },
+    { 1, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::SECONDS, false, "Lifetime" },
+    { 2, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::SECONDS, false, "Default minimum period" },
+    { 3, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::SECONDS, false, "Default maximum period" },
+    { 4, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Disable" },
+    { 5, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::SECONDS, false, "Disable timeout" },
+    { 6, ResourceOp::RES_RDWR, ResourceType::BOOLEAN, Units::NA, false, "Notification storing when disabled or offline" },
+    { 7, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Binding" },
+    { 8, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Registration update trigger" },
+};
+
+static constexpr ResourceDescriptor DEVICE_RESOURCES[] = {
+    { 0, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Manufacturer" },
+    { 1, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Model number" },
+    { 2, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Serial number" },
+    { 3, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Firmware version" },
+    { 4, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Reboot" },
+    { 5, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Factory reset" },
+    { 6, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, true, "Available power source" },
+    { 7, ResourceOp::RES_RD, ResourceType::INTEGER, Units::VOLT, false, "Power source voltage" },
+    { 8, ResourceOp::RES_RD, ResourceType::INTEGER, Units::AMPER, false, "Power source current" },
+    { 9, ResourceOp::RES_RD, ResourceType::INTEGER, Units::PERCENT, false, "Battery level" },
+    { 10, ResourceOp::RES_RD, ResourceType::INTEGER, Units::BYTES, false, "Free memory" },
+    { 11, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Error code" },
+    { 12, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Reset error code" },
+    { 13, ResourceOp::RES_RDWR, ResourceType::TIME, Units::DATE, false, "Current time" },
+    { 14, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "UTC offset" },
+    { 15, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Timezone" },
+    { 16, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Supported binding and mode" },
+    { 17, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Device type" },
+    { 18, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Hardware version" },
+    { 19, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Software version" },
+    { 20, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Battery status" },
+    { 21, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Memory total" },
+    { 22, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "External device info" },
+};
+
+static constexpr ResourceDescriptor DIGITAL_INPUT_RESOURCES[] = {
+    { 5500, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Digital input state" },
+    { 5501, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Digital input counter" },
+    { 5502, ResourceOp::RES_RDWR, ResourceType::BOOLEAN, Units::NA, false, "Digital input polarity" },
+    { 5503, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::MILLISECOND, false, "Digital input debounce" },
+    { 5504, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Digital input edge selection" },
+    { 5505, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Digital input counter reset" },
+    { 5750, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Application type" },
+    { 5751, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Sensor type" },
+    { 26241, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::HOURS, false, "Digital input failure check period" },
+    { 26242, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Digital input failure" },
+    { 26243, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Digital input level selection" },
+    { 26244, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Digital input selection" },
+};
+
+static constexpr ResourceDescriptor DIGITAL_OUTPUT_RESOURCES[] = {
+    { 5550, ResourceOp::RES_RDWR, ResourceType::BOOLEAN, Units::NA, false, "Digital Output State" },
+    { 5551, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Digital Output Polarity" },
+    { 5750, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Application Type" },
+};
+
+static constexpr ResourceDescriptor ANALOG_INPUT_RESOURCES[] = {
+    { 5600, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Analog Input Current Value" },
+    { 5601, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Min Measured Value" },
+    { 5602, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Max Measured Value" },
+    { 5603, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Min Range Value" },
+    { 5604, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Max Range Value" },
+    { 5605, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Reset Min and Max Measured Values" },
+    { 5750, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Application Type" },
+    { 5751, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Sensor Type" },
+};
+
+static constexpr ResourceDescriptor GENERIC_SENSOR_RESOURCES[] = {
+    { 5601, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Min Measured Value" },
+    { 5602, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Max Measured Value" },
+    { 5603, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Min Range Value" },
+    { 5604, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Max Range Value" },
+    { 5605, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Reset Min and Max Measured Values" },
+    { 5700, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Sensor value" },
+    { 5701, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Sensor Units" },
+    { 5750, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Application Type" },
+    { 5751, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Sensor Type" },
+};
+
+static constexpr ResourceDescriptor DEVICE_EXTENSION_RESOURCES[] = {
+    { 1, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "GTIN model number" },
+    { 2, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Manufacturer identifier" },
+    { 3, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "User-given name" },
+    { 4, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Asset identifier" },
+    { 5, ResourceOp::RES_RDWR, ResourceType::TIME, Units::DATE, false, "Installation date" },
+    { 6, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Software update" },
+    { 7, ResourceOp::RES_RDWR, ResourceType::BOOLEAN, Units::NA, false, "Maintenance" },
+    { 8, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Configuration reset" },
+    { 9, ResourceOp::RES_RD, ResourceType::INTEGER, Units::HOURS, false, "Device operating hours" },
+    { 10, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Additional firmware information" },
+};
+
+static constexpr ResourceDescriptor BATTERY_RESOURCES[] = {
+    { 1, ResourceOp::RES_RD, ResourceType::INTEGER, Units::PERCENT, false, "Battery level" },
+    { 2, ResourceOp::RES_RD, ResourceType::FLOAT, Units::AMPER_HOUR, false, "Battery capacity" },
+    { 3, ResourceOp::RES_RD, ResourceType::FLOAT, Units::VOLT, false, "Battery voltage" },
+    { 4, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Type of battery" },
+    { 5, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::PERCENT, false, "Low battery threshold" },
+    { 6, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Battery level too low" },
+    { 7, ResourceOp::RES_RDWR, ResourceType::BOOLEAN, Units::NA, false, "Battery shutdown" },
+    { 8, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Number of cycles" },
+    { 9, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Supply loss" },
+    { 10, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Supply loss counter" },
+    { 11, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Supply loss counter reset" },
+    { 12, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Supply loss reason" },
+};
+
+static constexpr ResourceDescriptor LPWAN_RESOURCES[] = {
+    { 1, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Type of network" },
+    { 2, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, true, "IPv4 address" },
+    { 3, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "IPv6 address" },
+    { 4, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Network address" },
+    { 5, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Secondary network address" },
+    { 6, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "MAC address" },
+    { 7, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Peer address" },
+    { 8, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Multicast group address" },
+    { 9, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Multicast group key" },
+    { 10, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Data rate" },
+    { 11, ResourceOp::RES_RD, ResourceType::FLOAT, Units::DECIBEL_MILLIWATT, false, "Transmit power" },
+    { 12, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::HERTZ, false, "Frequency" },
+    { 13, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Session time" },
+    { 14, ResourceOp::RES_RD, ResourceType::INTEGER, Units::SECONDS, false, "Session duration" },
+    { 15, ResourceOp::RES_RDWR, ResourceType::BOOLEAN, Units::NA, false, "Mesh node" },
+    { 16, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Maximum repeat time" },
+    { 17, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Number of repeats" },
+    { 18, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Signal to noise ratio" },
+    { 19, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Communication failure" },
+    { 20, ResourceOp::RES_RD, ResourceType::FLOAT, Units::DECIBEL_MILLIWATT, false, "Received Signal Strength Indication" },
+    { 21, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "IMSI" },
+    { 22, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "IMEI" },
+    { 23, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Current Communication Operator" },
+    { 24, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Integrated Circuit Card Identifier" },
+};
+
+static constexpr ResourceDescriptor GENERIC_ACTUATOR_RESOURCES[] = {
+    { 1, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::PERCENT, false, "Default dimming level" },
+    { 2, ResourceOp::RES_RD, ResourceType::INTEGER, Units::PERCENT, false, "Dimming level" },
+    { 3, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::PERCENT, false, "Command" },
+    { 4, ResourceOp::RES_RD, ResourceType::INTEGER, Units::PERCENT, false, "Command in action" },
+    { 5, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Scheduler ID" },
+    { 6, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Invalid scheduler" },
+};
+
+static constexpr ResourceDescriptor DATA_BRIDGE_RESOURCES[] = {
+    { 1, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Payload" },
+    { 2, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Hash" },
+    { 3, ResourceOp::RES_RD, ResourceType::INTEGER, Units::BYTES, false, "Cumulated daily data volume up" },
+    { 4, ResourceOp::RES_RD, ResourceType::INTEGER, Units::BYTES, false, "Cumulated daily data volume down" },
+    { 5, ResourceOp::RES_RD, ResourceType::INTEGER, Units::BYTES, false, "Cumulated daily data volume total" },
+    { 6, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Communication error" },
+};
+
+static constexpr ResourceDescriptor TIME_SYNCHRONISATION_RESOURCES[] = {
+    { 1, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "NTP server address" },
+    { 2, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Backup NTP server address" },
+    { 3, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "NTP period" },
+    { 4, ResourceOp::RES_RD, ResourceType::INTEGER, Units::HOURS, false, "Last time sync" },
+    { 5, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Time sync error" },
+};
+
+static constexpr ResourceDescriptor OUTDOOR_LAMP_CONTROLLER_RESOURCES[] = {
+    { 1, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::PERCENT, false, "Command" },
+    { 2, ResourceOp::RES_RD, ResourceType::INTEGER, Units::PERCENT, false, "Command in action" },
+    { 3, ResourceOp::RES_RD, ResourceType::INTEGER, Units::PERCENT, false, "Dimming level" },
+    { 4, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::PERCENT, false, "Default dimming level" },
+    { 5, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Lamp failure" },
+    { 6, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Lamp failure reason" },
+    { 7, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Control gear failure" },
+    { 8, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Control gear failure reason" },
+    { 9, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Relay failure" },
+    { 10, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Day burner" },
+    { 11, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Cycling failure" },
+    { 12, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Control gear communication failure" },
+    { 13, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, true, "Scheduler ID" },
+    { 14, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Invalid scheduler" },
+    { 15, ResourceOp::RES_RD, ResourceType::INTEGER, Units::HOURS, false, "Lamp operating hours" },
+    { 16, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Lamp operating hours reset" },
+    { 17, ResourceOp::RES_RD, ResourceType::TIME, Units::DATE, false, "Lamp ON timestamp" },
+    { 18, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Lamp switch counter" },
+    { 19, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Lamp switch counter reset" },
+    { 20, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Control gear start counter" },
+    { 21, ResourceOp::RES_RD, ResourceType::FLOAT, Units::CELCIUS_DEGREES, false, "Control gear temperature" },
+    { 22, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Control gear thermal derating" },
+    { 23, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Control gear thermal derating counter" },
+    { 24, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Control gear thermal derating counter reset" },
+    { 25, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Control gear thermal shutdown" },
+    { 26, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "Control gear thermal shutdown counter" },
+    { 27, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Control gear thermal shutdown counter reset" },
+    { 28, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Output port" },
+    { 29, ResourceOp::RES_RDWR, ResourceType::BOOLEAN, Units::NA, false, "Standby mode" },
+    { 30, ResourceOp::RES_RDWR, ResourceType::BOOLEAN, Units::NA, false, "Constant light output" },
+    { 31, ResourceOp::RES_RDWR, ResourceType::BOOLEAN, Units::NA, false, "Cleaning factor enabled" },
+    { 32, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Cleaning period" },
+    { 33, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::PERCENT, false, "Initial lamp cleaning factor" },
+    { 34, ResourceOp::RES_RDWR, ResourceType::TIME, Units::DATE, false, "Lamp cleaning date" },
+    { 35, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Control type" },
+    { 36, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::WATT, false, "Nominal lamp wattage" },
+    { 37, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::PERCENT, false, "Minimum dimming level" },
+    { 38, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::WATT, false, "Minimum lamp wattage" },
+    { 39, ResourceOp::RES_RDWR, ResourceType::STRING, Units::KELVIN, false, "Light color temperature command" },
+    { 40, ResourceOp::RES_RD, ResourceType::STRING, Units::KELVIN, false, "Actual light color temperature" },
+    { 41, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::PERCENT, false, "Virtual power output" },
+    { 42, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::VOLT, false, "Voltage at max dim level" },
+    { 43, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::VOLT, false, "Voltage at min dim level" },
+    { 44, ResourceOp::RES_RD, ResourceType::FLOAT, Units::VOLT, false, "Light source voltage" },
+    { 45, ResourceOp::RES_RD, ResourceType::FLOAT, Units::AMPER, false, "Light source current" },
+    { 46, ResourceOp::RES_RD, ResourceType::FLOAT, Units::WATT, false, "Light source active power" },
+    { 47, ResourceOp::RES_RD, ResourceType::FLOAT, Units::KILOWATT_HOUR, false, "Light source active energy" },
+};
+
+static constexpr ResourceDescriptor LUMINAIRE_ASSET_RESOURCES[] = {
+    { 1, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Asset GTIN" },
+    { 2, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Year of manufacture" },
+    { 3, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Week of manufacture" },
+    { 4, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::LUMEN, false, "Nominal light output" },
+    { 5, ResourceOp::RES_RDWR, ResourceType::INTEGER, Units::NA, false, "Light distribution type" },
+    { 6, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "Luminaire color" },
+    { 7, ResourceOp::RES_RD, ResourceType::FLOAT, Units::WATT, false, "Nominal input power" },
+    { 8, ResourceOp::RES_RD, ResourceType::FLOAT, Units::WATT, false, "Power at minimum dim level" },
+    { 9, ResourceOp::RES_RD, ResourceType::INTEGER, Units::VOLT, false, "Nominal max AC mains voltage" },
+    { 10, ResourceOp::RES_RD, ResourceType::INTEGER, Units::VOLT, false, "Nominal min AC mains voltage" },
+    { 11, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "CRI" },
+    { 12, ResourceOp::RES_RD, ResourceType::INTEGER, Units::KELVIN, false, "CCT value" },
+    { 13, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Luminaire identification" },
+    { 14, ResourceOp::RES_RD, ResourceType::STRING, Units::NA, false, "Luminaire identification number" },
+};
+
+static constexpr ResourceDescriptor ELECTRICAL_MONITOR_RESOURCES[] = {
+    { 1, ResourceOp::RES_RD, ResourceType::FLOAT, Units::VOLT, false, "Supply voltage" },
+    { 2, ResourceOp::RES_RD, ResourceType::FLOAT, Units::AMPER, false, "Supply current" },
+    { 3, ResourceOp::RES_RD, ResourceType::FLOAT, Units::HERTZ, false, "Frequency" },
+    { 4, ResourceOp::RES_RD, ResourceType::FLOAT, Units::WATT, false, "Active power" },
+    { 5, ResourceOp::RES_RD, ResourceType::FLOAT, Units::NA, false, "Power factor" },
+    { 6, ResourceOp::RES_RD, ResourceType::FLOAT, Units::KILOWATT_HOUR, false, "Cumulated active energy" },
+    { 7, ResourceOp::RES_E, ResourceType::INTEGER, Units::NA, false, "Energy reset" },
+    { 8, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::NA, false, "Low power factor threshold" },
+    { 9, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Low power factor" },
+    { 10, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::WATT, false, "Low power threshold" },
+    { 11, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::WATT, false, "Low power threshold at low dim level" },
+    { 12, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Low power" },
+    { 13, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::WATT, false, "High power threshold" },
+    { 14, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::WATT, false, "High power threshold at low dim level" },
+    { 15, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "High power" },
+    { 16, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::AMPER, false, "Low current threshold" },
+    { 17, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Low current" },
+    { 18, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::AMPER, false, "High current threshold" },
+    { 19, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "High current" },
+    { 20, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::VOLT, false, "Low voltage threshold" },
+    { 21, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Low voltage" },
+    { 22, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::VOLT, false, "High voltage threshold" },
+    { 23, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "High voltage" },
+    { 24, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::AMPER, false, "Critical inrush current threshold" },
+    { 25, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Critical inrush current" },
+    { 26, ResourceOp::RES_RD, ResourceType::FLOAT, Units::AMPER, false, "Minimum inrush current" },
+    { 27, ResourceOp::RES_RD, ResourceType::FLOAT, Units::AMPER, false, "Maximum inrush current" },
+    { 28, ResourceOp::RES_RD, ResourceType::FLOAT, Units::AMPER, false, "Latest inrush current" },
+    { 29, ResourceOp::RES_RD, ResourceType::FLOAT, Units::VAR, false, "Reactive power" },
+    { 30, ResourceOp::RES_RD, ResourceType::FLOAT, Units::KILOVAR_HOUR, false, "Reactive energy" },
+};
+
+static constexpr ResourceDescriptor PHOTOCELL_RESOURCES[] = {
+    { 1, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::LX, false, "ON lux level" },
+    { 2, ResourceOp::RES_RDWR, ResourceType::FLOAT, Units::LX, false, "OFF lux level" },
+    { 3, ResourceOp::RES_RD, ResourceType::BOOLEAN, Units::NA, false, "Photocell status" },
+};
+
+static constexpr ResourceDescriptor LED_COLOR_RESOURCES[] = {
+    { 1, ResourceOp::RES_RDWR, ResourceType::STRING, Units::NA, false, "RGB value" },
+};
+
+constexpr ObjectDescriptor OBJECT_MODEL[] = {
+    { 1, true, "LwM2M Server", LWM2M_SERVER_RESOURCES, sizeof(LWM2M_SERVER_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3, false, "Device", DEVICE_RESOURCES, sizeof(DEVICE_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3200, true, "Digital Input", DIGITAL_INPUT_RESOURCES, sizeof(DIGITAL_INPUT_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3201, true, "Digital Output", DIGITAL_OUTPUT_RESOURCES, sizeof(DIGITAL_OUTPUT_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3202, true, "Analog Input", ANALOG_INPUT_RESOURCES, sizeof(ANALOG_INPUT_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3300, true, "Generic Sensor", GENERIC_SENSOR_RESOURCES, sizeof(GENERIC_SENSOR_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3410, false, "Device extension", DEVICE_EXTENSION_RESOURCES, sizeof(DEVICE_EXTENSION_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3411, false, "Battery", BATTERY_RESOURCES, sizeof(BATTERY_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3412, true, "LPWAN", LPWAN_RESOURCES, sizeof(LPWAN_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3413, true, "Generic actuator", GENERIC_ACTUATOR_RESOURCES, sizeof(GENERIC_ACTUATOR_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3414, false, "Data bridge", DATA_BRIDGE_RESOURCES, sizeof(DATA_BRIDGE_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3415, false, "Time synchronisation", TIME_SYNCHRONISATION_RESOURCES, sizeof(TIME_SYNCHRONISATION_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3416, true, "Outdoor lamp controller", OUTDOOR_LAMP_CONTROLLER_RESOURCES, sizeof(OUTDOOR_LAMP_CONTROLLER_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3417, true, "Luminaire asset", LUMINAIRE_ASSET_RESOURCES, sizeof(LUMINAIRE_ASSET_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3418, true, "Electrical monitor", ELECTRICAL_MONITOR_RESOURCES, sizeof(ELECTRICAL_MONITOR_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3419, true, "Photocell", PHOTOCELL_RESOURCES, sizeof(PHOTOCELL_RESOURCES) / sizeof(ResourceDescriptor) },
+    { 3420, true, "LED color", LED_COLOR_RESOURCES, sizeof(LED_COLOR_RESOURCES) / sizeof(ResourceDescriptor) },
+};
+
+constexpr size_t OBJECT_MODEL_SIZE = sizeof(OBJECT_MODEL) / sizeof(ObjectDescriptor);
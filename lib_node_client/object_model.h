@@ -0,0 +1,28 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file object_model.h
+ *  @brief This header file declare the descriptor tables of every object and resource known by the client. The
+ *         tables are defined in object_model.cpp, generated by tools/generate_object_model.py from the object
+ *         definitions in objects/.
+ *
+ */
+
+#ifndef OBJECT_MODEL_H
+#define OBJECT_MODEL_H
+
+#include "resource_descriptor.h"
+
+/**
+ * @brief Descriptors of every object known by the client, sorted by ID
+ *
+ */
+extern const ObjectDescriptor OBJECT_MODEL[];
+
+/**
+ * @brief Number of entries in OBJECT_MODEL
+ *
+ */
+extern const size_t OBJECT_MODEL_SIZE;
+
+#endif
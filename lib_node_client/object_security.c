@@ -36,6 +36,7 @@
   *  Short Server ID         | 10 |            |  Single   |    No     | Integer | 1-65535 |       |
   *  Client Hold Off Time    | 11 |            |  Single   |    No     | Integer |         |   s   |
   *  BS Account Timeout      | 12 |            |  Single   |    No     | Integer |         |   s   |
+  *  OSCORE Security Mode    | 17 |            |  Single   |    No     | Objlnk  |         |       |
   *
   */
 
@@ -70,6 +71,7 @@ typedef struct _security_instance_
     uint16_t                     shortID;
     uint32_t                     clientHoldOffTime;
     uint32_t                     bootstrapServerAccountTimeout;
+    uint16_t                     oscoreInstanceId; // LWM2M_MAX_ID when OSCORE is not used
 } security_instance_t;
 
 static uint8_t prv_get_value(lwm2m_data_t *dataP,
@@ -129,6 +131,17 @@ static uint8_t prv_get_value(lwm2m_data_t *dataP,
             lwm2m_data_encode_int(targetP->bootstrapServerAccountTimeout, dataP);
             return COAP_205_CONTENT;
 
+        case LWM2M_SECURITY_OSCORE_ID:
+            if (targetP->oscoreInstanceId == LWM2M_MAX_ID)
+            {
+                lwm2m_data_encode_objlink(LWM2M_MAX_ID, LWM2M_MAX_ID, dataP);
+            }
+            else
+            {
+                lwm2m_data_encode_objlink(LWM2M_OSCORE_OBJECT_ID, targetP->oscoreInstanceId, dataP);
+            }
+            return COAP_205_CONTENT;
+
         default:
             return COAP_404_NOT_FOUND;
     }
@@ -165,7 +178,8 @@ static uint8_t prv_security_read(lwm2m_context_t *contextP,
                               LWM2M_SECURITY_SMS_SERVER_NUMBER_ID,
                               LWM2M_SECURITY_SHORT_SERVER_ID,
                               LWM2M_SECURITY_HOLD_OFF_ID,
-                              LWM2M_SECURITY_BOOTSTRAP_TIMEOUT_ID };
+                              LWM2M_SECURITY_BOOTSTRAP_TIMEOUT_ID,
+                              LWM2M_SECURITY_OSCORE_ID };
         int nbRes = sizeof(resList) / sizeof(uint16_t);
 
         *dataArrayP = lwm2m_data_new(nbRes);
@@ -415,6 +429,27 @@ static uint8_t prv_security_write(lwm2m_context_t *contextP,
                 break;
             }
 
+            case LWM2M_SECURITY_OSCORE_ID:
+                if (dataArray[i].type != LWM2M_TYPE_OBJECT_LINK)
+                {
+                    result = COAP_400_BAD_REQUEST;
+                }
+                else if (dataArray[i].value.asObjLink.objectId == LWM2M_MAX_ID)
+                {
+                    targetP->oscoreInstanceId = LWM2M_MAX_ID;
+                    result = COAP_204_CHANGED;
+                }
+                else if (dataArray[i].value.asObjLink.objectId == LWM2M_OSCORE_OBJECT_ID)
+                {
+                    targetP->oscoreInstanceId = dataArray[i].value.asObjLink.objectInstanceId;
+                    result = COAP_204_CHANGED;
+                }
+                else
+                {
+                    result = COAP_406_NOT_ACCEPTABLE;
+                }
+                break;
+
             default:
                 return COAP_400_BAD_REQUEST;
         }
@@ -459,6 +494,7 @@ static uint8_t prv_security_create(lwm2m_context_t *contextP,
     memset(targetP, 0, sizeof(security_instance_t));
 
     targetP->instanceId = instanceId;
+    targetP->oscoreInstanceId = LWM2M_MAX_ID;
     objectP->instanceList = LWM2M_LIST_ADD(objectP->instanceList, targetP);
 
     result = prv_security_write(contextP, instanceId, numData, dataArray, objectP, LWM2M_WRITE_REPLACE_RESOURCES);
@@ -544,6 +580,14 @@ void clean_security_object(lwm2m_object_t *objectP)
     }
 }
 
+void free_security_object(lwm2m_object_t *objectP)
+{
+    if (objectP == NULL)
+        return;
+    clean_security_object(objectP);
+    lwm2m_free(objectP);
+}
+
 lwm2m_object_t *get_security_object(int serverId,
     const char *serverUri,
     char *bsPskId,
@@ -605,6 +649,7 @@ lwm2m_object_t *get_security_object(int serverId,
         targetP->shortID = serverId;
         targetP->clientHoldOffTime = 10;
         targetP->bootstrapServerAccountTimeout = 600;
+        targetP->oscoreInstanceId = LWM2M_MAX_ID;
 
         securityObj->instanceList = LWM2M_LIST_ADD(securityObj->instanceList, targetP);
 
@@ -619,6 +664,18 @@ lwm2m_object_t *get_security_object(int serverId,
     return securityObj;
 }
 
+void set_security_oscore_instance(lwm2m_object_t *objectP,
+    uint16_t secObjInstID,
+    uint16_t oscoreInstanceId)
+{
+    security_instance_t *targetP = (security_instance_t *)LWM2M_LIST_FIND(objectP->instanceList, secObjInstID);
+
+    if (NULL != targetP)
+    {
+        targetP->oscoreInstanceId = oscoreInstanceId;
+    }
+}
+
 char *get_server_uri(lwm2m_object_t *objectP,
     uint16_t secObjInstID)
 {
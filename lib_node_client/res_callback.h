@@ -13,13 +13,60 @@
 #define RES_CALLBACK_H
 
 #include <functional>
-#include <memory>
-#include <algorithm>
+#include <utility>
 #include <vector>
+#include <stdint.h>
+
+#include "listener_queue.h"
 
 template <class T>
 class ResCallback;
 
+/**
+ * @brief Handle on a callback function registered in a ResCallback instance, returned when binding the function and
+ * used to unbind it. Copies of the ResCallback instance keep the same handles.
+ *
+ */
+class ResListener
+{
+public:
+    /**
+     * @brief Construct an invalid ResListener object, returned when binding fails
+     *
+     */
+    ResListener() : _id(0) {}
+
+    /**
+     * @brief Construct a new ResListener object
+     *
+     * @param id identifier of the callback function inside its ResCallback instance
+     */
+    explicit ResListener(uint32_t id) : _id(id) {}
+
+    /**
+     * @brief Get the handle, nullptr if binding failed
+     *
+     * @return const ResListener*
+     */
+    const ResListener *get() const { return _id ? this : nullptr; }
+
+    /**
+     * @brief Get the identifier of the callback function
+     *
+     * @return uint32_t 0 if binding failed
+     */
+    uint32_t GetId() const { return _id; }
+
+    explicit operator bool() const { return _id != 0; }
+
+    bool operator==(const ResListener &other) const { return _id == other._id; }
+
+    bool operator!=(const ResListener &other) const { return _id != other._id; }
+
+private:
+    uint32_t _id;
+};
+
 /**
  * @brief Parent class for generic child ResCallback class.
  *
@@ -51,35 +98,38 @@ public:
 /**
  * @brief Class registering callback functions. Used in Resource class
  *
+ * The first INLINE_LISTENERS functions are stored inside the instance, the following ones in a vector. Functions are
+ * called in registration order and receive the value by const reference.
+ *
  * @tparam T type of argument passed to any callback function registered in ResCallback instance
  */
 template <class T>
 class ResCallback : public ResCallbackBase
 {
 public:
-    using Function = std::function<void(T)>;
-    using FunctionPtr = std::shared_ptr<Function>;
-    using Functions = std::vector<FunctionPtr>;
+    using Function = std::function<void(const T &)>;
+
+    static const size_t INLINE_LISTENERS = 2;
 
     /**
      * @brief Construct a new ResCallback object
      *
      */
-    ResCallback() : _functions({}) {}
+    ResCallback() : _count(0), _nextId(1) {}
 
     /**
      * @brief Construct a new ResCallback object by copy
      *
      * @param src
      */
-    ResCallback(const ResCallback &src) : _functions(src._functions) {}
+    ResCallback(const ResCallback &src) = default;
 
     /**
      * @brief Construct a new ResCallback object by moving
      *
      * @param src
      */
-    ResCallback(ResCallback &&src) : _functions(std::move(src._functions)) {}
+    ResCallback(ResCallback &&src) = default;
 
     /**
      * @brief Destroy the ResCallback object
@@ -108,26 +158,47 @@ public:
     }
 
     /**
-     * @brief Add a callback function to the vector of other callback functions registered
+     * @brief Add a callback function after the other callback functions registered
      *
      * @param f function to register
-     * @return FunctionPtr shared pointer on the function registered
+     * @return ResListener handle on the function registered
      */
-    FunctionPtr AddListener(Function f)
+    ResListener AddListener(Function f)
     {
-        FunctionPtr fp = std::make_shared<Function>(f);
-        _functions.push_back(fp);
-        return fp;
+        uint32_t id = _nextId++;
+        Listener listener = { id, std::move(f) };
+
+        if (_count < INLINE_LISTENERS)
+            _inline[_count] = std::move(listener);
+        else
+            _overflow.push_back(std::move(listener));
+        _count++;
+
+        return ResListener(id);
     }
 
     /**
-     * @brief Remove a callback function registered by searching it's address in the vector
+     * @brief Remove a callback function registered, keeping the order of the other ones
      *
-     * @param fp shared pointer previously retrieved from returned value of AddListener function
+     * @param handle handle previously retrieved from returned value of AddListener function
      */
-    void RemoveListener(FunctionPtr fp)
+    void RemoveListener(const ResListener &handle)
     {
-        _functions.erase(std::find(_functions.begin(), _functions.end(), fp));
+        size_t i = 0;
+
+        while (i < _count && _at(i).id != handle.GetId())
+            i++;
+        if (i == _count)
+            return;
+
+        for (; i + 1 < _count; ++i)
+            _at(i) = std::move(_at(i + 1));
+
+        _count--;
+        if (_count < INLINE_LISTENERS)
+            _inline[_count] = Listener();
+        else
+            _overflow.pop_back();
     }
 
     /**
@@ -135,14 +206,60 @@ public:
      *
      * @param value in the Resource class, it's the value of the resource that will be passed
      */
-    void operator()(T value) const
+    void operator()(const T &value) const
+    {
+        size_t inlineCount = _count < INLINE_LISTENERS ? _count : INLINE_LISTENERS;
+
+        for (size_t i = 0; i < inlineCount; ++i)
+            _inline[i].function(value);
+        for (const Listener &listener : _overflow)
+            listener.function(value);
+    }
+
+    /**
+     * @brief Queue a call of every function registered, in registration order. Each call holds its own copy of the value,
+     * so that the resource can change before the queue runs it.
+     *
+     * @param queue queue drained by an application thread
+     * @param value in the Resource class, it's the value of the resource that will be passed
+     * @return true every call is queued
+     * @return false the queue was full, at least one call is dropped
+     */
+    bool Post(ListenerQueue &queue, const T &value) const
     {
-        for (auto &f : _functions)
-            f.get()->operator()(value);
+        size_t inlineCount = _count < INLINE_LISTENERS ? _count : INLINE_LISTENERS;
+        bool queued = true;
+
+        for (size_t i = 0; i < inlineCount; ++i)
+            queued &= _post(queue, _inline[i].function, value);
+        for (const Listener &listener : _overflow)
+            queued &= _post(queue, listener.function, value);
+
+        return queued;
     }
 
 private:
-    Functions _functions;
+    struct Listener
+    {
+        uint32_t id;
+        Function function;
+    };
+
+    static bool _post(ListenerQueue &queue, const Function &function, const T &value)
+    {
+        return queue.Post([function, value]()
+            { function(value); });
+    }
+
+    Listener &_at(size_t i)
+    {
+        return i < INLINE_LISTENERS ? _inline[i] : _overflow[i - INLINE_LISTENERS];
+    }
+
+    Listener _inline[INLINE_LISTENERS];
+    std::vector<Listener> _overflow;
+    size_t _count;
+    uint32_t _nextId;
 };
 
 #endif
@@ -10,8 +10,100 @@
 
 #include "resource.h"
 
+struct Resource::SharedDescriptor : public ResourceDescriptor
+{
+    size_t refCount;
+    std::string nameStorage;
+};
+
+const ResourceDescriptor Resource::_emptyDescriptor = { 0, ResourceOp::RES_RD, ResourceType::INTEGER, Units::NA, false, "" };
+
+const ResourceDescriptor *Resource::_newSharedDescriptor(ResourceOp rights, ResourceType type, Units unit, size_t id, bool multiple, const std::string &name)
+{
+    SharedDescriptor *shared = new SharedDescriptor();
+
+    shared->id = static_cast<uint16_t>(id);
+    shared->op = rights;
+    shared->type = type;
+    shared->unit = unit;
+    shared->multiple = multiple;
+    shared->refCount = 1;
+    shared->nameStorage = name;
+    shared->name = shared->nameStorage.c_str();
+
+    return shared;
+}
+
+const ResourceDescriptor *Resource::_retainDescriptor() const
+{
+    // Resources sharing a descriptor are copied and destroyed under the client lock
+    if (_sharedDescriptor)
+        static_cast<SharedDescriptor *>(const_cast<ResourceDescriptor *>(_descriptor))->refCount++;
+
+    return _descriptor;
+}
+
+void Resource::_releaseDescriptor()
+{
+    if (!_sharedDescriptor)
+        return;
+
+    SharedDescriptor *shared = static_cast<SharedDescriptor *>(const_cast<ResourceDescriptor *>(_descriptor));
+    if (--shared->refCount == 0)
+        delete shared;
+
+    _descriptor = &_emptyDescriptor;
+    _sharedDescriptor = false;
+}
+
+Resource::Resource(const ResourceDescriptor &descriptor) : _value(nullptr), _descriptor(&descriptor), _errorCode(RES_SUCCESS), _sharedDescriptor(false)
+{
+    // Instances of a multiple resource are added afterwards
+    if (descriptor.multiple)
+    {
+        switch (descriptor.type)
+        {
+        case ResourceType::FLOAT:
+            SetValue<ResourceArray<float>>(ResourceArray<float>());
+            break;
+        case ResourceType::BOOLEAN:
+            SetValue<ResourceArray<bool>>(ResourceArray<bool>());
+            break;
+        case ResourceType::STRING:
+            SetValue<ResourceArray<std::string>>(ResourceArray<std::string>());
+            break;
+        case ResourceType::INTEGER:
+        case ResourceType::TIME:
+        default:
+            SetValue<ResourceArray<int>>(ResourceArray<int>());
+            break;
+        }
+        return;
+    }
+
+    switch (descriptor.type)
+    {
+    case ResourceType::FLOAT:
+        SetValue<float>(0.0f);
+        break;
+    case ResourceType::BOOLEAN:
+        SetValue<bool>(false);
+        break;
+    case ResourceType::STRING:
+        SetValue<std::string>(std::string());
+        break;
+    case ResourceType::INTEGER:
+    case ResourceType::TIME:
+    default:
+        SetValue<int>(0);
+        break;
+    }
+}
+
 Resource::~Resource()
 {
+    _releaseDescriptor();
+
     if (!_value)
         return;
 
@@ -42,19 +134,34 @@ const std::type_info &Resource::Type()
 
 const ResourceOp &Resource::GetOp() const
 {
-    return _resourceOp;
+    return _descriptor->op;
 }
 
-const std::string &Resource::GetName() const {
-    return _name;
+const char *Resource::GetName() const {
+    return _descriptor->name;
 }
 
 const Units &Resource::GetUnit() const {
-    return _unit;
+    return _descriptor->unit;
+}
+
+size_t Resource::GetId() const {
+    return _descriptor->id;
+}
+
+const ResourceDescriptor *Resource::GetDescriptor() const {
+    return _descriptor;
+}
+
+void Resource::SetListenerQueue(ListenerQueue *queue) {
+    if (!_value)
+        return;
+
+    _head()->queue = queue;
 }
 
-const size_t &Resource::GetId() const {
-    return _id;
+ListenerQueue *Resource::GetListenerQueue() const {
+    return _value ? _head()->queue : nullptr;
 }
 
 int Resource::GetErrorCode() {
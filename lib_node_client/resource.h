@@ -16,49 +16,20 @@
 #include <typeinfo>
 #include <string>
 #include <iostream>
+#include <map>
+#include <type_traits>
 
 #include "res_callback.h"
+#include "response_token.h"
+#include "resource_array.h"
+#include "resource_descriptor.h"
 
 #define RES_SUCCESS 0
 #define BAD_EXPECTED_ACCESS 1
 #define VALUE_IS_EMPTY 2
 #define VALUE_TYPE_NOT_CORRESPONDING 3
 #define NO_CALLBACK_OBJECT 4
-
-enum class ResourceOp
-{
-    RES_RD,
-    RES_WR,
-    RES_E,
-    RES_RDWR
-};
-
-enum class Units
-{
-    NA,
-    DATE,
-    HOURS,
-    PERCENT,
-    AMPER_HOUR,
-    VOLT,
-    DECIBEL_MILLIWATT,
-    HERTZ,
-    SECONDS,
-    DECIBEL,
-    MILLISECOND,
-    BYTES,
-    CELCIUS_DEGREES,
-    WATT,
-    KELVIN,
-    AMPER,
-    KILOWATT_HOUR,
-    LUMEN,
-    WATT_HOUR,
-    VAR,
-    VAR_HOUR,
-    LX,
-    KILOVAR_HOUR
-};
+#define LISTENER_QUEUE_FULL 5
 
 /**
  * @brief Resource class implementing a resource contained in an object
@@ -91,12 +62,18 @@ private:
          *
          */
         const std::type_info &type;
+        /**
+         * @brief Queue the callbacks are run on, nullptr when they are called inline. Kept here rather than in the
+         * resource so that resources without callbacks do not grow.
+         *
+         */
+        ListenerQueue *queue;
         /**
          * @brief Construct a new Head object by copy
          *
          * @param type
          */
-        Head(const std::type_info &type) : type(type) {}
+        Head(const std::type_info &type) : type(type), queue(nullptr) {}
         /**
          * @brief Return pointer on the value object stored
          *
@@ -130,7 +107,10 @@ private:
          */
         virtual void *Copy() override
         {
-            return new (new (malloc(sizeof(Head) + sizeof(T))) THead() + 1) T(*(const T *)Data());
+            THead *head = new (malloc(sizeof(Head) + sizeof(T))) THead();
+
+            head->queue = queue;
+            return new (head + 1) T(*(const T *)Data());
         }
     };
 
@@ -147,46 +127,117 @@ private:
      */
     void *_copy() const { return _value ? _head()->Copy() : nullptr; }
 
+    /**
+     * @brief Descriptor allocated for a resource built without one, shared with the copies of the resource
+     *
+     */
+    struct SharedDescriptor;
+
+    /**
+     * @brief Descriptor of the resources built by default
+     *
+     */
+    static const ResourceDescriptor _emptyDescriptor;
+
+    /**
+     * @brief Allocate a shared descriptor
+     *
+     * @return const ResourceDescriptor* descriptor with a reference count of one
+     */
+    static const ResourceDescriptor *_newSharedDescriptor(ResourceOp rights, ResourceType type, Units unit, size_t id, bool multiple, const std::string &name);
+
+    /**
+     * @brief Take a reference on the descriptor if it is shared
+     *
+     * @return const ResourceDescriptor* the descriptor
+     */
+    const ResourceDescriptor *_retainDescriptor() const;
+
+    /**
+     * @brief Drop the reference on the descriptor if it is shared, freeing it with the last one
+     *
+     */
+    void _releaseDescriptor();
+
+    /**
+     * @brief Descriptor type matching the type of a value object
+     *
+     * @tparam T type of value object
+     * @return ResourceType
+     */
+    template <class T>
+    static ResourceType _typeOf()
+    {
+        if (std::is_same<T, bool>::value)
+            return ResourceType::BOOLEAN;
+        if (std::is_floating_point<T>::value)
+            return ResourceType::FLOAT;
+        if (std::is_same<T, std::string>::value)
+            return ResourceType::STRING;
+        return ResourceType::INTEGER;
+    }
+
     void *_value;
-    const ResourceOp _resourceOp;
-    const std::string _name;
-    const Units _unit;
+    const ResourceDescriptor *_descriptor;
     int _errorCode;
-    const size_t _id;
+    bool _sharedDescriptor;
 
     ResCallbackBase *_actionsOnWrite = nullptr;
     ResCallbackBase *_actionsOnRead = nullptr;
     ResCallbackBase *_actionsOnExec = nullptr;
 
+    /**
+     * @brief Call the functions registered in a callback object, or queue their calls when a listener queue is set
+     *
+     * @tparam T type of parameter inside callback function
+     * @param actions callback object of the operation
+     * @param value value passed to the functions
+     * @return true the functions are called or queued
+     * @return false the listener queue was full, at least one call is dropped
+     */
+    template <class T>
+    bool _notify(ResCallbackBase *actions, const T &value) const
+    {
+        ListenerQueue *queue = _head()->queue;
+
+        if (queue)
+            return ((ResCallback<T> *)actions)->Post(*queue, value);
+
+        (*((ResCallback<T> *)actions))(value);
+        return true;
+    }
+
 public:
     /**
      * @brief Construct a new Resource object by default
      *
      */
-    Resource() : _value(nullptr), _resourceOp(ResourceOp::RES_RD), _name(std::string("")), _unit(Units::NA), _errorCode(RES_SUCCESS), _id(0) {}
+    Resource() : _value(nullptr), _descriptor(&_emptyDescriptor), _errorCode(RES_SUCCESS), _sharedDescriptor(false) {}
 
     /**
-     * @brief Construct a new Resource object by copy
+     * @brief Construct a new Resource object by copy, the descriptor is shared with the reference object
      *
      * @param src reference object instance
      */
-    Resource(const Resource &src) : _value(src._copy()), _resourceOp(src._resourceOp), _name(src._name), _unit(src._unit), _errorCode(RES_SUCCESS), _id(src._id), _actionsOnWrite((src._actionsOnWrite ? src._actionsOnWrite->clone() : nullptr)), _actionsOnRead((src._actionsOnRead ? src._actionsOnRead->clone() : nullptr)), _actionsOnExec((src._actionsOnExec ? src._actionsOnExec->clone() : nullptr)) {}
+    Resource(const Resource &src) : _value(src._copy()), _descriptor(src._retainDescriptor()), _errorCode(RES_SUCCESS), _sharedDescriptor(src._sharedDescriptor), _actionsOnWrite((src._actionsOnWrite ? src._actionsOnWrite->clone() : nullptr)), _actionsOnRead((src._actionsOnRead ? src._actionsOnRead->clone() : nullptr)), _actionsOnExec((src._actionsOnExec ? src._actionsOnExec->clone() : nullptr)) {}
 
     /**
      * @brief Construct a new Resource object by moving
      *
      * @param src reference object instance
      */
-    Resource(Resource &&src) : _value(src._value), _resourceOp(src._resourceOp), _name(src._name), _unit(src._unit), _errorCode(RES_SUCCESS), _id(src._id), _actionsOnWrite((src._actionsOnWrite ? src._actionsOnWrite->move() : nullptr)), _actionsOnRead((src._actionsOnRead ? src._actionsOnRead->move() : nullptr)), _actionsOnExec((src._actionsOnExec ? src._actionsOnExec->move() : nullptr))
+    Resource(Resource &&src) : _value(src._value), _descriptor(src._descriptor), _errorCode(RES_SUCCESS), _sharedDescriptor(src._sharedDescriptor), _actionsOnWrite((src._actionsOnWrite ? src._actionsOnWrite->move() : nullptr)), _actionsOnRead((src._actionsOnRead ? src._actionsOnRead->move() : nullptr)), _actionsOnExec((src._actionsOnExec ? src._actionsOnExec->move() : nullptr))
     {
         src._value = nullptr;
+        src._descriptor = &_emptyDescriptor;
+        src._sharedDescriptor = false;
         src._actionsOnWrite = nullptr;
         src._actionsOnRead = nullptr;
         src._actionsOnExec = nullptr;
     }
 
     /**
-     * @brief Construct a new Resource object by specifying attribute
+     * @brief Construct a new Resource object by specifying attribute, a descriptor is allocated to hold them
      *
      * @tparam T type of value stored in the resource
      * @param src value object stored in the resource
@@ -196,7 +247,30 @@ public:
      * @param id resource id
      */
     template <class T>
-    Resource(const T &src, ResourceOp rights = ResourceOp::RES_RD, const std::string &name = std::string("name"), Units unit = Units::NA, size_t id = 0) : _value(new(new(malloc(sizeof(Head) + sizeof(T))) THead<T>() + 1) T(src)), _resourceOp(rights), _name(name), _unit(unit), _errorCode(RES_SUCCESS), _id(id) {}
+    Resource(const T &src, ResourceOp rights = ResourceOp::RES_RD, const std::string &name = std::string("name"), Units unit = Units::NA, size_t id = 0) : _value(new(new(malloc(sizeof(Head) + sizeof(T))) THead<T>() + 1) T(src)), _descriptor(_newSharedDescriptor(rights, _typeOf<typename ResourceArrayElement<T>::type>(), unit, id, ResourceArrayElement<T>::multiple, name)), _errorCode(RES_SUCCESS), _sharedDescriptor(true) {}
+
+    /**
+     * @brief Construct a new Resource object from its descriptor, holding the default value of the descriptor type
+     *
+     * @param descriptor resource descriptor, must outlive the resource
+     */
+    explicit Resource(const ResourceDescriptor &descriptor);
+
+    /**
+     * @brief Construct a new Resource object from its descriptor and its initial value
+     *
+     * @tparam T type of value stored in the resource
+     * @param descriptor resource descriptor, must outlive the resource
+     * @param src value object stored in the resource
+     */
+    template <class T>
+    Resource(const ResourceDescriptor &descriptor, const T &src) : _value(new(new(malloc(sizeof(Head) + sizeof(T))) THead<T>() + 1) T(src)), _descriptor(&descriptor), _errorCode(RES_SUCCESS), _sharedDescriptor(false) {}
+
+    /**
+     * @brief Resources are not assignable, copy them through the copy constructor
+     *
+     */
+    Resource &operator=(const Resource &) = delete;
 
     /**
      * @brief Destroy the Resource object
@@ -229,9 +303,9 @@ public:
     /**
      * @brief Get the resource name
      *
-     * @return const std::string&
+     * @return const char*
      */
-    const std::string &GetName() const;
+    const char *GetName() const;
 
     /**
      * @brief Get the resource unit
@@ -243,9 +317,32 @@ public:
     /**
      * @brief Get the resource id
      *
-     * @return const size_t&
+     * @return size_t
      */
-    const size_t &GetId() const;
+    size_t GetId() const;
+
+    /**
+     * @brief Get the resource descriptor
+     *
+     * @return const ResourceDescriptor*
+     */
+    const ResourceDescriptor *GetDescriptor() const;
+
+    /**
+     * @brief Run the callbacks of the resource on the thread draining a queue instead of the thread calling Read, Write
+     * or Exec. Callbacks then receive a copy of the value and asynchronous callbacks an invalid ResponseToken.
+     * The queue is kept with the value and copied with it, an empty resource ignores it.
+     *
+     * @param queue queue of the application thread, must outlive the resource, nullptr to call the callbacks inline
+     */
+    void SetListenerQueue(ListenerQueue *queue);
+
+    /**
+     * @brief Get the queue the callbacks are run on
+     *
+     * @return ListenerQueue* nullptr if the callbacks are called inline
+     */
+    ListenerQueue *GetListenerQueue() const;
 
     /**
      * @brief Get the resource error code
@@ -331,7 +428,7 @@ public:
         }
 
         // Check access rights
-        if (_resourceOp != ResourceOp::RES_RD && _resourceOp != ResourceOp::RES_RDWR)
+        if (_descriptor->op != ResourceOp::RES_RD && _descriptor->op != ResourceOp::RES_RDWR)
         {
             _errorCode = BAD_EXPECTED_ACCESS;
             return nullptr;
@@ -339,7 +436,7 @@ public:
 
         // Call of read callback functions
         if (_actionsOnRead)
-            (*((ResCallback<T> *)_actionsOnRead))(*(T *)_value);
+            _notify<T>(_actionsOnRead, *(T *)_value);
 
         return (T *)_value;
     }
@@ -355,7 +452,7 @@ public:
     int Write(const T &writeValue)
     {
         // Check access rights
-        if (_resourceOp != ResourceOp::RES_WR && _resourceOp != ResourceOp::RES_RDWR)
+        if (_descriptor->op != ResourceOp::RES_WR && _descriptor->op != ResourceOp::RES_RDWR)
         {
             _errorCode = BAD_EXPECTED_ACCESS;
             return BAD_EXPECTED_ACCESS;
@@ -375,9 +472,12 @@ public:
             *(T *)_value = writeValue;
         }
 
-        // Call of write callback functions
-        if (_actionsOnWrite)
-            (*((ResCallback<T> *)_actionsOnWrite))(writeValue);
+        // Call of write callback functions, the value stays written when their queue is full
+        if (_actionsOnWrite && !_notify<T>(_actionsOnWrite, writeValue))
+        {
+            _errorCode = LISTENER_QUEUE_FULL;
+            return LISTENER_QUEUE_FULL;
+        }
 
         return RES_SUCCESS;
     }
@@ -405,14 +505,17 @@ public:
         }
 
         // Check access rights
-        if (_resourceOp != ResourceOp::RES_E)
+        if (_descriptor->op != ResourceOp::RES_E)
         {
             _errorCode = BAD_EXPECTED_ACCESS;
             return BAD_EXPECTED_ACCESS;
         }
 
-        if (_actionsOnExec)
-            (*((ResCallback<T> *)_actionsOnExec))(*(T *)_value);
+        if (_actionsOnExec && !_notify<T>(_actionsOnExec, *(T *)_value))
+        {
+            _errorCode = LISTENER_QUEUE_FULL;
+            return LISTENER_QUEUE_FULL;
+        }
 
         return RES_SUCCESS;
     }
@@ -421,24 +524,24 @@ public:
      * @brief Bind a callback function to the resource instance for write operation
      *
      * @tparam T type of parameter inside callback function
-     * @param f callbcak function
-     * @return std::shared_ptr<std::function<void(T)>> pointer on the callback function registered
+     * @param f callback function
+     * @return ResListener handle on the callback function registered, invalid on error
      */
     template <class T>
-    std::shared_ptr<std::function<void(T)>> BindOnWrite(std::function<void(T)> f)
+    ResListener BindOnWrite(std::function<void(const T &)> f)
     {
         // Check access rights
-        if (this->_resourceOp != ResourceOp::RES_WR && this->_resourceOp != ResourceOp::RES_RDWR)
+        if (_descriptor->op != ResourceOp::RES_WR && _descriptor->op != ResourceOp::RES_RDWR)
         {
             _errorCode = BAD_EXPECTED_ACCESS;
-            return nullptr;
+            return ResListener();
         }
 
         // Check corresponding type between fct argument and _value
         if (Type() != typeid(T))
         {
             _errorCode = VALUE_TYPE_NOT_CORRESPONDING;
-            return nullptr;
+            return ResListener();
         }
 
         // Create a callback object on first bind
@@ -454,14 +557,14 @@ public:
      * @brief Remove callback registered previously using pointer on that callback for write operation
      *
      * @tparam T type of parameter inside callback function
-     * @param fp pointer on the callback function
+     * @param listener handle on the callback function
      * @return int error code
      */
     template <class T>
-    int UnbindOnWrite(std::shared_ptr<std::function<void(T)>> fp)
+    int UnbindOnWrite(const ResListener &listener)
     {
         // Check access rights
-        if (this->_resourceOp != ResourceOp::RES_WR && this->_resourceOp != ResourceOp::RES_RDWR)
+        if (_descriptor->op != ResourceOp::RES_WR && _descriptor->op != ResourceOp::RES_RDWR)
         {
             _errorCode = BAD_EXPECTED_ACCESS;
             return BAD_EXPECTED_ACCESS;
@@ -481,33 +584,48 @@ public:
             return NO_CALLBACK_OBJECT;
         }
 
-        ((ResCallback<T> *)_actionsOnWrite)->RemoveListener(fp);
+        ((ResCallback<T> *)_actionsOnWrite)->RemoveListener(listener);
 
         return RES_SUCCESS;
     }
 
+    /**
+     * @brief Bind a callback function to the resource instance for write operation, whose response is sent when the
+     * callback completes its ResponseToken, possibly from another thread once it has returned
+     *
+     * @tparam T type of parameter inside callback function
+     * @param f callback function
+     * @return ResListener handle on the callback function registered, to pass to UnbindOnWrite, invalid on error
+     */
+    template <class T>
+    ResListener BindOnWriteAsync(std::function<void(const T &, ResponseToken)> f)
+    {
+        return BindOnWrite<T>([f](const T &value)
+            { f(value, ResponseToken::Defer()); });
+    }
+
     /**
      * @brief Bind a callback function to the resource instance for read operation
      *
      * @tparam T type of parameter inside callback function
-     * @param f callbcak function
-     * @return std::shared_ptr<std::function<void(T)>> pointer on the callback function registered
+     * @param f callback function
+     * @return ResListener handle on the callback function registered, invalid on error
      */
     template <class T>
-    std::shared_ptr<std::function<void(T)>> BindOnRead(std::function<void(T)> f)
+    ResListener BindOnRead(std::function<void(const T &)> f)
     {
         // Check access rights
-        if (this->_resourceOp != ResourceOp::RES_RD && this->_resourceOp != ResourceOp::RES_RDWR)
+        if (_descriptor->op != ResourceOp::RES_RD && _descriptor->op != ResourceOp::RES_RDWR)
         {
             _errorCode = BAD_EXPECTED_ACCESS;
-            return nullptr;
+            return ResListener();
         }
 
         // Check corresponding type between fct argument and _value
         if (Type() != typeid(T))
         {
             _errorCode = VALUE_TYPE_NOT_CORRESPONDING;
-            return nullptr;
+            return ResListener();
         }
 
         // Create a callback object on first bind
@@ -523,14 +641,14 @@ public:
      * @brief Remove callback registered previously using pointer on that callback for write operation
      *
      * @tparam T type of parameter inside callback function
-     * @param fp pointer on the callback function
+     * @param listener handle on the callback function
      * @return int error code
      */
     template <class T>
-    int UnbindOnRead(std::shared_ptr<std::function<void(T)>> fp)
+    int UnbindOnRead(const ResListener &listener)
     {
         // Check access rights
-        if (this->_resourceOp != ResourceOp::RES_RD && this->_resourceOp != ResourceOp::RES_RDWR)
+        if (_descriptor->op != ResourceOp::RES_RD && _descriptor->op != ResourceOp::RES_RDWR)
         {
             _errorCode = BAD_EXPECTED_ACCESS;
             return BAD_EXPECTED_ACCESS;
@@ -550,7 +668,7 @@ public:
             return NO_CALLBACK_OBJECT;
         }
 
-        ((ResCallback<T> *)_actionsOnRead)->RemoveListener(fp);
+        ((ResCallback<T> *)_actionsOnRead)->RemoveListener(listener);
 
         return RES_SUCCESS;
     }
@@ -559,24 +677,24 @@ public:
      * @brief Bind a callback function to the resource instance for execute operation
      *
      * @tparam T type of parameter inside callback function
-     * @param f callbcak function
-     * @return std::shared_ptr<std::function<void(T)>> pointer on the callback function registered
+     * @param f callback function
+     * @return ResListener handle on the callback function registered, invalid on error
      */
     template <class T>
-    std::shared_ptr<std::function<void(T)>> BindOnExec(std::function<void(T)> f)
+    ResListener BindOnExec(std::function<void(const T &)> f)
     {
         // Check access rights
-        if (this->_resourceOp != ResourceOp::RES_E)
+        if (_descriptor->op != ResourceOp::RES_E)
         {
             _errorCode = BAD_EXPECTED_ACCESS;
-            return nullptr;
+            return ResListener();
         }
 
         // Check corresponding type between fct argument and _value
         if (Type() != typeid(T))
         {
             _errorCode = VALUE_TYPE_NOT_CORRESPONDING;
-            return nullptr;
+            return ResListener();
         }
 
         // Create a callback object on first bind
@@ -585,21 +703,21 @@ public:
             _actionsOnExec = new ResCallback<T>();
         }
 
-            return ((ResCallback<T> *)_actionsOnExec)->AddListener(f);
+        return ((ResCallback<T> *)_actionsOnExec)->AddListener(f);
     }
 
     /**
      * @brief Remove callback registered previously using pointer on that callback for write operation
      *
      * @tparam T type of parameter inside callback function
-     * @param fp pointer on the callback function
+     * @param listener handle on the callback function
      * @return int error code
      */
     template <class T>
-    int UnbindOnExec(std::shared_ptr<std::function<void(T)>> fp)
+    int UnbindOnExec(const ResListener &listener)
     {
         // Check access rights
-        if (this->_resourceOp != ResourceOp::RES_E)
+        if (_descriptor->op != ResourceOp::RES_E)
         {
             _errorCode = BAD_EXPECTED_ACCESS;
             return BAD_EXPECTED_ACCESS;
@@ -619,10 +737,25 @@ public:
             return NO_CALLBACK_OBJECT;
         }
 
-        ((ResCallback<T> *)_actionsOnExec)->RemoveListener(fp);
+        ((ResCallback<T> *)_actionsOnExec)->RemoveListener(listener);
 
         return RES_SUCCESS;
     }
+
+    /**
+     * @brief Bind a callback function to the resource instance for execute operation, whose response is sent when the
+     * callback completes its ResponseToken, possibly from another thread once it has returned
+     *
+     * @tparam T type of parameter inside callback function
+     * @param f callback function
+     * @return ResListener handle on the callback function registered, to pass to UnbindOnExec, invalid on error
+     */
+    template <class T>
+    ResListener BindOnExecAsync(std::function<void(const T &, ResponseToken)> f)
+    {
+        return BindOnExec<T>([f](const T &value)
+            { f(value, ResponseToken::Defer()); });
+    }
 };
 
 #endif
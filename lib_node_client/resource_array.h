@@ -0,0 +1,199 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file resource_array.h
+ *  @brief This header file contain the declaration of the ResourceArray class, value of a multiple instances resource.
+ *  Instances are stored contiguously with their ID, sorted by ID, so that a resource holding a list of addresses or
+ *  measures needs a single allocation and is encoded in one pass.
+ *
+ *  @author Bastien Pillonel <bastien.pillonel@heig-vd.ch>
+ *
+ */
+
+#ifndef RESOURCE_ARRAY_H
+#define RESOURCE_ARRAY_H
+
+#include <algorithm>
+#include <initializer_list>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Instances of a multiple instances resource, all of the same type
+ *
+ * @tparam T type of value stored in each instance
+ */
+template <class T>
+class ResourceArray
+{
+public:
+    /**
+     * @brief Resource instance, its ID and its value
+     *
+     */
+    struct Instance
+    {
+        uint16_t id;
+        T value;
+    };
+
+    using iterator = typename std::vector<Instance>::iterator;
+    using const_iterator = typename std::vector<Instance>::const_iterator;
+
+    /**
+     * @brief Construct an empty ResourceArray object
+     *
+     */
+    ResourceArray() {}
+
+    /**
+     * @brief Construct a new ResourceArray object whose instances get the IDs 0 to values.size() - 1
+     *
+     * @param values value of each instance
+     */
+    ResourceArray(std::initializer_list<T> values)
+    {
+        uint16_t id = 0;
+
+        _instances.reserve(values.size());
+        for (const T &value : values)
+            _instances.push_back({ id++, value });
+    }
+
+    /**
+     * @brief Get the number of instances
+     *
+     * @return size_t
+     */
+    size_t Size() const { return _instances.size(); }
+
+    /**
+     * @brief Inform if the resource has no instance
+     *
+     * @return true no instance
+     * @return false at least one instance
+     */
+    bool Empty() const { return _instances.empty(); }
+
+    /**
+     * @brief Reserve room for instances, so that adding them does not reallocate
+     *
+     * @param count number of instances
+     */
+    void Reserve(size_t count) { _instances.reserve(count); }
+
+    /**
+     * @brief Get the value of an instance
+     *
+     * @param id instance ID
+     * @return T* nullptr if there is no instance with this ID
+     */
+    T *Find(uint16_t id)
+    {
+        iterator it = _lowerBound(id);
+        return (it != _instances.end() && (*it).id == id) ? &(*it).value : nullptr;
+    }
+
+    /**
+     * @brief Get the value of an instance
+     *
+     * @param id instance ID
+     * @return const T* nullptr if there is no instance with this ID
+     */
+    const T *Find(uint16_t id) const
+    {
+        return const_cast<ResourceArray *>(this)->Find(id);
+    }
+
+    /**
+     * @brief Set the value of an instance, adding the instance if needed
+     *
+     * @param id instance ID
+     * @param value value of the instance
+     */
+    void Set(uint16_t id, const T &value)
+    {
+        iterator it = _lowerBound(id);
+
+        if (it != _instances.end() && (*it).id == id)
+            (*it).value = value;
+        else
+            _instances.insert(it, { id, value });
+    }
+
+    /**
+     * @brief Remove an instance
+     *
+     * @param id instance ID
+     * @return true the instance is removed
+     * @return false there is no instance with this ID
+     */
+    bool Remove(uint16_t id)
+    {
+        iterator it = _lowerBound(id);
+
+        if (it == _instances.end() || (*it).id != id)
+            return false;
+
+        _instances.erase(it);
+        return true;
+    }
+
+    /**
+     * @brief Remove every instance, keeping the room reserved
+     *
+     */
+    void Clear() { _instances.clear(); }
+
+    /**
+     * @brief Get an instance by position, instances are sorted by ID
+     *
+     * @param index position of the instance, lower than Size()
+     * @return Instance&
+     */
+    Instance &operator[](size_t index) { return _instances[index]; }
+
+    /**
+     * @brief Get an instance by position, instances are sorted by ID
+     *
+     * @param index position of the instance, lower than Size()
+     * @return const Instance&
+     */
+    const Instance &operator[](size_t index) const { return _instances[index]; }
+
+    iterator begin() { return _instances.begin(); }
+    iterator end() { return _instances.end(); }
+    const_iterator begin() const { return _instances.begin(); }
+    const_iterator end() const { return _instances.end(); }
+
+private:
+    std::vector<Instance> _instances;
+
+    iterator _lowerBound(uint16_t id)
+    {
+        return std::lower_bound(_instances.begin(), _instances.end(), id,
+            [](const Instance &instance, uint16_t instanceId) { return instance.id < instanceId; });
+    }
+};
+
+/**
+ * @brief Type of the value stored in each instance of a resource, the value type itself for a single instance resource
+ *
+ * @tparam T type of value stored in the resource
+ */
+template <class T>
+struct ResourceArrayElement
+{
+    using type = T;
+    static const bool multiple = false;
+};
+
+template <class T>
+struct ResourceArrayElement<ResourceArray<T>>
+{
+    using type = T;
+    static const bool multiple = true;
+};
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file resource_descriptor.h
+ *  @brief This header file contain the descriptors of the objects and resources described by the uCIFI standard.
+ *  Descriptors hold the metadata that never changes at runtime (IDs, names, types, operations and units), they are
+ *  generated from the object definitions and kept in read-only memory.
+ *
+ *  @author Bastien Pillonel <bastien.pillonel@heig-vd.ch>
+ *
+ */
+
+#ifndef RESOURCE_DESCRIPTOR_H
+#define RESOURCE_DESCRIPTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum class ResourceOp
+{
+    RES_RD,
+    RES_WR,
+    RES_E,
+    RES_RDWR
+};
+
+enum class Units
+{
+    NA,
+    DATE,
+    HOURS,
+    PERCENT,
+    AMPER_HOUR,
+    VOLT,
+    DECIBEL_MILLIWATT,
+    HERTZ,
+    SECONDS,
+    DECIBEL,
+    MILLISECOND,
+    BYTES,
+    CELCIUS_DEGREES,
+    WATT,
+    KELVIN,
+    AMPER,
+    KILOWATT_HOUR,
+    LUMEN,
+    WATT_HOUR,
+    VAR,
+    VAR_HOUR,
+    LX,
+    KILOVAR_HOUR
+};
+
+/**
+ * @brief Type of the value stored in a resource, as found in the object definition
+ *
+ */
+enum class ResourceType
+{
+    INTEGER,
+    FLOAT,
+    BOOLEAN,
+    STRING,
+    TIME
+};
+
+/**
+ * @brief Immutable description of a resource
+ *
+ */
+struct ResourceDescriptor
+{
+    uint16_t id;
+    ResourceOp op;
+    ResourceType type;
+    Units unit;
+    bool multiple;
+    const char *name;
+};
+
+/**
+ * @brief Immutable description of an object and of its resources, sorted by ID
+ *
+ */
+struct ObjectDescriptor
+{
+    uint16_t id;
+    bool multiple;
+    const char *name;
+    const ResourceDescriptor *resources;
+    size_t resourceCount;
+};
+
+#endif
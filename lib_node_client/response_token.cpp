@@ -0,0 +1,73 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file response_token.cpp
+ *  @brief This source file contain the definition of the ResponseToken class.
+ *
+ *  @author Bastien Pillonel <bastien.pillonel@heig-vd.ch>
+ *
+ */
+
+#include "response_token.h"
+
+ResponseToken::Scope *ResponseToken::_scopes = nullptr;
+Mutex ResponseToken::_scopesMutex;
+
+ResponseToken::Scope::Scope(ResponseCompleter *completer, lwm2m_context_t *contextP) : _completer(completer), _contextP(contextP), _thread(ThisThread::get_id())
+{
+    _scopesMutex.lock();
+    _next = _scopes;
+    _scopes = this;
+    _scopesMutex.unlock();
+}
+
+ResponseToken::Scope::~Scope()
+{
+    _scopesMutex.lock();
+    Scope **scopeP = &_scopes;
+    while (*scopeP != this)
+        scopeP = &(*scopeP)->_next;
+    *scopeP = _next;
+    _scopesMutex.unlock();
+}
+
+ResponseToken ResponseToken::Defer()
+{
+#ifdef LWM2M_SEPARATE_RESPONSE
+    osThreadId_t thread = ThisThread::get_id();
+    Scope *scope;
+
+    _scopesMutex.lock();
+    for (scope = _scopes; scope != nullptr && scope->_thread != thread; scope = scope->_next)
+        ;
+    _scopesMutex.unlock();
+    // Only the thread owning the scope reads it, and it outlives this call
+    if (scope == nullptr || !scope->_contextP)
+        return ResponseToken();
+
+    // Only Write and Execute requests can be deferred, -1 otherwise
+    int responseId = lwm2m_defer_response(scope->_contextP);
+    if (responseId < 0)
+        return ResponseToken();
+
+    return ResponseToken(scope->_completer, scope->_contextP, responseId);
+#else
+    return ResponseToken();
+#endif
+}
+
+bool ResponseToken::Complete(uint8_t status) const
+{
+#ifdef LWM2M_SEPARATE_RESPONSE
+    if (_responseId < 0)
+        return false;
+
+    if (_completer)
+        return (*_completer).CompleteResponse(_contextP, _responseId, status) == COAP_NO_ERROR;
+
+    return lwm2m_complete_response(_contextP, _responseId, status) == COAP_NO_ERROR;
+#else
+    (void)status;
+    return false;
+#endif
+}
@@ -0,0 +1,142 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file response_token.h
+ *  @brief This header file contain the declaration of the ResponseToken class given to asynchronous Write/Exec callbacks.
+ *  The request is acknowledged at once and its response is sent when the application completes the token.
+ *
+ *  @author Bastien Pillonel <bastien.pillonel@heig-vd.ch>
+ *
+ */
+
+#ifndef RESPONSE_TOKEN_H
+#define RESPONSE_TOKEN_H
+
+#include <stdint.h>
+#include "mbed.h"
+#include "liblwm2m.h"
+
+/**
+ * @brief Interface of the owner of a LwM2M context, serializing the completion of deferred responses with the other
+ * calls into the context. Implemented by NodeClient.
+ *
+ */
+class ResponseCompleter
+{
+public:
+    /**
+     * @brief Destroy the Response Completer object
+     *
+     */
+    virtual ~ResponseCompleter() {}
+
+    /**
+     * @brief Send the response of a deferred request, may be called from any thread
+     *
+     * @param contextP context the request was received on
+     * @param responseId identifier returned by lwm2m_defer_response()
+     * @param status CoAP status code of the response
+     * @return int COAP_NO_ERROR, COAP_404_NOT_FOUND if the response was already sent
+     */
+    virtual int CompleteResponse(lwm2m_context_t *contextP, int responseId, uint8_t status) = 0;
+};
+
+/**
+ * @brief Completion token of a Write or Execute request whose response is sent later (requires LWM2M_SEPARATE_RESPONSE).
+ * Copies of a token complete the same response, only the first completion sends it.
+ *
+ * A token is invalid when the callback is not called for a request of the server (e.g. Write() called by the
+ * application), or when the request cannot be deferred (Create, feature disabled). The response is then sent as soon
+ * as the callbacks return, as for synchronous callbacks.
+ *
+ */
+class ResponseToken
+{
+public:
+    /**
+     * @brief Requests handled by the thread creating a Scope object, while it exists, are answered through its
+     * completer. Each thread dispatching packets has its own scopes, so clients may handle packets concurrently.
+     *
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @brief Construct a new Scope object, to be created around lwm2m_handle_packet()
+         *
+         * @param completer serializes the completion with the other calls into the context, nullptr if the application
+         * completes the tokens on the thread driving the context
+         * @param contextP context handling the packet
+         */
+        Scope(ResponseCompleter *completer, lwm2m_context_t *contextP);
+
+        /**
+         * @brief Destroy the Scope object, the previous scope of the thread applying again
+         *
+         */
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        friend class ResponseToken;
+
+        ResponseCompleter *_completer;
+        lwm2m_context_t *_contextP;
+        // Callbacks run by a ListenerQueue on another thread cannot defer the request
+        osThreadId_t _thread;
+        Scope *_next;
+    };
+
+    /**
+     * @brief Construct an invalid ResponseToken object
+     *
+     */
+    ResponseToken() : _completer(nullptr), _contextP(nullptr), _responseId(-1) {}
+
+    /**
+     * @brief Construct a new ResponseToken object
+     *
+     * @param completer owner of the context, nullptr to complete directly on the context
+     * @param contextP context the request was received on
+     * @param responseId identifier returned by lwm2m_defer_response()
+     */
+    ResponseToken(ResponseCompleter *completer, lwm2m_context_t *contextP, int responseId) : _completer(completer), _contextP(contextP), _responseId(responseId) {}
+
+    /**
+     * @brief Defer the response of the request being handled
+     *
+     * @return ResponseToken invalid if no request is being handled by the calling thread or if it cannot be deferred
+     */
+    static ResponseToken Defer();
+
+    /**
+     * @brief Send the response of the request, may be called from any thread when the token has a completer
+     *
+     * @param status CoAP status code of the response, COAP_204_CHANGED for a successful Write or Execute
+     * @return true the response is sent, or piggybacked on the acknowledgement when completed inside the callback
+     * @return false the token is invalid, or the response was already sent or timed out
+     */
+    bool Complete(uint8_t status = COAP_204_CHANGED) const;
+
+    /**
+     * @brief Get the identifier of the deferred response
+     *
+     * @return int -1 if the token is invalid
+     */
+    int GetId() const { return _responseId; }
+
+    explicit operator bool() const { return _responseId >= 0; }
+
+private:
+    ResponseCompleter *_completer;
+    lwm2m_context_t *_contextP;
+    int _responseId;
+
+    // Scopes of the threads handling a packet, innermost first
+    static Scope *_scopes;
+    static Mutex _scopesMutex;
+};
+
+#endif
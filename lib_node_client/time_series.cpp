@@ -0,0 +1,259 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file time_series.cpp
+ *  @brief This source file contain the definition of the TimeSeriesBase class.
+ *
+ *  @author Bastien Pillonel <bastien.pillonel@heig-vd.ch>
+ *
+ */
+
+#include <string.h>
+
+#include "time_series.h"
+
+TimeSeriesBase::TimeSeriesBase(const lwm2m_uri_t &uri, size_t capacity, const TimeSeriesPolicy &policy, TimeSeriesTransport transport) : _uri(uri), _capacity(capacity > 0 ? capacity : 1), _policy(policy), _transport(transport)
+{
+}
+
+size_t TimeSeriesBase::Size() const
+{
+    _mutex.lock();
+    size_t count = _count;
+    _mutex.unlock();
+
+    return count;
+}
+
+TimeSeriesStats TimeSeriesBase::GetStats() const
+{
+    _mutex.lock();
+    TimeSeriesStats stats = _stats;
+    _mutex.unlock();
+
+    return stats;
+}
+
+size_t TimeSeriesBase::GetMaxPackSize() const
+{
+    return _policy.maxSize > 0 ? _policy.maxSize : lwm2m_get_coap_block_size();
+}
+
+void TimeSeriesBase::SetDueCallback(Callback<void()> onDue)
+{
+    _mutex.lock();
+    _onDue = onDue;
+    _mutex.unlock();
+}
+
+void TimeSeriesBase::SetResourceMutex(Mutex *mutex)
+{
+    _mutex.lock();
+    _resourceMutex = mutex;
+    _mutex.unlock();
+}
+
+bool TimeSeriesBase::FlushDue(time_t now, time_t *delayP) const
+{
+    bool due = false;
+
+    _mutex.lock();
+    if (_count > 0)
+    {
+        if (now < _retryTime)
+        {
+            if (delayP != nullptr)
+                *delayP = _retryTime - now;
+        }
+        else if (_full())
+        {
+            due = true;
+        }
+        else if (_policy.maxAge > 0)
+        {
+            time_t age = now - _time(_head);
+
+            if (age >= _policy.maxAge)
+                due = true;
+            else if (delayP != nullptr)
+                *delayP = _policy.maxAge - age;
+        }
+    }
+    _mutex.unlock();
+
+    return due;
+}
+
+int TimeSeriesBase::BuildPack(uint8_t *buffer, size_t bufferLen, uint32_t *endP) const
+{
+    int length = 0;
+    size_t position;
+
+    _mutex.lock();
+    time_t baseTime = _count > 0 ? _time(_head) : 0;
+
+    for (position = 0; position < _count; ++position)
+    {
+        int res = _append(_index(position), baseTime, buffer, length, bufferLen);
+
+        if (res < 0)
+            break;
+        length = res;
+    }
+    *endP = _first + position;
+    _mutex.unlock();
+
+    // A sample alone does not fit
+    if (length == 0 && position < _count)
+        return -1;
+
+    return length;
+}
+
+void TimeSeriesBase::Release(uint32_t end)
+{
+    _mutex.lock();
+    // Samples overwritten since the pack was built are already gone
+    while (_count > 0 && (int32_t)(end - _first) > 0)
+    {
+        _head = (_head + 1) % _capacity;
+        _first++;
+        _count--;
+        _stats.uploaded++;
+    }
+    _stats.packs++;
+    _retryTime = 0;
+    _packSize = _measure();
+    _mutex.unlock();
+}
+
+void TimeSeriesBase::Retry(time_t now)
+{
+    _mutex.lock();
+    _stats.failures++;
+    _retryTime = now + TIME_SERIES_RETRY_DELAY;
+    _mutex.unlock();
+}
+
+size_t TimeSeriesBase::_push(time_t time)
+{
+    size_t index = _index(_count);
+
+    _stats.recorded++;
+    if (_count == _capacity)
+    {
+        // The new sample takes the room of the oldest one
+        _head = (_head + 1) % _capacity;
+        _first++;
+        _stats.overwritten++;
+        _remeasure = true;
+    }
+    else
+    {
+        _count++;
+    }
+
+    return index;
+}
+
+Callback<void()> TimeSeriesBase::_recorded()
+{
+    if (_remeasure || _count == 1)
+    {
+        _packSize = _measure();
+        _remeasure = false;
+    }
+#if defined(LWM2M_SUPPORT_SENML_JSON)
+    else
+    {
+        uint8_t record[TIME_SERIES_RECORD_MAX_SIZE] = { '[', ']' };
+        int res = _append(_index(_count - 1), _time(_head), record, 2, sizeof(record));
+
+        // Appended to an empty pack, the separator included
+        if (res > 2)
+            _packSize += res - 2;
+    }
+#endif
+
+    // An upload due because of the age of the samples is left to the client
+    if (!_full())
+        return nullptr;
+
+    return _onDue;
+}
+
+void TimeSeriesBase::_rejected()
+{
+    _mutex.lock();
+    _stats.rejected++;
+    _mutex.unlock();
+}
+
+Mutex *TimeSeriesBase::_getResourceMutex() const
+{
+    _mutex.lock();
+    Mutex *mutex = _resourceMutex;
+    _mutex.unlock();
+
+    return mutex;
+}
+
+bool TimeSeriesBase::_full() const
+{
+    size_t maxCount = (_policy.maxCount > 0 && _policy.maxCount < _capacity) ? _policy.maxCount : _capacity;
+
+    if (_count >= maxCount)
+        return true;
+
+#if defined(LWM2M_SUPPORT_SENML_JSON)
+    // The next sample may not fit in the pack
+    if (_packSize + TIME_SERIES_RECORD_MAX_SIZE > GetMaxPackSize())
+        return true;
+#endif
+
+    return false;
+}
+
+size_t TimeSeriesBase::_measure() const
+{
+#if defined(LWM2M_SUPPORT_SENML_JSON)
+    uint8_t record[TIME_SERIES_RECORD_MAX_SIZE];
+    size_t size = 0;
+
+    if (_count == 0)
+        return 0;
+
+    // The first record holds the base name and the base time, the next ones a relative time
+    int res = _append(_head, _time(_head), record, 0, sizeof(record));
+    if (res > 0)
+        size = res;
+
+    for (size_t position = 1; position < _count; ++position)
+    {
+        record[0] = '[';
+        record[1] = ']';
+        res = _append(_index(position), _time(_head), record, 2, sizeof(record));
+        if (res > 2)
+            size += res - 2;
+    }
+
+    return size;
+#else
+    return 0;
+#endif
+}
+
+int TimeSeriesBase::_append(size_t index, time_t baseTime, uint8_t *buffer, size_t length, size_t bufferLen) const
+{
+#if defined(LWM2M_SUPPORT_SENML_JSON)
+    lwm2m_data_t data;
+    lwm2m_uri_t uri = _uri;
+
+    memset(&data, 0, sizeof(data));
+    _encode(index, &data);
+
+    return lwm2m_data_append_series(&uri, baseTime, _time(index), &data, buffer, length, bufferLen);
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,408 @@
+/**
+ *  Copyright (c) 2024
+ *
+ *  @file time_series.h
+ *  @brief This header file contain the declaration of the TimeSeries class, a ring buffer of timestamped values of a
+ *  resource uploaded by the client as a single SenML JSON pack, with a base time and timestamps relative to it.
+ *
+ *  @author Bastien Pillonel <bastien.pillonel@heig-vd.ch>
+ *
+ */
+
+#ifndef TIME_SERIES_H
+#define TIME_SERIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+
+#include "mbed.h"
+#include "liblwm2m.h"
+#include "resource.h"
+
+#define TIME_SERIES_CAPACITY 32
+// Delay before uploading again the samples of a series whose upload failed, in seconds
+#define TIME_SERIES_RETRY_DELAY 30
+// Room for the longest record of a sample, base name and base time included
+#define TIME_SERIES_RECORD_MAX_SIZE 96
+// Times below are counted from the boot, the RTC is not set yet (2^28 seconds since the epoch, in 1978)
+#define TIME_SERIES_MIN_TIME ((time_t)1 << 28)
+// Returned by Record when the time of the sample is below TIME_SERIES_MIN_TIME, next to the codes of Resource
+#define TIME_SERIES_CLOCK_NOT_SET 6
+
+/**
+ * @brief When the samples of a TimeSeries are uploaded, the first condition met triggers the upload
+ *
+ */
+struct TimeSeriesPolicy
+{
+    size_t maxCount; // samples stored, 0 for the capacity of the series
+    time_t maxAge;   // seconds since the oldest sample was recorded, 0 disables
+    size_t maxSize;  // bytes of the pack, also the largest pack sent, 0 for the CoAP block size
+};
+
+/**
+ * @brief How the samples of a TimeSeries reach the server
+ *
+ */
+enum class TimeSeriesTransport
+{
+    NOTIFY, // notification of the resource, to the servers observing it in SenML JSON
+    SEND    // Send operation to every registered server (requires LwM2M 1.1)
+};
+
+/**
+ * @brief Metrics of a TimeSeries
+ *
+ */
+struct TimeSeriesStats
+{
+    uint32_t recorded;    // samples recorded
+    uint32_t uploaded;    // samples accepted by the transport
+    uint32_t overwritten; // samples lost because the series was full
+    uint32_t packs;       // packs accepted by the transport
+    uint32_t failures;    // uploads refused by the transport, the samples are kept
+    uint32_t rejected;    // samples refused because the clock was not set
+};
+
+/**
+ * @brief Ring buffer of timestamped values of a resource, whatever the value type. Its room is allocated once, when
+ * full the oldest sample is overwritten.
+ *
+ * Samples are recorded by the application thread and uploaded by the thread of the client the series is added to,
+ * which also serializes the updates of the resource with its calls into the LwM2M context.
+ *
+ */
+class TimeSeriesBase
+{
+public:
+    /**
+     * @brief Destroy the Time Series Base object
+     *
+     */
+    virtual ~TimeSeriesBase() {}
+
+    TimeSeriesBase(const TimeSeriesBase &) = delete;
+    TimeSeriesBase &operator=(const TimeSeriesBase &) = delete;
+
+    /**
+     * @brief Get the number of samples stored
+     *
+     * @return size_t
+     */
+    size_t Size() const;
+
+    /**
+     * @brief Get the maximum number of samples stored
+     *
+     * @return size_t
+     */
+    size_t Capacity() const { return _capacity; }
+
+    /**
+     * @brief Get the path of the resource
+     *
+     * @return const lwm2m_uri_t&
+     */
+    const lwm2m_uri_t &GetUri() const { return _uri; }
+
+    /**
+     * @brief Get the upload conditions
+     *
+     * @return const TimeSeriesPolicy&
+     */
+    const TimeSeriesPolicy &GetPolicy() const { return _policy; }
+
+    /**
+     * @brief Get the way the samples reach the server
+     *
+     * @return TimeSeriesTransport
+     */
+    TimeSeriesTransport GetTransport() const { return _transport; }
+
+    /**
+     * @brief Get the size of the largest pack uploaded, maxSize of the policy or the CoAP block size
+     *
+     * @return size_t
+     */
+    size_t GetMaxPackSize() const;
+
+    /**
+     * @brief Get the metrics
+     *
+     * @return TimeSeriesStats
+     */
+    TimeSeriesStats GetStats() const;
+
+    /**
+     * @brief Call a function when an upload becomes due because of a new sample, set by the client the series is
+     * added to so that it uploads without waiting for its next step
+     *
+     * @param onDue function called on the thread recording the sample, nullptr to remove it
+     */
+    void SetDueCallback(Callback<void()> onDue);
+
+    /**
+     * @brief Set the mutex held while the resource is updated, set by the client the series is added to so that the
+     * value does not change while the LwM2M context reads it
+     *
+     * @param mutex LwM2M mutex of the client, nullptr to remove it
+     */
+    void SetResourceMutex(Mutex *mutex);
+
+    /**
+     * @brief Inform if the samples have to be uploaded
+     *
+     * @param now current time, in the time base of the samples
+     * @param delayP (can be nullptr) receives the number of seconds until the upload is due because of the age of
+     * the samples, left unchanged if the age does not matter
+     * @return true upload due
+     * @return false nothing to upload yet
+     */
+    bool FlushDue(time_t now, time_t *delayP = nullptr) const;
+
+    /**
+     * @brief Serialize the oldest samples in a SenML JSON pack, as many as fit (requires LWM2M_SUPPORT_SENML_JSON)
+     *
+     * @param buffer room for the pack
+     * @param bufferLen size of buffer
+     * @param endP receives the sequence number following the last sample serialized, given to Release
+     * @return int length of the pack, 0 if there is no sample, -1 if a sample cannot be serialized
+     */
+    int BuildPack(uint8_t *buffer, size_t bufferLen, uint32_t *endP) const;
+
+    /**
+     * @brief Remove the samples uploaded, the ones overwritten meanwhile are skipped
+     *
+     * @param end sequence number returned by BuildPack
+     */
+    void Release(uint32_t end);
+
+    /**
+     * @brief Record a failed upload, the samples are uploaded again after TIME_SERIES_RETRY_DELAY seconds
+     *
+     * @param now current time, in the time base of the samples
+     */
+    void Retry(time_t now);
+
+protected:
+    /**
+     * @brief Construct a new Time Series Base object
+     *
+     * @param uri path of the resource
+     * @param capacity maximum number of samples stored
+     * @param policy upload conditions
+     * @param transport way the samples reach the server
+     */
+    TimeSeriesBase(const lwm2m_uri_t &uri, size_t capacity, const TimeSeriesPolicy &policy, TimeSeriesTransport transport);
+
+    /**
+     * @brief Make room for a new sample, overwriting the oldest one if the series is full, under the lock
+     *
+     * @param time timestamp of the sample
+     * @return size_t position of the new sample in the ring
+     */
+    size_t _push(time_t time);
+
+    /**
+     * @brief Account for the new sample once stored, under the lock
+     *
+     * @return Callback<void()> function to call once the lock is released, nullptr if no upload became due
+     */
+    Callback<void()> _recorded();
+
+    /**
+     * @brief Account for a sample refused because the clock was not set
+     *
+     */
+    void _rejected();
+
+    /**
+     * @brief Get the mutex to hold while the resource is updated
+     *
+     * @return Mutex* nullptr if the series is not added to a client
+     */
+    Mutex *_getResourceMutex() const;
+
+    /**
+     * @brief Get the position in the ring of a sample
+     *
+     * @param position rank of the sample, oldest first
+     * @return size_t
+     */
+    size_t _index(size_t position) const { return (_head + position) % _capacity; }
+
+    /**
+     * @brief Encode the value of a sample
+     *
+     * @param index position of the sample in the ring
+     * @param dataP data receiving the value
+     */
+    virtual void _encode(size_t index, lwm2m_data_t *dataP) const = 0;
+
+    /**
+     * @brief Get the timestamp of a sample
+     *
+     * @param index position of the sample in the ring
+     * @return time_t
+     */
+    virtual time_t _time(size_t index) const = 0;
+
+    mutable Mutex _mutex;
+
+private:
+    lwm2m_uri_t _uri;
+    size_t _capacity;
+    TimeSeriesPolicy _policy;
+    TimeSeriesTransport _transport;
+    Callback<void()> _onDue;
+    Mutex *_resourceMutex = nullptr;
+    // Sequence number of the oldest sample, at position _head in the ring
+    uint32_t _first = 0;
+    size_t _head = 0;
+    size_t _count = 0;
+    // Length of the pack of the samples stored, measured again when the oldest sample changes
+    size_t _packSize = 0;
+    bool _remeasure = false;
+    time_t _retryTime = 0;
+    TimeSeriesStats _stats = {};
+
+    /**
+     * @brief Inform if the upload is due because of the number of samples or the size of their pack, under the lock
+     *
+     * @return true upload due
+     * @return false not yet
+     */
+    bool _full() const;
+
+    /**
+     * @brief Length of the pack of the samples stored, recomputed when the oldest ones are removed
+     *
+     * @return size_t
+     */
+    size_t _measure() const;
+
+    /**
+     * @brief Append the record of a sample to a pack
+     *
+     * @param index position of the sample in the ring
+     * @param baseTime timestamp of the oldest sample of the pack
+     * @param buffer pack
+     * @param length length of the pack, 0 for the first record
+     * @param bufferLen size of buffer
+     * @return int new length of the pack, -1 if the record does not fit
+     */
+    int _append(size_t index, time_t baseTime, uint8_t *buffer, size_t length, size_t bufferLen) const;
+};
+
+/**
+ * @brief Ring buffer of timestamped values of a resource
+ *
+ * @tparam T type of value stored in the resource, int, float, double or bool
+ */
+template <class T>
+class TimeSeries : public TimeSeriesBase
+{
+public:
+    /**
+     * @brief Sample of the resource, 4 bytes of timestamp before the value
+     *
+     */
+    struct Sample
+    {
+        uint32_t time;
+        T value;
+    };
+
+    /**
+     * @brief Construct a new Time Series object recording the values of a resource
+     *
+     * @param resource resource updated with each value recorded, must outlive the series
+     * @param objectId ID of the object holding the resource
+     * @param instanceId ID of the object instance holding the resource
+     * @param capacity maximum number of samples stored
+     * @param policy upload conditions
+     * @param transport way the samples reach the server
+     */
+    TimeSeries(Resource &resource, uint16_t objectId, uint16_t instanceId, size_t capacity = TIME_SERIES_CAPACITY, const TimeSeriesPolicy &policy = {}, TimeSeriesTransport transport = TimeSeriesTransport::NOTIFY)
+        : TimeSeriesBase(_makeUri(objectId, instanceId, resource.GetId()), capacity, policy, transport), _resource(resource), _samples(capacity) {}
+
+    /**
+     * @brief Record a value, stored in the resource as well
+     *
+     * @param value new value of the resource
+     * @param time timestamp of the value, in seconds since the epoch
+     * @return int error code of Resource::SetValue, the sample is recorded anyway, or TIME_SERIES_CLOCK_NOT_SET if
+     * the time is counted from the boot: the resource is updated but the sample is not recorded
+     */
+    int Record(const T &value, time_t time = ::time(nullptr))
+    {
+        Mutex *resourceMutex = _getResourceMutex();
+
+        if (resourceMutex != nullptr)
+            (*resourceMutex).lock();
+        int result = _resource.SetValue<T>(value);
+        if (resourceMutex != nullptr)
+            (*resourceMutex).unlock();
+
+        if (time < TIME_SERIES_MIN_TIME)
+        {
+            _rejected();
+            return TIME_SERIES_CLOCK_NOT_SET;
+        }
+
+        _mutex.lock();
+        Sample &sample = _samples[_push(time)];
+        sample.time = (uint32_t)time;
+        sample.value = value;
+        Callback<void()> onDue = _recorded();
+        _mutex.unlock();
+
+        if (onDue)
+        {
+            onDue();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get a sample, oldest first
+     *
+     * @param position rank of the sample, lower than Size()
+     * @return Sample
+     */
+    Sample Get(size_t position) const
+    {
+        _mutex.lock();
+        Sample sample = _samples[_index(position)];
+        _mutex.unlock();
+
+        return sample;
+    }
+
+private:
+    Resource &_resource;
+    std::vector<Sample> _samples;
+
+    static lwm2m_uri_t _makeUri(uint16_t objectId, uint16_t instanceId, uint16_t resourceId)
+    {
+        lwm2m_uri_t uri;
+
+        LWM2M_URI_RESET(&uri);
+        uri.objectId = objectId;
+        uri.instanceId = instanceId;
+        uri.resourceId = resourceId;
+        return uri;
+    }
+
+    static void _encodeValue(int value, lwm2m_data_t *dataP) { lwm2m_data_encode_int(value, dataP); }
+    static void _encodeValue(float value, lwm2m_data_t *dataP) { lwm2m_data_encode_float(value, dataP); }
+    static void _encodeValue(double value, lwm2m_data_t *dataP) { lwm2m_data_encode_float(value, dataP); }
+    static void _encodeValue(bool value, lwm2m_data_t *dataP) { lwm2m_data_encode_bool(value, dataP); }
+
+    void _encode(size_t index, lwm2m_data_t *dataP) const override { _encodeValue(_samples[index].value, dataP); }
+    time_t _time(size_t index) const override { return (time_t)_samples[index].time; }
+};
+
+#endif
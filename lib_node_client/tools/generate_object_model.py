@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+#
+#  Copyright (c) 2024
+#
+#  Generate object_model.cpp, the constexpr descriptor tables of the objects and resources
+#  known by the client, from OMA LwM2M object definitions (DDF XML files).
+#
+#  Usage: generate_object_model.py [-o OUTPUT] [XML ...]
+#  Without arguments, every objects/*.xml file is read and ../object_model.cpp is written.
+#
+
+import argparse
+import glob
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+OPERATIONS = {
+    'R': 'ResourceOp::RES_RD',
+    'W': 'ResourceOp::RES_WR',
+    'RW': 'ResourceOp::RES_RDWR',
+    'E': 'ResourceOp::RES_E',
+}
+
+# Execute resources have no type in the definitions, they hold an integer
+TYPES = {
+    'Integer': 'ResourceType::INTEGER',
+    'Unsigned Integer': 'ResourceType::INTEGER',
+    'Float': 'ResourceType::FLOAT',
+    'Boolean': 'ResourceType::BOOLEAN',
+    'String': 'ResourceType::STRING',
+    'Time': 'ResourceType::TIME',
+    '': 'ResourceType::INTEGER',
+}
+
+UNITS = {
+    '': 'Units::NA',
+    'h': 'Units::HOURS',
+    '%': 'Units::PERCENT',
+    'Ah': 'Units::AMPER_HOUR',
+    'V': 'Units::VOLT',
+    'dBm': 'Units::DECIBEL_MILLIWATT',
+    'Hz': 'Units::HERTZ',
+    's': 'Units::SECONDS',
+    'dB': 'Units::DECIBEL',
+    'ms': 'Units::MILLISECOND',
+    'B': 'Units::BYTES',
+    'Cel': 'Units::CELCIUS_DEGREES',
+    'W': 'Units::WATT',
+    'K': 'Units::KELVIN',
+    'A': 'Units::AMPER',
+    'kWh': 'Units::KILOWATT_HOUR',
+    'lm': 'Units::LUMEN',
+    'Wh': 'Units::WATT_HOUR',
+    'var': 'Units::VAR',
+    'varh': 'Units::VAR_HOUR',
+    'lx': 'Units::LX',
+    'kvarh': 'Units::KILOVAR_HOUR',
+}
+
+HEADER = '''/**
+ *  Copyright (c) 2024
+ *
+ *  @file object_model.cpp
+ *  @brief This source file contain the descriptors of every object and resource known by the client.
+ *
+ *  Generated by tools/generate_object_model.py from the object definitions in objects/, do not edit.
+ *
+ */
+
+#include "object_model.h"
+'''
+
+
+def text(element, tag):
+    child = element.find(tag)
+    if child is None or child.text is None:
+        return ''
+    return child.text.strip()
+
+
+def c_string(value):
+    return '"' + value.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def c_identifier(name):
+    return re.sub(r'[^A-Z0-9]+', '_', name.upper()).strip('_')
+
+
+def parse(path):
+    obj = ET.parse(path).getroot().find('Object')
+    if obj is None:
+        sys.exit('%s: no Object element' % path)
+
+    resources = []
+    for item in obj.find('Resources').findall('Item'):
+        name = text(item, 'Name')
+        operations = text(item, 'Operations')
+        res_type = text(item, 'Type')
+        units = text(item, 'Units')
+        for value, table in ((operations, OPERATIONS), (res_type, TYPES), (units, UNITS)):
+            if value not in table:
+                sys.exit('%s: resource %s: unsupported value "%s"' % (path, item.get('ID'), value))
+        # Time resources hold a date
+        unit = UNITS[units]
+        if res_type == 'Time' and units == '':
+            unit = 'Units::DATE'
+        resources.append({
+            'id': int(item.get('ID')),
+            'name': name,
+            'op': OPERATIONS[operations],
+            'type': TYPES[res_type],
+            'unit': unit,
+            'multiple': text(item, 'MultipleInstances') == 'Multiple',
+        })
+    resources.sort(key=lambda res: res['id'])
+
+    return {
+        'id': int(text(obj, 'ObjectID')),
+        'name': text(obj, 'Name'),
+        'multiple': text(obj, 'MultipleInstances') == 'Multiple',
+        'resources': resources,
+    }
+
+
+def generate(objects):
+    lines = [HEADER]
+    for obj in objects:
+        lines.append('static constexpr ResourceDescriptor %s_RESOURCES[] = {' % c_identifier(obj['name']))
+        for res in obj['resources']:
+            lines.append('    { %d, %s, %s, %s, %s, %s },' % (res['id'], res['op'], res['type'], res['unit'],
+                                                          'true' if res['multiple'] else 'false', c_string(res['name'])))
+        lines.append('};')
+        lines.append('')
+
+    lines.append('constexpr ObjectDescriptor OBJECT_MODEL[] = {')
+    for obj in objects:
+        identifier = c_identifier(obj['name'])
+        lines.append('    { %d, %s, %s, %s_RESOURCES, sizeof(%s_RESOURCES) / sizeof(ResourceDescriptor) },' % (
+            obj['id'], 'true' if obj['multiple'] else 'false', c_string(obj['name']), identifier, identifier))
+    lines.append('};')
+    lines.append('')
+    lines.append('constexpr size_t OBJECT_MODEL_SIZE = sizeof(OBJECT_MODEL) / sizeof(ObjectDescriptor);')
+    lines.append('')
+    return '\n'.join(lines)
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description='Generate the object model descriptor tables')
+    parser.add_argument('-o', '--output', default=os.path.join(root, 'object_model.cpp'))
+    parser.add_argument('definitions', nargs='*')
+    args = parser.parse_args()
+
+    paths = args.definitions or glob.glob(os.path.join(root, 'objects', '*.xml'))
+    objects = sorted((parse(path) for path in paths), key=lambda obj: obj['id'])
+
+    ids = [obj['id'] for obj in objects]
+    if len(ids) != len(set(ids)):
+        sys.exit('duplicated object ID')
+
+    with open(args.output, 'w') as output:
+        output.write(generate(objects))
+
+
+if __name__ == '__main__':
+    main()
@@ -61,13 +61,6 @@
 #define PRINTLLADDR(addr)
 #endif
 
-/*-----------------------------------------------------------------------------------*/
-/*- Variables -----------------------------------------------------------------------*/
-/*-----------------------------------------------------------------------------------*/
-static uint16_t current_mid = 0;
-
-coap_status_t coap_error_code = NO_ERROR;
-const char *coap_error_message = "";
 /*-----------------------------------------------------------------------------------*/
 /*- LOCAL HELP FUNCTIONS ------------------------------------------------------------*/
 /*-----------------------------------------------------------------------------------*/
@@ -262,6 +255,7 @@ coap_add_multi_option(multi_option_t **dst, uint8_t *option, size_t option_len,
   if (opt)
   {
     opt->next = NULL;
+    opt->is_pooled = 0;
     opt->len = (uint8_t)option_len;
     if (is_static)
     {
@@ -296,6 +290,15 @@ coap_add_multi_option(multi_option_t **dst, uint8_t *option, size_t option_len,
   }
 }
 
+void
+coap_copy_multi_option(multi_option_t **dst, multi_option_t *src)
+{
+  for ( ; src != NULL ; src = src->next)
+  {
+    coap_add_multi_option(dst, src->data, src->len, 0);
+  }
+}
+
 void
 free_multi_option(multi_option_t *dst)
 {
@@ -307,11 +310,40 @@ free_multi_option(multi_option_t *dst)
     {
         lwm2m_free(dst->data);
     }
-    lwm2m_free(dst);
+    if (dst->is_pooled == 0)
+    {
+        lwm2m_free(dst);
+    }
     free_multi_option(n);
   }
 }
 
+/* Parsed segments point into the received buffer. The nodes come from the packet pool while it lasts. */
+static void
+coap_add_parsed_multi_option(coap_packet_t *coap_pkt, multi_option_t **dst, uint8_t *option, size_t option_len)
+{
+#if COAP_OPTION_POOL_SIZE > 0
+  if (coap_pkt->option_pool_used < COAP_OPTION_POOL_SIZE)
+  {
+    multi_option_t *opt = coap_pkt->option_pool + coap_pkt->option_pool_used++;
+
+    opt->next = NULL;
+    opt->is_static = 1;
+    opt->is_pooled = 1;
+    opt->len = (uint8_t)option_len;
+    opt->data = option;
+
+    while (*dst)
+    {
+      dst = &((*dst)->next);
+    }
+    *dst = opt;
+    return;
+  }
+#endif
+  coap_add_multi_option(dst, option, option_len, 1);
+}
+
 static
 char *
 prv_coap_get_multi_option_as_string(multi_option_t * option, char prefix, char delimiter)
@@ -461,12 +493,6 @@ coap_get_variable(const uint8_t *buffer, size_t length, const char *name, const
   return 0;
 }
 
-/*-----------------------------------------------------------------------------------*/
-uint16_t
-coap_get_mid(void)
-{
-  return ++current_mid;
-}
 /*-----------------------------------------------------------------------------------*/
 /*- MEASSAGE PROCESSING -------------------------------------------------------------*/
 /*-----------------------------------------------------------------------------------*/
@@ -531,6 +557,10 @@ size_t coap_serialize_get_size(void *packet)
         // can be stored in extended fields
         length += COAP_MAX_OPTION_HEADER_LEN;
     }
+    if (IS_OPTION(coap_pkt, COAP_OPTION_OSCORE))
+    {
+        length += COAP_MAX_OPTION_HEADER_LEN + coap_pkt->oscore_len;
+    }
     if (IS_OPTION(coap_pkt, COAP_OPTION_LOCATION_PATH))
     {
         multi_option_t * optP;
@@ -595,6 +625,12 @@ size_t coap_serialize_get_size(void *packet)
     {
         length += COAP_MAX_OPTION_HEADER_LEN + coap_pkt->proxy_uri_len;
     }
+#ifdef LWM2M_SUPPORT_OSCORE
+    if (coap_pkt->echo != NULL)
+    {
+        length += COAP_MAX_OPTION_HEADER_LEN + coap_pkt->echo_len;
+    }
+#endif
 
     if (coap_pkt->payload_len)
     {
@@ -606,8 +642,9 @@ size_t coap_serialize_get_size(void *packet)
 }
 
 /*-----------------------------------------------------------------------------------*/
+/* Serializes everything but the payload, which the caller sends from its own buffer. */
 size_t
-coap_serialize_message(void *packet, uint8_t *buffer)
+coap_serialize_header(void *packet, uint8_t *buffer)
 {
   coap_packet_t *const coap_pkt = (coap_packet_t *) packet;
   uint8_t *option;
@@ -652,6 +689,7 @@ coap_serialize_message(void *packet, uint8_t *buffer)
   COAP_SERIALIZE_INT_OPTION(    COAP_OPTION_OBSERVE,        observe, "Observe")
   COAP_SERIALIZE_INT_OPTION(    COAP_OPTION_URI_PORT,       uri_port, "Uri-Port")
   COAP_SERIALIZE_MULTI_OPTION(  COAP_OPTION_LOCATION_PATH,  location_path, "Location-Path")
+  COAP_SERIALIZE_STRING_OPTION( COAP_OPTION_OSCORE,         oscore, '\0', "OSCORE")
   COAP_SERIALIZE_MULTI_OPTION(  COAP_OPTION_URI_PATH,       uri_path, "Uri-Path")
   COAP_SERIALIZE_INT_OPTION(    COAP_OPTION_CONTENT_TYPE,   content_type, "Content-Format")
   COAP_SERIALIZE_INT_OPTION(    COAP_OPTION_MAX_AGE,        max_age, "Max-Age")
@@ -662,13 +700,20 @@ coap_serialize_message(void *packet, uint8_t *buffer)
   COAP_SERIALIZE_BLOCK_OPTION(  COAP_OPTION_BLOCK1,         block1, "Block1")
   COAP_SERIALIZE_INT_OPTION(    COAP_OPTION_SIZE,           size, "Size")
   COAP_SERIALIZE_STRING_OPTION( COAP_OPTION_PROXY_URI,      proxy_uri, '\0', "Proxy-Uri")
+#ifdef LWM2M_SUPPORT_OSCORE
+  if (coap_pkt->echo != NULL)
+  {
+    PRINTF("Echo [%u B]\n", coap_pkt->echo_len);
+    option += coap_serialize_array_option(COAP_OPTION_ECHO, current_number, option, (uint8_t *) coap_pkt->echo, coap_pkt->echo_len, '\0');
+    current_number = COAP_OPTION_ECHO;
+  }
+#endif
 
   PRINTF("-Done serializing at %p----\n", option);
 
   /* Free allocated header fields */
   coap_free_header(packet);
 
-  /* Pack payload */
   /* Payload marker */
   if (coap_pkt->payload_len)
   {
@@ -676,6 +721,18 @@ coap_serialize_message(void *packet, uint8_t *buffer)
     ++option;
   }
 
+  return option - buffer;
+}
+/*-----------------------------------------------------------------------------------*/
+size_t
+coap_serialize_message(void *packet, uint8_t *buffer)
+{
+  coap_packet_t *const coap_pkt = (coap_packet_t *) packet;
+  uint8_t *option;
+
+  option = buffer + coap_serialize_header(packet, buffer);
+
+  /* Pack payload */
   memmove(option, coap_pkt->payload, coap_pkt->payload_len);
 
   PRINTF("-Done %u B (header len %u, payload len %u)-\n", coap_pkt->payload_len + option - buffer, option - buffer, coap_pkt->payload_len);
@@ -726,7 +783,7 @@ coap_parse_message(void *packet, uint8_t *data, uint16_t data_len)
 
   if (coap_pkt->version != 1)
   {
-    coap_error_message = "CoAP version must be 1";
+    coap_pkt->error_message = "CoAP version must be 1";
     return BAD_REQUEST_4_00;
   }
 
@@ -891,19 +948,34 @@ coap_parse_message(void *packet, uint8_t *data, uint16_t data_len)
       case COAP_OPTION_URI_PATH:
         /* coap_merge_multi_option() operates in-place on the IPBUF, but final packet field should be const string -> cast to string */
         // coap_merge_multi_option( (char **) &(coap_pkt->uri_path), &(coap_pkt->uri_path_len), current_option, option_length, 0);
-        coap_add_multi_option( &(coap_pkt->uri_path), current_option, option_length, 1);
+        coap_add_parsed_multi_option(coap_pkt, &(coap_pkt->uri_path), current_option, option_length);
         PRINTF("Uri-Path [%.*s]\n", option_length, current_option);
         break;
       case COAP_OPTION_URI_QUERY:
         /* coap_merge_multi_option() operates in-place on the IPBUF, but final packet field should be const string -> cast to string */
         // coap_merge_multi_option( (char **) &(coap_pkt->uri_query), &(coap_pkt->uri_query_len), current_option, option_length, '&');
-        coap_add_multi_option( &(coap_pkt->uri_query), current_option, option_length, 1);
+        coap_add_parsed_multi_option(coap_pkt, &(coap_pkt->uri_query), current_option, option_length);
         PRINTF("Uri-Query [%.*s]\n", option_length, current_option);
         break;
 
       case COAP_OPTION_LOCATION_PATH:
-        coap_add_multi_option( &(coap_pkt->location_path), current_option, option_length, 1);
+        coap_add_parsed_multi_option(coap_pkt, &(coap_pkt->location_path), current_option, option_length);
+        break;
+#ifdef LWM2M_SUPPORT_OSCORE
+      case COAP_OPTION_OSCORE:
+        coap_pkt->oscore = current_option;
+        coap_pkt->oscore_len = option_length;
+        PRINTF("OSCORE %u B\n", option_length);
+        break;
+      case COAP_OPTION_ECHO:
+        if (option_length == 0 || option_length > 40) {
+            goto exit_parse_error;
+        }
+        coap_pkt->echo = current_option;
+        coap_pkt->echo_len = option_length;
+        PRINTF("Echo %u B\n", option_length);
         break;
+#endif
       case COAP_OPTION_LOCATION_QUERY:
         /* coap_merge_multi_option() operates in-place on the IPBUF, but final packet field should be const string -> cast to string */
         coap_merge_multi_option( &(coap_pkt->location_query), &(coap_pkt->location_query_len), current_option, option_length, '&');
@@ -916,7 +988,7 @@ coap_parse_message(void *packet, uint8_t *data, uint16_t data_len)
         coap_pkt->proxy_uri_len = option_length;
         /*TODO length > 270 not implemented (actually not required) */
         PRINTF("Proxy-Uri NOT IMPLEMENTED [%.*s]\n", coap_pkt->proxy_uri_len, coap_pkt->proxy_uri);
-        coap_error_message = "This is a constrained server (Contiki)";
+        coap_pkt->error_message = "This is a constrained server (Contiki)";
         return PROXYING_NOT_SUPPORTED_5_05;
 
       case COAP_OPTION_OBSERVE:
@@ -948,7 +1020,7 @@ coap_parse_message(void *packet, uint8_t *data, uint16_t data_len)
         /* Check if critical (odd) */
         if (option_number & 1)
         {
-          coap_error_message = "Unsupported critical option";
+          coap_pkt->error_message = "Unsupported critical option";
           coap_free_header(coap_pkt);
           return BAD_OPTION_4_02;
         }
@@ -964,7 +1036,7 @@ coap_parse_message(void *packet, uint8_t *data, uint16_t data_len)
 
 exit_parse_error:
   coap_free_header(coap_pkt);
-  coap_error_message = "Invalid COAP message";
+  coap_pkt->error_message = "Invalid COAP message";
   return BAD_REQUEST_4_00;
 }
 /*-----------------------------------------------------------------------------------*/
@@ -1190,6 +1262,51 @@ coap_set_header_proxy_uri(void *packet, const char *uri)
 }
 /*-----------------------------------------------------------------------------------*/
 int
+coap_get_header_oscore(void *packet, const uint8_t **value)
+{
+  coap_packet_t *const coap_pkt = (coap_packet_t *) packet;
+
+  if (!IS_OPTION(coap_pkt, COAP_OPTION_OSCORE)) return -1;
+
+  *value = coap_pkt->oscore;
+  return coap_pkt->oscore_len;
+}
+
+int
+coap_set_header_oscore(void *packet, const uint8_t *value, size_t length)
+{
+  coap_packet_t *const coap_pkt = (coap_packet_t *) packet;
+
+  coap_pkt->oscore = value;
+  coap_pkt->oscore_len = length;
+
+  SET_OPTION(coap_pkt, COAP_OPTION_OSCORE);
+  return coap_pkt->oscore_len;
+}
+#ifdef LWM2M_SUPPORT_OSCORE
+int
+coap_get_header_echo(void *packet, const uint8_t **value)
+{
+  coap_packet_t *const coap_pkt = (coap_packet_t *) packet;
+
+  if (coap_pkt->echo == NULL) return -1;
+
+  *value = coap_pkt->echo;
+  return coap_pkt->echo_len;
+}
+
+int
+coap_set_header_echo(void *packet, const uint8_t *value, size_t length)
+{
+  coap_packet_t *const coap_pkt = (coap_packet_t *) packet;
+
+  coap_pkt->echo = value;
+  coap_pkt->echo_len = (uint8_t)length;
+  return coap_pkt->echo_len;
+}
+#endif
+/*-----------------------------------------------------------------------------------*/
+int
 coap_get_header_uri_host(void *packet, const char **host)
 {
   coap_packet_t *const coap_pkt = (coap_packet_t *) packet;
@@ -61,6 +61,9 @@
 #define COAP_ETAG_LEN                        8 /* The maximum number of bytes for the ETag */
 #define COAP_TOKEN_LEN                       8 /* The maximum number of bytes for the Token */
 #define COAP_MAX_ACCEPT_NUM                  2 /* The maximum number of accept preferences to parse/store */
+#ifndef COAP_OPTION_POOL_SIZE
+#define COAP_OPTION_POOL_SIZE                4 /* The number of parsed multi-option segments stored without allocation, a full LwM2M path */
+#endif
 
 #define COAP_MAX_OPTION_HEADER_LEN           5
 
@@ -102,7 +105,10 @@ typedef enum {
   COAP_GET = 1,
   COAP_POST,
   COAP_PUT,
-  COAP_DELETE
+  COAP_DELETE,
+  COAP_FETCH,   /* RFC 8132 */
+  COAP_PATCH,
+  COAP_IPATCH
 } coap_method_t;
 
 #define COAP_EMPTY_MESSAGE_CODE 0x00
@@ -153,6 +159,7 @@ typedef enum {
   COAP_OPTION_OBSERVE = 6,        /* 0-3 B */
   COAP_OPTION_URI_PORT = 7,       /* 0-2 B */
   COAP_OPTION_LOCATION_PATH = 8,  /* 0-255 B */
+  COAP_OPTION_OSCORE = 9,         /* 0-255 B, RFC 8613 */
   COAP_OPTION_URI_PATH = 11,      /* 0-255 B */
   COAP_OPTION_CONTENT_TYPE = 12,  /* 0-2 B */
   COAP_OPTION_MAX_AGE = 14,       /* 0-4 B */
@@ -164,6 +171,7 @@ typedef enum {
   COAP_OPTION_BLOCK1 = 27,        /* 1-3 B */
   COAP_OPTION_SIZE = 28,          /* 0-4 B */
   COAP_OPTION_PROXY_URI = 35,     /* 1-270 B */
+  COAP_OPTION_ECHO = 252,         /* 1-40 B, RFC 9175 */
   OPTION_MAX_VALUE = 0xFFFF
 } coap_option_t;
 
@@ -197,11 +205,14 @@ typedef enum {
 typedef struct _multi_option_t {
   struct _multi_option_t *next;
   uint8_t is_static;
+  uint8_t is_pooled; /* node belongs to the option_pool of its packet */
   uint8_t len;
   uint8_t *data;
 } multi_option_t;
 
-/* Parsed message struct */
+/* Parsed message struct
+ * Once parsed, its multi-option lists may link nodes of its own option_pool: the packet must not be copied
+ * (struct assignment or memcpy). Copy the lists with coap_copy_multi_option() instead. */
 typedef struct {
   uint8_t *buffer; /* pointer to CoAP header / incoming packet buffer / memory to serialize packet */
 
@@ -222,6 +233,12 @@ typedef struct {
   const uint8_t *uri_host;
   multi_option_t *location_path;
   uint16_t uri_port;
+  size_t oscore_len;
+  const uint8_t *oscore;
+#ifdef LWM2M_SUPPORT_OSCORE
+  uint8_t echo_len;
+  const uint8_t *echo; /* beyond the option bitmap: set when the option is */
+#endif
   size_t location_query_len;
   uint8_t *location_query;
   multi_option_t *uri_path;
@@ -247,6 +264,12 @@ typedef struct {
   size_t payload_len;
   uint8_t *payload;
 
+  const char *error_message; /* human-readable reason of a parsing error */
+
+#if COAP_OPTION_POOL_SIZE > 0
+  uint8_t option_pool_used;
+  multi_option_t option_pool[COAP_OPTION_POOL_SIZE]; /* views into buffer for the parsed multi-options */
+#endif
 } coap_packet_t;
 
 /* Option format serialization*/
@@ -305,14 +328,11 @@ typedef struct {
       current_number = number; \
     }
 
-/* To store error code and human-readable payload */
-extern const char *coap_error_message;
-
-uint16_t coap_get_mid(void);
-
 void coap_init_message(void *packet, coap_message_type_t type, uint8_t code, uint16_t mid);
 size_t coap_serialize_get_size(void *packet);
+size_t coap_serialize_header(void *packet, uint8_t *buffer);
 size_t coap_serialize_message(void *packet, uint8_t *buffer);
+/* the parsed packet points into data and into itself, see coap_packet_t */
 coap_status_t coap_parse_message(void *request, uint8_t *data, uint16_t data_len);
 void coap_free_header(void *packet);
 
@@ -320,6 +340,7 @@ char * coap_get_multi_option_as_path_string(multi_option_t * option);
 char * coap_get_multi_option_as_query_string(multi_option_t * option);
 char * coap_get_packet_uri_as_string(coap_packet_t * packet);
 void coap_add_multi_option(multi_option_t **dst, uint8_t *option, size_t option_len, uint8_t is_static);
+void coap_copy_multi_option(multi_option_t **dst, multi_option_t *src);
 void free_multi_option(multi_option_t *dst);
 
 int coap_get_query_variable(void *packet, const char *name, const char **output);
@@ -353,6 +374,13 @@ int coap_set_header_token(void *packet, const uint8_t *token, size_t token_len);
 int coap_get_header_proxy_uri(void *packet, const char **uri); /* In-place string might not be 0-terminated. */
 int coap_set_header_proxy_uri(void *packet, const char *uri);
 
+int coap_get_header_oscore(void *packet, const uint8_t **value); /* Returns -1 when the option is absent, it may be empty. */
+int coap_set_header_oscore(void *packet, const uint8_t *value, size_t length);
+#ifdef LWM2M_SUPPORT_OSCORE
+int coap_get_header_echo(void *packet, const uint8_t **value); /* Returns -1 when the option is absent. */
+int coap_set_header_echo(void *packet, const uint8_t *value, size_t length);
+#endif
+
 int coap_get_header_uri_host(void *packet, const char **host); /* In-place string might not be 0-terminated. */
 int coap_set_header_uri_host(void *packet, const char *host);
 
@@ -126,7 +126,7 @@ static int prv_checkFinished(lwm2m_transaction_t * transacP,
         return false;
     }
 
-    if (COAP_DELETE < transactionMessage->code)
+    if (COAP_IPATCH < transactionMessage->code)
     {
         // response
         return transacP->ack_received ? 1 : 0;
@@ -298,6 +298,14 @@ bool transaction_handleResponse(lwm2m_context_t * contextP,
 
     while (NULL != transacP)
     {
+#ifdef LWM2M_SEPARATE_RESPONSE
+        // a deferred response is not sent yet, nothing can answer it
+        if (transacP->deferred)
+        {
+            transacP = transacP->next;
+            continue;
+        }
+#endif
         if (lwm2m_session_is_equal(fromSessionH, transacP->peerH, contextP->userData) == true)
         {
             if (!transacP->ack_received)
@@ -421,6 +429,9 @@ int transaction_send(lwm2m_context_t * contextP,
 
         if (COAP_MAX_RETRANSMIT + 1 >= transacP->retrans_counter)
         {
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_QUEUE_MODE)
+            queue_keepAwake(contextP);
+#endif
             (void)lwm2m_buffer_send(transacP->peerH, transacP->buffer, transacP->buffer_len, contextP->userData);
 
             transacP->retrans_time += timeout;
@@ -465,6 +476,26 @@ void transaction_step(lwm2m_context_t * contextP,
         lwm2m_transaction_t * nextP = transacP->next;
         int removed = 0;
 
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_SEPARATE_RESPONSE)
+        // sent by lwm2m_complete_response(), with 5.03 if the application did not call it in time
+        if (transacP->deferred)
+        {
+            time_t interval = transacP->retrans_time - currentTime;
+
+            if (interval <= 0)
+            {
+                LOG_ARG("Deferred response %d timed out", transacP->mID);
+                (void)lwm2m_complete_response(contextP, transacP->mID, COAP_503_SERVICE_UNAVAILABLE);
+                interval = COAP_RESPONSE_TIMEOUT;
+            }
+            if (*timeoutP > interval)
+            {
+                *timeoutP = interval;
+            }
+            transacP = nextP;
+            continue;
+        }
+#endif
         if (transacP->retrans_time <= currentTime)
         {
             removed = transaction_send(contextP, transacP);
@@ -513,7 +544,7 @@ bool transaction_set_payload(lwm2m_transaction_t *transaction, uint8_t *buffer,
         coap_set_header_block1(transaction->message, 0, true, lwm2m_coap_block_size);
     }
 
-    coap_set_payload(transaction->message, buffer, MIN(length, lwm2m_coap_block_size));
+    coap_set_payload(transaction->message, transaction_payload, MIN(length, lwm2m_coap_block_size));
     return true;
 }
 
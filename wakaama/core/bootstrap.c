@@ -183,7 +183,7 @@ static uint8_t prv_handleBootstrapDiscover(lwm2m_context_t * contextP,
         if (LWM2M_URI_IS_SET_RESOURCE_INSTANCE(uriP)) return COAP_400_BAD_REQUEST;
 #endif
 
-        objectP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+        objectP = object_find(contextP, uriP->objectId);
         if (objectP == NULL)
         {
             return COAP_404_NOT_FOUND;
@@ -768,6 +768,10 @@ uint8_t bootstrap_handleCommand(lwm2m_context_t * contextP,
     result = prv_checkServerStatus(serverP);
     if (result != COAP_NO_ERROR) return result;
 
+#ifdef LWM2M_RESPONSE_CACHE
+    if (message->code != COAP_GET) cache_invalidate(contextP, uriP);
+#endif
+
     switch (message->code)
     {
     case COAP_PUT:
@@ -804,7 +808,7 @@ uint8_t bootstrap_handleCommand(lwm2m_context_t * contextP,
                 }
                 else
                 {
-                    size = lwm2m_data_parse(uriP, message->payload, message->payload_len, format, &dataP);
+                    size = data_parse(uriP, message->payload, message->payload_len, format, &dataP);
                     if (size == 0)
                     {
                         result = COAP_500_INTERNAL_SERVER_ERROR;
@@ -985,6 +989,10 @@ uint8_t bootstrap_handleDeleteAll(lwm2m_context_t * contextP,
     result = prv_checkServerStatus(serverP);
     if (result != COAP_NO_ERROR) return result;
 
+#ifdef LWM2M_RESPONSE_CACHE
+    cache_invalidate(contextP, NULL);
+#endif
+
     result = COAP_202_DELETED;
     for (objectP = contextP->objectList; objectP != NULL; objectP = objectP->next)
     {
@@ -0,0 +1,282 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Eclipse Foundation and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v2.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v20.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Response cache for Read and Discover.
+ *
+ * Serialized payloads of objects marked as cacheable are kept until a request
+ * or lwm2m_resource_value_changed() touches an overlapping path. Each entry
+ * gets a new ETag when it is filled, so a server presenting the ETag of the
+ * current entry gets a 2.03 Valid without payload. The ETags follow the seed
+ * given by the application, as the clock may restart from the same value
+ * after a reboot.
+ */
+
+#include "internals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_RESPONSE_CACHE)
+
+#define PRV_NO_ACCEPT   0xFFFF
+
+static bool prv_isUriOverlapping(lwm2m_uri_t * uriP,
+                                 lwm2m_uri_t * targetP)
+{
+    if (!LWM2M_URI_IS_SET_OBJECT(uriP)) return true;
+    if (uriP->objectId != targetP->objectId) return false;
+
+    if (LWM2M_URI_IS_SET_INSTANCE(uriP)
+     && LWM2M_URI_IS_SET_INSTANCE(targetP)
+     && uriP->instanceId != targetP->instanceId)
+    {
+        return false;
+    }
+    if (LWM2M_URI_IS_SET_RESOURCE(uriP)
+     && LWM2M_URI_IS_SET_RESOURCE(targetP)
+     && uriP->resourceId != targetP->resourceId)
+    {
+        return false;
+    }
+#ifndef LWM2M_VERSION_1_0
+    if (LWM2M_URI_IS_SET_RESOURCE_INSTANCE(uriP)
+     && LWM2M_URI_IS_SET_RESOURCE_INSTANCE(targetP)
+     && uriP->resourceInstanceId != targetP->resourceInstanceId)
+    {
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+static bool prv_isCacheable(lwm2m_context_t * contextP,
+                            lwm2m_uri_t * uriP,
+                            coap_packet_t * message)
+{
+    lwm2m_object_t * objectP;
+
+    if (!LWM2M_URI_IS_SET_OBJECT(uriP)) return false;
+    if (IS_OPTION(message, COAP_OPTION_OBSERVE)) return false;
+    if (message->accept_num > 1) return false;
+
+    if (contextP->cacheSeeded == false) return false;
+
+    objectP = object_find(contextP, uriP->objectId);
+    if (objectP == NULL) return false;
+
+    return objectP->cacheable;
+}
+
+static void prv_freeEntry(lwm2m_cache_entry_t * entryP)
+{
+    lwm2m_free(entryP->buffer);
+    lwm2m_free(entryP);
+}
+
+static void prv_setEtag(coap_packet_t * response,
+                        uint32_t etag)
+{
+    uint8_t buffer[4];
+
+    buffer[0] = (uint8_t)(etag >> 24);
+    buffer[1] = (uint8_t)(etag >> 16);
+    buffer[2] = (uint8_t)(etag >> 8);
+    buffer[3] = (uint8_t)etag;
+
+    coap_set_header_etag(response, buffer, sizeof(buffer));
+}
+
+bool cache_lookup(lwm2m_context_t * contextP,
+                  lwm2m_uri_t * uriP,
+                  lwm2m_server_t * serverP,
+                  bool discover,
+                  coap_packet_t * message,
+                  coap_packet_t * response,
+                  lwm2m_media_type_t * formatP,
+                  uint8_t ** bufferP,
+                  size_t * lengthP,
+                  uint8_t * resultP)
+{
+    lwm2m_cache_entry_t * entryP;
+    lwm2m_cache_entry_t * parentP;
+    uint16_t accept;
+    const uint8_t * etag;
+    int etagLen;
+
+    if (!prv_isCacheable(contextP, uriP, message)) return false;
+
+    accept = message->accept_num == 1 ? message->accept[0] : PRV_NO_ACCEPT;
+
+    parentP = NULL;
+    for (entryP = contextP->cacheList ; entryP != NULL ; parentP = entryP, entryP = entryP->next)
+    {
+        if (entryP->shortServerID == serverP->shortID
+         && entryP->discover == discover
+         && entryP->accept == accept
+         && entryP->uri.objectId == uriP->objectId
+         && entryP->uri.instanceId == uriP->instanceId
+         && entryP->uri.resourceId == uriP->resourceId
+#ifndef LWM2M_VERSION_1_0
+         && entryP->uri.resourceInstanceId == uriP->resourceInstanceId
+#endif
+           )
+        {
+            break;
+        }
+    }
+    if (entryP == NULL) return false;
+
+    LOG_ARG("Cache hit, ETag: %08X", entryP->etag);
+    LOG_URI(uriP);
+
+    // keep the most recently used entries at the head
+    if (parentP != NULL)
+    {
+        parentP->next = entryP->next;
+        entryP->next = contextP->cacheList;
+        contextP->cacheList = entryP;
+    }
+
+    prv_setEtag(response, entryP->etag);
+
+    etagLen = coap_get_header_etag(message, &etag);
+    if (etagLen == 4
+     && (uint32_t)((etag[0] << 24) | (etag[1] << 16) | (etag[2] << 8) | etag[3]) == entryP->etag)
+    {
+        *bufferP = NULL;
+        *lengthP = 0;
+        *resultP = COAP_203_VALID;
+        return true;
+    }
+
+    // lwm2m_handle_packet frees the response payload
+    *bufferP = (uint8_t *)data_malloc(entryP->length);
+    if (*bufferP == NULL)
+    {
+        *resultP = COAP_500_INTERNAL_SERVER_ERROR;
+        return true;
+    }
+    memcpy(*bufferP, entryP->buffer, entryP->length);
+    *lengthP = entryP->length;
+    *formatP = entryP->format;
+    *resultP = COAP_205_CONTENT;
+
+    return true;
+}
+
+void cache_store(lwm2m_context_t * contextP,
+                 lwm2m_uri_t * uriP,
+                 lwm2m_server_t * serverP,
+                 bool discover,
+                 coap_packet_t * message,
+                 coap_packet_t * response,
+                 lwm2m_media_type_t format,
+                 uint8_t * buffer,
+                 size_t length)
+{
+    lwm2m_cache_entry_t * entryP;
+    int count;
+
+    if (!prv_isCacheable(contextP, uriP, message)) return;
+    if (length == 0 || length > LWM2M_RESPONSE_CACHE_MAX_PAYLOAD) return;
+
+    entryP = (lwm2m_cache_entry_t *)lwm2m_malloc(sizeof(lwm2m_cache_entry_t));
+    if (entryP == NULL) return;
+    entryP->buffer = (uint8_t *)lwm2m_malloc(length);
+    if (entryP->buffer == NULL)
+    {
+        lwm2m_free(entryP);
+        return;
+    }
+    memcpy(entryP->buffer, buffer, length);
+    entryP->length = length;
+    memcpy(&entryP->uri, uriP, sizeof(lwm2m_uri_t));
+    entryP->shortServerID = serverP->shortID;
+    entryP->discover = discover;
+    entryP->accept = message->accept_num == 1 ? message->accept[0] : PRV_NO_ACCEPT;
+    entryP->format = format;
+
+    entryP->etag = ++contextP->cacheGeneration;
+
+    entryP->next = contextP->cacheList;
+    contextP->cacheList = entryP;
+
+    // drop the least recently used entry
+    count = 1;
+    for (entryP = contextP->cacheList ; entryP->next != NULL ; entryP = entryP->next)
+    {
+        if (++count > LWM2M_RESPONSE_CACHE_SIZE)
+        {
+            prv_freeEntry(entryP->next);
+            entryP->next = NULL;
+            break;
+        }
+    }
+
+    LOG_ARG("Cached %d bytes, ETag: %08X", length, contextP->cacheList->etag);
+    prv_setEtag(response, contextP->cacheList->etag);
+}
+
+void lwm2m_set_cache_seed(lwm2m_context_t * contextP,
+                          uint32_t seed)
+{
+    LOG_ARG("seed: %08X", seed);
+
+    // the ETags of the entries already filled may follow the new seed
+    cache_invalidate(contextP, NULL);
+    contextP->cacheGeneration = seed;
+    contextP->cacheSeeded = true;
+}
+
+void cache_invalidate(lwm2m_context_t * contextP,
+                      lwm2m_uri_t * uriP)
+{
+    lwm2m_cache_entry_t * entryP;
+    lwm2m_cache_entry_t * parentP;
+
+    LOG_URI(uriP);
+
+    parentP = NULL;
+    entryP = contextP->cacheList;
+    while (entryP != NULL)
+    {
+        if (uriP == NULL || prv_isUriOverlapping(uriP, &entryP->uri))
+        {
+            lwm2m_cache_entry_t * nextP = entryP->next;
+
+            if (parentP == NULL)
+            {
+                contextP->cacheList = nextP;
+            }
+            else
+            {
+                parentP->next = nextP;
+            }
+            prv_freeEntry(entryP);
+            entryP = nextP;
+        }
+        else
+        {
+            parentP = entryP;
+            entryP = entryP->next;
+        }
+    }
+}
+
+#endif
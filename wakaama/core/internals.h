@@ -157,6 +157,8 @@
 #define URI_REGISTRATION_SEGMENT_LEN    2
 #define URI_BOOTSTRAP_SEGMENT           "bs"
 #define URI_BOOTSTRAP_SEGMENT_LEN       2
+#define URI_SEND_SEGMENT                "dp"
+#define URI_SEND_SEGMENT_LEN            2
 
 #define QUERY_STARTER        "?"
 #define QUERY_NAME           "ep="
@@ -268,6 +270,50 @@ typedef struct
     lwm2m_context_t *       contextP;
 } observation_data_t;
 
+#ifdef LWM2M_VECTORED_SEND
+#ifndef LWM2M_COAP_HEADER_BUFFER_SIZE
+#define LWM2M_COAP_HEADER_BUFFER_SIZE       128
+#endif
+#endif
+
+#ifdef LWM2M_SEPARATE_RESPONSE
+#ifndef LWM2M_SEPARATE_RESPONSE_TIMEOUT
+#define LWM2M_SEPARATE_RESPONSE_TIMEOUT     60
+#endif
+
+// request whose separate response was sent, kept COAP_EXCHANGE_LIFETIME seconds to answer its duplicates
+typedef struct _lwm2m_separate_exchange_
+{
+    struct _lwm2m_separate_exchange_ * next;
+    void *              peerH;
+    uint16_t            requestMID;
+    uint8_t             code;
+    time_t              expiry;
+} lwm2m_separate_exchange_t;
+#endif
+
+#ifdef LWM2M_RESPONSE_CACHE
+#ifndef LWM2M_RESPONSE_CACHE_SIZE
+#define LWM2M_RESPONSE_CACHE_SIZE           8
+#endif
+#ifndef LWM2M_RESPONSE_CACHE_MAX_PAYLOAD
+#define LWM2M_RESPONSE_CACHE_MAX_PAYLOAD    LWM2M_COAP_DEFAULT_BLOCK_SIZE
+#endif
+
+typedef struct _lwm2m_cache_entry_
+{
+    struct _lwm2m_cache_entry_ * next;
+    lwm2m_uri_t         uri;
+    uint16_t            shortServerID;  // Discover output depends on the server's attributes
+    bool                discover;
+    uint16_t            accept;         // requested format or 0xFFFF if none
+    lwm2m_media_type_t  format;
+    uint32_t            etag;
+    uint8_t *           buffer;
+    size_t              length;
+} lwm2m_cache_entry_t;
+#endif
+
 typedef enum
 {
     URI_DEPTH_NONE,
@@ -292,7 +338,8 @@ typedef enum
     LWM2M_REQUEST_TYPE_DM,
     LWM2M_REQUEST_TYPE_REGISTRATION,
     LWM2M_REQUEST_TYPE_BOOTSTRAP,
-    LWM2M_REQUEST_TYPE_DELETE_ALL
+    LWM2M_REQUEST_TYPE_DELETE_ALL,
+    LWM2M_REQUEST_TYPE_SEND
 } lwm2m_request_type_t;
 
 // defined in uri.c
@@ -313,6 +360,8 @@ uint8_t object_raw_block1_execute(lwm2m_context_t * contextP, lwm2m_uri_t * uriP
 #endif
 uint8_t object_delete(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
 uint8_t object_discover(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, uint8_t ** bufferP, size_t * lengthP);
+int object_updateIndex(lwm2m_context_t * contextP);
+lwm2m_object_t * object_find(lwm2m_context_t * contextP, uint16_t objectId);
 uint8_t object_checkReadable(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_attributes_t * attrP);
 bool object_isInstanceNew(lwm2m_context_t * contextP, uint16_t objectId, uint16_t instanceId);
 int object_getRegisterPayloadBufferLength(lwm2m_context_t * contextP);
@@ -320,6 +369,10 @@ int object_getRegisterPayload(lwm2m_context_t * contextP, uint8_t * buffer, size
 int object_getServers(lwm2m_context_t * contextP, bool checkOnly);
 uint8_t object_createInstance(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_data_t * dataP);
 uint8_t object_writeInstance(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_data_t * dataP);
+#ifdef LWM2M_SUPPORT_COMPOSITE
+uint8_t object_readComposite(lwm2m_context_t * contextP, lwm2m_uri_t * uriList, int count, uint8_t ** bufferP, size_t * lengthP);
+uint8_t object_writeComposite(lwm2m_context_t * contextP, uint8_t * buffer, size_t length);
+#endif
 
 // defined in transaction.c
 lwm2m_transaction_t * transaction_new(void * sessionH, coap_method_t method, char * altPath, lwm2m_uri_t * uriP, uint16_t mID, uint8_t token_len, uint8_t* token);
@@ -333,6 +386,9 @@ bool transaction_set_payload(lwm2m_transaction_t *transaction, uint8_t *buffer,
 
 // defined in management.c
 uint8_t dm_handleRequest(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, coap_packet_t * message, coap_packet_t * response);
+#ifdef LWM2M_SEPARATE_RESPONSE
+void dm_clearSeparateExchanges(lwm2m_context_t * contextP);
+#endif
 
 // defined in observe.c
 uint8_t observe_handleRequest(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, int size, lwm2m_data_t * dataP, coap_packet_t * message, coap_packet_t * response);
@@ -343,6 +399,11 @@ void observe_clear(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
 bool observe_handleNotify(lwm2m_context_t * contextP, void * fromSessionH, coap_packet_t * message, coap_packet_t * response);
 void observe_remove(lwm2m_observation_t * observationP);
 lwm2m_observed_t * observe_findByUri(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
+#ifdef LWM2M_SUPPORT_COMPOSITE
+uint8_t observe_handleCompositeRequest(lwm2m_context_t * contextP, lwm2m_uri_t * uriList, int count, lwm2m_server_t * serverP, coap_packet_t * message, coap_packet_t * response);
+uint8_t observe_handleSend(lwm2m_context_t * contextP, void * fromSessionH, coap_packet_t * message);
+void observe_getCompositePeriods(lwm2m_context_t * contextP, lwm2m_observed_composite_t * compositeP, lwm2m_attributes_t * periodsP);
+#endif
 
 // defined in registration.c
 uint8_t registration_handleRequest(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, void * fromSessionH, coap_packet_t * message, coap_packet_t * response);
@@ -351,6 +412,9 @@ void registration_freeClient(lwm2m_client_t * clientP);
 uint8_t registration_start(lwm2m_context_t * contextP, bool restartFailed);
 void registration_step(lwm2m_context_t * contextP, time_t currentTime, time_t * timeoutP);
 lwm2m_status_t registration_getStatus(lwm2m_context_t * contextP);
+#ifdef LWM2M_CLIENT_MODE
+time_t registration_getUpdateTime(lwm2m_server_t * serverP);
+#endif
 
 // defined in packet.c
 uint8_t message_send(lwm2m_context_t * contextP, coap_packet_t * message, void * sessionH);
@@ -364,6 +428,21 @@ uint8_t bootstrap_handleRequest(lwm2m_context_t * contextP, lwm2m_uri_t * uriP,
 void bootstrap_start(lwm2m_context_t * contextP);
 lwm2m_status_t bootstrap_getStatus(lwm2m_context_t * contextP);
 
+// defined in data.c
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_DATA_ARENA)
+void data_arenaBegin(lwm2m_context_t * contextP);
+void data_arenaEnd(lwm2m_context_t * contextP);
+void * data_malloc(size_t size);
+void data_free(void * p);
+int data_parse(lwm2m_uri_t * uriP, const uint8_t * buffer, size_t bufferLen, lwm2m_media_type_t format, lwm2m_data_t ** dataP);
+int data_serialize(lwm2m_uri_t * uriP, int size, lwm2m_data_t * dataP, lwm2m_media_type_t * formatP, uint8_t ** bufferP);
+#else
+#define data_malloc(S) lwm2m_malloc(S)
+#define data_free(P) lwm2m_free(P)
+#define data_parse lwm2m_data_parse
+#define data_serialize lwm2m_data_serialize
+#endif
+
 #ifdef LWM2M_SUPPORT_TLV
 // defined in tlv.c
 int tlv_parse(const uint8_t * buffer, size_t bufferLen, lwm2m_data_t ** dataP);
@@ -380,6 +459,10 @@ int json_serialize(lwm2m_uri_t * uriP, int size, lwm2m_data_t * tlvP, uint8_t **
 #ifdef LWM2M_SUPPORT_SENML_JSON
 int senml_json_parse(const lwm2m_uri_t * uriP, const uint8_t * buffer, size_t bufferLen, lwm2m_data_t ** dataP);
 int senml_json_serialize(const lwm2m_uri_t * uriP, int size, const lwm2m_data_t * tlvP, uint8_t ** bufferP);
+int senml_json_parse_uris(const uint8_t * buffer, size_t bufferLen, lwm2m_uri_t ** urisP);
+int senml_json_serialize_uris(const lwm2m_uri_t * uriList, size_t count, uint8_t ** bufferP);
+int senml_json_append(uint8_t ** packP, size_t * packLenP, const uint8_t * buffer, size_t bufferLen);
+int senml_json_append_record(const lwm2m_uri_t * uriP, time_t baseTime, time_t time, const lwm2m_data_t * dataP, uint8_t * buffer, size_t length, size_t bufferLen);
 #endif
 
 // defined in json_common.c
@@ -399,6 +482,19 @@ uri_depth_t json_decreaseLevel(uri_depth_t level);
 int json_findAndCheckData(const lwm2m_uri_t * uriP, uri_depth_t baseLevel, size_t size, const lwm2m_data_t * tlvP, lwm2m_data_t ** targetP, uri_depth_t *targetLevelP);
 #endif
 
+// defined in cache.c
+#ifdef LWM2M_RESPONSE_CACHE
+bool cache_lookup(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, bool discover, coap_packet_t * message, coap_packet_t * response, lwm2m_media_type_t * formatP, uint8_t ** bufferP, size_t * lengthP, uint8_t * resultP);
+void cache_store(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, bool discover, coap_packet_t * message, coap_packet_t * response, lwm2m_media_type_t format, uint8_t * buffer, size_t length);
+void cache_invalidate(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
+#endif
+
+// defined in queue.c
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_QUEUE_MODE)
+void queue_keepAwake(lwm2m_context_t * contextP);
+bool queue_step(lwm2m_context_t * contextP, time_t currentTime, time_t * timeoutP);
+#endif
+
 // defined in discover.c
 int discover_serialize(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, int size, lwm2m_data_t * dataP, uint8_t ** bufferP);
 
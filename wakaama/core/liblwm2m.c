@@ -162,6 +162,18 @@ static void prv_deleteObservedList(lwm2m_context_t * contextP)
 
         lwm2m_free(targetP);
     }
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    while (NULL != contextP->compositeObservedList)
+    {
+        lwm2m_observed_composite_t * compositeP;
+
+        compositeP = contextP->compositeObservedList;
+        contextP->compositeObservedList = contextP->compositeObservedList->next;
+
+        lwm2m_free(compositeP->uriList);
+        lwm2m_free(compositeP);
+    }
+#endif
 }
 #endif
 
@@ -186,6 +198,12 @@ void lwm2m_close(lwm2m_context_t * contextP)
     prv_deleteServerList(contextP);
     prv_deleteBootstrapServerList(contextP);
     prv_deleteObservedList(contextP);
+#ifdef LWM2M_RESPONSE_CACHE
+    cache_invalidate(contextP, NULL);
+#endif
+#ifdef LWM2M_SEPARATE_RESPONSE
+    dm_clearSeparateExchanges(contextP);
+#endif
     lwm2m_free(contextP->endpointName);
     if (contextP->msisdn != NULL)
     {
@@ -195,6 +213,10 @@ void lwm2m_close(lwm2m_context_t * contextP)
     {
         lwm2m_free(contextP->altPath);
     }
+    if (contextP->objectIndex != NULL)
+    {
+        lwm2m_free(contextP->objectIndex);
+    }
 
 #endif
 
@@ -328,6 +350,7 @@ int lwm2m_configure(lwm2m_context_t * contextP,
         objectList[i]->next = NULL;
         contextP->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(contextP->objectList, objectList[i]);
     }
+    (void)object_updateIndex(contextP);
 
     return COAP_NO_ERROR;
 }
@@ -338,11 +361,12 @@ int lwm2m_add_object(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG_ARG("ID: %d", objectP->objID);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, objectP->objID);
+    targetP = object_find(contextP, objectP->objID);
     if (targetP != NULL) return COAP_406_NOT_ACCEPTABLE;
     objectP->next = NULL;
 
     contextP->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(contextP->objectList, objectP);
+    (void)object_updateIndex(contextP);
 
     if (contextP->state == STATE_READY)
     {
@@ -361,6 +385,17 @@ int lwm2m_remove_object(lwm2m_context_t * contextP,
     contextP->objectList = (lwm2m_object_t *)LWM2M_LIST_RM(contextP->objectList, id, &targetP);
 
     if (targetP == NULL) return COAP_404_NOT_FOUND;
+    (void)object_updateIndex(contextP);
+
+#ifdef LWM2M_RESPONSE_CACHE
+    {
+        lwm2m_uri_t uri;
+
+        LWM2M_URI_RESET(&uri);
+        uri.objectId = id;
+        cache_invalidate(contextP, &uri);
+    }
+#endif
 
     if (contextP->state == STATE_READY)
     {
@@ -383,6 +418,10 @@ int lwm2m_step(lwm2m_context_t * contextP,
     if (tv_sec < 0) return COAP_500_INTERNAL_SERVER_ERROR;
 
 #ifdef LWM2M_CLIENT_MODE
+#ifdef LWM2M_SERVER_MODE
+    // a context never given to lwm2m_configure() is only a LWM2M Server
+    if (contextP->endpointName == NULL) goto server_step;
+#endif
     LOG_ARG("State: %s", STR_STATE(contextP->state));
     // state can also be modified in bootstrap_handleCommand().
 
@@ -479,9 +518,27 @@ next_step:
         break;
     }
 
+#ifdef LWM2M_QUEUE_MODE
+    if (queue_step(contextP, tv_sec, timeoutP) == true)
+    {
+        // the pending notifications and Sends wait for the client to wake up
+        LOG_ARG("Sleeping, final timeoutP: %d", (int) *timeoutP);
+        return 0;
+    }
+#endif
+
+#ifdef LWM2M_DATA_ARENA
+    data_arenaBegin(contextP);
+    observe_step(contextP, tv_sec, timeoutP);
+    data_arenaEnd(contextP);
+#else
     observe_step(contextP, tv_sec, timeoutP);
 #endif
+#endif
 
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_SERVER_MODE)
+server_step:
+#endif
     registration_step(contextP, tv_sec, timeoutP);
     transaction_step(contextP, tv_sec, timeoutP);
 
@@ -160,6 +160,190 @@ static int prv_readAttributes(multi_option_t * query,
     return 0;
 }
 
+#ifdef LWM2M_SEPARATE_RESPONSE
+static lwm2m_transaction_t * prv_findDeferred(lwm2m_context_t * contextP,
+                                              void * sessionH,
+                                              uint16_t requestMID)
+{
+    lwm2m_transaction_t * transacP;
+
+    for (transacP = contextP->transactionList; transacP != NULL; transacP = transacP->next)
+    {
+        if (transacP->deferred
+         && transacP->requestMID == requestMID
+         && lwm2m_session_is_equal(sessionH, transacP->peerH, contextP->userData))
+        {
+            return transacP;
+        }
+    }
+
+    return NULL;
+}
+
+static lwm2m_separate_exchange_t * prv_findExchange(lwm2m_context_t * contextP,
+                                                   void * sessionH,
+                                                   uint16_t requestMID,
+                                                   time_t currentTime)
+{
+    lwm2m_separate_exchange_t ** exchangePP;
+
+    exchangePP = &contextP->separateExchangeList;
+    while (*exchangePP != NULL)
+    {
+        lwm2m_separate_exchange_t * exchangeP = *exchangePP;
+
+        if (exchangeP->expiry <= currentTime)
+        {
+            *exchangePP = exchangeP->next;
+            lwm2m_free(exchangeP);
+            continue;
+        }
+        if (exchangeP->requestMID == requestMID
+         && lwm2m_session_is_equal(sessionH, exchangeP->peerH, contextP->userData))
+        {
+            return exchangeP;
+        }
+        exchangePP = &exchangeP->next;
+    }
+
+    return NULL;
+}
+
+static void prv_keepExchange(lwm2m_context_t * contextP,
+                             lwm2m_transaction_t * transacP)
+{
+    lwm2m_separate_exchange_t * exchangeP;
+    time_t currentTime;
+
+    currentTime = lwm2m_gettime();
+    exchangeP = prv_findExchange(contextP, transacP->peerH, transacP->requestMID, currentTime);
+    if (exchangeP == NULL)
+    {
+        exchangeP = (lwm2m_separate_exchange_t *)lwm2m_malloc(sizeof(lwm2m_separate_exchange_t));
+        // the duplicates would be executed again, the response is sent anyway
+        if (exchangeP == NULL) return;
+        exchangeP->peerH = transacP->peerH;
+        exchangeP->requestMID = transacP->requestMID;
+        exchangeP->next = contextP->separateExchangeList;
+        contextP->separateExchangeList = exchangeP;
+    }
+    exchangeP->code = ((coap_packet_t *)transacP->message)->code;
+    exchangeP->expiry = currentTime + COAP_EXCHANGE_LIFETIME;
+}
+
+void dm_clearSeparateExchanges(lwm2m_context_t * contextP)
+{
+    while (contextP->separateExchangeList != NULL)
+    {
+        lwm2m_separate_exchange_t * exchangeP = contextP->separateExchangeList;
+
+        contextP->separateExchangeList = exchangeP->next;
+        lwm2m_free(exchangeP);
+    }
+}
+
+static void prv_sendEmptyAck(lwm2m_context_t * contextP,
+                             void * sessionH,
+                             coap_packet_t * message,
+                             coap_packet_t * response)
+{
+    // a NON request gets its separate response only
+    if (message->type != COAP_TYPE_CON) return;
+
+    coap_init_message(response, COAP_TYPE_ACK, 0, message->mid);
+    (void)message_send(contextP, response, sessionH);
+}
+
+static void prv_beginDeferrable(lwm2m_context_t * contextP,
+                                lwm2m_server_t * serverP,
+                                coap_packet_t * message)
+{
+    contextP->deferrableRequest = message;
+    contextP->deferrableSessionH = serverP->sessionH;
+    contextP->deferredP = NULL;
+}
+
+static uint8_t prv_endDeferrable(lwm2m_context_t * contextP,
+                                 coap_packet_t * message,
+                                 coap_packet_t * response,
+                                 uint8_t result)
+{
+    lwm2m_transaction_t * transacP = contextP->deferredP;
+
+    contextP->deferrableRequest = NULL;
+    contextP->deferredP = NULL;
+
+    if (transacP == NULL) return result;
+
+    if (result >= COAP_400_BAD_REQUEST || !transacP->deferred)
+    {
+        // an error, or a response completed before the callback returned, is answered at once
+        if (result < COAP_400_BAD_REQUEST)
+        {
+            result = ((coap_packet_t *)transacP->message)->code;
+        }
+        transaction_remove(contextP, transacP);
+        return result;
+    }
+
+    LOG_ARG("Response to mid %d deferred as %d", message->mid, transacP->mID);
+    prv_sendEmptyAck(contextP, contextP->deferrableSessionH, message, response);
+
+    return COAP_IGNORE;
+}
+
+int lwm2m_defer_response(lwm2m_context_t * contextP)
+{
+    coap_packet_t * message = (coap_packet_t *)contextP->deferrableRequest;
+    lwm2m_transaction_t * transacP;
+
+    LOG("Entering");
+    if (message == NULL) return -1;
+    if (contextP->deferredP != NULL) return contextP->deferredP->mID;
+
+    transacP = transaction_new(contextP->deferrableSessionH, COAP_POST, NULL, NULL, contextP->nextMID++, message->token_len, message->token);
+    if (transacP == NULL) return -1;
+
+    // the status code is set on completion, until then lwm2m_step() only checks the deadline
+    transacP->deferred = true;
+    transacP->requestMID = message->mid;
+    transacP->retrans_time = lwm2m_gettime() + LWM2M_SEPARATE_RESPONSE_TIMEOUT;
+    contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transacP);
+    contextP->deferredP = transacP;
+
+    return transacP->mID;
+}
+
+int lwm2m_complete_response(lwm2m_context_t * contextP,
+                            int responseID,
+                            uint8_t status)
+{
+    lwm2m_transaction_t * transacP;
+
+    LOG_ARG("responseID: %d, status: %d", responseID, status);
+    if (responseID < 0 || responseID > LWM2M_MAX_ID) return COAP_404_NOT_FOUND;
+
+    // message IDs wrap around, another transaction may use the same one
+    transacP = contextP->transactionList;
+    while (transacP != NULL && (transacP->mID != responseID || !transacP->deferred))
+    {
+        transacP = transacP->next;
+    }
+    if (transacP == NULL) return COAP_404_NOT_FOUND;
+
+    transacP->deferred = false;
+    ((coap_packet_t *)transacP->message)->code = status;
+
+    // completed by the callback itself: prv_endDeferrable() piggybacks the response on the ACK
+    if (transacP == contextP->deferredP) return COAP_NO_ERROR;
+
+    prv_keepExchange(contextP, transacP);
+    (void)transaction_send(contextP, transacP);
+
+    return COAP_NO_ERROR;
+}
+#endif
+
 uint8_t dm_handleRequest(lwm2m_context_t * contextP,
                          lwm2m_uri_t * uriP,
                          lwm2m_server_t * serverP,
@@ -196,6 +380,38 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
 
     // TODO: check ACL
 
+#ifdef LWM2M_SEPARATE_RESPONSE
+    if (message->type == COAP_TYPE_CON)
+    {
+        lwm2m_separate_exchange_t * exchangeP;
+
+        if (prv_findDeferred(contextP, serverP->sessionH, message->mid) != NULL)
+        {
+            // our empty ACK was lost, the request is already being processed
+            prv_sendEmptyAck(contextP, serverP->sessionH, message, response);
+            return COAP_IGNORE;
+        }
+
+        exchangeP = prv_findExchange(contextP, serverP->sessionH, message->mid, lwm2m_gettime());
+        if (exchangeP != NULL)
+        {
+            // already processed, the separate response is piggybacked on the ACK of the duplicate
+            return exchangeP->code;
+        }
+    }
+#endif
+
+#ifdef LWM2M_RESPONSE_CACHE
+    if (message->code != COAP_GET
+#ifdef LWM2M_SUPPORT_COMPOSITE
+     && message->code != COAP_FETCH
+#endif
+       )
+    {
+        cache_invalidate(contextP, uriP);
+    }
+#endif
+
     switch (message->code)
     {
     case COAP_GET:
@@ -203,7 +419,19 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
             uint8_t * buffer = NULL;
             size_t length = 0;
             int res;
-
+#ifdef LWM2M_RESPONSE_CACHE
+            bool discover = IS_OPTION(message, COAP_OPTION_ACCEPT)
+                         && message->accept_num == 1
+                         && message->accept[0] == APPLICATION_LINK_FORMAT;
+            bool cached;
+
+            cached = cache_lookup(contextP, uriP, serverP, discover, message, response, &format, &buffer, &length, &result);
+            if (cached)
+            {
+                LOG("Answered from the response cache");
+            }
+            else
+#endif
             if (IS_OPTION(message, COAP_OPTION_OBSERVE))
             {
                 lwm2m_data_t * dataP = NULL;
@@ -230,7 +458,7 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
                                                        response);
                         if (COAP_205_CONTENT == result)
                         {
-                            res = lwm2m_data_serialize(uriP, size, dataP, &format, &buffer);
+                            res = data_serialize(uriP, size, dataP, &format, &buffer);
                             if (res < 0)
                             {
                                 result = COAP_500_INTERNAL_SERVER_ERROR;
@@ -269,13 +497,19 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
             }
             if (COAP_205_CONTENT == result)
             {
+#ifdef LWM2M_RESPONSE_CACHE
+                if (!cached)
+                {
+                    cache_store(contextP, uriP, serverP, discover, message, response, format, buffer, length);
+                }
+#endif
                 coap_set_header_content_type(response, format);
                 coap_set_payload(response, buffer, length);
                 // lwm2m_handle_packet will free buffer
             }
             else
             {
-                lwm2m_free(buffer);
+                data_free(buffer);
             }
         }
         break;
@@ -337,12 +571,24 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
                 }
                 else
                 {
+#ifdef LWM2M_SEPARATE_RESPONSE
+                    prv_beginDeferrable(contextP, serverP, message);
+#endif
                     result = object_execute(contextP, uriP, message->payload, message->payload_len);
+#ifdef LWM2M_SEPARATE_RESPONSE
+                    result = prv_endDeferrable(contextP, message, response, result);
+#endif
                 }
             }
             else
             {
+#ifdef LWM2M_SEPARATE_RESPONSE
+                prv_beginDeferrable(contextP, serverP, message);
+#endif
                 result = object_write(contextP, uriP, format, message->payload, message->payload_len, true);
+#ifdef LWM2M_SEPARATE_RESPONSE
+                result = prv_endDeferrable(contextP, message, response, result);
+#endif
             }
         }
         break;
@@ -371,7 +617,13 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
             }
             else if (LWM2M_URI_IS_SET_INSTANCE(uriP))
             {
+#ifdef LWM2M_SEPARATE_RESPONSE
+                prv_beginDeferrable(contextP, serverP, message);
+#endif
                 result = object_write(contextP, uriP, format, message->payload, message->payload_len, false);
+#ifdef LWM2M_SEPARATE_RESPONSE
+                result = prv_endDeferrable(contextP, message, response, result);
+#endif
             }
             else
             {
@@ -397,6 +649,77 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
         }
         break;
 
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    case COAP_FETCH:
+        {
+            lwm2m_uri_t * uriList = NULL;
+            uint8_t * buffer = NULL;
+            size_t length = 0;
+            int count;
+
+            // Read-Composite and Observe-Composite target the root path
+            if (LWM2M_URI_IS_SET_OBJECT(uriP))
+            {
+                result = COAP_405_METHOD_NOT_ALLOWED;
+                break;
+            }
+            if (format != LWM2M_CONTENT_SENML_JSON)
+            {
+                result = COAP_415_UNSUPPORTED_CONTENT_FORMAT;
+                break;
+            }
+            if (message->accept_num > 0 && message->accept[0] != LWM2M_CONTENT_SENML_JSON)
+            {
+                result = COAP_406_NOT_ACCEPTABLE;
+                break;
+            }
+            count = senml_json_parse_uris(message->payload, message->payload_len, &uriList);
+            if (count <= 0)
+            {
+                result = COAP_400_BAD_REQUEST;
+                break;
+            }
+
+            result = object_readComposite(contextP, uriList, count, &buffer, &length);
+            if (COAP_205_CONTENT == result
+             && IS_OPTION(message, COAP_OPTION_OBSERVE))
+            {
+                result = observe_handleCompositeRequest(contextP, uriList, count, serverP, message, response);
+            }
+            lwm2m_free(uriList);
+
+            if (COAP_205_CONTENT == result)
+            {
+                coap_set_header_content_type(response, LWM2M_CONTENT_SENML_JSON);
+                coap_set_payload(response, buffer, length);
+                // lwm2m_handle_packet will free buffer
+            }
+            else
+            {
+                data_free(buffer);
+            }
+        }
+        break;
+
+    case COAP_IPATCH:
+        {
+            // Write-Composite
+            if (LWM2M_URI_IS_SET_OBJECT(uriP))
+            {
+                result = COAP_405_METHOD_NOT_ALLOWED;
+            }
+            else if (format != LWM2M_CONTENT_SENML_JSON)
+            {
+                result = COAP_415_UNSUPPORTED_CONTENT_FORMAT;
+            }
+            else
+            {
+                result = object_writeComposite(contextP, message->payload, message->payload_len);
+            }
+        }
+        break;
+#endif
+
     default:
         result = COAP_400_BAD_REQUEST;
         break;
@@ -510,6 +833,12 @@ static int prv_makeOperation(lwm2m_context_t *contextP, uint16_t clientID, lwm2m
     }
     else if (buffer != NULL)
     {
+#ifdef LWM2M_SUPPORT_COMPOSITE
+        if (method == COAP_FETCH)
+        {
+            coap_set_header_accept(transaction->message, format);
+        }
+#endif
         coap_set_header_content_type(transaction->message, format);
         if (!transaction_set_payload(transaction, buffer, length)) {
             transaction_free(transaction);
@@ -570,6 +899,59 @@ int lwm2m_dm_read(lwm2m_context_t * contextP,
     return prv_lwm2m_dm_read(contextP, clientID, uriP, callback, userData);
 }
 
+#ifdef LWM2M_SUPPORT_COMPOSITE
+int lwm2m_dm_read_composite(lwm2m_context_t * contextP,
+                            uint16_t clientID,
+                            lwm2m_uri_t * uriList,
+                            size_t count,
+                            lwm2m_result_callback_t callback,
+                            void * userData)
+{
+    lwm2m_uri_t rootUri;
+    uint8_t * buffer = NULL;
+    int length;
+    int result;
+
+    LOG_ARG("clientID: %d, count: %d", clientID, count);
+
+    length = senml_json_serialize_uris(uriList, count, &buffer);
+    if (length <= 0) return COAP_400_BAD_REQUEST;
+
+    LWM2M_URI_RESET(&rootUri);
+    result = prv_makeOperation(contextP, clientID, &rootUri,
+                               COAP_FETCH,
+                               LWM2M_CONTENT_SENML_JSON, buffer, length,
+                               callback, userData);
+    lwm2m_free(buffer);
+
+    return result;
+}
+
+int lwm2m_dm_write_composite(lwm2m_context_t * contextP,
+                             uint16_t clientID,
+                             lwm2m_media_type_t format,
+                             uint8_t * buffer,
+                             size_t length,
+                             lwm2m_result_callback_t callback,
+                             void * userData)
+{
+    lwm2m_uri_t rootUri;
+
+    LOG_ARG("clientID: %d, format: %s, length: %d", clientID, STR_MEDIA_TYPE(format), length);
+    if (format != LWM2M_CONTENT_SENML_JSON
+     || length == 0)
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+
+    LWM2M_URI_RESET(&rootUri);
+    return prv_makeOperation(contextP, clientID, &rootUri,
+                             COAP_IPATCH,
+                             format, buffer, length,
+                             callback, userData);
+}
+#endif
+
 static int prv_lwm2m_dm_write(lwm2m_context_t *contextP, uint16_t clientID, lwm2m_uri_t *uriP,
                               lwm2m_media_type_t format, uint8_t *buffer, size_t length, bool partialUpdate,
                               lwm2m_result_callback_t callback, void *userData) {
@@ -59,6 +59,66 @@
 #include <string.h>
 #include <stdio.h>
 
+int object_updateIndex(lwm2m_context_t * contextP)
+{
+    lwm2m_object_t * objectP;
+    size_t count;
+    size_t i;
+
+    if (contextP->objectIndex != NULL) lwm2m_free(contextP->objectIndex);
+    contextP->objectIndex = NULL;
+    contextP->objectIds = NULL;
+    contextP->objectCount = 0;
+
+    count = 0;
+    for (objectP = contextP->objectList ; objectP != NULL ; objectP = objectP->next) count++;
+    if (count == 0) return 0;
+
+    // one block: the pointers, then the IDs the binary search goes through
+    contextP->objectIndex = (lwm2m_object_t **)lwm2m_malloc(count * (sizeof(lwm2m_object_t *) + sizeof(uint16_t)));
+    if (contextP->objectIndex == NULL) return -1;
+    contextP->objectIds = (uint16_t *)(contextP->objectIndex + count);
+
+    // objectList is sorted by ID
+    for (i = 0, objectP = contextP->objectList ; objectP != NULL ; i++, objectP = objectP->next)
+    {
+        contextP->objectIndex[i] = objectP;
+        contextP->objectIds[i] = objectP->objID;
+    }
+    contextP->objectCount = count;
+
+    return 0;
+}
+
+lwm2m_object_t * object_find(lwm2m_context_t * contextP,
+                             uint16_t objectId)
+{
+    size_t low;
+    size_t high;
+
+    // the index could not be allocated
+    if (contextP->objectIndex == NULL) return (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, objectId);
+
+    low = 0;
+    high = contextP->objectCount;
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+
+        if (contextP->objectIds[middle] < objectId)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if (low < contextP->objectCount && contextP->objectIds[low] == objectId) return contextP->objectIndex[low];
+    return NULL;
+}
+
 static int prv_getMandatoryInfo(lwm2m_context_t *contextP,
                                 lwm2m_object_t * objectP,
                                 uint16_t instanceID,
@@ -118,7 +178,7 @@ uint8_t object_checkReadable(lwm2m_context_t * contextP,
     int size;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->readFunc) return COAP_405_METHOD_NOT_ALLOWED;
 
@@ -179,7 +239,7 @@ uint8_t object_readData(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->readFunc) return COAP_405_METHOD_NOT_ALLOWED;
 
@@ -291,7 +351,7 @@ uint8_t object_read(lwm2m_context_t * contextP,
         }
         if (result == COAP_205_CONTENT)
         {
-            res = lwm2m_data_serialize(uriP, size, dataP, formatP, bufferP);
+            res = data_serialize(uriP, size, dataP, formatP, bufferP);
             if (res < 0)
             {
                 result = COAP_500_INTERNAL_SERVER_ERROR;
@@ -376,7 +436,7 @@ uint8_t object_write(lwm2m_context_t * contextP,
     if (!LWM2M_URI_IS_SET_OBJECT(uriP)) return COAP_400_BAD_REQUEST;
     if (!LWM2M_URI_IS_SET_INSTANCE(uriP)) return COAP_400_BAD_REQUEST;
 
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP)
     {
         result = COAP_404_NOT_FOUND;
@@ -387,7 +447,7 @@ uint8_t object_write(lwm2m_context_t * contextP,
     }
     else
     {
-        size = lwm2m_data_parse(uriP, buffer, length, format, &dataP);
+        size = data_parse(uriP, buffer, length, format, &dataP);
         if (size <= 0)
         {
             result = COAP_406_NOT_ACCEPTABLE;
@@ -436,6 +496,132 @@ uint8_t object_write(lwm2m_context_t * contextP,
     return result;
 }
 
+#ifdef LWM2M_SUPPORT_COMPOSITE
+uint8_t object_readComposite(lwm2m_context_t * contextP,
+                             lwm2m_uri_t * uriList,
+                             int count,
+                             uint8_t ** bufferP,
+                             size_t * lengthP)
+{
+    int i;
+
+    LOG_ARG("count: %d", count);
+    *bufferP = NULL;
+    *lengthP = 0;
+
+    for (i = 0 ; i < count ; i++)
+    {
+        lwm2m_media_type_t format = LWM2M_CONTENT_SENML_JSON;
+        uint8_t * itemP = NULL;
+        size_t itemLen = 0;
+
+        LOG_URI(uriList + i);
+        // paths which cannot be read are left out of the pack
+        if (uriList[i].objectId == LWM2M_SECURITY_OBJECT_ID) continue;
+        if (COAP_205_CONTENT != object_read(contextP, uriList + i, NULL, 0, &format, &itemP, &itemLen)) continue;
+
+        if (senml_json_append(bufferP, lengthP, itemP, itemLen) < 0)
+        {
+            data_free(itemP);
+            if (*bufferP != NULL) data_free(*bufferP);
+            *bufferP = NULL;
+            *lengthP = 0;
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        }
+        data_free(itemP);
+    }
+
+    return (*bufferP != NULL) ? COAP_205_CONTENT : COAP_404_NOT_FOUND;
+}
+
+uint8_t object_writeComposite(lwm2m_context_t * contextP,
+                              uint8_t * buffer,
+                              size_t length)
+{
+    lwm2m_uri_t uri;
+    lwm2m_data_t * dataP = NULL;
+    int size;
+    int i;
+    size_t j;
+    uint8_t result = COAP_204_CHANGED;
+
+    LWM2M_URI_RESET(&uri);
+    size = senml_json_parse(&uri, buffer, length, &dataP);
+    if (size <= 0) return COAP_400_BAD_REQUEST;
+
+    // check all the targets first, so that a bad path does not leave a partial write behind
+    for (i = 0 ; i < size && result == COAP_204_CHANGED ; i++)
+    {
+        lwm2m_object_t * targetP;
+
+        if (dataP[i].type != LWM2M_TYPE_OBJECT)
+        {
+            result = COAP_400_BAD_REQUEST;
+            break;
+        }
+        if (dataP[i].id == LWM2M_SECURITY_OBJECT_ID)
+        {
+            result = COAP_401_UNAUTHORIZED;
+            break;
+        }
+        targetP = object_find(contextP, dataP[i].id);
+        if (NULL == targetP)
+        {
+            result = COAP_404_NOT_FOUND;
+            break;
+        }
+        if (NULL == targetP->writeFunc)
+        {
+            result = COAP_405_METHOD_NOT_ALLOWED;
+            break;
+        }
+        for (j = 0 ; j < dataP[i].value.asChildren.count ; j++)
+        {
+            lwm2m_data_t * instanceP = dataP[i].value.asChildren.array + j;
+
+            if (instanceP->type != LWM2M_TYPE_OBJECT_INSTANCE)
+            {
+                result = COAP_400_BAD_REQUEST;
+                break;
+            }
+            if (NULL == lwm2m_list_find(targetP->instanceList, instanceP->id))
+            {
+                result = COAP_404_NOT_FOUND;
+                break;
+            }
+        }
+    }
+
+    for (i = 0 ; i < size && result == COAP_204_CHANGED ; i++)
+    {
+        lwm2m_object_t * targetP;
+
+        targetP = object_find(contextP, dataP[i].id);
+        for (j = 0 ; j < dataP[i].value.asChildren.count && result == COAP_204_CHANGED ; j++)
+        {
+            lwm2m_data_t * instanceP = dataP[i].value.asChildren.array + j;
+
+            result = targetP->writeFunc(contextP,
+                                        instanceP->id,
+                                        instanceP->value.asChildren.count,
+                                        instanceP->value.asChildren.array,
+                                        targetP,
+                                        LWM2M_WRITE_PARTIAL_UPDATE);
+            if (result == COAP_204_CHANGED && targetP->objID == LWM2M_SERVER_OBJECT_ID)
+            {
+                prv_updateServerInfo(contextP, targetP, instanceP->id);
+            }
+        }
+    }
+
+    lwm2m_data_free(size, dataP);
+
+    LOG_ARG("result: %u.%02u", (result & 0xFF) >> 5, (result & 0x1F));
+
+    return result;
+}
+#endif
+
 uint8_t object_execute(lwm2m_context_t * contextP,
                        lwm2m_uri_t * uriP,
                        uint8_t * buffer,
@@ -444,7 +630,7 @@ uint8_t object_execute(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->executeFunc) return COAP_405_METHOD_NOT_ALLOWED;
     if (NULL == lwm2m_list_find(targetP->instanceList, uriP->instanceId)) return COAP_404_NOT_FOUND;
@@ -470,11 +656,11 @@ uint8_t object_create(lwm2m_context_t * contextP,
         return COAP_400_BAD_REQUEST;
     }
 
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->createFunc) return COAP_405_METHOD_NOT_ALLOWED;
 
-    size = lwm2m_data_parse(uriP, buffer, length, format, &dataP);
+    size = data_parse(uriP, buffer, length, format, &dataP);
     if (size <= 0) return COAP_400_BAD_REQUEST;
 
     switch (dataP[0].type)
@@ -531,7 +717,7 @@ uint8_t object_raw_block1_write(lwm2m_context_t * contextP,
     int size = 0;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->rawBlock1WriteFunc) return COAP_405_METHOD_NOT_ALLOWED;
 #ifndef LWM2M_VERSION_1_0
@@ -560,7 +746,7 @@ uint8_t object_raw_block1_execute(lwm2m_context_t * contextP,
     uint8_t result;
     
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->rawBlock1ExecuteFunc) return COAP_405_METHOD_NOT_ALLOWED;
     if (NULL == lwm2m_list_find(targetP->instanceList, uriP->instanceId)) return COAP_404_NOT_FOUND;
@@ -593,7 +779,7 @@ uint8_t object_raw_block1_create(lwm2m_context_t * contextP,
         return COAP_400_BAD_REQUEST;
     }
 
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->rawBlock1CreateFunc) return COAP_405_METHOD_NOT_ALLOWED;
 
@@ -615,7 +801,7 @@ uint8_t object_delete(lwm2m_context_t * contextP,
     uint8_t result;
 
     LOG_URI(uriP);
-    objectP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    objectP = object_find(contextP, uriP->objectId);
     if (NULL == objectP) return COAP_404_NOT_FOUND;
     if (NULL == objectP->deleteFunc) return COAP_405_METHOD_NOT_ALLOWED;
 
@@ -668,7 +854,7 @@ uint8_t object_discover(lwm2m_context_t * contextP,
     int size = 0;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->discoverFunc) return COAP_501_NOT_IMPLEMENTED;
 
@@ -742,7 +928,7 @@ bool object_isInstanceNew(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG("Entering");
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, objectId);
+    targetP = object_find(contextP, objectId);
     if (targetP != NULL)
     {
         if (NULL != lwm2m_list_find(targetP->instanceList, instanceId))
@@ -1204,7 +1390,7 @@ uint8_t object_createInstance(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
 
     if (NULL == targetP->createFunc)
@@ -1222,7 +1408,7 @@ uint8_t object_writeInstance(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
 
     if (NULL == targetP->writeFunc)
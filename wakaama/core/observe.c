@@ -158,6 +158,56 @@ static lwm2m_watcher_t * prv_getWatcher(lwm2m_context_t * contextP,
     return watcherP;
 }
 
+#ifdef LWM2M_SUPPORT_COMPOSITE
+static lwm2m_observed_composite_t * prv_findComposite(lwm2m_context_t * contextP,
+                                                      lwm2m_server_t * serverP,
+                                                      uint8_t * token,
+                                                      size_t tokenLen)
+{
+    lwm2m_observed_composite_t * compositeP;
+
+    for (compositeP = contextP->compositeObservedList ; compositeP != NULL ; compositeP = compositeP->next)
+    {
+        if (compositeP->watcher.server == serverP
+         && compositeP->watcher.tokenLen == tokenLen
+         && memcmp(compositeP->watcher.token, token, tokenLen) == 0)
+        {
+            return compositeP;
+        }
+    }
+
+    return NULL;
+}
+
+static void prv_removeComposite(lwm2m_context_t * contextP,
+                                lwm2m_observed_composite_t * compositeP)
+{
+    LOG("Entering");
+
+    if (contextP->compositeObservedList == compositeP)
+    {
+        contextP->compositeObservedList = compositeP->next;
+    }
+    else
+    {
+        lwm2m_observed_composite_t * parentP;
+
+        parentP = contextP->compositeObservedList;
+        while (parentP != NULL && parentP->next != compositeP)
+        {
+            parentP = parentP->next;
+        }
+        if (parentP != NULL)
+        {
+            parentP->next = compositeP->next;
+        }
+    }
+
+    lwm2m_free(compositeP->uriList);
+    lwm2m_free(compositeP);
+}
+#endif
+
 uint8_t observe_handleRequest(lwm2m_context_t * contextP,
                               lwm2m_uri_t * uriP,
                               lwm2m_server_t * serverP,
@@ -192,6 +242,9 @@ uint8_t observe_handleRequest(lwm2m_context_t * contextP,
         watcherP->active = true;
         watcherP->lastTime = lwm2m_gettime();
         watcherP->lastMid = response->mid;
+        // the server asked for this one, it counts as confirmed
+        watcherP->lastConTime = watcherP->lastTime;
+        watcherP->nonCount = 0;
         watcherP->format = (lwm2m_media_type_t)response->content_type;
 
         valueP = dataP;
@@ -243,6 +296,81 @@ uint8_t observe_handleRequest(lwm2m_context_t * contextP,
     }
 }
 
+#ifdef LWM2M_SUPPORT_COMPOSITE
+uint8_t observe_handleCompositeRequest(lwm2m_context_t * contextP,
+                                       lwm2m_uri_t * uriList,
+                                       int count,
+                                       lwm2m_server_t * serverP,
+                                       coap_packet_t * message,
+                                       coap_packet_t * response)
+{
+    lwm2m_observed_composite_t * compositeP;
+    lwm2m_uri_t * listP;
+    uint32_t observe;
+
+    LOG_ARG("Code: %02X, count: %d, server status: %s", message->code, count, STR_STATUS(serverP->status));
+
+    if (message->token_len == 0) return COAP_400_BAD_REQUEST;
+
+    coap_get_header_observe(message, &observe);
+    compositeP = prv_findComposite(contextP, serverP, message->token, message->token_len);
+
+    switch (observe)
+    {
+    case 0:
+        listP = (lwm2m_uri_t *)lwm2m_malloc(count * sizeof(lwm2m_uri_t));
+        if (listP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+        memcpy(listP, uriList, count * sizeof(lwm2m_uri_t));
+
+        if (compositeP == NULL)
+        {
+            compositeP = (lwm2m_observed_composite_t *)lwm2m_malloc(sizeof(lwm2m_observed_composite_t));
+            if (compositeP == NULL)
+            {
+                lwm2m_free(listP);
+                return COAP_500_INTERNAL_SERVER_ERROR;
+            }
+            memset(compositeP, 0, sizeof(lwm2m_observed_composite_t));
+            compositeP->watcher.server = serverP;
+            compositeP->watcher.tokenLen = message->token_len;
+            memcpy(compositeP->watcher.token, message->token, message->token_len);
+            compositeP->next = contextP->compositeObservedList;
+            contextP->compositeObservedList = compositeP;
+        }
+        else
+        {
+            // same token: the server replaces the observed paths
+            lwm2m_free(compositeP->uriList);
+        }
+        compositeP->uriList = listP;
+        compositeP->uriCount = count;
+
+        compositeP->watcher.active = true;
+        compositeP->watcher.update = false;
+        compositeP->watcher.lastTime = lwm2m_gettime();
+        compositeP->watcher.lastMid = response->mid;
+        compositeP->watcher.lastConTime = compositeP->watcher.lastTime;
+        compositeP->watcher.nonCount = 0;
+        compositeP->watcher.format = LWM2M_CONTENT_SENML_JSON;
+
+        coap_set_header_observe(response, compositeP->watcher.counter++);
+
+        return COAP_205_CONTENT;
+
+    case 1:
+        // cancellation
+        if (compositeP != NULL)
+        {
+            prv_removeComposite(contextP, compositeP);
+        }
+        return COAP_205_CONTENT;
+
+    default:
+        return COAP_400_BAD_REQUEST;
+    }
+}
+#endif
+
 void observe_cancel(lwm2m_context_t * contextP,
                     uint16_t mid,
                     void * fromSessionH)
@@ -292,6 +420,22 @@ void observe_cancel(lwm2m_context_t * contextP,
             return;
         }
     }
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    {
+        lwm2m_observed_composite_t * compositeP;
+
+        for (compositeP = contextP->compositeObservedList ; compositeP != NULL ; compositeP = compositeP->next)
+        {
+            if (compositeP->watcher.lastMid == mid
+             && lwm2m_session_is_equal(compositeP->watcher.server->sessionH, fromSessionH, contextP->userData))
+            {
+                prv_removeComposite(contextP, compositeP);
+                return;
+            }
+        }
+    }
+#endif
 }
 
 void observe_clear(lwm2m_context_t * contextP,
@@ -329,6 +473,33 @@ void observe_clear(lwm2m_context_t * contextP,
             observedP = observedP->next;
         }
     }
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    {
+        lwm2m_observed_composite_t * compositeP;
+
+        compositeP = contextP->compositeObservedList;
+        while (compositeP != NULL)
+        {
+            lwm2m_observed_composite_t * nextP;
+            int i;
+
+            nextP = compositeP->next;
+            for (i = 0 ; i < compositeP->uriCount ; i++)
+            {
+                if (compositeP->uriList[i].objectId == uriP->objectId
+                 && (LWM2M_URI_IS_SET_INSTANCE(uriP) == false
+                  || compositeP->uriList[i].instanceId == uriP->instanceId))
+                {
+                    // the server observes the paths as a whole
+                    prv_removeComposite(contextP, compositeP);
+                    break;
+                }
+            }
+            compositeP = nextP;
+        }
+    }
+#endif
 }
 
 uint8_t observe_setParameters(lwm2m_context_t * contextP,
@@ -466,51 +637,468 @@ lwm2m_observed_t * observe_findByUri(lwm2m_context_t * contextP,
     return NULL;
 }
 
+static bool prv_isUriOverlapping(lwm2m_uri_t * uriP,
+                                 lwm2m_uri_t * targetP)
+{
+    if (targetP->objectId != uriP->objectId) return false;
+
+    if (LWM2M_URI_IS_SET_INSTANCE(uriP)
+     && LWM2M_URI_IS_SET_INSTANCE(targetP)
+     && uriP->instanceId != targetP->instanceId)
+    {
+        return false;
+    }
+    if (LWM2M_URI_IS_SET_RESOURCE(uriP)
+     && LWM2M_URI_IS_SET_RESOURCE(targetP)
+     && uriP->resourceId != targetP->resourceId)
+    {
+        return false;
+    }
+#ifndef LWM2M_VERSION_1_0
+    if (LWM2M_URI_IS_SET_RESOURCE_INSTANCE(uriP)
+     && LWM2M_URI_IS_SET_RESOURCE_INSTANCE(targetP)
+     && uriP->resourceInstanceId != targetP->resourceInstanceId)
+    {
+        return false;
+    }
+#endif
+
+    return true;
+}
+
 void lwm2m_resource_value_changed(lwm2m_context_t * contextP,
                                   lwm2m_uri_t * uriP)
 {
     lwm2m_observed_t * targetP;
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    lwm2m_observed_composite_t * compositeP;
+#endif
 
     LOG_URI(uriP);
+#ifdef LWM2M_RESPONSE_CACHE
+    cache_invalidate(contextP, uriP);
+#endif
     targetP = contextP->observedList;
     while (targetP != NULL)
     {
-        if (targetP->uri.objectId == uriP->objectId)
+        if (prv_isUriOverlapping(uriP, &targetP->uri))
         {
-            if (!LWM2M_URI_IS_SET_INSTANCE(uriP)
-             || !LWM2M_URI_IS_SET_INSTANCE(&targetP->uri)
-             || uriP->instanceId == targetP->uri.instanceId)
+            lwm2m_watcher_t * watcherP;
+
+            LOG("Found an observation");
+            LOG_URI(&(targetP->uri));
+
+            for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
             {
-                if (!LWM2M_URI_IS_SET_RESOURCE(uriP)
-                 || !LWM2M_URI_IS_SET_RESOURCE(&targetP->uri)
-                 || uriP->resourceId == targetP->uri.resourceId)
+                if (watcherP->active == true)
                 {
-#ifndef LWM2M_VERSION_1_0
-                    if (!LWM2M_URI_IS_SET_RESOURCE_INSTANCE(uriP)
-                     || !LWM2M_URI_IS_SET_RESOURCE_INSTANCE(&targetP->uri)
-                     || uriP->resourceInstanceId == targetP->uri.resourceInstanceId)
+                    LOG("Tagging a watcher");
+                    watcherP->update = true;
+                }
+            }
+        }
+        targetP = targetP->next;
+    }
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    for (compositeP = contextP->compositeObservedList ; compositeP != NULL ; compositeP = compositeP->next)
+    {
+        int i;
+
+        if (compositeP->watcher.active == false) continue;
+
+        for (i = 0 ; i < compositeP->uriCount ; i++)
+        {
+            if (prv_isUriOverlapping(uriP, compositeP->uriList + i))
+            {
+                LOG("Tagging a composite watcher");
+                compositeP->watcher.update = true;
+                break;
+            }
+        }
+    }
 #endif
-                    {
-                        lwm2m_watcher_t * watcherP;
+}
 
-                        LOG("Found an observation");
-                        LOG_URI(&(targetP->uri));
+int lwm2m_set_notify_confirmable(lwm2m_context_t * contextP,
+                                 uint32_t count,
+                                 time_t interval)
+{
+    LOG_ARG("count: %d, interval: %d", (int)count, (int)interval);
+    if (interval < 0) return COAP_400_BAD_REQUEST;
 
-                        for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
-                        {
-                            if (watcherP->active == true)
-                            {
-                                LOG("Tagging a watcher");
-                                watcherP->update = true;
-                            }
-                        }
-                    }
+    contextP->notifyConCount = count;
+    contextP->notifyConInterval = interval;
+
+    return COAP_NO_ERROR;
+}
+
+static void prv_confirmableCallback(lwm2m_context_t * contextP,
+                                    lwm2m_transaction_t * transacP,
+                                    void * message)
+{
+    coap_packet_t * packet = (coap_packet_t *)message;
+    lwm2m_observed_t * observedP;
+
+    for (observedP = contextP->observedList ; observedP != NULL ; observedP = observedP->next)
+    {
+        lwm2m_watcher_t * parentP = NULL;
+        lwm2m_watcher_t * watcherP;
+
+        for (watcherP = observedP->watcherList ; watcherP != NULL ; parentP = watcherP, watcherP = watcherP->next)
+        {
+            if (watcherP->conPending == false
+             || watcherP->conMid != transacP->mID
+             || !lwm2m_session_is_equal(watcherP->server->sessionH, transacP->peerH, contextP->userData))
+            {
+                continue;
+            }
+
+            watcherP->conPending = false;
+            if (packet != NULL && packet->type != COAP_TYPE_RST) return;
+
+            // Not acknowledged or rejected: the observer is gone
+            LOG_ARG("Removing watcher after unconfirmed notification (mid: %d)", transacP->mID);
+            if (parentP == NULL)
+            {
+                observedP->watcherList = watcherP->next;
+            }
+            else
+            {
+                parentP->next = watcherP->next;
+            }
+            if (watcherP->parameters != NULL) lwm2m_free(watcherP->parameters);
+            lwm2m_free(watcherP);
+            if (observedP->watcherList == NULL)
+            {
+                prv_unlinkObserved(contextP, observedP);
+                lwm2m_free(observedP);
+            }
+            return;
+        }
+    }
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    {
+        lwm2m_observed_composite_t * compositeP;
+
+        for (compositeP = contextP->compositeObservedList ; compositeP != NULL ; compositeP = compositeP->next)
+        {
+            if (compositeP->watcher.conPending == false
+             || compositeP->watcher.conMid != transacP->mID
+             || !lwm2m_session_is_equal(compositeP->watcher.server->sessionH, transacP->peerH, contextP->userData))
+            {
+                continue;
+            }
+
+            compositeP->watcher.conPending = false;
+            if (packet == NULL || packet->type == COAP_TYPE_RST)
+            {
+                LOG_ARG("Removing composite watcher after unconfirmed notification (mid: %d)", transacP->mID);
+                prv_removeComposite(contextP, compositeP);
+            }
+            return;
+        }
+    }
+#endif
+}
+
+static void prv_sendNotification(lwm2m_context_t * contextP,
+                                 lwm2m_watcher_t * watcherP,
+                                 coap_packet_t * message,
+                                 time_t currentTime)
+{
+    bool confirmable = false;
+
+    watcherP->lastTime = currentTime;
+    watcherP->lastMid = contextP->nextMID++;
+    message->mid = watcherP->lastMid;
+    coap_set_header_token(message, watcherP->token, watcherP->tokenLen);
+    coap_set_header_observe(message, watcherP->counter++);
+
+    if (watcherP->conPending == false)
+    {
+        if (contextP->notifyConCount > 0
+         && watcherP->nonCount + 1 >= contextP->notifyConCount)
+        {
+            confirmable = true;
+        }
+        if (contextP->notifyConInterval > 0
+         && (time_t)(watcherP->lastConTime + contextP->notifyConInterval) <= currentTime)
+        {
+            confirmable = true;
+        }
+    }
+
+    if (confirmable == true)
+    {
+        lwm2m_transaction_t * transactionP;
+
+        transactionP = transaction_new(watcherP->server->sessionH, (coap_method_t)message->code, NULL, NULL, watcherP->lastMid, watcherP->tokenLen, watcherP->token);
+        if (transactionP != NULL)
+        {
+            coap_set_header_observe(transactionP->message, message->observe);
+            if (IS_OPTION(message, COAP_OPTION_CONTENT_TYPE))
+            {
+                coap_set_header_content_type(transactionP->message, message->content_type);
+            }
+            // the payload is serialized by transaction_send() before the caller releases it
+            coap_set_payload(transactionP->message, message->payload, message->payload_len);
+            transactionP->callback = prv_confirmableCallback;
+
+            contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transactionP);
+            if (0 == transaction_send(contextP, transactionP))
+            {
+                watcherP->conPending = true;
+                watcherP->conMid = watcherP->lastMid;
+                watcherP->lastConTime = currentTime;
+                watcherP->nonCount = 0;
+            }
+            return;
+        }
+    }
+
+    watcherP->nonCount++;
+    (void)message_send(contextP, message, watcherP->server->sessionH);
+}
+
+#ifdef LWM2M_NOTIFY_BATCHING
+int lwm2m_set_notify_batching(lwm2m_context_t * contextP,
+                              time_t window,
+                              size_t maxSize)
+{
+    LOG_ARG("window: %d, maxSize: %d", (int)window, (int)maxSize);
+    if (window < 0) return COAP_400_BAD_REQUEST;
+    if (maxSize == 0) maxSize = lwm2m_get_coap_block_size();
+
+    contextP->notifyBatchWindow = window;
+    contextP->notifyBatchMaxSize = maxSize;
+
+    return COAP_NO_ERROR;
+}
+
+static void prv_sendBatch(lwm2m_context_t * contextP,
+                          lwm2m_server_t * serverP,
+                          uint8_t * packP,
+                          size_t packLen)
+{
+    int result;
+
+    result = lwm2m_send_pack(contextP, serverP->shortID, packP, packLen, NULL, NULL);
+    if (result != COAP_NO_ERROR)
+    {
+        LOG_ARG("Sending the notification batch of server %d failed: %d.%02d", serverP->shortID, (result & 0xE0) >> 5, result & 0x1F);
+    }
+    data_free(packP);
+}
+
+static void prv_flushServerBatch(lwm2m_context_t * contextP,
+                                 lwm2m_server_t * serverP,
+                                 time_t currentTime)
+{
+    lwm2m_observed_t * targetP;
+    lwm2m_watcher_t * watcherP;
+    uint8_t * packP;
+    size_t packLen;
+
+    // The latest values of all the pending observations of the server go out as one SenML JSON pack
+    // in a Send operation. A pack reaching notifyBatchMaxSize is sent and the next one started.
+    packP = NULL;
+    packLen = 0;
+    for (targetP = contextP->observedList ; targetP != NULL ; targetP = targetP->next)
+    {
+        for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
+        {
+            lwm2m_media_type_t format;
+            uint8_t * itemP;
+            size_t itemLen;
+
+            if (watcherP->batchPending == false || watcherP->server != serverP) continue;
+
+            watcherP->batchPending = false;
+            watcherP->lastTime = currentTime;
+
+            format = LWM2M_CONTENT_SENML_JSON;
+            itemP = NULL;
+            itemLen = 0;
+            if (COAP_205_CONTENT != object_read(contextP, &targetP->uri, NULL, 0, &format, &itemP, &itemLen))
+            {
+                if (itemP != NULL) data_free(itemP);
+                continue;
+            }
+
+            // merging drops one bracket of each pack and adds a separator
+            if (packP != NULL
+             && packLen + itemLen - 1 > contextP->notifyBatchMaxSize)
+            {
+                prv_sendBatch(contextP, serverP, packP, packLen);
+                packP = NULL;
+                packLen = 0;
+            }
+            if (senml_json_append(&packP, &packLen, itemP, itemLen) < 0)
+            {
+                data_free(itemP);
+                break;
+            }
+            data_free(itemP);
+        }
+    }
+
+    if (packP != NULL)
+    {
+        prv_sendBatch(contextP, serverP, packP, packLen);
+    }
+}
+
+static void prv_flushBatches(lwm2m_context_t * contextP,
+                             time_t currentTime,
+                             time_t * timeoutP)
+{
+    lwm2m_server_t * serverP;
+
+    for (serverP = contextP->serverList ; serverP != NULL ; serverP = serverP->next)
+    {
+        lwm2m_observed_t * targetP;
+        lwm2m_watcher_t * watcherP;
+        bool due = false;
+
+        // The whole batch of a server goes out when the window of its oldest notification closes.
+        for (targetP = contextP->observedList ; targetP != NULL && due == false ; targetP = targetP->next)
+        {
+            for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
+            {
+                time_t interval;
+
+                if (watcherP->batchPending == false || watcherP->server != serverP) continue;
+
+                interval = watcherP->batchTime + contextP->notifyBatchWindow - currentTime;
+                if (interval <= 0)
+                {
+                    due = true;
+                    break;
                 }
+                if (*timeoutP > interval) *timeoutP = interval;
             }
         }
-        targetP = targetP->next;
+
+        if (due == true)
+        {
+            LOG_ARG("Flushing notification batch of server %d", serverP->shortID);
+            prv_flushServerBatch(contextP, serverP, currentTime);
+        }
+    }
+}
+#endif
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+// The composite observation is notified once the longest Minimum Period set on its paths elapsed,
+// and at the latest when the shortest Maximum Period set on its paths elapsed.
+void observe_getCompositePeriods(lwm2m_context_t * contextP,
+                                 lwm2m_observed_composite_t * compositeP,
+                                 lwm2m_attributes_t * periodsP)
+{
+    lwm2m_observed_t * observedP;
+    int i;
+
+    memset(periodsP, 0, sizeof(lwm2m_attributes_t));
+    for (i = 0 ; i < compositeP->uriCount ; i++)
+    {
+        for (observedP = contextP->observedList ; observedP != NULL ; observedP = observedP->next)
+        {
+            lwm2m_watcher_t * watcherP;
+
+            if (memcmp(&observedP->uri, compositeP->uriList + i, sizeof(lwm2m_uri_t)) != 0) continue;
+
+            watcherP = prv_findWatcher(observedP, compositeP->watcher.server);
+            if (watcherP == NULL || watcherP->parameters == NULL) break;
+
+            if ((watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MIN_PERIOD) != 0
+             && ((periodsP->toSet & LWM2M_ATTR_FLAG_MIN_PERIOD) == 0
+              || watcherP->parameters->minPeriod > periodsP->minPeriod))
+            {
+                periodsP->toSet |= LWM2M_ATTR_FLAG_MIN_PERIOD;
+                periodsP->minPeriod = watcherP->parameters->minPeriod;
+            }
+            if ((watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0
+             && ((periodsP->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) == 0
+              || watcherP->parameters->maxPeriod < periodsP->maxPeriod))
+            {
+                periodsP->toSet |= LWM2M_ATTR_FLAG_MAX_PERIOD;
+                periodsP->maxPeriod = watcherP->parameters->maxPeriod;
+            }
+            break;
+        }
+    }
+}
+
+static void prv_stepComposite(lwm2m_context_t * contextP,
+                              time_t currentTime,
+                              time_t * timeoutP)
+{
+    lwm2m_observed_composite_t * compositeP;
+
+    for (compositeP = contextP->compositeObservedList ; compositeP != NULL ; compositeP = compositeP->next)
+    {
+        lwm2m_watcher_t * watcherP = &compositeP->watcher;
+        lwm2m_attributes_t periods;
+        uint8_t * buffer = NULL;
+        size_t length = 0;
+        coap_packet_t message[1];
+        bool notify = false;
+        time_t interval;
+
+        if (watcherP->active == false) continue;
+
+        observe_getCompositePeriods(contextP, compositeP, &periods);
+
+        if (watcherP->update == true)
+        {
+            if ((periods.toSet & LWM2M_ATTR_FLAG_MIN_PERIOD) != 0
+             && (time_t)(watcherP->lastTime + periods.minPeriod) > currentTime)
+            {
+                // Minimum Period did not elapse yet, the change is kept for later
+                interval = watcherP->lastTime + periods.minPeriod - currentTime;
+                if (*timeoutP > interval) *timeoutP = interval;
+            }
+            else
+            {
+                notify = true;
+            }
+        }
+
+        if (notify == false
+         && (periods.toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0
+         && (time_t)(watcherP->lastTime + periods.maxPeriod) <= currentTime)
+        {
+            LOG("Notify composite on maximal period");
+            notify = true;
+        }
+
+        if (notify == true)
+        {
+            watcherP->update = false;
+            if (COAP_205_CONTENT == object_readComposite(contextP, compositeP->uriList, compositeP->uriCount, &buffer, &length))
+            {
+                coap_init_message(message, COAP_TYPE_NON, COAP_205_CONTENT, 0);
+                coap_set_header_content_type(message, LWM2M_CONTENT_SENML_JSON);
+                coap_set_payload(message, buffer, length);
+                prv_sendNotification(contextP, watcherP, message, currentTime);
+            }
+            else
+            {
+                watcherP->lastTime = currentTime;
+            }
+            if (buffer != NULL) data_free(buffer);
+        }
+
+        if ((periods.toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0)
+        {
+            interval = watcherP->lastTime + periods.maxPeriod - currentTime;
+            if (*timeoutP > interval) *timeoutP = interval;
+        }
     }
 }
+#endif
 
 void observe_step(lwm2m_context_t * contextP,
                   time_t currentTime,
@@ -771,6 +1359,19 @@ void observe_step(lwm2m_context_t * contextP,
                     }
                 }
 
+#ifdef LWM2M_NOTIFY_BATCHING
+                if (notify == true && contextP->notifyBatchWindow > 0)
+                {
+                    // deferred to prv_flushBatches(), the value is read again when the batch is sent
+                    if (watcherP->batchPending == false)
+                    {
+                        watcherP->batchPending = true;
+                        watcherP->batchTime = currentTime;
+                    }
+                    watcherP->update = false;
+                }
+                else
+#endif
                 if (notify == true)
                 {
                     if (buffer == NULL)
@@ -779,7 +1380,7 @@ void observe_step(lwm2m_context_t * contextP,
                         {
                             int res;
 
-                            res = lwm2m_data_serialize(&targetP->uri, size, dataP, &(watcherP->format), &buffer);
+                            res = data_serialize(&targetP->uri, size, dataP, &(watcherP->format), &buffer);
                             if (res < 0)
                             {
                                 break;
@@ -802,12 +1403,7 @@ void observe_step(lwm2m_context_t * contextP,
                         coap_set_header_content_type(message, watcherP->format);
                         coap_set_payload(message, buffer, length);
                     }
-                    watcherP->lastTime = currentTime;
-                    watcherP->lastMid = contextP->nextMID++;
-                    message->mid = watcherP->lastMid;
-                    coap_set_header_token(message, watcherP->token, watcherP->tokenLen);
-                    coap_set_header_observe(message, watcherP->counter++);
-                    (void)message_send(contextP, message, watcherP->server->sessionH);
+                    prv_sendNotification(contextP, watcherP, message, currentTime);
                     watcherP->update = false;
                 }
 
@@ -830,7 +1426,11 @@ void observe_step(lwm2m_context_t * contextP,
                     }
                 }
 
-                if (watcherP->parameters != NULL && (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0)
+                if (watcherP->parameters != NULL && (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0
+#ifdef LWM2M_NOTIFY_BATCHING
+                 && watcherP->batchPending == false
+#endif
+                   )
                 {
                     // update timers
                     interval = watcherP->lastTime + watcherP->parameters->maxPeriod - currentTime;
@@ -839,9 +1439,201 @@ void observe_step(lwm2m_context_t * contextP,
             }
         }
         if (dataP != NULL) lwm2m_data_free(size, dataP);
-        if (buffer != NULL) lwm2m_free(buffer);
+        if (buffer != NULL) data_free(buffer);
+    }
+
+#ifdef LWM2M_NOTIFY_BATCHING
+    if (contextP->notifyBatchWindow > 0)
+    {
+        prv_flushBatches(contextP, currentTime, timeoutP);
+    }
+#endif
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    prv_stepComposite(contextP, currentTime, timeoutP);
+#endif
+}
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+typedef struct
+{
+    uint16_t shortServerID;
+    lwm2m_send_callback_t callback;
+    void * userData;
+} send_data_t;
+
+static void prv_sendResultCallback(lwm2m_context_t * contextP,
+                                   lwm2m_transaction_t * transacP,
+                                   void * message)
+{
+    coap_packet_t * packet = (coap_packet_t *)message;
+    send_data_t * dataP = (send_data_t *)transacP->userData;
+    uint8_t status;
+
+    if (packet == NULL)
+    {
+        status = COAP_503_SERVICE_UNAVAILABLE;
+    }
+    else
+    {
+        status = packet->code;
+    }
+    LOG_ARG("Send result for server %d: %d.%02d", dataP->shortServerID, (status & 0xE0) >> 5, status & 0x1F);
+
+    if (dataP->callback != NULL)
+    {
+        dataP->callback(contextP, dataP->shortServerID, status, dataP->userData);
+    }
+    lwm2m_free(dataP);
+    transacP->userData = NULL;
+}
+
+int lwm2m_send_pack(lwm2m_context_t * contextP,
+                    uint16_t shortServerID,
+                    const uint8_t * buffer,
+                    size_t length,
+                    lwm2m_send_callback_t callback,
+                    void * userData)
+{
+    lwm2m_server_t * serverP;
+    int result;
+
+    LOG_ARG("shortServerID: %d, length: %d", shortServerID, (int)length);
+
+    if (buffer == NULL || length == 0) return COAP_400_BAD_REQUEST;
+
+    result = COAP_404_NOT_FOUND;
+    for (serverP = contextP->serverList ; serverP != NULL ; serverP = serverP->next)
+    {
+        lwm2m_transaction_t * transactionP;
+        send_data_t * dataP;
+
+        if (shortServerID != 0 && serverP->shortID != shortServerID) continue;
+        if (serverP->status != STATE_REGISTERED
+         && serverP->status != STATE_REG_UPDATE_NEEDED
+         && serverP->status != STATE_REG_FULL_UPDATE_NEEDED
+         && serverP->status != STATE_REG_UPDATE_PENDING)
+        {
+            if (result == COAP_404_NOT_FOUND) result = COAP_503_SERVICE_UNAVAILABLE;
+            continue;
+        }
+
+        transactionP = transaction_new(serverP->sessionH, COAP_POST, NULL, NULL, contextP->nextMID++, 4, NULL);
+        if (transactionP == NULL)
+        {
+            result = COAP_500_INTERNAL_SERVER_ERROR;
+            break;
+        }
+        coap_set_header_uri_path(transactionP->message, "/"URI_SEND_SEGMENT);
+        coap_set_header_content_type(transactionP->message, LWM2M_CONTENT_SENML_JSON);
+        if (!transaction_set_payload(transactionP, (uint8_t *)buffer, length))
+        {
+            transaction_free(transactionP);
+            result = COAP_500_INTERNAL_SERVER_ERROR;
+            break;
+        }
+
+        dataP = (send_data_t *)lwm2m_malloc(sizeof(send_data_t));
+        if (dataP == NULL)
+        {
+            transaction_free(transactionP);
+            result = COAP_500_INTERNAL_SERVER_ERROR;
+            break;
+        }
+        dataP->shortServerID = serverP->shortID;
+        dataP->callback = callback;
+        dataP->userData = userData;
+
+        transactionP->callback = prv_sendResultCallback;
+        transactionP->userData = (void *)dataP;
+
+        contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transactionP);
+        result = COAP_NO_ERROR;
+#ifdef LWM2M_QUEUE_MODE
+        // sent by transaction_step() when the client wakes up
+        if (contextP->queueSleeping == true) continue;
+#endif
+        if (0 != transaction_send(contextP, transactionP))
+        {
+            result = COAP_500_INTERNAL_SERVER_ERROR;
+            break;
+        }
+    }
+
+    return result;
+}
+
+int lwm2m_send(lwm2m_context_t * contextP,
+               uint16_t shortServerID,
+               lwm2m_uri_t * uriList,
+               size_t count,
+               lwm2m_send_callback_t callback,
+               void * userData)
+{
+    uint8_t * buffer = NULL;
+    size_t length = 0;
+    int result;
+
+    LOG_ARG("shortServerID: %d, count: %d", shortServerID, (int)count);
+
+    if (uriList == NULL || count == 0) return COAP_400_BAD_REQUEST;
+
+    result = object_readComposite(contextP, uriList, (int)count, &buffer, &length);
+    if (result != COAP_205_CONTENT) return result;
+
+    result = lwm2m_send_pack(contextP, shortServerID, buffer, length, callback, userData);
+
+    data_free(buffer);
+
+    return result;
+}
+#endif
+
+#ifdef LWM2M_SUPPORT_SENML_JSON
+int lwm2m_notify_pack(lwm2m_context_t * contextP,
+                      lwm2m_uri_t * uriP,
+                      const uint8_t * buffer,
+                      size_t length)
+{
+    lwm2m_observed_t * observedP;
+    lwm2m_watcher_t * watcherP;
+    time_t currentTime;
+    int result;
+
+    LOG_ARG("length: %d", (int)length);
+    LOG_URI(uriP);
+
+    if (uriP == NULL || buffer == NULL || length == 0) return COAP_400_BAD_REQUEST;
+#ifdef LWM2M_QUEUE_MODE
+    // nothing leaves the client while it sleeps, the application keeps the pack
+    if (contextP->queueSleeping == true) return COAP_503_SERVICE_UNAVAILABLE;
+#endif
+
+    currentTime = lwm2m_gettime();
+    if (currentTime < 0) return COAP_500_INTERNAL_SERVER_ERROR;
+
+    result = COAP_404_NOT_FOUND;
+    observedP = prv_findObserved(contextP, uriP);
+    if (observedP == NULL) return result;
+
+    for (watcherP = observedP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
+    {
+        coap_packet_t message[1];
+
+        // the pack replaces a notification of the observed value, in the format asked by the server
+        if (watcherP->active == false || watcherP->format != LWM2M_CONTENT_SENML_JSON) continue;
+
+        coap_init_message(message, COAP_TYPE_NON, COAP_205_CONTENT, 0);
+        coap_set_header_content_type(message, LWM2M_CONTENT_SENML_JSON);
+        coap_set_payload(message, buffer, length);
+        prv_sendNotification(contextP, watcherP, message, currentTime);
+        watcherP->update = false;
+        result = COAP_NO_ERROR;
     }
+
+    return result;
 }
+#endif
 
 #endif
 
@@ -1105,6 +1897,8 @@ static
 int prv_lwm2m_observe(lwm2m_context_t * contextP,
         uint16_t clientID,
         lwm2m_uri_t * uriP,
+        uint8_t * payload,
+        size_t payloadLength,
         lwm2m_result_callback_t callback,
         void * userData)
 {
@@ -1151,7 +1945,8 @@ int prv_lwm2m_observe(lwm2m_context_t * contextP,
     token[2] = observationData->id >> 8;
     token[3] = observationData->id & 0xFF;
 
-    transactionP = transaction_new(clientP->sessionH, COAP_GET, clientP->altPath, uriP, contextP->nextMID++, 4, token);
+    // a payload carries the path list of an Observe-Composite
+    transactionP = transaction_new(clientP->sessionH, payload == NULL ? COAP_GET : COAP_FETCH, clientP->altPath, uriP, contextP->nextMID++, 4, token);
     if (transactionP == NULL)
     {
         lwm2m_free(observationData);
@@ -1159,7 +1954,21 @@ int prv_lwm2m_observe(lwm2m_context_t * contextP,
     }
 
     coap_set_header_observe(transactionP->message, 0);
-    coap_set_header_accept(transactionP->message, clientP->format);
+    if (payload == NULL)
+    {
+        coap_set_header_accept(transactionP->message, clientP->format);
+    }
+    else
+    {
+        coap_set_header_content_type(transactionP->message, LWM2M_CONTENT_SENML_JSON);
+        coap_set_header_accept(transactionP->message, LWM2M_CONTENT_SENML_JSON);
+        if (!transaction_set_payload(transactionP, payload, payloadLength))
+        {
+            transaction_free(transactionP);
+            lwm2m_free(observationData);
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        }
+    }
 
     transactionP->callback = prv_obsRequestCallback;
     transactionP->userData = (void *)observationData;
@@ -1187,10 +1996,114 @@ int lwm2m_observe(lwm2m_context_t * contextP,
     return prv_lwm2m_observe(contextP,
                              clientID,
                              uriP,
+                             NULL,
+                             0,
                              callback,
                              userData);
 }
 
+#ifdef LWM2M_SUPPORT_COMPOSITE
+int lwm2m_observe_composite(lwm2m_context_t * contextP,
+        uint16_t clientID,
+        lwm2m_uri_t * uriList,
+        size_t count,
+        lwm2m_result_callback_t callback,
+        void * userData)
+{
+    lwm2m_uri_t rootUri;
+    uint8_t * buffer = NULL;
+    int length;
+    int result;
+
+    LOG_ARG("clientID: %d, count: %d", clientID, (int)count);
+
+    length = senml_json_serialize_uris(uriList, count, &buffer);
+    if (length <= 0) return COAP_400_BAD_REQUEST;
+
+    // the composite observation is stored under the root path
+    LWM2M_URI_RESET(&rootUri);
+    result = prv_lwm2m_observe(contextP,
+                               clientID,
+                               &rootUri,
+                               buffer,
+                               (size_t)length,
+                               callback,
+                               userData);
+    lwm2m_free(buffer);
+
+    return result;
+}
+
+int lwm2m_observe_composite_cancel(lwm2m_context_t * contextP,
+        uint16_t clientID)
+{
+    lwm2m_client_t * clientP;
+    lwm2m_observation_t * observationP;
+    lwm2m_uri_t rootUri;
+
+    LOG_ARG("clientID: %d", clientID);
+
+    clientP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)contextP->clientList, clientID);
+    if (clientP == NULL) return COAP_404_NOT_FOUND;
+
+    LWM2M_URI_RESET(&rootUri);
+    observationP = prv_findObservationByURI(clientP, &rootUri);
+    if (observationP == NULL) return COAP_404_NOT_FOUND;
+
+    // passive cancellation: the next notification is answered with a Reset
+    observationP->callback(contextP, clientID, &observationP->uri, COAP_202_DELETED, NULL,
+                           LWM2M_CONTENT_TEXT, NULL, 0, observationP->userData);
+    observe_remove(observationP);
+
+    return COAP_NO_ERROR;
+}
+
+void lwm2m_set_send_callback(lwm2m_context_t * contextP,
+                             lwm2m_result_callback_t callback,
+                             void * userData)
+{
+    LOG("Entering");
+    contextP->sendCallback = callback;
+    contextP->sendUserData = userData;
+}
+
+uint8_t observe_handleSend(lwm2m_context_t * contextP,
+                           void * fromSessionH,
+                           coap_packet_t * message)
+{
+    lwm2m_client_t * clientP;
+    lwm2m_uri_t rootUri;
+
+    LOG("Entering");
+
+    if (message->code != COAP_POST) return COAP_405_METHOD_NOT_ALLOWED;
+
+    clientP = utils_findClient(contextP, fromSessionH);
+    if (clientP == NULL) return COAP_400_BAD_REQUEST;
+
+    if (!IS_OPTION(message, COAP_OPTION_CONTENT_TYPE)
+     || utils_convertMediaType(message->content_type) != LWM2M_CONTENT_SENML_JSON)
+    {
+        return COAP_415_UNSUPPORTED_CONTENT_FORMAT;
+    }
+    if (message->payload_len == 0) return COAP_400_BAD_REQUEST;
+    if (contextP->sendCallback == NULL) return COAP_404_NOT_FOUND;
+
+    LWM2M_URI_RESET(&rootUri);
+    contextP->sendCallback(contextP,
+                           clientP->internalID,
+                           &rootUri,
+                           COAP_NO_ERROR,
+                           NULL,
+                           LWM2M_CONTENT_SENML_JSON,
+                           message->payload,
+                           message->payload_len,
+                           contextP->sendUserData);
+
+    return COAP_204_CHANGED;
+}
+#endif
+
 static
 int prv_lwm2m_observe_cancel(lwm2m_context_t * contextP,
         uint16_t clientID,
@@ -198,6 +198,11 @@ static uint8_t handle_request(lwm2m_context_t * contextP,
     case LWM2M_REQUEST_TYPE_REGISTRATION:
         result = registration_handleRequest(contextP, &uri, fromSessionH, message, response);
         break;
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    case LWM2M_REQUEST_TYPE_SEND:
+        result = observe_handleSend(contextP, fromSessionH, message);
+        break;
+#endif
 #endif
 #ifdef LWM2M_BOOTSTRAP_SERVER_MODE
     case LWM2M_REQUEST_TYPE_BOOTSTRAP:
@@ -239,13 +244,17 @@ static lwm2m_transaction_t * prv_get_transaction(lwm2m_context_t * contextP, voi
 
 // limited clone of transaction to be used by block transfers
 static lwm2m_transaction_t * prv_create_next_block_transaction(lwm2m_transaction_t * transaction, uint16_t nextMID){
-    static coap_packet_t message[1];
+    coap_packet_t message[1];
     if (0 != coap_parse_message(message, transaction->buffer, transaction->buffer_len)){
         return NULL;
     }
 
     lwm2m_transaction_t * clone = transaction_new(transaction->peerH, (coap_method_t) message->code, NULL, NULL, nextMID, message->token_len, message->token);
-    if (clone == NULL) return NULL;
+    if (clone == NULL)
+    {
+        coap_free_header(message);
+        return NULL;
+    }
 
     coap_set_header_content_type(clone->message, message->type);
 
@@ -277,7 +286,8 @@ static lwm2m_transaction_t * prv_create_next_block_transaction(lwm2m_transaction
 
     if(IS_OPTION(message, COAP_OPTION_LOCATION_PATH))
     {
-        ((coap_packet_t *)clone->message)->location_path = message->location_path;
+        // the parsed options point into message, which does not outlive this function
+        coap_copy_multi_option(&((coap_packet_t *)clone->message)->location_path, message->location_path);
         SET_OPTION((coap_packet_t *)clone->message, COAP_OPTION_LOCATION_PATH);
     }
     
@@ -297,7 +307,7 @@ static lwm2m_transaction_t * prv_create_next_block_transaction(lwm2m_transaction
   
     if(IS_OPTION(message, COAP_OPTION_URI_PATH))
     {
-        ((coap_packet_t *)clone->message)->uri_path = message->uri_path;
+        coap_copy_multi_option(&((coap_packet_t *)clone->message)->uri_path, message->uri_path);
         SET_OPTION((coap_packet_t *)clone->message, COAP_OPTION_URI_PATH);
     }
 
@@ -317,7 +327,7 @@ static lwm2m_transaction_t * prv_create_next_block_transaction(lwm2m_transaction
 
     if(IS_OPTION(message, COAP_OPTION_URI_QUERY))
     {
-        ((coap_packet_t *)clone->message)->uri_query = message->uri_query;
+        coap_copy_multi_option(&((coap_packet_t *)clone->message)->uri_query, message->uri_query);
         SET_OPTION((coap_packet_t *)clone->message, COAP_OPTION_URI_QUERY);
     }
 
@@ -326,6 +336,8 @@ static lwm2m_transaction_t * prv_create_next_block_transaction(lwm2m_transaction
         coap_set_header_if_none_match(clone->message);
     }
 
+    coap_free_header(message);
+
     uint8_t *cloned_transaction_payload = (uint8_t *)lwm2m_malloc(transaction->payload_len);
     if (cloned_transaction_payload == NULL) {
         return NULL;
@@ -479,20 +491,39 @@ static int prv_send_get_next_block2(lwm2m_context_t * contextP,
  */
 void lwm2m_handle_packet(lwm2m_context_t *contextP, uint8_t *buffer, size_t length, void *fromSessionH) {
     uint8_t coap_error_code = NO_ERROR;
-    static coap_packet_t message[1];
-    static coap_packet_t response[1];
+    const char * coap_error_message;
+    // per-packet state lives on the stack so that contexts can be driven from different threads
+    coap_packet_t message[1];
+    coap_packet_t response[1];
 
     LOG("Entering");
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_QUEUE_MODE)
+    queue_keepAwake(contextP);
+#endif
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_DATA_ARENA)
+    // the data trees and payloads built for this message are released at once on return
+    data_arenaBegin(contextP);
+#endif
     /* The buffer length is uint16_t here, as UDP packet length field is 16 bit.
      * This might change in the future e.g. for supporting TCP or other transport.
      */
     coap_error_code = coap_parse_message(message, buffer, (uint16_t)length);
+#ifdef LWM2M_SUPPORT_OSCORE
+    if (coap_error_code == NO_ERROR && IS_OPTION(message, COAP_OPTION_OSCORE))
+    {
+        // protected messages are verified and decrypted by their session before reaching the stack
+        coap_free_header(message);
+        message->error_message = "Unexpected OSCORE option";
+        coap_error_code = BAD_OPTION_4_02;
+    }
+#endif
+    coap_error_message = message->error_message != NULL ? message->error_message : "";
     if (coap_error_code == NO_ERROR)
     {
         LOG_ARG("Parsed: ver %u, type %u, tkl %u, code %u.%.2u, mid %u, Content type: %d",
                 message->version, message->type, message->token_len, message->code >> 5, message->code & 0x1F, message->mid, message->content_type);
         LOG_ARG("Payload: %.*s", message->payload_len, STR_NULL2EMPTY(message->payload));
-        if (message->code >= COAP_GET && message->code <= COAP_DELETE)
+        if (message->code >= COAP_GET && message->code <= COAP_IPATCH)
         {
             uint32_t block_num = 0;
             uint16_t block_size = lwm2m_get_coap_block_size();
@@ -641,7 +672,7 @@ void lwm2m_handle_packet(lwm2m_context_t *contextP, uint8_t *buffer, size_t leng
 
                 coap_error_code = message_send(contextP, response, fromSessionH);
 
-                lwm2m_free(payload);
+                data_free(payload);
                 response->payload = NULL;
                 response->payload_len = 0;
             }
@@ -844,7 +875,7 @@ void lwm2m_handle_packet(lwm2m_context_t *contextP, uint8_t *buffer, size_t leng
 
     if (coap_error_code != NO_ERROR && coap_error_code != COAP_IGNORE)
     {
-        LOG_ARG("ERROR %u: %s", coap_error_code, STR_NULL2EMPTY(coap_error_message));
+        LOG_ARG("ERROR %u: %s", coap_error_code, coap_error_message);
 
         /* Set to sendable error code. */
         if (coap_error_code >= 192)
@@ -856,6 +887,9 @@ void lwm2m_handle_packet(lwm2m_context_t *contextP, uint8_t *buffer, size_t leng
         coap_set_payload(message, coap_error_message, strlen(coap_error_message));
         message_send(contextP, message, fromSessionH);
     }
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_DATA_ARENA)
+    data_arenaEnd(contextP);
+#endif
 }
 
 uint8_t message_send(lwm2m_context_t * contextP,
@@ -868,11 +902,32 @@ uint8_t message_send(lwm2m_context_t * contextP,
     size_t allocLen;
 
     LOG("Entering");
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_QUEUE_MODE)
+    queue_keepAwake(contextP);
+#endif
     allocLen = coap_serialize_get_size(message);
     LOG_ARG("Size to allocate: %d", allocLen);
     if (allocLen == 0) return COAP_500_INTERNAL_SERVER_ERROR;
 
-    pktBuffer = (uint8_t *)lwm2m_malloc(allocLen);
+#ifdef LWM2M_VECTORED_SEND
+    // the payload is sent from where it lies, only the header is serialized
+    if (allocLen - message->payload_len <= LWM2M_COAP_HEADER_BUFFER_SIZE)
+    {
+        uint8_t header[LWM2M_COAP_HEADER_BUFFER_SIZE];
+        lwm2m_iovec_t iov[2];
+
+        iov[0].base = header;
+        iov[0].length = coap_serialize_header(message, header);
+        iov[1].base = message->payload;
+        iov[1].length = message->payload_len;
+        LOG_ARG("coap_serialize_header() returned %d", iov[0].length);
+
+        return lwm2m_buffer_sendv(sessionH, iov, message->payload_len != 0 ? 2 : 1, contextP->userData);
+    }
+#endif
+
+    // taken from the data arena when called while handling a request or a notification
+    pktBuffer = (uint8_t *)data_malloc(allocLen);
     if (pktBuffer != NULL)
     {
         pktBufferLen = coap_serialize_message(message, pktBuffer);
@@ -881,7 +936,7 @@ uint8_t message_send(lwm2m_context_t * contextP,
         {
             result = lwm2m_buffer_send(sessionH, pktBuffer, pktBufferLen, contextP->userData);
         }
-        lwm2m_free(pktBuffer);
+        data_free(pktBuffer);
     }
 
     return result;
@@ -0,0 +1,286 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Eclipse Foundation and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v2.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v20.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Queue mode scheduler.
+ *
+ * When all the servers use a binding with queue mode, the client stays awake
+ * for the awake time after its last exchange with a server, then sleeps. While
+ * asleep, value changes and Sends are kept pending. The client wakes up when a
+ * notification reaches its Maximum Period or a registration update is due, and
+ * everything pending goes out in the same lwm2m_step().
+ */
+
+#include "internals.h"
+
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_QUEUE_MODE)
+
+static bool prv_canSleep(lwm2m_context_t * contextP,
+                         time_t currentTime)
+{
+    lwm2m_server_t * serverP;
+    lwm2m_observed_t * targetP;
+
+    if (contextP->state != STATE_READY
+     || contextP->serverList == NULL
+     || contextP->transactionList != NULL)
+    {
+        return false;
+    }
+
+    for (serverP = contextP->serverList ; serverP != NULL ; serverP = serverP->next)
+    {
+        // a server without queue mode expects to reach the client at any time
+        if ((serverP->binding & BINDING_Q) == 0
+         || serverP->status != STATE_REGISTERED
+         || serverP->blockData != NULL)
+        {
+            return false;
+        }
+    }
+
+#ifdef LWM2M_NOTIFY_BATCHING
+    for (targetP = contextP->observedList ; targetP != NULL ; targetP = targetP->next)
+    {
+        lwm2m_watcher_t * watcherP;
+
+        for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
+        {
+            if (watcherP->batchPending == true) return false;
+        }
+    }
+#else
+    (void)targetP;
+#endif
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    {
+        lwm2m_observed_composite_t * compositeP;
+
+        for (compositeP = contextP->compositeObservedList ; compositeP != NULL ; compositeP = compositeP->next)
+        {
+            lwm2m_attributes_t periods;
+
+            if (compositeP->watcher.active == false || compositeP->watcher.update == false) continue;
+
+            // a change whose Minimum Period elapsed goes out before sleeping
+            observe_getCompositePeriods(contextP, compositeP, &periods);
+            if ((periods.toSet & LWM2M_ATTR_FLAG_MIN_PERIOD) == 0
+             || (time_t)(compositeP->watcher.lastTime + periods.minPeriod) <= currentTime)
+            {
+                return false;
+            }
+        }
+    }
+#endif
+
+    return true;
+}
+
+// date of the next event the client must wake up for
+static time_t prv_nextWakeup(lwm2m_context_t * contextP,
+                             time_t currentTime)
+{
+    lwm2m_server_t * serverP;
+    lwm2m_observed_t * targetP;
+    time_t wakeup;
+
+    wakeup = currentTime + LWM2M_DEFAULT_LIFETIME;
+
+    for (serverP = contextP->serverList ; serverP != NULL ; serverP = serverP->next)
+    {
+        time_t updateTime;
+
+        // lwm2m_update_registration() was called
+        if (serverP->status != STATE_REGISTERED) return currentTime;
+
+        updateTime = registration_getUpdateTime(serverP);
+        if (wakeup > updateTime) wakeup = updateTime;
+    }
+
+    for (targetP = contextP->observedList ; targetP != NULL ; targetP = targetP->next)
+    {
+        lwm2m_watcher_t * watcherP;
+
+        for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
+        {
+            time_t maxTime;
+
+            if (watcherP->active == false
+             || watcherP->parameters == NULL
+             || (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) == 0)
+            {
+                continue;
+            }
+
+            maxTime = watcherP->lastTime + watcherP->parameters->maxPeriod;
+            if (wakeup > maxTime) wakeup = maxTime;
+        }
+    }
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    {
+        lwm2m_observed_composite_t * compositeP;
+
+        for (compositeP = contextP->compositeObservedList ; compositeP != NULL ; compositeP = compositeP->next)
+        {
+            lwm2m_attributes_t periods;
+            time_t maxTime;
+
+            if (compositeP->watcher.active == false) continue;
+
+            observe_getCompositePeriods(contextP, compositeP, &periods);
+            if ((periods.toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) == 0) continue;
+
+            maxTime = compositeP->watcher.lastTime + periods.maxPeriod;
+            if (wakeup > maxTime) wakeup = maxTime;
+        }
+    }
+#endif
+
+    return wakeup;
+}
+
+static void prv_wakeUp(lwm2m_context_t * contextP,
+                       time_t currentTime)
+{
+    LOG("Waking up");
+    contextP->queueSleeping = false;
+    contextP->queueWakeup = false;
+    contextP->queueSleepTime = currentTime + contextP->queueAwakeTime;
+
+#ifdef LWM2M_VERSION_1_0
+    {
+        lwm2m_server_t * serverP;
+
+        // a LWM2M 1.0 server only learns the client is reachable from a registration update
+        for (serverP = contextP->serverList ; serverP != NULL ; serverP = serverP->next)
+        {
+            if (serverP->status == STATE_REGISTERED) serverP->status = STATE_REG_UPDATE_NEEDED;
+        }
+    }
+#endif
+}
+
+int lwm2m_set_queue_mode(lwm2m_context_t * contextP,
+                         time_t awakeTime)
+{
+    LOG_ARG("awakeTime: %d", (int)awakeTime);
+    if (awakeTime < 0) return COAP_400_BAD_REQUEST;
+
+    contextP->queueAwakeTime = awakeTime;
+    if (awakeTime == 0)
+    {
+        contextP->queueSleeping = false;
+        contextP->queueWakeup = false;
+    }
+    else
+    {
+        time_t tv_sec = lwm2m_gettime();
+        if (tv_sec < 0) return COAP_500_INTERNAL_SERVER_ERROR;
+        contextP->queueSleepTime = tv_sec + awakeTime;
+    }
+
+    return COAP_NO_ERROR;
+}
+
+void lwm2m_queue_wakeup(lwm2m_context_t * contextP)
+{
+    LOG("Entering");
+    if (contextP->queueSleeping == true) contextP->queueWakeup = true;
+}
+
+bool lwm2m_queue_is_sleeping(lwm2m_context_t * contextP,
+                             time_t * nextWakeupP)
+{
+    if (contextP->queueSleeping == false) return false;
+
+    if (nextWakeupP != NULL)
+    {
+        time_t tv_sec = lwm2m_gettime();
+
+        *nextWakeupP = prv_nextWakeup(contextP, tv_sec < 0 ? 0 : tv_sec);
+    }
+    return true;
+}
+
+void queue_keepAwake(lwm2m_context_t * contextP)
+{
+    time_t tv_sec;
+
+    if (contextP->queueAwakeTime == 0) return;
+
+    tv_sec = lwm2m_gettime();
+    if (tv_sec < 0) return;
+
+    if (contextP->queueSleeping == true)
+    {
+        LOG("Woken up by an exchange with a server");
+    }
+    contextP->queueSleeping = false;
+    contextP->queueWakeup = false;
+    contextP->queueSleepTime = tv_sec + contextP->queueAwakeTime;
+}
+
+bool queue_step(lwm2m_context_t * contextP,
+                time_t currentTime,
+                time_t * timeoutP)
+{
+    time_t wakeup;
+
+    if (contextP->queueAwakeTime == 0) return false;
+
+    if (contextP->queueSleeping == false)
+    {
+        if (contextP->queueSleepTime > currentTime)
+        {
+            time_t interval = contextP->queueSleepTime - currentTime;
+
+            if (*timeoutP > interval) *timeoutP = interval;
+            return false;
+        }
+        if (prv_canSleep(contextP, currentTime) == false) return false;
+
+        // something is due, go to sleep once it is done
+        wakeup = prv_nextWakeup(contextP, currentTime);
+        if (wakeup <= currentTime) return false;
+
+        LOG("Going to sleep");
+        contextP->queueSleeping = true;
+    }
+    else
+    {
+        if (contextP->state != STATE_READY)
+        {
+            prv_wakeUp(contextP, currentTime);
+            return false;
+        }
+
+        wakeup = prv_nextWakeup(contextP, currentTime);
+        if (wakeup <= currentTime || contextP->queueWakeup == true)
+        {
+            prv_wakeUp(contextP, currentTime);
+            return false;
+        }
+    }
+
+    LOG_ARG("Sleeping for %d s", (int)(wakeup - currentTime));
+    if (*timeoutP > wakeup - currentTime) *timeoutP = wakeup - currentTime;
+    return true;
+}
+
+#endif
@@ -593,7 +593,7 @@ static void prv_handleRegistrationAttemptFailure(lwm2m_context_t *contextP, lwm2
 {
     lwm2m_object_t *serverObjP;
 
-    serverObjP = (lwm2m_object_t*)LWM2M_LIST_FIND(contextP->objectList, LWM2M_SERVER_OBJECT_ID);
+    serverObjP = object_find(contextP, LWM2M_SERVER_OBJECT_ID);
     if (serverObjP)
     {
         uint8_t attemptLimit;
@@ -672,7 +672,7 @@ static void prv_handleRegistrationReply(lwm2m_context_t * contextP,
             {
                 lwm2m_object_t *serverObjP;
 
-                serverObjP = (lwm2m_object_t*)LWM2M_LIST_FIND(contextP->objectList, LWM2M_SERVER_OBJECT_ID);
+                serverObjP = object_find(contextP, LWM2M_SERVER_OBJECT_ID);
                 if (serverObjP)
                 {
                     bool ordered;
@@ -1029,7 +1029,7 @@ uint8_t registration_start(lwm2m_context_t * contextP, bool restartFailed)
     LOG_ARG("State: %s", STR_STATE(contextP->state));
 
 #ifndef LWM2M_VERSION_1_0
-    serverObjP = (lwm2m_object_t*)LWM2M_LIST_FIND(contextP->objectList, LWM2M_SERVER_OBJECT_ID);
+    serverObjP = object_find(contextP, LWM2M_SERVER_OBJECT_ID);
     if (!serverObjP)
     {
         return COAP_500_INTERNAL_SERVER_ERROR;
@@ -2045,6 +2045,25 @@ void lwm2m_set_monitoring_callback(lwm2m_context_t * contextP,
 
 // for each server update the registration if needed
 // for each client check if the registration expired
+#ifdef LWM2M_CLIENT_MODE
+time_t registration_getUpdateTime(lwm2m_server_t * serverP)
+{
+    time_t nextUpdate;
+
+    nextUpdate = serverP->lifetime;
+    if (COAP_MAX_TRANSMIT_WAIT < nextUpdate)
+    {
+        nextUpdate -= COAP_MAX_TRANSMIT_WAIT;
+    }
+    else
+    {
+        nextUpdate = nextUpdate >> 1;
+    }
+
+    return serverP->registration + nextUpdate;
+}
+#endif
+
 void registration_step(lwm2m_context_t * contextP,
                        time_t currentTime,
                        time_t * timeoutP)
@@ -2075,20 +2094,9 @@ void registration_step(lwm2m_context_t * contextP,
 #endif
         case STATE_REGISTERED:
         {
-            time_t nextUpdate;
             time_t interval;
 
-            nextUpdate = targetP->lifetime;
-            if (COAP_MAX_TRANSMIT_WAIT < nextUpdate)
-            {
-                nextUpdate -= COAP_MAX_TRANSMIT_WAIT;
-            }
-            else
-            {
-                nextUpdate = nextUpdate >> 1;
-            }
-
-            interval = targetP->registration + nextUpdate - currentTime;
+            interval = registration_getUpdateTime(targetP) - currentTime;
             if (0 >= interval)
             {
                 LOG_ARG("%d Updating registration", targetP->shortID);
@@ -121,6 +121,16 @@ lwm2m_request_type_t uri_decode(char * altPath,
         if (uriPath != NULL) goto error;
         return LWM2M_REQUEST_TYPE_BOOTSTRAP;
     }
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    else if (NULL != uriPath
+     && URI_SEND_SEGMENT_LEN == uriPath->len
+     && 0 == strncmp(URI_SEND_SEGMENT, (char *)uriPath->data, uriPath->len))
+    {
+        uriPath = uriPath->next;
+        if (uriPath != NULL) goto error;
+        return LWM2M_REQUEST_TYPE_SEND;
+    }
+#endif
 
     if (requestType != LWM2M_REQUEST_TYPE_REGISTRATION)
     {
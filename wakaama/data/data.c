@@ -20,9 +20,94 @@
 
 #include "internals.h"
 #include <float.h>
+#include <assert.h>
 
 #define _PRV_STR_LENGTH 32
 
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_DATA_ARENA)
+
+#ifndef LWM2M_THREAD_LOCAL
+#define LWM2M_THREAD_LOCAL
+#endif
+
+// Arena of the context handled by the calling thread, NULL outside of data_arenaBegin() / data_arenaEnd().
+// The public data functions take no context: this is the only link from them to the arena of the context.
+static LWM2M_THREAD_LOCAL lwm2m_data_arena_t * boundArenaP = NULL;
+
+static bool prv_inArena(lwm2m_data_arena_t * arenaP,
+                        const void * p)
+{
+    const uint8_t * startP;
+
+    startP = (const uint8_t *)arenaP->buffer;
+    return (const uint8_t *)p >= startP && (const uint8_t *)p < startP + sizeof(arenaP->buffer);
+}
+
+void data_arenaBegin(lwm2m_context_t * contextP)
+{
+    lwm2m_data_arena_t * arenaP = &contextP->dataArena;
+
+    if (arenaP->depth++ > 0) return;
+
+    // a context handled from the callback of another one keeps the arena of the latter
+    arenaP->previousP = boundArenaP;
+    boundArenaP = arenaP;
+}
+
+void data_arenaEnd(lwm2m_context_t * contextP)
+{
+    lwm2m_data_arena_t * arenaP = &contextP->dataArena;
+
+    if (arenaP->depth == 0 || --arenaP->depth > 0) return;
+
+    // every block must be released before the arena is left, data_free() would not recognize it afterwards
+    if (arenaP->live != 0)
+    {
+        LOG_ARG("%d blocks still in use", (int)arenaP->live);
+    }
+    assert(arenaP->live == 0);
+    boundArenaP = arenaP->previousP;
+    arenaP->previousP = NULL;
+}
+
+void * data_malloc(size_t size)
+{
+    lwm2m_data_arena_t * arenaP = boundArenaP;
+    size_t length;
+
+    // keep the blocks 8-byte aligned for the int64_t and double members of lwm2m_data_t
+    length = (size + 7) & ~(size_t)7;
+    if (arenaP == NULL
+     || length == 0
+     || length > sizeof(arenaP->buffer) - arenaP->used)
+    {
+        return lwm2m_malloc(size);
+    }
+
+    arenaP->used += length;
+    arenaP->live++;
+    return (uint8_t *)arenaP->buffer + arenaP->used - length;
+}
+
+void data_free(void * p)
+{
+    lwm2m_data_arena_t * arenaP;
+
+    // blocks of the arenas still bound, from the innermost one
+    for (arenaP = boundArenaP; arenaP != NULL; arenaP = arenaP->previousP)
+    {
+        if (prv_inArena(arenaP, p))
+        {
+            arenaP->live--;
+            if (arenaP->live == 0) arenaP->used = 0;
+            return;
+        }
+    }
+    lwm2m_free(p);
+}
+
+#endif
+
 // dataP array length is assumed to be 1.
 static int prv_textSerialize(lwm2m_data_t * dataP,
                              uint8_t ** bufferP)
@@ -33,7 +118,7 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
     {
     case LWM2M_TYPE_STRING:
     case LWM2M_TYPE_CORE_LINK:
-        *bufferP = (uint8_t *)lwm2m_malloc(dataP->value.asBuffer.length);
+        *bufferP = (uint8_t *)data_malloc(dataP->value.asBuffer.length);
         if (*bufferP == NULL) return 0;
         memcpy(*bufferP, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
         return (int)dataP->value.asBuffer.length;
@@ -45,7 +130,7 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
         res = utils_intToText(dataP->value.asInteger, intString, _PRV_STR_LENGTH);
         if (res == 0) return -1;
 
-        *bufferP = (uint8_t *)lwm2m_malloc(res);
+        *bufferP = (uint8_t *)data_malloc(res);
         if (NULL == *bufferP) return -1;
 
         memcpy(*bufferP, intString, res);
@@ -60,7 +145,7 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
         res = utils_uintToText(dataP->value.asUnsigned, intString, _PRV_STR_LENGTH);
         if (res == 0) return -1;
 
-        *bufferP = (uint8_t *)lwm2m_malloc(res);
+        *bufferP = (uint8_t *)data_malloc(res);
         if (NULL == *bufferP) return -1;
 
         memcpy(*bufferP, intString, res);
@@ -75,7 +160,7 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
         res = utils_floatToText(dataP->value.asFloat, floatString, _PRV_STR_LENGTH * 2, false);
         if (res == 0) return -1;
 
-        *bufferP = (uint8_t *)lwm2m_malloc(res);
+        *bufferP = (uint8_t *)data_malloc(res);
         if (NULL == *bufferP) return -1;
 
         memcpy(*bufferP, floatString, res);
@@ -84,7 +169,7 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
     }
 
     case LWM2M_TYPE_BOOLEAN:
-        *bufferP = (uint8_t *)lwm2m_malloc(1);
+        *bufferP = (uint8_t *)data_malloc(1);
         if (NULL == *bufferP) return -1;
 
         *bufferP[0] = dataP->value.asBoolean ? '1' : '0';
@@ -107,7 +192,7 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
 
         res += length;
 
-        *bufferP = (uint8_t *)lwm2m_malloc(res);
+        *bufferP = (uint8_t *)data_malloc(res);
         if (*bufferP == NULL) return -1;
 
         memcpy(*bufferP, stringBuffer, res);
@@ -120,12 +205,12 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
         size_t length;
 
         length = utils_base64GetSize(dataP->value.asBuffer.length);
-        *bufferP = (uint8_t *)lwm2m_malloc(length);
+        *bufferP = (uint8_t *)data_malloc(length);
         if (*bufferP == NULL) return 0;
         length = utils_base64Encode(dataP->value.asBuffer.buffer, dataP->value.asBuffer.length, *bufferP, length);
         if (length == 0)
         {
-            lwm2m_free(*bufferP);
+            data_free(*bufferP);
             *bufferP = NULL;
             return 0;
         }
@@ -142,7 +227,8 @@ static int prv_setBuffer(lwm2m_data_t * dataP,
                          const uint8_t * buffer,
                          size_t bufferLen)
 {
-    dataP->value.asBuffer.buffer = (uint8_t *)lwm2m_malloc(bufferLen);
+    dataP->flags &= ~LWM2M_DATA_FLAG_BORROWED;
+    dataP->value.asBuffer.buffer = (uint8_t *)data_malloc(bufferLen);
     if (dataP->value.asBuffer.buffer == NULL)
     {
         return 0;
@@ -160,7 +246,7 @@ lwm2m_data_t * lwm2m_data_new(int size)
     LOG_ARG("size: %d", size);
     if (size <= 0) return NULL;
 
-    dataP = (lwm2m_data_t *)lwm2m_malloc(size * sizeof(lwm2m_data_t));
+    dataP = (lwm2m_data_t *)data_malloc(size * sizeof(lwm2m_data_t));
 
     if (dataP != NULL)
     {
@@ -191,9 +277,10 @@ void lwm2m_data_free(int size,
         case LWM2M_TYPE_STRING:
         case LWM2M_TYPE_OPAQUE:
         case LWM2M_TYPE_CORE_LINK:
-            if (dataP[i].value.asBuffer.buffer != NULL)
+            if (dataP[i].value.asBuffer.buffer != NULL
+             && (dataP[i].flags & LWM2M_DATA_FLAG_BORROWED) == 0)
             {
-                lwm2m_free(dataP[i].value.asBuffer.buffer);
+                data_free(dataP[i].value.asBuffer.buffer);
             }
             break;
 
@@ -202,7 +289,7 @@ void lwm2m_data_free(int size,
             break;
         }
     }
-    lwm2m_free(dataP);
+    data_free(dataP);
 }
 
 void lwm2m_data_encode_string(const char * string,
@@ -223,6 +310,7 @@ void lwm2m_data_encode_string(const char * string,
 
     if (len == 0)
     {
+        dataP->flags &= ~LWM2M_DATA_FLAG_BORROWED;
         dataP->value.asBuffer.length = 0;
         dataP->value.asBuffer.buffer = NULL;
         res = 1;
@@ -251,6 +339,7 @@ void lwm2m_data_encode_opaque(const uint8_t * buffer,
     LOG_ARG("length: %d", length);
     if (length == 0)
     {
+        dataP->flags &= ~LWM2M_DATA_FLAG_BORROWED;
         dataP->value.asBuffer.length = 0;
         dataP->value.asBuffer.buffer = NULL;
         res = 1;
@@ -283,6 +372,26 @@ void lwm2m_data_encode_nstring(const char * string,
     }
 }
 
+void lwm2m_data_encode_borrowed_nstring(const char * string,
+                                        size_t length,
+                                        lwm2m_data_t * dataP)
+{
+    LOG_ARG("length: %d, string: \"%.*s\"", length, length, STR_NULL2EMPTY(string));
+    lwm2m_data_encode_borrowed_opaque((const uint8_t *)string, length, dataP);
+    dataP->type = LWM2M_TYPE_STRING;
+}
+
+void lwm2m_data_encode_borrowed_opaque(const uint8_t * buffer,
+                                       size_t length,
+                                       lwm2m_data_t * dataP)
+{
+    LOG_ARG("length: %d", length);
+    dataP->type = LWM2M_TYPE_OPAQUE;
+    dataP->flags |= LWM2M_DATA_FLAG_BORROWED;
+    dataP->value.asBuffer.length = length;
+    dataP->value.asBuffer.buffer = length == 0 ? NULL : (uint8_t *)buffer;
+}
+
 void lwm2m_data_encode_int(int64_t value,
                            lwm2m_data_t * dataP)
 {
@@ -642,7 +751,7 @@ void lwm2m_data_encode_instances(lwm2m_data_t * subDataP,
     dataP->type = LWM2M_TYPE_MULTIPLE_RESOURCE;
 }
 
-int lwm2m_data_parse(lwm2m_uri_t * uriP,
+static int prv_parse(lwm2m_uri_t * uriP,
                      const uint8_t * buffer,
                      size_t bufferLen,
                      lwm2m_media_type_t format,
@@ -716,7 +825,7 @@ int lwm2m_data_parse(lwm2m_uri_t * uriP,
     }
 }
 
-int lwm2m_data_serialize(lwm2m_uri_t * uriP,
+static int prv_serialize(lwm2m_uri_t * uriP,
                          int size,
                          lwm2m_data_t * dataP,
                          lwm2m_media_type_t * formatP,
@@ -762,7 +871,7 @@ int lwm2m_data_serialize(lwm2m_uri_t * uriP,
         return prv_textSerialize(dataP, bufferP);
 
     case LWM2M_CONTENT_OPAQUE:
-        *bufferP = (uint8_t *)lwm2m_malloc(dataP->value.asBuffer.length);
+        *bufferP = (uint8_t *)data_malloc(dataP->value.asBuffer.length);
         if (*bufferP == NULL) return -1;
         memcpy(*bufferP, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
         return (int)dataP->value.asBuffer.length;
@@ -818,3 +927,79 @@ int lwm2m_data_serialize(lwm2m_uri_t * uriP,
     }
 }
 
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_DATA_ARENA)
+int data_parse(lwm2m_uri_t * uriP,
+               const uint8_t * buffer,
+               size_t bufferLen,
+               lwm2m_media_type_t format,
+               lwm2m_data_t ** dataP)
+{
+    return prv_parse(uriP, buffer, bufferLen, format, dataP);
+}
+
+int data_serialize(lwm2m_uri_t * uriP,
+                   int size,
+                   lwm2m_data_t * dataP,
+                   lwm2m_media_type_t * formatP,
+                   uint8_t ** bufferP)
+{
+    return prv_serialize(uriP, size, dataP, formatP, bufferP);
+}
+#endif
+
+int lwm2m_data_parse(lwm2m_uri_t * uriP,
+                     const uint8_t * buffer,
+                     size_t bufferLen,
+                     lwm2m_media_type_t format,
+                     lwm2m_data_t ** dataP)
+{
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_DATA_ARENA)
+    lwm2m_data_arena_t * arenaP = boundArenaP;
+    int res;
+
+    // the application may keep the result beyond the current request
+    boundArenaP = NULL;
+    res = prv_parse(uriP, buffer, bufferLen, format, dataP);
+    boundArenaP = arenaP;
+    return res;
+#else
+    return prv_parse(uriP, buffer, bufferLen, format, dataP);
+#endif
+}
+
+int lwm2m_data_serialize(lwm2m_uri_t * uriP,
+                         int size,
+                         lwm2m_data_t * dataP,
+                         lwm2m_media_type_t * formatP,
+                         uint8_t ** bufferP)
+{
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_DATA_ARENA)
+    lwm2m_data_arena_t * arenaP = boundArenaP;
+    int res;
+
+    // the application releases the buffer with lwm2m_free()
+    boundArenaP = NULL;
+    res = prv_serialize(uriP, size, dataP, formatP, bufferP);
+    boundArenaP = arenaP;
+    return res;
+#else
+    return prv_serialize(uriP, size, dataP, formatP, bufferP);
+#endif
+}
+
+#ifdef LWM2M_SUPPORT_SENML_JSON
+int lwm2m_data_append_series(lwm2m_uri_t * uriP,
+                             time_t baseTime,
+                             time_t time,
+                             lwm2m_data_t * dataP,
+                             uint8_t * buffer,
+                             size_t length,
+                             size_t bufferLen)
+{
+    LOG_ARG("baseTime: %d, time: %d, length: %d", (int)baseTime, (int)time, (int)length);
+    if (buffer == NULL || dataP == NULL) return -1;
+    if (length == 0 && (uriP == NULL || !LWM2M_URI_IS_SET_RESOURCE(uriP))) return -1;
+
+    return senml_json_append_record(uriP, baseTime, time, dataP, buffer, length, bufferLen);
+}
+#endif
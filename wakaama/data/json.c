@@ -274,17 +274,17 @@ static bool prv_convertValue(_record_t * recordP,
         if (0 != recordP->valueLen)
         {
             size_t stringLen;
-            uint8_t *string = (uint8_t *)lwm2m_malloc(recordP->valueLen);
+            uint8_t *string = (uint8_t *)data_malloc(recordP->valueLen);
             if (string == NULL) return false;
             stringLen = json_unescapeString(string, recordP->value, recordP->valueLen);
             if (stringLen)
             {
                 lwm2m_data_encode_nstring((char *)string, stringLen, targetP);
-                lwm2m_free(string);
+                data_free(string);
             }
             else
             {
-                lwm2m_free(string);
+                data_free(string);
                 return false;
             }
         }
@@ -466,7 +466,7 @@ static int prv_convertRecord(lwm2m_uri_t * uriP,
             parentP->value.asChildren.array = newRootP;
             parentP->value.asChildren.count = freeIndex;
         }
-        lwm2m_free(rootP);     /* do not use lwm2m_data_free() to keep pointed values */
+        data_free(rootP);     /* do not use lwm2m_data_free() to keep pointed values */
     }
 
     return size;
@@ -527,7 +527,7 @@ int json_parse(lwm2m_uri_t * uriP,
             _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
             count = json_countItems(buffer + index, bufferLen - index);
             if (count <= 0) goto error;
-            recordArray = (_record_t*)lwm2m_malloc(count * sizeof(_record_t));
+            recordArray = (_record_t*)data_malloc(count * sizeof(_record_t));
             if (recordArray == NULL) goto error;
             // at this point we are sure buffer[index] is '{' and all { and } are matching
             recordIndex = 0;
@@ -662,7 +662,7 @@ int json_parse(lwm2m_uri_t * uriP,
         }
 
         count = prv_convertRecord(baseUriP, recordArray, count, &parsedP);
-        lwm2m_free(recordArray);
+        data_free(recordArray);
         recordArray = NULL;
 
         if (count > 0 && uriP != NULL)
@@ -745,7 +745,7 @@ error:
     }
     if (recordArray != NULL)
     {
-        lwm2m_free(recordArray);
+        data_free(recordArray);
     }
     return -1;
 }
@@ -1077,7 +1077,7 @@ int json_serialize(lwm2m_uri_t * uriP,
     memcpy(bufferJSON + head, JSON_FOOTER, JSON_FOOTER_SIZE);
     head = head + JSON_FOOTER_SIZE;
 
-    *bufferP = (uint8_t *)lwm2m_malloc(head);
+    *bufferP = (uint8_t *)data_malloc(head);
     if (*bufferP == NULL) return -1;
     memcpy(*bufferP, bufferJSON, head);
 
@@ -500,7 +500,7 @@ lwm2m_data_t * json_extendData(lwm2m_data_t * parentP)
         memcpy(newP,
                parentP->value.asChildren.array,
                parentP->value.asChildren.count * sizeof(lwm2m_data_t));
-        lwm2m_free(parentP->value.asChildren.array);     /* do not use lwm2m_data_free() to keep pointed values */
+        data_free(parentP->value.asChildren.array);     /* do not use lwm2m_data_free() to keep pointed values */
     }
     parentP->value.asChildren.array = newP;
     parentP->value.asChildren.count += 1;
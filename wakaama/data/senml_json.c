@@ -60,6 +60,8 @@
 #define JSON_BN_HEADER_SIZE               6
 #define JSON_BT_HEADER                    "\"bt\":"
 #define JSON_BT_HEADER_SIZE               5
+#define JSON_ITEM_TIME                    "\"t\":"
+#define JSON_ITEM_TIME_SIZE               4
 #define JSON_HEADER                       '['
 #define JSON_FOOTER                       ']'
 #define JSON_SEPARATOR                    ','
@@ -448,7 +450,7 @@ static bool prv_convertValue(const _record_t * recordP,
         if (0 != recordP->value.value.asBuffer.length)
         {
             size_t stringLen;
-            uint8_t *string = (uint8_t *)lwm2m_malloc(recordP->value.value.asBuffer.length);
+            uint8_t *string = (uint8_t *)data_malloc(recordP->value.value.asBuffer.length);
             if (!string) return false;
             stringLen = json_unescapeString(string,
                                             recordP->value.value.asBuffer.buffer,
@@ -456,11 +458,11 @@ static bool prv_convertValue(const _record_t * recordP,
             if (stringLen)
             {
                 lwm2m_data_encode_nstring((char *)string, stringLen, targetP);
-                lwm2m_free(string);
+                data_free(string);
             }
             else
             {
-                lwm2m_free(string);
+                data_free(string);
                 return false;
             }
         }
@@ -476,7 +478,7 @@ static bool prv_convertValue(const _record_t * recordP,
             uint8_t *data;
             dataLength = utils_base64GetDecodedSize((const char *)recordP->value.value.asBuffer.buffer,
                                                     recordP->value.value.asBuffer.length);
-            data = (uint8_t*) lwm2m_malloc(dataLength);
+            data = (uint8_t*) data_malloc(dataLength);
             if (!data) return false;
             dataLength = utils_base64Decode((const char *)recordP->value.value.asBuffer.buffer,
                                    recordP->value.value.asBuffer.length,
@@ -485,11 +487,11 @@ static bool prv_convertValue(const _record_t * recordP,
             if (dataLength)
             {
                 lwm2m_data_encode_opaque(data, dataLength, targetP);
-                lwm2m_free(data);
+                data_free(data);
             }
             else
             {
-                lwm2m_free(data);
+                data_free(data);
                 return false;
             }
         }
@@ -583,7 +585,7 @@ static int prv_convertRecord(const _record_t * recordArray,
         *dataP = lwm2m_data_new(freeIndex);
         if (*dataP == NULL) goto error;
         memcpy(*dataP, rootP, freeIndex * sizeof(lwm2m_data_t));
-        lwm2m_free(rootP);     /* do not use lwm2m_data_free() to keep pointed values */
+        data_free(rootP);     /* do not use lwm2m_data_free() to keep pointed values */
     }
     else
     {
@@ -627,7 +629,7 @@ int senml_json_parse(const lwm2m_uri_t * uriP,
     _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
     count = json_countItems(buffer + index, bufferLen - index);
     if (count <= 0) goto error;
-    recordArray = (_record_t*)lwm2m_malloc(count * sizeof(_record_t));
+    recordArray = (_record_t*)data_malloc(count * sizeof(_record_t));
     if (recordArray == NULL) goto error;
     /* at this point we are sure buffer[index] is '{' and all { and } are matching */
     recordIndex = 0;
@@ -669,7 +671,7 @@ int senml_json_parse(const lwm2m_uri_t * uriP,
     int size;
 
     count = prv_convertRecord(recordArray, count, &parsedP);
-    lwm2m_free(recordArray);
+    data_free(recordArray);
     recordArray = NULL;
 
     if (count > 0 && uriP != NULL && LWM2M_URI_IS_SET_OBJECT(uriP))
@@ -784,7 +786,7 @@ error:
     }
     if (recordArray != NULL)
     {
-        lwm2m_free(recordArray);
+        data_free(recordArray);
     }
     return -1;
 }
@@ -1146,6 +1148,132 @@ int senml_json_serialize(const lwm2m_uri_t * uriP,
     if (head + 1 > PRV_JSON_BUFFER_SIZE) return 0;
     bufferJSON[head++] = JSON_FOOTER;
 
+    *bufferP = (uint8_t *)data_malloc(head);
+    if (*bufferP == NULL) return -1;
+    memcpy(*bufferP, bufferJSON, head);
+
+    return head;
+}
+
+int senml_json_parse_uris(const uint8_t * buffer,
+                          size_t bufferLen,
+                          lwm2m_uri_t ** urisP)
+{
+    size_t index;
+    int count = 0;
+    int recordIndex;
+    lwm2m_uri_t * uriArray;
+    _record_t record;
+    char baseUri[URI_MAX_STRING_LEN + 1];
+    time_t baseTime;
+    lwm2m_data_t baseValue;
+
+    LOG_ARG("bufferLen: %d, buffer: \"%.*s\"", bufferLen, bufferLen, STR_NULL2EMPTY((char *)buffer));
+    *urisP = NULL;
+    uriArray = NULL;
+
+    index = json_skipSpace(buffer, bufferLen);
+    if (index == bufferLen) return -1;
+
+    if (buffer[index] != JSON_HEADER) return -1;
+
+    _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
+    count = json_countItems(buffer + index, bufferLen - index);
+    if (count <= 0) goto error;
+    uriArray = (lwm2m_uri_t *)lwm2m_malloc(count * sizeof(lwm2m_uri_t));
+    if (uriArray == NULL) goto error;
+    recordIndex = 0;
+    baseUri[0] = '\0';
+    baseTime = 0;
+    memset(&baseValue, 0, sizeof(baseValue));
+    while (recordIndex < count)
+    {
+        int itemLen = json_itemLength(buffer + index, bufferLen - index);
+        if (itemLen < 0) goto error;
+        if (prv_parseItem(buffer + index + 1,
+                          itemLen - 2,
+                          &record,
+                          baseUri,
+                          &baseTime,
+                          &baseValue))
+        {
+            goto error;
+        }
+        /* values, if any, are ignored: only the names matter here */
+        if (record.ids[0] == LWM2M_MAX_ID) goto error;
+        LWM2M_URI_RESET(uriArray + recordIndex);
+        uriArray[recordIndex].objectId = record.ids[0];
+        uriArray[recordIndex].instanceId = record.ids[1];
+        uriArray[recordIndex].resourceId = record.ids[2];
+        uriArray[recordIndex].resourceInstanceId = record.ids[3];
+        recordIndex++;
+        index += itemLen - 1;
+        _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
+        switch (buffer[index])
+        {
+        case JSON_SEPARATOR:
+            _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
+            break;
+        case JSON_FOOTER:
+            if (recordIndex != count) goto error;
+            break;
+        default:
+            goto error;
+        }
+    }
+
+    if (buffer[index] != JSON_FOOTER) goto error;
+
+    *urisP = uriArray;
+    LOG_ARG("Parsing successful. count: %d", count);
+    return count;
+
+error:
+    LOG("Parsing failed");
+    if (uriArray != NULL)
+    {
+        lwm2m_free(uriArray);
+    }
+    return -1;
+}
+
+int senml_json_serialize_uris(const lwm2m_uri_t * uriList,
+                              size_t count,
+                              uint8_t ** bufferP)
+{
+    size_t index;
+    size_t head;
+    uint8_t bufferJSON[PRV_JSON_BUFFER_SIZE];
+
+    LOG_ARG("count: %d", count);
+    if (count == 0 || uriList == NULL) return -1;
+
+    head = 0;
+    bufferJSON[head++] = JSON_HEADER;
+    for (index = 0 ; index < count ; index++)
+    {
+        int res;
+
+        if (!LWM2M_URI_IS_SET_OBJECT(uriList + index)) return -1;
+        if (index != 0)
+        {
+            if (head + 1 > PRV_JSON_BUFFER_SIZE) return 0;
+            bufferJSON[head++] = JSON_SEPARATOR;
+        }
+        if (PRV_JSON_BUFFER_SIZE - head < 1 + JSON_ITEM_URI_SIZE + URI_MAX_STRING_LEN + 2) return 0;
+        bufferJSON[head++] = JSON_ITEM_BEGIN;
+        memcpy(bufferJSON + head, JSON_ITEM_URI, JSON_ITEM_URI_SIZE);
+        head += JSON_ITEM_URI_SIZE;
+        res = uri_toString(uriList + index, bufferJSON + head, URI_MAX_STRING_LEN, NULL);
+        if (res <= 0) return -1;
+        head += res;
+        bufferJSON[head++] = JSON_ITEM_URI_END;
+        bufferJSON[head++] = JSON_ITEM_END;
+    }
+
+    if (head + 1 > PRV_JSON_BUFFER_SIZE) return 0;
+    bufferJSON[head++] = JSON_FOOTER;
+
     *bufferP = (uint8_t *)lwm2m_malloc(head);
     if (*bufferP == NULL) return -1;
     memcpy(*bufferP, bufferJSON, head);
@@ -1153,5 +1281,117 @@ int senml_json_serialize(const lwm2m_uri_t * uriP,
     return head;
 }
 
-#endif
+int senml_json_append(uint8_t ** packP,
+                      size_t * packLenP,
+                      const uint8_t * buffer,
+                      size_t bufferLen)
+{
+    uint8_t * newP;
+    size_t newLen;
+
+    /* Each pack carries its own base name, so both can be merged by dropping the inner brackets. */
+    if (bufferLen <= 2) return (int)*packLenP;
+    if (*packP == NULL || *packLenP <= 2)
+    {
+        newP = (uint8_t *)data_malloc(bufferLen);
+        if (newP == NULL) return -1;
+        memcpy(newP, buffer, bufferLen);
+        newLen = bufferLen;
+    }
+    else
+    {
+        newLen = *packLenP + bufferLen - 1;
+        newP = (uint8_t *)data_malloc(newLen);
+        if (newP == NULL) return -1;
+        memcpy(newP, *packP, *packLenP - 1);
+        newP[*packLenP - 1] = JSON_SEPARATOR;
+        memcpy(newP + *packLenP, buffer + 1, bufferLen - 1);
+    }
+    if (*packP != NULL) data_free(*packP);
+    *packP = newP;
+    *packLenP = newLen;
+
+    return (int)newLen;
+}
+
+int senml_json_append_record(const lwm2m_uri_t * uriP,
+                             time_t baseTime,
+                             time_t time,
+                             const lwm2m_data_t * dataP,
+                             uint8_t * buffer,
+                             size_t length,
+                             size_t bufferLen)
+{
+    size_t head;
+    size_t res;
+    int valueLen;
+
+    if (length == 0)
+    {
+        uint8_t uriStr[URI_MAX_STRING_LEN];
+        int uriLen;
+
+        /* The first record opens the pack and carries the base name and the base time. */
+        uriLen = uri_toString(uriP, uriStr, URI_MAX_STRING_LEN, NULL);
+        if (uriLen <= 0) return -1;
+        if (bufferLen < 2 + JSON_BN_HEADER_SIZE + (size_t)uriLen + 2 + JSON_BT_HEADER_SIZE) return -1;
+
+        head = 0;
+        buffer[head++] = JSON_HEADER;
+        buffer[head++] = JSON_ITEM_BEGIN;
+        memcpy(buffer + head, JSON_BN_HEADER, JSON_BN_HEADER_SIZE);
+        head += JSON_BN_HEADER_SIZE;
+        memcpy(buffer + head, uriStr, uriLen);
+        head += uriLen;
+        buffer[head++] = JSON_ITEM_STRING_END;
+        buffer[head++] = JSON_SEPARATOR;
+        memcpy(buffer + head, JSON_BT_HEADER, JSON_BT_HEADER_SIZE);
+        head += JSON_BT_HEADER_SIZE;
 
+        res = utils_intToText(baseTime, buffer + head, bufferLen - head);
+        if (!res) return -1;
+        head += res;
+
+        if (bufferLen - head < 1) return -1;
+        buffer[head++] = JSON_SEPARATOR;
+    }
+    else
+    {
+        /* The next ones replace the closing bracket, which is restored if the record does not fit. */
+        if (length < 2 || length > bufferLen || buffer[length - 1] != JSON_FOOTER) return -1;
+        head = length - 1;
+        if (bufferLen - head < 2) return -1;
+        buffer[head++] = JSON_SEPARATOR;
+        buffer[head++] = JSON_ITEM_BEGIN;
+    }
+
+    if (time != baseTime)
+    {
+        if (bufferLen - head < JSON_ITEM_TIME_SIZE) goto error;
+        memcpy(buffer + head, JSON_ITEM_TIME, JSON_ITEM_TIME_SIZE);
+        head += JSON_ITEM_TIME_SIZE;
+
+        res = utils_intToText(time - baseTime, buffer + head, bufferLen - head);
+        if (!res) goto error;
+        head += res;
+
+        if (bufferLen - head < 1) goto error;
+        buffer[head++] = JSON_SEPARATOR;
+    }
+
+    valueLen = prv_serializeValue(dataP, buffer + head, bufferLen - head);
+    if (valueLen < 0) goto error;
+    head += valueLen;
+
+    if (bufferLen - head < 2) goto error;
+    buffer[head++] = JSON_ITEM_END;
+    buffer[head++] = JSON_FOOTER;
+
+    return (int)head;
+
+error:
+    if (length != 0) buffer[length - 1] = JSON_FOOTER;
+    return -1;
+}
+
+#endif
@@ -373,7 +373,7 @@ int tlv_parse(const uint8_t * buffer,
             else
             {
                 memcpy(newTlvP, *dataP, size * sizeof(lwm2m_data_t));
-                lwm2m_free(*dataP);
+                data_free(*dataP);
             }
         }
         *dataP = newTlvP;
@@ -513,7 +513,7 @@ int tlv_serialize(bool isResourceInstance,
     length = prv_getLength(size, dataP);
     if (length <= 0) return length;
 
-    *bufferP = (uint8_t *)lwm2m_malloc(length);
+    *bufferP = (uint8_t *)data_malloc(length);
     if (*bufferP == NULL) return 0;
 
     index = 0;
@@ -550,7 +550,7 @@ int tlv_serialize(bool isResourceInstance,
                     {
                         memcpy(*bufferP + index, tmpBuffer, tmpLength);
                         index += tmpLength;
-                        lwm2m_free(tmpBuffer);
+                        data_free(tmpBuffer);
                     }
                 }
             }
@@ -640,7 +640,7 @@ int tlv_serialize(bool isResourceInstance,
 
     if (length < 0)
     {
-        lwm2m_free(*bufferP);
+        data_free(*bufferP);
         *bufferP = NULL;
     }
 
@@ -0,0 +1,260 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Eclipse Foundation and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v2.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v20.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Saturation benchmark of the batched transport.
+ *
+ * A LWM2M Server context is driven through examples/shared/mmsg_transport.c on
+ * the loopback interface, while a load generator thread keeps a window of
+ * confirmable requests in flight from several sockets. Each request is answered
+ * by the core with a piggybacked error response, so the cost measured is the
+ * one of the transport and of the CoAP layer. The run is repeated for each
+ * batch size from 1, one system call per datagram, to LWM2M_MMSG_BATCH_SIZE.
+ *
+ * Usage: mmsg_benchmark [seconds per batch size] [requests in flight]
+ */
+
+#include "mmsg_transport.h"
+
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_SOCKETS 8
+#define BENCH_DEFAULT_DURATION 2
+#define BENCH_DEFAULT_WINDOW 256
+#define BENCH_GENERATOR_BATCH 64
+#define BENCH_REQUEST_SIZE 16
+
+typedef struct {
+    struct sockaddr_in serverAddr;
+    int sock[BENCH_SOCKETS];
+    unsigned int window;
+    volatile bool running;
+    volatile unsigned long answered;
+    uint16_t mid;
+} bench_generator_t;
+
+static double prv_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// CON GET /bench: no such path on a server, answered with 4.00 or 4.04
+static size_t prv_build_request(uint8_t *buffer, uint16_t mid) {
+    static const uint8_t path[] = {0xB5, 'b', 'e', 'n', 'c', 'h'};
+
+    buffer[0] = 0x40;
+    buffer[1] = 0x01;
+    buffer[2] = (uint8_t)(mid >> 8);
+    buffer[3] = (uint8_t)mid;
+    memcpy(buffer + 4, path, sizeof(path));
+
+    return 4 + sizeof(path);
+}
+
+static void prv_send_requests(bench_generator_t *generatorP, int sock, unsigned int count) {
+    struct mmsghdr msg[BENCH_GENERATOR_BATCH];
+    struct iovec iov[BENCH_GENERATOR_BATCH];
+    uint8_t buffer[BENCH_GENERATOR_BATCH][BENCH_REQUEST_SIZE];
+
+    while (count > 0) {
+        unsigned int batch = count < BENCH_GENERATOR_BATCH ? count : BENCH_GENERATOR_BATCH;
+        unsigned int i;
+
+        for (i = 0; i < batch; i++) {
+            iov[i].iov_base = buffer[i];
+            iov[i].iov_len = prv_build_request(buffer[i], generatorP->mid++);
+            memset(&msg[i], 0, sizeof(struct mmsghdr));
+            msg[i].msg_hdr.msg_name = &generatorP->serverAddr;
+            msg[i].msg_hdr.msg_namelen = sizeof(generatorP->serverAddr);
+            msg[i].msg_hdr.msg_iov = &iov[i];
+            msg[i].msg_hdr.msg_iovlen = 1;
+        }
+        if (sendmmsg(sock, msg, batch, 0) < 0) {
+            return;
+        }
+        count -= batch;
+    }
+}
+
+// each response received is replaced by a new request from the same socket
+static void *prv_generator_thread(void *arg) {
+    bench_generator_t *generatorP = (bench_generator_t *)arg;
+    struct mmsghdr msg[BENCH_GENERATOR_BATCH];
+    struct iovec iov[BENCH_GENERATOR_BATCH];
+    uint8_t buffer[BENCH_GENERATOR_BATCH][64];
+    int i;
+
+    for (i = 0; i < BENCH_SOCKETS; i++) {
+        prv_send_requests(generatorP, generatorP->sock[i], generatorP->window / BENCH_SOCKETS);
+    }
+
+    while (generatorP->running) {
+        for (i = 0; i < BENCH_SOCKETS; i++) {
+            int count;
+            int j;
+
+            for (j = 0; j < BENCH_GENERATOR_BATCH; j++) {
+                iov[j].iov_base = buffer[j];
+                iov[j].iov_len = sizeof(buffer[j]);
+                memset(&msg[j], 0, sizeof(struct mmsghdr));
+                msg[j].msg_hdr.msg_iov = &iov[j];
+                msg[j].msg_hdr.msg_iovlen = 1;
+            }
+            count = recvmmsg(generatorP->sock[i], msg, BENCH_GENERATOR_BATCH, MSG_DONTWAIT, NULL);
+            if (count <= 0) {
+                continue;
+            }
+            generatorP->answered += count;
+            prv_send_requests(generatorP, generatorP->sock[i], count);
+        }
+    }
+
+    return NULL;
+}
+
+static int prv_open_generator(bench_generator_t *generatorP, uint16_t serverPort) {
+    int i;
+
+    memset(&generatorP->serverAddr, 0, sizeof(generatorP->serverAddr));
+    generatorP->serverAddr.sin_family = AF_INET;
+    generatorP->serverAddr.sin_port = htons(serverPort);
+    generatorP->serverAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    for (i = 0; i < BENCH_SOCKETS; i++) {
+        generatorP->sock[i] = socket(AF_INET, SOCK_DGRAM, 0);
+        if (generatorP->sock[i] < 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void prv_close_generator(bench_generator_t *generatorP) {
+    int i;
+
+    for (i = 0; i < BENCH_SOCKETS; i++) {
+        close(generatorP->sock[i]);
+    }
+}
+
+// drain what a previous run left in flight, so that each run starts with a full window
+static void prv_drain(mmsg_transport_t *transportP, bench_generator_t *generatorP) {
+    uint8_t buffer[64];
+    int i;
+
+    while (mmsg_transport_receive(transportP, 50) > 0)
+        ;
+    for (i = 0; i < BENCH_SOCKETS; i++) {
+        while (recv(generatorP->sock[i], buffer, sizeof(buffer), MSG_DONTWAIT) > 0)
+            ;
+    }
+}
+
+static double prv_run(lwm2m_context_t *contextP, mmsg_transport_t *transportP, bench_generator_t *generatorP,
+                      double duration) {
+    pthread_t thread;
+    unsigned long answered;
+    double start;
+    double elapsed = 0;
+
+    generatorP->answered = 0;
+    generatorP->running = true;
+    if (pthread_create(&thread, NULL, prv_generator_thread, generatorP) != 0) {
+        return -1;
+    }
+
+    start = prv_now();
+    do {
+        time_t timeout = 1;
+
+        if (mmsg_transport_receive(transportP, 10) < 0) {
+            break;
+        }
+        lwm2m_step(contextP, &timeout);
+        mmsg_transport_flush(transportP);
+        elapsed = prv_now() - start;
+    } while (elapsed < duration);
+    answered = generatorP->answered;
+
+    generatorP->running = false;
+    pthread_join(thread, NULL);
+    prv_drain(transportP, generatorP);
+
+    return elapsed > 0 ? answered / elapsed : 0;
+}
+
+int main(int argc, char *argv[]) {
+    lwm2m_context_t *contextP;
+    mmsg_transport_t *transportP;
+    bench_generator_t generator;
+    struct sockaddr_in addr;
+    socklen_t addrLen;
+    double duration;
+    unsigned int batchSize;
+
+    duration = argc > 1 ? atof(argv[1]) : BENCH_DEFAULT_DURATION;
+    memset(&generator, 0, sizeof(generator));
+    generator.window = argc > 2 ? (unsigned int)atoi(argv[2]) : BENCH_DEFAULT_WINDOW;
+    if (duration <= 0 || generator.window < BENCH_SOCKETS) {
+        fprintf(stderr, "Usage: %s [seconds per batch size] [requests in flight, at least %d]\r\n", argv[0],
+                BENCH_SOCKETS);
+        return -1;
+    }
+
+    contextP = lwm2m_init(NULL);
+    if (contextP == NULL) {
+        return -1;
+    }
+    // port 0: the system picks a free one
+    transportP = mmsg_transport_open(contextP, "0", AF_INET);
+    if (transportP == NULL) {
+        fprintf(stderr, "Failed to open the transport\r\n");
+        lwm2m_close(contextP);
+        return -1;
+    }
+    addrLen = sizeof(addr);
+    if (getsockname(transportP->sock, (struct sockaddr *)&addr, &addrLen) != 0 ||
+        prv_open_generator(&generator, ntohs(addr.sin_port)) != 0) {
+        fprintf(stderr, "Failed to open the load generator\r\n");
+        mmsg_transport_close(transportP);
+        lwm2m_close(contextP);
+        return -1;
+    }
+
+    fprintf(stdout, "%u requests in flight from %d sockets, %.1f s per batch size\r\n", generator.window,
+            BENCH_SOCKETS, duration);
+    fprintf(stdout, "batch size  requests/s\r\n");
+    for (batchSize = 1; batchSize <= LWM2M_MMSG_BATCH_SIZE; batchSize *= 2) {
+        mmsg_transport_set_batch_size(transportP, batchSize);
+        fprintf(stdout, "%10u  %10.0f\r\n", batchSize, prv_run(contextP, transportP, &generator, duration));
+    }
+
+    prv_close_generator(&generator);
+    mmsg_transport_close(transportP);
+    lwm2m_close(contextP);
+
+    return 0;
+}
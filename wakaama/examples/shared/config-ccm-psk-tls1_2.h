@@ -45,6 +45,7 @@
 #define MBEDTLS_CIPHER_C
 #define MBEDTLS_CTR_DRBG_C
 #define MBEDTLS_ENTROPY_C
+#define MBEDTLS_HKDF_C // OSCORE key derivation
 #define MBEDTLS_MD_C
 //#define MBEDTLS_NET_C
 /* The library does not currently support enabling SHA-224 without SHA-256.
@@ -61,6 +62,11 @@
 #define MBEDTLS_SSL_DTLS_ANTI_REPLAY
 #define MBEDTLS_SSL_DTLS_BADMAC_LIMIT
 
+/* Resume sessions after a sleep instead of running a full handshake */
+#define MBEDTLS_SSL_SESSION_TICKETS
+/* Keep the association when the NAT binding of the Client changes */
+#define MBEDTLS_SSL_DTLS_CONNECTION_ID
+
 //#define MBEDTLS_TIMING_C
 // For Mbed OS
 #define MBEDTLS_TIMING_ALT
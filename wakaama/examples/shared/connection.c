@@ -18,6 +18,9 @@
 
 #include "connection.h"
 #include "commandline.h"
+#ifdef USE_DTLS
+#include "dtlsconnection.h"
+#endif
 #include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
@@ -27,46 +30,54 @@
 #include "mbed_trace.h"
 #include "net_interface.h"
 
-static int cur_sock;
-static uint8_t pending_rx_buffer[2048];
-static ns_address_t pending_rx_addr;
+#define CONNECTION_RX_BUFFER_SIZE 2048
+#ifndef CONNECTION_MAX_SOCKETS
+// socket ids of Nanostack are below its SOCKETS_MAX
+#define CONNECTION_MAX_SOCKETS 16
+#endif
+#ifndef CONNECTION_IOV_MAX
+// buffers of a datagram sent with connection_sendv(), the core sends the header and the payload
+#define CONNECTION_IOV_MAX 4
+#endif
 
 /** This stack does not do anything with the incoming packets.
  * These must be used by the application, which should call
  * connectionlayer_find_connection, connection_new_incoming and
  * connectionlayer_handle_packet
 */
-extern void lwm2m_handle_incoming_socket_data(ns_address_t *addr, uint8_t *buf, size_t len);
+extern void lwm2m_handle_incoming_socket_data(int sock, ns_address_t *addr, uint8_t *buf, size_t len);
+
+// Receive buffer of each socket opened by create_socket(): not shared, each socket may belong to a different context
+static uint8_t *rx_buffers[CONNECTION_MAX_SOCKETS];
 
 void socket_recv_callback(void *socket_cb) {
-    //printf("%s\n", __func__);
     socket_callback_t *socket_callback = (socket_callback_t *)socket_cb;
+    ns_address_t addr;
+    uint8_t *buffer;
+    int length;
+
+    if (socket_callback->socket_id < 0 || socket_callback->socket_id >= CONNECTION_MAX_SOCKETS ||
+        rx_buffers[socket_callback->socket_id] == NULL) {
+        return;
+    }
+    buffer = rx_buffers[socket_callback->socket_id];
 
-	memset(pending_rx_buffer, 0, sizeof(pending_rx_buffer));
-	bool something_in_socket = true;
-	int length = 0;
-	while (something_in_socket)
-	{
-		//int rc = recv(n->my_socket, &buffer[bytes], (size_t)(len - bytes), 0);
-		//length = socket_recv(mqttc_ptr->ipstack->my_socket, &receive_buffer, sizeof(receive_buffer) - 1, 0);
-        length = socket_recvfrom(socket_callback->socket_id, pending_rx_buffer, 2048, 0, &pending_rx_addr);
-		//INFO("Mbed data read size : %d", rc);
-		if (length > 0) {
+    while (true) {
+        length = socket_recvfrom(socket_callback->socket_id, buffer, CONNECTION_RX_BUFFER_SIZE, 0, &addr);
+        if (length > 0) {
             char a[40];
-            ip6tos(pending_rx_addr.address, a);
-            printf("[%s] : Length %d , Received: %x \n", a, length, pending_rx_buffer[0]);
-            lwm2m_handle_incoming_socket_data(&pending_rx_addr, pending_rx_buffer, length);
-        }
-        else if (length!=NS_EWOULDBLOCK) {
-            printf("Error happened when receiving %d\n", length);
-            something_in_socket = false;
+            ip6tos(addr.address, a);
+            printf("[%s] : Length %d , Received: %x \n", a, length, buffer[0]);
+            lwm2m_handle_incoming_socket_data(socket_callback->socket_id, &addr, buffer, length);
         }
         else {
-            // there was nothing to read.
-            //printf("there was nothing to read\n");
-            something_in_socket = false;
+            if (length != NS_EWOULDBLOCK) {
+                printf("Error happened when receiving %d\n", length);
+            }
+            // otherwise there was nothing left to read
+            break;
         }
-	}
+    }
 }
 
 int create_socket(int port_number, int ai_family)
@@ -77,7 +88,18 @@ int create_socket(int port_number, int ai_family)
         printf("Could not open socket\n");
         return -1;
     }
-    cur_sock = sock;
+    if (sock >= CONNECTION_MAX_SOCKETS) {
+        printf("Socket %d above CONNECTION_MAX_SOCKETS\n", sock);
+        socket_close(sock);
+        return -1;
+    }
+    // allocated once, the datagrams are read into it from the socket callback
+    rx_buffers[sock] = (uint8_t *)lwm2m_malloc(CONNECTION_RX_BUFFER_SIZE);
+    if (rx_buffers[sock] == NULL) {
+        printf("Out of memory for the receive buffer of socket %d\n", sock);
+        socket_close(sock);
+        return -1;
+    }
     // Normally socket_open already binds
     //ns_address_t binding;
     //memcpy(binding.address, ns_in6addr_any, 16);
@@ -91,6 +113,16 @@ int create_socket(int port_number, int ai_family)
     return sock;
 }
 
+void close_socket(int sock)
+{
+    if (sock < 0 || sock >= CONNECTION_MAX_SOCKETS) {
+        return;
+    }
+    socket_close(sock);
+    lwm2m_free(rx_buffers[sock]);
+    rx_buffers[sock] = NULL;
+}
+
 static int connection_send(uint8_t const *buffer, size_t length, void *userData) {
     //int nbSent;
     size_t offset;
@@ -113,19 +145,46 @@ static int connection_send(uint8_t const *buffer, size_t length, void *userData)
     return 0;
 }
 
+#ifdef LWM2M_VECTORED_SEND
+static int connection_sendv(lwm2m_iovec_t const *iov, size_t iovCount, void *userData) {
+    connection_t *connP = (connection_t *)userData;
+    ns_iovec_t nsIov[CONNECTION_IOV_MAX];
+    ns_msghdr_t msg;
+    size_t i;
+
+    if (iovCount > CONNECTION_IOV_MAX) {
+        return -1;
+    }
+    for (i = 0; i < iovCount; i++) {
+        nsIov[i].iov_base = iov[i].base;
+        nsIov[i].iov_len = iov[i].length;
+    }
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &connP->addr;
+    msg.msg_namelen = sizeof(ns_address_t);
+    msg.msg_iov = nsIov;
+    msg.msg_iovlen = iovCount;
+
+    if (socket_sendmsg(connP->sock, &msg, 0) < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+#endif
+
 static int connection_recv(lwm2m_context_t *ctx, uint8_t *buffer, size_t length, void *userData) {
     lwm2m_handle_packet(ctx, buffer, length, userData);
     return 0;
 }
 
-static connection_t *connection_find(connection_t *connList, ns_address_t *addr) {
+static connection_t *connection_find(connection_t *connList, ns_address_t const *addr) {
     connection_t *connP;
 
     connP = connList;
     while (connP != NULL) {
         if (memcmp(connP->addr.address, addr->address, 16) == 0)
         {
-            printf("Found\n");
             return connP;
         }
         connP = connP->next;
@@ -138,6 +197,9 @@ static void connection_free(connection_t *conn) {
     if (conn->deinitFunc) {
         conn->deinitFunc(conn);
     }
+#ifdef LWM2M_VECTORED_SEND
+    lwm2m_free(conn->flatBuffer);
+#endif
     lwm2m_free(conn);
 }
 
@@ -159,6 +221,13 @@ lwm2m_connection_layer_t *connectionlayer_create(lwm2m_context_t *context) {
     }
     layerCtx->ctx = context;
     layerCtx->connList = NULL;
+#ifdef LWM2M_SUPPORT_OSCORE
+    layerCtx->ssnStorage = NULL;
+#endif
+#ifdef USE_DTLS
+    layerCtx->dtlsState = NULL;
+    layerCtx->sessionStorage = NULL;
+#endif
     return layerCtx;
 }
 
@@ -180,6 +249,9 @@ void connectionlayer_free(lwm2m_connection_layer_t *connLayerP) {
         return;
     }
     connectionlayer_free_connlist(connLayerP->connList);
+#ifdef USE_DTLS
+    dtlsconnection_layer_free(connLayerP);
+#endif
     lwm2m_free(connLayerP);
 }
 
@@ -209,7 +281,14 @@ static void connection_new_incoming_internal(connection_t *conn, int sock, ns_ad
     memcpy(conn->addr.address, addr->address, 16);
     conn->addr.identifier = addr->identifier;
     conn->sendFunc = connection_send;
+#ifdef LWM2M_VECTORED_SEND
+    conn->sendvFunc = connection_sendv;
+    conn->flatBuffer = NULL;
+    conn->flatSize = 0;
+#endif
     conn->recvFunc = connection_recv;
+    // set by the secure connections once created in place
+    conn->deinitFunc = NULL;
 }
 
 connection_t *connection_new_incoming(lwm2m_connection_layer_t *connLayerP, int sock, ns_address_t *addr) {
@@ -280,6 +359,50 @@ uint8_t lwm2m_buffer_send(void *sessionH, uint8_t *buffer, size_t length, void *
     return COAP_NO_ERROR;
 }
 
+#ifdef LWM2M_VECTORED_SEND
+uint8_t lwm2m_buffer_sendv(void *sessionH, lwm2m_iovec_t *iov, size_t iovCount, void *userdata) {
+    connection_t *connP = (connection_t *)sessionH;
+    size_t length;
+    size_t i;
+
+    if (connP == NULL) {
+        fprintf(stderr, "#> failed sending datagram, missing connection\r\n");
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    if (connP->sendvFunc != NULL) {
+        if (-1 == connP->sendvFunc(iov, iovCount, connP)) {
+            fprintf(stderr, "#> failed sending datagram\r\n");
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        }
+        return COAP_NO_ERROR;
+    }
+
+    // DTLS and OSCORE encrypt from a contiguous buffer: copied into the one of the connection, grown to the largest
+    // datagram sent so far
+    length = 0;
+    for (i = 0; i < iovCount; i++) {
+        length += iov[i].length;
+    }
+    if (length > connP->flatSize) {
+        uint8_t *buffer = (uint8_t *)lwm2m_malloc(length);
+        if (buffer == NULL) {
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        }
+        lwm2m_free(connP->flatBuffer);
+        connP->flatBuffer = buffer;
+        connP->flatSize = length;
+    }
+    length = 0;
+    for (i = 0; i < iovCount; i++) {
+        memcpy(connP->flatBuffer + length, iov[i].base, iov[i].length);
+        length += iov[i].length;
+    }
+
+    return lwm2m_buffer_send(sessionH, connP->flatBuffer, length, userdata);
+}
+#endif
+
 bool lwm2m_session_is_equal(void *session1, void *session2, void *userData) {
     (void)userData; /* unused */
 
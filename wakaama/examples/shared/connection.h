@@ -33,12 +33,20 @@
 typedef int (*connection_send_func_t)(uint8_t const *, size_t, void *);
 typedef int (*connection_recv_func_t)(lwm2m_context_t *, uint8_t *, size_t, void *);
 typedef void (*connection_deinit_func_t)(void *);
+#ifdef LWM2M_VECTORED_SEND
+typedef int (*connection_sendv_func_t)(lwm2m_iovec_t const *, size_t, void *);
+#endif
 
 typedef struct _connection_t {
     struct _connection_t *next;
     int sock;
     ns_address_t addr;
     connection_send_func_t sendFunc;
+#ifdef LWM2M_VECTORED_SEND
+    connection_sendv_func_t sendvFunc; // NULL when the datagram must be contiguous
+    uint8_t *flatBuffer; // datagrams of lwm2m_buffer_sendv() made contiguous when sendvFunc is NULL, kept for the next ones
+    size_t flatSize;
+#endif
     connection_recv_func_t recvFunc;
     connection_deinit_func_t deinitFunc;
 } connection_t;
@@ -46,6 +54,13 @@ typedef struct _connection_t {
 typedef struct _lwm2m_connection_layer_t {
     lwm2m_context_t *ctx;
     connection_t *connList;
+#ifdef LWM2M_SUPPORT_OSCORE
+    void const *ssnStorage; // set by oscoreconnection_set_ssn_storage()
+#endif
+#ifdef USE_DTLS
+    void *dtlsState; // session cache, random generator and PSK profiles of the DTLS connections of the layer
+    void const *sessionStorage; // set by dtlsconnection_set_session_storage()
+#endif
 } lwm2m_connection_layer_t;
 
 lwm2m_connection_layer_t *connectionlayer_create(lwm2m_context_t *context);
@@ -57,6 +72,8 @@ connection_t *connectionlayer_find_connection(lwm2m_connection_layer_t *connLaye
 void connectionlayer_add_connection(lwm2m_connection_layer_t *connLayer, connection_t *conn);
 
 int create_socket(int port_number, int ai_family);
+// closes a socket opened by create_socket() and releases its receive buffer
+void close_socket(int sock);
 
 connection_t *connection_new_incoming(lwm2m_connection_layer_t *connLayerP, int sock, ns_address_t *addr);
 connection_t *connection_create(lwm2m_connection_layer_t *connLayerP, int sock, char *host, char *port,
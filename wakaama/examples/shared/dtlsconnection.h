@@ -22,7 +22,47 @@
 #include "connection.h"
 #include "liblwm2m.h"
 
+#ifndef DTLS_PENDING_MAX
+#define DTLS_PENDING_MAX 4 // datagrams kept while the handshake runs, the next ones are refused
+#endif
+
+#ifndef DTLS_SESSION_BUFFER_SIZE
+#define DTLS_SESSION_BUFFER_SIZE 512 // serialized session handed to the storage, with its server digest
+#endif
+
 connection_t *dtlsconnection_create(lwm2m_connection_layer_t *connLayerP, uint16_t securityInstance, int sock,
                                     char *host, char *port, int addressFamily);
 
+// Drive the handshakes in progress without blocking: retransmit the flights whose timer expired
+// and lower *timeoutMsP to the delay before the next retransmission. Call it after lwm2m_step().
+void dtlsconnection_step(lwm2m_connection_layer_t *connLayerP, uint32_t *timeoutMsP);
+
+// Sessions are cached by the connection layer per security instance once the handshake completes, and
+// resumed by the next connection of the layer to the same instance, as long as its server URI and PSK
+// identity did not change: a session negotiated with another server or identity is forgotten. The
+// stored buffer holds a digest of these before the session itself. The storage keeps them across
+// reboots: store is called with the serialized session once a handshake completes, and with a length
+// of 0 when the server rejected it. load copies the session stored for the instance into buffer and sets
+// *outLengthP, to 0 when nothing was stored. Both return 0 on success.
+typedef int (*dtlsconnection_session_load_t)(uint16_t securityInstance, uint8_t *buffer, size_t length,
+                                             size_t *outLengthP, void *userData);
+typedef int (*dtlsconnection_session_store_t)(uint16_t securityInstance, uint8_t const *buffer, size_t length,
+                                              void *userData);
+
+typedef struct {
+    dtlsconnection_session_load_t loadFunc;
+    dtlsconnection_session_store_t storeFunc;
+    void *userData;
+} dtlsconnection_session_storage_t;
+
+// Optional, before the first DTLS connection of the layer. The storage must outlive the layer.
+void dtlsconnection_set_session_storage(lwm2m_connection_layer_t *connLayerP,
+                                        dtlsconnection_session_storage_t const *storageP);
+
+// Run a full handshake on the next connection to the security instance, e.g. once its credentials changed
+void dtlsconnection_session_forget(lwm2m_connection_layer_t *connLayerP, uint16_t securityInstance);
+
+// Called by connectionlayer_free() once the connections of the layer are freed
+void dtlsconnection_layer_free(lwm2m_connection_layer_t *connLayerP);
+
 #endif
@@ -6,36 +6,498 @@
 #include "mbedtls/debug.h"
 #include "mbedtls/entropy.h"
 #include "mbedtls/error.h"
+#include "mbedtls/md.h"
+#include "mbedtls/platform_util.h"
 #include "mbedtls/ssl.h"
-#include "mbedtls/timing.h"
+#include "mbedtls/version.h"
 #include "object_utils.h"
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "cmsis_os2.h"
 #include "socket_api.h"
 #include "ip6string.h"
 #include "mbed_trace.h"
 
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
-typedef struct _dtlsconnection_t {
-    connection_t conn;
+#ifndef DTLS_SESSION_CACHE_SIZE
+#define DTLS_SESSION_CACHE_SIZE 2 // bootstrap and LWM2M Server
+#endif
+
+#define DTLS_PEER_DIGEST_SIZE 32 // SHA-256
+
+typedef struct {
+    bool valid;
+    uint16_t securityInstance;
+    uint8_t peerDigest[DTLS_PEER_DIGEST_SIZE]; // server and identity the session was negotiated with
+    mbedtls_ssl_session session;
+} dtlssession_cache_entry_t;
+
+/*
+ * The entropy source and the DRBG are shared by all the connections of a layer, and so is the ssl
+ * configuration of the connections using the same credentials. Connections only own their ssl
+ * context. Like the session cache, these belong to the connection layer: layers driven from
+ * different threads share nothing.
+ */
+typedef struct {
+    int refCount;
     mbedtls_entropy_context entropy;
     mbedtls_ctr_drbg_context ctr_drbg;
-    mbedtls_ssl_context ssl;
+} dtlscrypto_t;
+
+typedef struct _dtlsprofile_t {
+    struct _dtlsprofile_t *next;
+    int refCount;
+    uint8_t *identity;
+    size_t identityLen;
+    uint8_t *psk;
+    size_t pskLen;
     mbedtls_ssl_config conf;
-    mbedtls_timing_delay_context timer;
+} dtlsprofile_t;
+
+typedef struct _dtlslayer_t {
+    dtlscrypto_t crypto;
+    dtlsprofile_t *profileList;
+    dtlssession_cache_entry_t sessionCache[DTLS_SESSION_CACHE_SIZE];
+    uint32_t lastTicks; // osKernelGetTickCount() wraps around, see dtlslayer_now_ms()
+    uint32_t tickWraps;
+} dtlslayer_t;
+
+typedef struct _dtlsdatagram_t {
+    struct _dtlsdatagram_t *next;
+    size_t len;
+    uint8_t buffer[];
+} dtlsdatagram_t;
+
+typedef struct _dtlsconnection_t {
+    connection_t conn;
+    lwm2m_connection_layer_t *connLayerP;
+    dtlslayer_t *layerP;
+    uint16_t securityInstance;
+    uint8_t peerDigest[DTLS_PEER_DIGEST_SIZE];
+    bool sessionSaved;
+    dtlsprofile_t *profile;
+    mbedtls_ssl_context ssl;
+    uint64_t timerStart; // handshake retransmission timer, in ms
+    uint32_t timerIntMs;
+    uint32_t timerFinMs;
+    dtlsdatagram_t *pendingList; // datagrams waiting for the handshake to complete, oldest first
+    size_t pendingCount;
     uint8_t *recvBuffer;
     size_t len;
 } dtlsconnection_t;
 
+static dtlslayer_t *dtlslayer_get(lwm2m_connection_layer_t *connLayerP) {
+    if (connLayerP->dtlsState == NULL) {
+        dtlslayer_t *layerP = (dtlslayer_t *)lwm2m_malloc(sizeof(dtlslayer_t));
+        if (layerP == NULL) {
+            return NULL;
+        }
+        memset(layerP, 0, sizeof(dtlslayer_t));
+        layerP->lastTicks = osKernelGetTickCount();
+        connLayerP->dtlsState = layerP;
+    }
+    return (dtlslayer_t *)connLayerP->dtlsState;
+}
+
+// osKernelGetTickCount() wraps around after 2^32 ticks, about 49 days at 1 kHz: the wraps are counted on each
+// read, and dtlsconnection_step() reads it far more often than that
+static uint64_t dtlslayer_now_ms(dtlslayer_t *layerP) {
+    uint32_t ticks = osKernelGetTickCount();
+
+    if (ticks < layerP->lastTicks) {
+        layerP->tickWraps++;
+    }
+    layerP->lastTicks = ticks;
+    return ((uint64_t)layerP->tickWraps << 32 | ticks) * 1000 / osKernelGetTickFreq();
+}
+
+static dtlssession_cache_entry_t *dtlssession_find(dtlslayer_t *layerP, uint16_t securityInstance, bool create) {
+    dtlssession_cache_entry_t *sessionCache = layerP->sessionCache;
+    dtlssession_cache_entry_t *freeP = NULL;
+    int i;
+
+    for (i = 0; i < DTLS_SESSION_CACHE_SIZE; i++) {
+        if (sessionCache[i].valid && sessionCache[i].securityInstance == securityInstance) {
+            return sessionCache + i;
+        }
+        if (!sessionCache[i].valid && freeP == NULL) {
+            freeP = sessionCache + i;
+        }
+    }
+    if (!create) {
+        return NULL;
+    }
+    if (freeP == NULL) {
+        // evict the first entry
+        freeP = sessionCache;
+        mbedtls_ssl_session_free(&freeP->session);
+        freeP->valid = false;
+    }
+    mbedtls_ssl_session_init(&freeP->session);
+    freeP->securityInstance = securityInstance;
+
+    return freeP;
+}
+
+// digest of the server URI and of the PSK identity: a session is only resumed with the server and the
+// identity it was negotiated with, the security instance may have been rewritten since
+static int dtlsconnection_peer_digest(char const *host, char const *port, uint8_t const *identity,
+                                      size_t identityLen, uint8_t *digest) {
+    mbedtls_md_context_t md;
+    int ret;
+
+    mbedtls_md_init(&md);
+    ret = mbedtls_md_setup(&md, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 0);
+    if (ret == 0) {
+        ret = mbedtls_md_starts(&md);
+    }
+    // the terminating nul bytes separate the fields
+    if (ret == 0) {
+        ret = mbedtls_md_update(&md, (uint8_t const *)host, strlen(host) + 1);
+    }
+    if (ret == 0) {
+        ret = mbedtls_md_update(&md, (uint8_t const *)port, strlen(port) + 1);
+    }
+    if (ret == 0) {
+        ret = mbedtls_md_update(&md, identity, identityLen);
+    }
+    if (ret == 0) {
+        ret = mbedtls_md_finish(&md, digest);
+    }
+    mbedtls_md_free(&md);
+
+    return ret;
+}
+
+static bool dtlsconnection_handshake_over(dtlsconnection_t *dtlsConn) {
+#if MBEDTLS_VERSION_MAJOR >= 3
+    return mbedtls_ssl_is_handshake_over(&dtlsConn->ssl);
+#else
+    return dtlsConn->ssl.state == MBEDTLS_SSL_HANDSHAKE_OVER;
+#endif
+}
+
+// keep the negotiated session for the next connection to the same server, and in the storage of the
+// layer for the connections made after a reboot
+static void dtlsconnection_save_session(dtlsconnection_t *dtlsConn) {
+    dtlsconnection_session_storage_t const *storageP =
+        (dtlsconnection_session_storage_t const *)dtlsConn->connLayerP->sessionStorage;
+    dtlssession_cache_entry_t *entryP;
+    uint8_t buffer[DTLS_SESSION_BUFFER_SIZE];
+    size_t length;
+
+    if (dtlsConn->sessionSaved || !dtlsconnection_handshake_over(dtlsConn)) {
+        return;
+    }
+    dtlsConn->sessionSaved = true;
+
+    entryP = dtlssession_find(dtlsConn->layerP, dtlsConn->securityInstance, true);
+    if (entryP->valid) {
+        mbedtls_ssl_session_free(&entryP->session);
+        mbedtls_ssl_session_init(&entryP->session);
+    }
+    entryP->valid = (mbedtls_ssl_get_session(&dtlsConn->ssl, &entryP->session) == 0);
+    memcpy(entryP->peerDigest, dtlsConn->peerDigest, DTLS_PEER_DIGEST_SIZE);
+
+    if (!entryP->valid || storageP == NULL) {
+        return;
+    }
+    // stored after the digest of its server and identity
+    memcpy(buffer, dtlsConn->peerDigest, DTLS_PEER_DIGEST_SIZE);
+    if (mbedtls_ssl_session_save(&entryP->session, buffer + DTLS_PEER_DIGEST_SIZE,
+                                 sizeof(buffer) - DTLS_PEER_DIGEST_SIZE, &length) != 0 ||
+        storageP->storeFunc(dtlsConn->securityInstance, buffer, DTLS_PEER_DIGEST_SIZE + length,
+                            storageP->userData) != 0) {
+        printf("Failed to store the DTLS session of security instance %d\n", dtlsConn->securityInstance);
+    }
+    mbedtls_platform_zeroize(buffer, sizeof(buffer));
+}
+
+// the session of the cache, else the one kept in the storage before a reboot. A session negotiated with
+// another server or identity is forgotten.
+static dtlssession_cache_entry_t *dtlsconnection_load_session(lwm2m_connection_layer_t *connLayerP,
+                                                              dtlslayer_t *layerP, uint16_t securityInstance,
+                                                              uint8_t const *peerDigest) {
+    dtlsconnection_session_storage_t const *storageP =
+        (dtlsconnection_session_storage_t const *)connLayerP->sessionStorage;
+    dtlssession_cache_entry_t *entryP = dtlssession_find(layerP, securityInstance, false);
+    uint8_t buffer[DTLS_SESSION_BUFFER_SIZE];
+    size_t length = 0;
+
+    if (entryP != NULL) {
+        if (memcmp(entryP->peerDigest, peerDigest, DTLS_PEER_DIGEST_SIZE) == 0) {
+            return entryP;
+        }
+        dtlsconnection_session_forget(connLayerP, securityInstance);
+        return NULL;
+    }
+    if (storageP == NULL) {
+        return NULL;
+    }
+    if (storageP->loadFunc(securityInstance, buffer, sizeof(buffer), &length, storageP->userData) != 0 ||
+        length <= DTLS_PEER_DIGEST_SIZE) {
+        return NULL;
+    }
+    if (memcmp(buffer, peerDigest, DTLS_PEER_DIGEST_SIZE) != 0) {
+        mbedtls_platform_zeroize(buffer, sizeof(buffer));
+        dtlsconnection_session_forget(connLayerP, securityInstance);
+        return NULL;
+    }
+
+    entryP = dtlssession_find(layerP, securityInstance, true);
+    entryP->valid = (mbedtls_ssl_session_load(&entryP->session, buffer + DTLS_PEER_DIGEST_SIZE,
+                                              length - DTLS_PEER_DIGEST_SIZE) == 0);
+    memcpy(entryP->peerDigest, peerDigest, DTLS_PEER_DIGEST_SIZE);
+    mbedtls_platform_zeroize(buffer, sizeof(buffer));
+    if (!entryP->valid) {
+        mbedtls_ssl_session_free(&entryP->session);
+        return NULL;
+    }
+    return entryP;
+}
+
+void dtlsconnection_set_session_storage(lwm2m_connection_layer_t *connLayerP,
+                                        dtlsconnection_session_storage_t const *storageP) {
+    connLayerP->sessionStorage = storageP;
+}
+
+void dtlsconnection_session_forget(lwm2m_connection_layer_t *connLayerP, uint16_t securityInstance) {
+    dtlsconnection_session_storage_t const *storageP =
+        (dtlsconnection_session_storage_t const *)connLayerP->sessionStorage;
+    dtlssession_cache_entry_t *entryP = NULL;
+
+    if (connLayerP->dtlsState != NULL) {
+        entryP = dtlssession_find((dtlslayer_t *)connLayerP->dtlsState, securityInstance, false);
+    }
+    if (entryP != NULL) {
+        mbedtls_ssl_session_free(&entryP->session);
+        entryP->valid = false;
+    }
+    if (storageP != NULL) {
+        storageP->storeFunc(securityInstance, NULL, 0, storageP->userData);
+    }
+}
+
+void dtlsconnection_layer_free(lwm2m_connection_layer_t *connLayerP) {
+    dtlslayer_t *layerP = (dtlslayer_t *)connLayerP->dtlsState;
+    int i;
+
+    if (layerP == NULL) {
+        return;
+    }
+    // the connections were freed first: they released the profiles and the crypto
+    for (i = 0; i < DTLS_SESSION_CACHE_SIZE; i++) {
+        mbedtls_ssl_session_free(&layerP->sessionCache[i].session);
+    }
+    mbedtls_platform_zeroize(layerP, sizeof(dtlslayer_t));
+    lwm2m_free(layerP);
+    connLayerP->dtlsState = NULL;
+}
+
+static int dtlscrypto_acquire(dtlscrypto_t *cryptoP, const uint8_t *custom, size_t customLen) {
+    if (cryptoP->refCount == 0) {
+        mbedtls_ctr_drbg_init(&cryptoP->ctr_drbg);
+        mbedtls_entropy_init(&cryptoP->entropy);
+        if (mbedtls_ctr_drbg_seed(&cryptoP->ctr_drbg, mbedtls_entropy_func, &cryptoP->entropy, custom, customLen) !=
+            0) {
+            mbedtls_ctr_drbg_free(&cryptoP->ctr_drbg);
+            mbedtls_entropy_free(&cryptoP->entropy);
+            return -1;
+        }
+    }
+    cryptoP->refCount++;
+
+    return 0;
+}
+
+static void dtlscrypto_release(dtlscrypto_t *cryptoP) {
+    if (--cryptoP->refCount == 0) {
+        mbedtls_ctr_drbg_free(&cryptoP->ctr_drbg);
+        mbedtls_entropy_free(&cryptoP->entropy);
+    }
+}
+
+static void dtlsprofile_free_credentials(uint8_t *identity, uint8_t *psk, size_t pskLen) {
+    mbedtls_platform_zeroize(psk, pskLen);
+    lwm2m_free(psk);
+    lwm2m_free(identity);
+}
+
+// takes ownership of identity and psk
+static dtlsprofile_t *dtlsprofile_acquire(dtlslayer_t *layerP, uint8_t *identity, size_t identityLen, uint8_t *psk,
+                                          size_t pskLen) {
+    static int ciphersuites[] = {MBEDTLS_TLS_PSK_WITH_AES_128_CCM, 0};
+    dtlsprofile_t *profileP;
+
+    for (profileP = layerP->profileList; profileP != NULL; profileP = profileP->next) {
+        if (profileP->identityLen == identityLen && profileP->pskLen == pskLen &&
+            memcmp(profileP->identity, identity, identityLen) == 0 && memcmp(profileP->psk, psk, pskLen) == 0) {
+            profileP->refCount++;
+            dtlsprofile_free_credentials(identity, psk, pskLen);
+            return profileP;
+        }
+    }
+
+    profileP = (dtlsprofile_t *)lwm2m_malloc(sizeof(dtlsprofile_t));
+    if (profileP == NULL) {
+        dtlsprofile_free_credentials(identity, psk, pskLen);
+        return NULL;
+    }
+    memset(profileP, 0, sizeof(dtlsprofile_t));
+    mbedtls_ssl_config_init(&profileP->conf);
+
+    if (mbedtls_ssl_config_defaults(&profileP->conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_DATAGRAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0 ||
+        mbedtls_ssl_conf_psk(&profileP->conf, psk, pskLen, identity, identityLen) != 0) {
+        mbedtls_ssl_config_free(&profileP->conf);
+        lwm2m_free(profileP);
+        dtlsprofile_free_credentials(identity, psk, pskLen);
+        return NULL;
+    }
+
+    mbedtls_ssl_conf_ciphersuites(&profileP->conf, ciphersuites);
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    // the Client never changes the address of the server: it only needs the server to accept a CID
+    mbedtls_ssl_conf_cid(&profileP->conf, 0, MBEDTLS_SSL_UNEXPECTED_CID_IGNORE);
+#endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&profileP->conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+    mbedtls_ssl_conf_rng(&profileP->conf, mbedtls_ctr_drbg_random, &layerP->crypto.ctr_drbg);
+
+    profileP->identity = identity;
+    profileP->identityLen = identityLen;
+    profileP->psk = psk;
+    profileP->pskLen = pskLen;
+    profileP->refCount = 1;
+    profileP->next = layerP->profileList;
+    layerP->profileList = profileP;
+
+    return profileP;
+}
+
+static void dtlsprofile_release(dtlslayer_t *layerP, dtlsprofile_t *profileP) {
+    dtlsprofile_t **itorP;
+
+    if (--profileP->refCount > 0) {
+        return;
+    }
+
+    for (itorP = &layerP->profileList; *itorP != NULL; itorP = &(*itorP)->next) {
+        if (*itorP == profileP) {
+            *itorP = profileP->next;
+            break;
+        }
+    }
+    mbedtls_ssl_config_free(&profileP->conf);
+    dtlsprofile_free_credentials(profileP->identity, profileP->psk, profileP->pskLen);
+    lwm2m_free(profileP);
+}
+
+// mbedtls_ssl_set_delay_t: same semantics as mbedtls_timing_set_delay(), on a clock dtlsconnection_step() can read
+static void dtlsconnection_set_delay(void *data, uint32_t int_ms, uint32_t fin_ms) {
+    dtlsconnection_t *dtlsConn = (dtlsconnection_t *)data;
+
+    dtlsConn->timerIntMs = int_ms;
+    dtlsConn->timerFinMs = fin_ms;
+    if (fin_ms != 0) {
+        dtlsConn->timerStart = dtlslayer_now_ms(dtlsConn->layerP);
+    }
+}
+
+// mbedtls_ssl_get_timer_t
+static int dtlsconnection_get_delay(void *data) {
+    dtlsconnection_t *dtlsConn = (dtlsconnection_t *)data;
+    uint64_t elapsed;
+
+    if (dtlsConn->timerFinMs == 0) {
+        return -1;
+    }
+    elapsed = dtlslayer_now_ms(dtlsConn->layerP) - dtlsConn->timerStart;
+    if (elapsed >= dtlsConn->timerFinMs) {
+        return 2;
+    }
+    if (elapsed >= dtlsConn->timerIntMs) {
+        return 1;
+    }
+    return 0;
+}
+
+static void dtlsconnection_print_error(int ret) {
+#if defined(MBEDTLS_ERROR_C)
+    char error_buf[200];
+    mbedtls_strerror(ret, error_buf, 200);
+    printf("Last error was: -0x%04x - %s\n\n", (unsigned int)-ret, error_buf);
+#else
+    printf("Last error was: -0x%04x\n\n", (unsigned int)-ret);
+#endif /* MBEDTLS_ERROR_C */
+}
+
+static void dtlsconnection_drop_pending(dtlsconnection_t *dtlsConn) {
+    while (dtlsConn->pendingList != NULL) {
+        dtlsdatagram_t *datagramP = dtlsConn->pendingList;
+        dtlsConn->pendingList = datagramP->next;
+        lwm2m_free(datagramP);
+    }
+    dtlsConn->pendingCount = 0;
+}
+
+static int dtlsconnection_queue_pending(dtlsconnection_t *dtlsConn, uint8_t const *buffer, size_t len) {
+    dtlsdatagram_t **itorP;
+    dtlsdatagram_t *datagramP;
+
+    if (dtlsConn->pendingCount >= DTLS_PENDING_MAX) {
+        return -1;
+    }
+    datagramP = (dtlsdatagram_t *)lwm2m_malloc(sizeof(dtlsdatagram_t) + len);
+    if (datagramP == NULL) {
+        return -1;
+    }
+    datagramP->next = NULL;
+    datagramP->len = len;
+    memcpy(datagramP->buffer, buffer, len);
+
+    for (itorP = &dtlsConn->pendingList; *itorP != NULL; itorP = &(*itorP)->next)
+        ;
+    *itorP = datagramP;
+    dtlsConn->pendingCount++;
+
+    return 0;
+}
+
+// called whenever the handshake may have progressed
+static void dtlsconnection_handshake_progressed(dtlsconnection_t *dtlsConn) {
+    if (!dtlsconnection_handshake_over(dtlsConn)) {
+        return;
+    }
+
+    dtlsconnection_save_session(dtlsConn);
+
+    while (dtlsConn->pendingList != NULL) {
+        dtlsdatagram_t *datagramP = dtlsConn->pendingList;
+        int ret = mbedtls_ssl_write(&dtlsConn->ssl, datagramP->buffer, datagramP->len);
+        if (ret < 0) {
+            dtlsconnection_print_error(ret);
+        }
+        dtlsConn->pendingList = datagramP->next;
+        dtlsConn->pendingCount--;
+        lwm2m_free(datagramP);
+    }
+}
+
 static void dtlsconnection_deinit(void *conn) {
     dtlsconnection_t *dtlsConn = (dtlsconnection_t *)conn;
-    mbedtls_ssl_config_free(&dtlsConn->conf);
-    mbedtls_ctr_drbg_free(&dtlsConn->ctr_drbg);
-    mbedtls_entropy_free(&dtlsConn->entropy);
+    dtlsconnection_drop_pending(dtlsConn);
     mbedtls_ssl_free(&dtlsConn->ssl);
+    if (dtlsConn->profile != NULL) {
+        dtlsprofile_release(dtlsConn->layerP, dtlsConn->profile);
+    }
+    dtlscrypto_release(&dtlsConn->layerP->crypto);
 }
 
 static int dtlsconnection_recv(lwm2m_context_t *context, uint8_t *buffer, size_t len, void *conn) {
@@ -44,20 +506,20 @@ static int dtlsconnection_recv(lwm2m_context_t *context, uint8_t *buffer, size_t
     dtlsConn->recvBuffer = buffer;
     dtlsConn->len = len;
 
-    do {
-        ret = mbedtls_ssl_read(&dtlsConn->ssl, buffer, len);
-    } while (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+    // the bio never blocks: a pending handshake consumes the record and returns WANT_READ
+    ret = mbedtls_ssl_read(&dtlsConn->ssl, buffer, len);
 
-    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret < 0) {
-#if defined(MBEDTLS_ERROR_C)
-        char error_buf[200];
-        mbedtls_strerror(ret, error_buf, 200);
-        printf("Last error was: -0x%04x - %s\n\n", (unsigned int)-ret, error_buf);
-#else
-        printf("Last error was: -0x%04x\n\n", (unsigned int)-ret);
-#endif /* MBEDTLS_ERROR_C */
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE && ret < 0) {
+        dtlsconnection_print_error(ret);
     }
 
+    if (ret == MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE) {
+        // the server does not know the session anymore: run a full handshake next time
+        dtlsconnection_session_forget(dtlsConn->connLayerP, dtlsConn->securityInstance);
+    }
+
+    dtlsconnection_handshake_progressed(dtlsConn);
+
     if (ret > 0) {
         lwm2m_handle_packet(context, buffer, ret, dtlsConn);
         return ret;
@@ -68,18 +530,25 @@ static int dtlsconnection_recv(lwm2m_context_t *context, uint8_t *buffer, size_t
 static int dtlsconnection_send(uint8_t const *buffer, size_t len, void *conn) {
     dtlsconnection_t *dtlsConn = (dtlsconnection_t *)conn;
     int ret = 0;
-    do {
-        ret = mbedtls_ssl_write(&dtlsConn->ssl, buffer, len);
-    } while (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
 
-    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret < 0) {
-#if defined(MBEDTLS_ERROR_C)
-        char error_buf[200];
-        mbedtls_strerror(ret, error_buf, 200);
-        printf("Last error was: -0x%04x - %s\n\n", (unsigned int)-ret, error_buf);
-#else
-        printf("Last error was: -0x%04x\n\n", (unsigned int)-ret);
-#endif /* MBEDTLS_ERROR_C */
+    if (!dtlsconnection_handshake_over(dtlsConn)) {
+        // kept in order until dtlsconnection_step() or a received record completes the handshake. Once
+        // DTLS_PENDING_MAX are waiting the datagram is refused, and the transaction retransmits it later
+        if (dtlsconnection_queue_pending(dtlsConn, buffer, len) != 0) {
+            return -1;
+        }
+
+        ret = mbedtls_ssl_handshake(&dtlsConn->ssl);
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE && ret < 0) {
+            dtlsconnection_print_error(ret);
+        }
+        dtlsconnection_handshake_progressed(dtlsConn);
+        return (int)len;
+    }
+
+    ret = mbedtls_ssl_write(&dtlsConn->ssl, buffer, len);
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE && ret < 0) {
+        dtlsconnection_print_error(ret);
     }
     return ret;
 }
@@ -130,6 +599,12 @@ connection_t *dtlsconnection_create(lwm2m_connection_layer_t *connLayerP, uint16
     size_t pskLen = 0;
     uint8_t *psk = NULL;
     dtlsconnection_t *dtlsConn = NULL;
+    dtlslayer_t *layerP = dtlslayer_get(connLayerP);
+    dtlssession_cache_entry_t *entryP;
+
+    if (layerP == NULL) {
+        return NULL;
+    }
 
     int ret = security_get_psk_identity(connLayerP->ctx, securityInstance, &identity, &identityLen);
     if (ret <= 0) {
@@ -155,61 +630,106 @@ connection_t *dtlsconnection_create(lwm2m_connection_layer_t *connLayerP, uint16
         return NULL;
     }
     dtlsConn->conn.sendFunc = dtlsconnection_send;
+#ifdef LWM2M_VECTORED_SEND
+    // a record is encrypted from a single plaintext buffer
+    dtlsConn->conn.sendvFunc = NULL;
+#endif
     dtlsConn->conn.recvFunc = dtlsconnection_recv;
     dtlsConn->conn.deinitFunc = dtlsconnection_deinit;
+    dtlsConn->connLayerP = connLayerP;
+    dtlsConn->layerP = layerP;
+    dtlsConn->securityInstance = securityInstance;
+    if (dtlsconnection_peer_digest(host, port, identity, identityLen, dtlsConn->peerDigest) != 0) {
+        dtlsprofile_free_credentials(identity, psk, pskLen);
+        lwm2m_free(dtlsConn);
+        return NULL;
+    }
 
     mbedtls_debug_set_threshold(5);
 
     mbedtls_ssl_init(&dtlsConn->ssl);
-    mbedtls_ssl_config_init(&dtlsConn->conf);
-    mbedtls_ctr_drbg_init(&dtlsConn->ctr_drbg);
-    mbedtls_entropy_init(&dtlsConn->entropy);
-    if ((ret = mbedtls_ctr_drbg_seed(&dtlsConn->ctr_drbg, mbedtls_entropy_func, &dtlsConn->entropy,
-                                     (const unsigned char *)identity, identityLen)) != 0) {
-        dtlsconnection_deinit(dtlsConn);
-        lwm2m_free(identity);
-        lwm2m_free(psk);
+    if (dtlscrypto_acquire(&layerP->crypto, (const unsigned char *)identity, identityLen) != 0) {
+        mbedtls_ssl_free(&dtlsConn->ssl);
+        dtlsprofile_free_credentials(identity, psk, pskLen);
         lwm2m_free(dtlsConn);
         return NULL;
     }
 
-    if ((ret = mbedtls_ssl_config_defaults(&dtlsConn->conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_DATAGRAM,
-                                           MBEDTLS_SSL_PRESET_DEFAULT)) != 0) {
+    dtlsConn->profile = dtlsprofile_acquire(layerP, identity, identityLen, psk, pskLen);
+    if (dtlsConn->profile == NULL) {
         dtlsconnection_deinit(dtlsConn);
-        lwm2m_free(identity);
-        lwm2m_free(psk);
         lwm2m_free(dtlsConn);
         return NULL;
     }
-    static int ciphersuites[] = {MBEDTLS_TLS_PSK_WITH_AES_128_CCM, 0};
 
-    mbedtls_ssl_conf_ciphersuites(&dtlsConn->conf, ciphersuites);
+    mbedtls_ssl_set_bio(&dtlsConn->ssl, dtlsConn, dtlsconnection_mbedtls_send, dtlsconnection_mbedtls_recv, NULL);
+
+    mbedtls_ssl_set_timer_cb(&dtlsConn->ssl, dtlsConn, dtlsconnection_set_delay, dtlsconnection_get_delay);
 
-    if ((ret = mbedtls_ssl_conf_psk(&dtlsConn->conf, (uint8_t *)psk, pskLen, (uint8_t *)identity, identityLen)) != 0) {
+    if ((ret = mbedtls_ssl_setup(&dtlsConn->ssl, &dtlsConn->profile->conf)) != 0) {
         dtlsconnection_deinit(dtlsConn);
-        lwm2m_free(identity);
-        lwm2m_free(psk);
         lwm2m_free(dtlsConn);
         return NULL;
     }
-    lwm2m_free(identity);
-    lwm2m_free(psk);
-
-    mbedtls_ssl_conf_rng(&dtlsConn->conf, mbedtls_ctr_drbg_random, &dtlsConn->ctr_drbg);
-    mbedtls_ssl_set_bio(&dtlsConn->ssl, dtlsConn, dtlsconnection_mbedtls_send, dtlsconnection_mbedtls_recv, NULL);
 
-    mbedtls_ssl_set_timer_cb(&dtlsConn->ssl, &dtlsConn->timer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    mbedtls_ssl_set_cid(&dtlsConn->ssl, MBEDTLS_SSL_CID_ENABLED, NULL, 0);
+#endif
 
-    if ((ret = mbedtls_ssl_setup(&dtlsConn->ssl, &dtlsConn->conf)) != 0) {
-        dtlsconnection_deinit(dtlsConn);
-        lwm2m_free(dtlsConn);
-        return NULL;
+    entryP = dtlsconnection_load_session(connLayerP, layerP, securityInstance, dtlsConn->peerDigest);
+    if (entryP != NULL && entryP->valid && mbedtls_ssl_set_session(&dtlsConn->ssl, &entryP->session) == 0) {
+        printf("Resuming DTLS session of security instance %d\n", securityInstance);
     }
 
     connectionlayer_add_connection(connLayerP, (connection_t *)dtlsConn);
     return (connection_t *)dtlsConn;
 }
 
+void dtlsconnection_step(lwm2m_connection_layer_t *connLayerP, uint32_t *timeoutMsP) {
+    connection_t *connP;
+
+    if (connLayerP->dtlsState == NULL) {
+        return;
+    }
+    // keeps track of the wraps of the tick count while no handshake runs
+    dtlslayer_now_ms((dtlslayer_t *)connLayerP->dtlsState);
+
+    for (connP = connLayerP->connList; connP != NULL; connP = connP->next) {
+        dtlsconnection_t *dtlsConn;
+        uint64_t elapsed;
+        int ret;
+
+        if (connP->deinitFunc != dtlsconnection_deinit) {
+            continue;
+        }
+        dtlsConn = (dtlsconnection_t *)connP;
+        if (dtlsconnection_handshake_over(dtlsConn)) {
+            continue;
+        }
+
+        // retransmits the last flight once the timer expired, returns WANT_READ while waiting
+        if (dtlsConn->pendingList != NULL || dtlsConn->timerFinMs != 0) {
+            ret = mbedtls_ssl_handshake(&dtlsConn->ssl);
+            if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE && ret < 0) {
+                dtlsconnection_print_error(ret);
+                dtlsconnection_drop_pending(dtlsConn);
+                mbedtls_ssl_session_reset(&dtlsConn->ssl);
+                continue;
+            }
+            dtlsconnection_handshake_progressed(dtlsConn);
+        }
+
+        if (!dtlsconnection_handshake_over(dtlsConn) && dtlsConn->timerFinMs != 0) {
+            elapsed = dtlslayer_now_ms(dtlsConn->layerP) - dtlsConn->timerStart;
+            if (elapsed >= dtlsConn->timerFinMs) {
+                *timeoutMsP = 0;
+            } else if (dtlsConn->timerFinMs - elapsed < *timeoutMsP) {
+                *timeoutMsP = (uint32_t)(dtlsConn->timerFinMs - elapsed);
+            }
+        }
+    }
+}
+
 #else
 connection_t *dtlsconnection_create(lwm2m_connection_layer_t *connLayerP, uint16_t securityInstance, int sock,
                                     char *host, char *port, int addressFamily) {
@@ -221,4 +741,22 @@ connection_t *dtlsconnection_create(lwm2m_connection_layer_t *connLayerP, uint16
     (void)addressFamily;
     return NULL;
 }
+
+void dtlsconnection_set_session_storage(lwm2m_connection_layer_t *connLayerP,
+                                        dtlsconnection_session_storage_t const *storageP) {
+    (void)connLayerP;
+    (void)storageP;
+}
+
+void dtlsconnection_session_forget(lwm2m_connection_layer_t *connLayerP, uint16_t securityInstance) {
+    (void)connLayerP;
+    (void)securityInstance;
+}
+
+void dtlsconnection_layer_free(lwm2m_connection_layer_t *connLayerP) { (void)connLayerP; }
+
+void dtlsconnection_step(lwm2m_connection_layer_t *connLayerP, uint32_t *timeoutMsP) {
+    (void)connLayerP;
+    (void)timeoutMsP;
+}
 #endif
@@ -0,0 +1,393 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Eclipse Foundation and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v2.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v20.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "mmsg_transport.h"
+
+#if defined(__linux__) && defined(LWM2M_MMSG_TRANSPORT)
+
+#include <errno.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static mmsg_peer_t *prv_find_peer(mmsg_transport_t *transportP, struct sockaddr_storage *addr, socklen_t addrLen) {
+    mmsg_peer_t *peerP;
+
+    for (peerP = transportP->peerList; peerP != NULL; peerP = peerP->next) {
+        if (peerP->addrLen == addrLen && memcmp(&peerP->addr, addr, addrLen) == 0) {
+            return peerP;
+        }
+    }
+
+    return NULL;
+}
+
+// whether the peer is the session of a server, a client or a pending transaction of the context
+static bool prv_peer_in_use(lwm2m_context_t *contextP, mmsg_peer_t *peerP) {
+    lwm2m_transaction_t *transactionP;
+#ifdef LWM2M_CLIENT_MODE
+    lwm2m_server_t *serverP;
+#endif
+#if defined(LWM2M_SERVER_MODE) || defined(LWM2M_BOOTSTRAP_SERVER_MODE)
+    lwm2m_client_t *clientP;
+#endif
+
+    for (transactionP = contextP->transactionList; transactionP != NULL; transactionP = transactionP->next) {
+        if (transactionP->peerH == peerP) {
+            return true;
+        }
+    }
+#ifdef LWM2M_CLIENT_MODE
+    for (serverP = contextP->serverList; serverP != NULL; serverP = serverP->next) {
+        if (serverP->sessionH == peerP) {
+            return true;
+        }
+    }
+    for (serverP = contextP->bootstrapServerList; serverP != NULL; serverP = serverP->next) {
+        if (serverP->sessionH == peerP) {
+            return true;
+        }
+    }
+#endif
+#if defined(LWM2M_SERVER_MODE) || defined(LWM2M_BOOTSTRAP_SERVER_MODE)
+    for (clientP = contextP->clientList; clientP != NULL; clientP = clientP->next) {
+        if (clientP->sessionH == peerP) {
+            return true;
+        }
+    }
+#endif
+
+    return false;
+}
+
+// free the peer idle for the longest time among those the context does not refer to
+static bool prv_evict_peer(mmsg_transport_t *transportP) {
+    mmsg_peer_t **peerPP;
+    mmsg_peer_t **oldestPP;
+    mmsg_peer_t *peerP;
+
+    oldestPP = NULL;
+    for (peerPP = &transportP->peerList; *peerPP != NULL; peerPP = &(*peerPP)->next) {
+        if ((oldestPP == NULL || (*peerPP)->lastSeen <= (*oldestPP)->lastSeen)
+            && !prv_peer_in_use(transportP->ctx, *peerPP)) {
+            oldestPP = peerPP;
+        }
+    }
+    if (oldestPP == NULL) {
+        return false;
+    }
+
+    peerP = *oldestPP;
+    *oldestPP = peerP->next;
+    lwm2m_free(peerP);
+    transportP->peerCount--;
+
+    return true;
+}
+
+static mmsg_peer_t *prv_add_peer(mmsg_transport_t *transportP, struct sockaddr_storage *addr, socklen_t addrLen) {
+    mmsg_peer_t *peerP;
+
+    if (transportP->peerCount >= LWM2M_MMSG_MAX_PEERS && !prv_evict_peer(transportP)) {
+        fprintf(stderr, "#> %d peers in use, new peer dropped\r\n", LWM2M_MMSG_MAX_PEERS);
+        return NULL;
+    }
+
+    peerP = (mmsg_peer_t *)lwm2m_malloc(sizeof(mmsg_peer_t));
+    if (peerP == NULL) {
+        return NULL;
+    }
+    memset(peerP, 0, sizeof(mmsg_peer_t));
+    peerP->transportP = transportP;
+    memcpy(&peerP->addr, addr, addrLen);
+    peerP->addrLen = addrLen;
+    peerP->lastSeen = lwm2m_gettime();
+    peerP->next = transportP->peerList;
+    transportP->peerList = peerP;
+    transportP->peerCount++;
+
+    return peerP;
+}
+
+mmsg_transport_t *mmsg_transport_open(lwm2m_context_t *contextP, const char *port, int addressFamily) {
+    mmsg_transport_t *transportP;
+    struct addrinfo hints;
+    struct addrinfo *res;
+    struct addrinfo *p;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = addressFamily;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_PASSIVE;
+    if (getaddrinfo(NULL, port, &hints, &res) != 0 || res == NULL) {
+        return NULL;
+    }
+
+    transportP = (mmsg_transport_t *)lwm2m_malloc(sizeof(mmsg_transport_t));
+    if (transportP == NULL) {
+        freeaddrinfo(res);
+        return NULL;
+    }
+    memset(transportP, 0, sizeof(mmsg_transport_t));
+    transportP->ctx = contextP;
+    transportP->sock = -1;
+    transportP->batchSize = LWM2M_MMSG_BATCH_SIZE;
+
+    for (p = res; p != NULL && transportP->sock == -1; p = p->ai_next) {
+        transportP->sock = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+        if (transportP->sock >= 0 && bind(transportP->sock, p->ai_addr, p->ai_addrlen) == -1) {
+            close(transportP->sock);
+            transportP->sock = -1;
+        }
+    }
+    freeaddrinfo(res);
+
+    if (transportP->sock == -1) {
+        lwm2m_free(transportP);
+        return NULL;
+    }
+
+    return transportP;
+}
+
+void mmsg_transport_close(mmsg_transport_t *transportP) {
+    while (transportP->peerList != NULL) {
+        mmsg_peer_t *nextP = transportP->peerList->next;
+
+        lwm2m_free(transportP->peerList);
+        transportP->peerList = nextP;
+    }
+    transportP->peerCount = 0;
+    close(transportP->sock);
+    lwm2m_free(transportP);
+}
+
+int mmsg_transport_set_batch_size(mmsg_transport_t *transportP, unsigned int batchSize) {
+    if (batchSize == 0 || batchSize > LWM2M_MMSG_BATCH_SIZE) {
+        return -1;
+    }
+    // the datagrams queued for a larger batch leave first
+    if (mmsg_transport_flush(transportP) < 0) {
+        return -1;
+    }
+    transportP->batchSize = batchSize;
+
+    return 0;
+}
+
+mmsg_peer_t *mmsg_transport_connect(mmsg_transport_t *transportP, const char *host, const char *port) {
+    struct addrinfo hints;
+    struct addrinfo *res;
+    struct sockaddr_storage addr;
+    socklen_t addrLen;
+    mmsg_peer_t *peerP;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(host, port, &hints, &res) != 0 || res == NULL) {
+        return NULL;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    memcpy(&addr, res->ai_addr, res->ai_addrlen);
+    addrLen = res->ai_addrlen;
+    freeaddrinfo(res);
+
+    peerP = prv_find_peer(transportP, &addr, addrLen);
+    if (peerP == NULL) {
+        peerP = prv_add_peer(transportP, &addr, addrLen);
+    }
+
+    return peerP;
+}
+
+int mmsg_transport_receive(mmsg_transport_t *transportP, int timeoutMs) {
+    struct pollfd pfd;
+    int total;
+    int count;
+    int i;
+
+    pfd.fd = transportP->sock;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, timeoutMs) < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    if ((pfd.revents & POLLIN) == 0) {
+        return 0;
+    }
+
+    total = 0;
+    do {
+        for (i = 0; i < (int)transportP->batchSize; i++) {
+            transportP->rxIov[i].iov_base = transportP->rxBuffer[i];
+            transportP->rxIov[i].iov_len = LWM2M_MMSG_PACKET_SIZE;
+            memset(&transportP->rxMsg[i], 0, sizeof(struct mmsghdr));
+            transportP->rxMsg[i].msg_hdr.msg_name = &transportP->rxAddr[i];
+            transportP->rxMsg[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+            transportP->rxMsg[i].msg_hdr.msg_iov = &transportP->rxIov[i];
+            transportP->rxMsg[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        count = recvmmsg(transportP->sock, transportP->rxMsg, transportP->batchSize, MSG_DONTWAIT, NULL);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                break;
+            }
+            return -1;
+        }
+
+        for (i = 0; i < count; i++) {
+            mmsg_peer_t *peerP;
+            struct sockaddr_storage *addr = &transportP->rxAddr[i];
+            socklen_t addrLen = transportP->rxMsg[i].msg_hdr.msg_namelen;
+
+            if (transportP->rxMsg[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                fprintf(stderr, "#> dropping truncated datagram\r\n");
+                continue;
+            }
+
+            peerP = prv_find_peer(transportP, addr, addrLen);
+            if (peerP == NULL) {
+                peerP = prv_add_peer(transportP, addr, addrLen);
+                if (peerP == NULL) {
+                    continue;
+                }
+            } else {
+                peerP->lastSeen = lwm2m_gettime();
+            }
+
+            lwm2m_handle_packet(transportP->ctx, transportP->rxBuffer[i], transportP->rxMsg[i].msg_len, peerP);
+        }
+        total += count;
+
+        // the responses of the whole batch leave together
+        if (mmsg_transport_flush(transportP) < 0) {
+            return -1;
+        }
+    } while (count == (int)transportP->batchSize);
+
+    return total;
+}
+
+int mmsg_transport_flush(mmsg_transport_t *transportP) {
+    unsigned int sent;
+
+    sent = 0;
+    while (sent < transportP->txCount) {
+        int result;
+
+        result = sendmmsg(transportP->sock, transportP->txMsg + sent, transportP->txCount - sent, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // liblwm2m retransmits confirmable messages, drop the batch
+            transportP->txCount = 0;
+            return -1;
+        }
+        sent += (unsigned int)result;
+    }
+    transportP->txCount = 0;
+
+    return (int)sent;
+}
+
+// reserve the next slot of the transmit batch for a datagram of length bytes to peerP
+static uint8_t *prv_queue_datagram(mmsg_peer_t *peerP, size_t length) {
+    mmsg_transport_t *transportP;
+    unsigned int slot;
+
+    if (peerP == NULL) {
+        fprintf(stderr, "#> failed sending %lu bytes, missing connection\r\n", length);
+        return NULL;
+    }
+    if (length > LWM2M_MMSG_PACKET_SIZE) {
+        fprintf(stderr, "#> failed sending %lu bytes, datagram too large\r\n", length);
+        return NULL;
+    }
+
+    transportP = peerP->transportP;
+    if (transportP->txCount == transportP->batchSize && mmsg_transport_flush(transportP) < 0) {
+        return NULL;
+    }
+
+    slot = transportP->txCount++;
+    transportP->txIov[slot].iov_base = transportP->txBuffer[slot];
+    transportP->txIov[slot].iov_len = length;
+    memset(&transportP->txMsg[slot], 0, sizeof(struct mmsghdr));
+    memcpy(&transportP->txAddr[slot], &peerP->addr, peerP->addrLen);
+    transportP->txMsg[slot].msg_hdr.msg_name = &transportP->txAddr[slot];
+    transportP->txMsg[slot].msg_hdr.msg_namelen = peerP->addrLen;
+    transportP->txMsg[slot].msg_hdr.msg_iov = &transportP->txIov[slot];
+    transportP->txMsg[slot].msg_hdr.msg_iovlen = 1;
+
+    return transportP->txBuffer[slot];
+}
+
+uint8_t lwm2m_buffer_send(void *sessionH, uint8_t *buffer, size_t length, void *userdata) {
+    uint8_t *slotBuffer;
+
+    (void)userdata; /* unused */
+
+    // liblwm2m may release the buffer as soon as we return
+    slotBuffer = prv_queue_datagram((mmsg_peer_t *)sessionH, length);
+    if (slotBuffer == NULL) {
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+    memcpy(slotBuffer, buffer, length);
+
+    return COAP_NO_ERROR;
+}
+
+#ifdef LWM2M_VECTORED_SEND
+uint8_t lwm2m_buffer_sendv(void *sessionH, lwm2m_iovec_t *iov, size_t iovCount, void *userdata) {
+    uint8_t *slotBuffer;
+    size_t length;
+    size_t i;
+
+    (void)userdata; /* unused */
+
+    length = 0;
+    for (i = 0; i < iovCount; i++) {
+        length += iov[i].length;
+    }
+
+    // gathered straight into the transmit batch
+    slotBuffer = prv_queue_datagram((mmsg_peer_t *)sessionH, length);
+    if (slotBuffer == NULL) {
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+    for (i = 0; i < iovCount; i++) {
+        memcpy(slotBuffer, iov[i].base, iov[i].length);
+        slotBuffer += iov[i].length;
+    }
+
+    return COAP_NO_ERROR;
+}
+#endif
+
+bool lwm2m_session_is_equal(void *session1, void *session2, void *userData) {
+    (void)userData; /* unused */
+
+    return (session1 == session2);
+}
+
+#endif
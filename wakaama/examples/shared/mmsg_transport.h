@@ -0,0 +1,107 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Eclipse Foundation and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v2.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v20.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Batched UDP transport for Linux hosts.
+ *
+ * This replaces connection.c, which relies on the Nanostack socket API, when
+ * the stack runs on a Linux host as a server or a gateway. Datagrams are read
+ * with recvmmsg() and handed to lwm2m_handle_packet() one batch at a time,
+ * while the datagrams given to lwm2m_buffer_send() are queued and written with
+ * sendmmsg() by mmsg_transport_flush().
+ *
+ * Typical loop:
+ *
+ *     mmsg_transport_receive(transportP, timeout * 1000);
+ *     lwm2m_step(contextP, &timeout);
+ *     mmsg_transport_flush(transportP);
+ */
+
+#ifndef MMSG_TRANSPORT_H_
+#define MMSG_TRANSPORT_H_
+
+#if defined(__linux__) && defined(LWM2M_MMSG_TRANSPORT)
+
+// recvmmsg() and sendmmsg() are GNU extensions: include this header first
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <liblwm2m.h>
+#include <sys/socket.h>
+
+#ifndef LWM2M_MMSG_BATCH_SIZE
+#define LWM2M_MMSG_BATCH_SIZE 32
+#endif
+
+#ifndef LWM2M_MMSG_PACKET_SIZE
+#define LWM2M_MMSG_PACKET_SIZE 2048
+#endif
+
+// beyond this, a new peer replaces the one idle for the longest time that the context no longer refers to
+#ifndef LWM2M_MMSG_MAX_PEERS
+#define LWM2M_MMSG_MAX_PEERS 1024
+#endif
+
+struct _mmsg_transport_t;
+
+// session handle given to liblwm2m
+typedef struct _mmsg_peer_t {
+    struct _mmsg_peer_t *next;
+    struct _mmsg_transport_t *transportP;
+    struct sockaddr_storage addr;
+    socklen_t addrLen;
+    time_t lastSeen;
+} mmsg_peer_t;
+
+typedef struct _mmsg_transport_t {
+    int sock;
+    lwm2m_context_t *ctx;
+    mmsg_peer_t *peerList;
+    unsigned int peerCount;
+    unsigned int batchSize; // datagrams per recvmmsg() and sendmmsg(), at most LWM2M_MMSG_BATCH_SIZE
+    struct mmsghdr rxMsg[LWM2M_MMSG_BATCH_SIZE];
+    struct iovec rxIov[LWM2M_MMSG_BATCH_SIZE];
+    struct sockaddr_storage rxAddr[LWM2M_MMSG_BATCH_SIZE];
+    uint8_t rxBuffer[LWM2M_MMSG_BATCH_SIZE][LWM2M_MMSG_PACKET_SIZE];
+    unsigned int txCount;
+    struct mmsghdr txMsg[LWM2M_MMSG_BATCH_SIZE];
+    struct iovec txIov[LWM2M_MMSG_BATCH_SIZE];
+    struct sockaddr_storage txAddr[LWM2M_MMSG_BATCH_SIZE]; // a queued datagram outlives an evicted peer
+    uint8_t txBuffer[LWM2M_MMSG_BATCH_SIZE][LWM2M_MMSG_PACKET_SIZE];
+} mmsg_transport_t;
+
+// open a UDP socket bound to port; addressFamily is AF_INET or AF_INET6
+mmsg_transport_t *mmsg_transport_open(lwm2m_context_t *contextP, const char *port, int addressFamily);
+void mmsg_transport_close(mmsg_transport_t *transportP);
+
+// datagrams read and written per system call, from 1 to LWM2M_MMSG_BATCH_SIZE (the default).
+// Returns 0 on success.
+int mmsg_transport_set_batch_size(mmsg_transport_t *transportP, unsigned int batchSize);
+
+// peer to use as the session of lwm2m_connect_server() or of the security object
+mmsg_peer_t *mmsg_transport_connect(mmsg_transport_t *transportP, const char *host, const char *port);
+
+// wait up to timeoutMs for datagrams, then hand everything available to liblwm2m and flush the responses.
+// Returns the number of datagrams processed or -1 on error.
+int mmsg_transport_receive(mmsg_transport_t *transportP, int timeoutMs);
+
+// send the queued datagrams. Returns the number of datagrams sent or -1 on error.
+int mmsg_transport_flush(mmsg_transport_t *transportP);
+
+#endif
+
+#endif
@@ -70,10 +70,40 @@ int object_get_opaque(lwm2m_context_t *clientCtx, uint16_t objId, uint16_t insta
     uint8_t coapRet = obj->readFunc(clientCtx, instanceId, &numData, &data, obj);
     if (coapRet == COAP_205_CONTENT) {
         if (data->type == LWM2M_TYPE_OPAQUE || data->type == LWM2M_TYPE_STRING) {
-            *value = data->value.asBuffer.buffer;
+            // copied rather than taken over: the buffer may belong to the data arena of the current request
             *len = data->value.asBuffer.length;
-            data->value.asBuffer.buffer = NULL;
-            data->value.asBuffer.length = 0;
+            *value = NULL;
+            if (*len > 0) {
+                *value = (uint8_t *)lwm2m_malloc(*len);
+                if (*value != NULL) {
+                    memcpy(*value, data->value.asBuffer.buffer, *len);
+                }
+            }
+            ret = (*len == 0 || *value != NULL) ? 1 : 0;
+        }
+    }
+    lwm2m_data_free(1, data);
+    return ret;
+}
+
+int object_get_objlink(lwm2m_context_t *clientCtx, uint16_t objId, uint16_t instanceId, uint16_t resourceId,
+                       uint16_t *linkObjId, uint16_t *linkInstanceId) {
+    lwm2m_object_t *obj = (lwm2m_object_t *)LWM2M_LIST_FIND(clientCtx->objectList, objId);
+    int ret = 0;
+    if (obj == NULL) {
+        return 0;
+    }
+    int numData = 1;
+    lwm2m_data_t *data = lwm2m_data_new(1);
+    if (data == NULL) {
+        return 0;
+    }
+    data->id = resourceId;
+    uint8_t coapRet = obj->readFunc(clientCtx, instanceId, &numData, &data, obj);
+    if (coapRet == COAP_205_CONTENT) {
+        if (data->type == LWM2M_TYPE_OBJECT_LINK) {
+            *linkObjId = data->value.asObjLink.objectId;
+            *linkInstanceId = data->value.asObjLink.objectInstanceId;
             ret = 1;
         }
     }
@@ -95,4 +125,15 @@ int security_get_security_mode(lwm2m_context_t *clientCtx, uint16_t securityInst
     return object_get_int(clientCtx, LWM2M_SECURITY_OBJECT_ID, securityInstanceId, LWM2M_SECURITY_SECURITY_ID, mode);
 }
 
+int security_get_oscore_instance(lwm2m_context_t *clientCtx, uint16_t securityInstanceId, uint16_t *oscoreInstanceId) {
+    uint16_t objId;
+
+    if (object_get_objlink(clientCtx, LWM2M_SECURITY_OBJECT_ID, securityInstanceId, LWM2M_SECURITY_OSCORE_ID, &objId,
+                           oscoreInstanceId) != 1) {
+        return 0;
+    }
+    // an unset link reads as 65535:65535
+    return objId == LWM2M_OSCORE_OBJECT_ID && *oscoreInstanceId != LWM2M_MAX_ID;
+}
+
 #endif
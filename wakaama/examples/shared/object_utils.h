@@ -10,10 +10,14 @@ int object_get_int(lwm2m_context_t *clientCtx, uint16_t objId, uint16_t instance
 int object_get_str(lwm2m_context_t *clientCtx, uint16_t objId, uint16_t instanceId, uint16_t resourceId, char **value);
 int object_get_opaque(lwm2m_context_t *clientCtx, uint16_t objId, uint16_t instanceId, uint16_t resourceId,
                       uint8_t **value, size_t *len);
+int object_get_objlink(lwm2m_context_t *clientCtx, uint16_t objId, uint16_t instanceId, uint16_t resourceId,
+                       uint16_t *linkObjId, uint16_t *linkInstanceId);
 
 int security_get_psk_identity(lwm2m_context_t *clientCtx, uint16_t securityInstanceId, uint8_t **pskId, size_t *len);
 int security_get_psk(lwm2m_context_t *clientCtx, uint16_t securityInstanceId, uint8_t **psk, size_t *len);
 int security_get_security_mode(lwm2m_context_t *clientCtx, uint16_t securityInstanceId, int *mode);
+// instance of the OSCORE object linked by the security instance, returns 0 when there is none
+int security_get_oscore_instance(lwm2m_context_t *clientCtx, uint16_t securityInstanceId, uint16_t *oscoreInstanceId);
 
 #endif
 
@@ -0,0 +1,918 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Eclipse Foundation and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v2.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v20.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "oscoreconnection.h"
+
+#if defined LWM2M_CLIENT_MODE && defined LWM2M_SUPPORT_OSCORE
+#include "er-coap-13/er-coap-13.h"
+#include "mbedtls/ccm.h"
+#include "mbedtls/hkdf.h"
+#include "mbedtls/md.h"
+#include "mbedtls/platform_util.h"
+#include "object_utils.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define OSCORE_ALG_AES_CCM_16_64_128 10
+#define OSCORE_ALG_HKDF_SHA_256 -10
+#define OSCORE_ALG_HMAC_256_256 5
+
+#define OSCORE_KEY_LEN 16
+#define OSCORE_NONCE_LEN 13
+#define OSCORE_TAG_LEN 8
+#define OSCORE_MAX_ID_LEN (OSCORE_NONCE_LEN - 6)
+#define OSCORE_MAX_PIV_LEN 5
+#define OSCORE_MAX_SSN ((((uint64_t)1) << 40) - 1)
+#define OSCORE_REPLAY_WINDOW 32
+
+#ifndef OSCORE_MAX_ID_CONTEXT_LEN
+#define OSCORE_MAX_ID_CONTEXT_LEN 16
+#endif
+
+#ifndef OSCORE_EXCHANGE_COUNT
+#define OSCORE_EXCHANGE_COUNT 4 // requests remembered in each direction to protect or verify their responses
+#endif
+
+#define OSCORE_MAX_OPTION_LEN (1 + OSCORE_MAX_PIV_LEN + 1 + OSCORE_MAX_ID_CONTEXT_LEN + OSCORE_MAX_ID_LEN)
+#define OSCORE_MAX_AAD_LEN 48
+#define OSCORE_MAX_INFO_LEN (16 + OSCORE_MAX_ID_LEN + OSCORE_MAX_ID_CONTEXT_LEN)
+
+#define OSCORE_FLAG_KID 0x08
+#define OSCORE_FLAG_KID_CONTEXT 0x10
+#define OSCORE_FLAG_PIV_MASK 0x07
+
+// a request and the Partial IV protecting it, needed by its responses
+typedef struct {
+    bool valid;
+    bool observe;        // observation in progress, keep as long as possible
+    bool notified;       // lastNotification is set
+    uint32_t age;
+    uint16_t mid;
+    uint8_t tokenLen;
+    uint8_t token[COAP_TOKEN_LEN];
+    uint8_t pivLen;
+    uint8_t piv[OSCORE_MAX_PIV_LEN];
+    uint64_t lastNotification;
+} oscoreexchange_t;
+
+typedef struct _oscoreconnection_t {
+    connection_t conn;
+    connection_send_func_t plainSend;
+    uint16_t oscoreInstance;
+    uint8_t senderId[OSCORE_MAX_ID_LEN];
+    size_t senderIdLen;
+    uint8_t recipientId[OSCORE_MAX_ID_LEN];
+    size_t recipientIdLen;
+    uint8_t idContext[OSCORE_MAX_ID_CONTEXT_LEN];
+    size_t idContextLen;
+    uint8_t commonIv[OSCORE_NONCE_LEN];
+    mbedtls_ccm_context senderCcm;
+    mbedtls_ccm_context recipientCcm;
+    oscoreconnection_ssn_storage_t const *ssnStorage;
+    uint64_t ssn;
+    uint64_t ssnLimit; // first Sender Sequence Number not reserved in the storage
+    bool replayInit;
+    uint8_t echoLen;
+    uint8_t echo[OSCORE_MAX_PIV_LEN]; // value requests must echo before the replay window is initialized
+    uint64_t replayMax;
+    uint32_t replayWindow;
+    uint32_t exchangeAge;
+    oscoreexchange_t sent[OSCORE_EXCHANGE_COUNT];
+    oscoreexchange_t received[OSCORE_EXCHANGE_COUNT];
+} oscoreconnection_t;
+
+void oscoreconnection_set_ssn_storage(lwm2m_connection_layer_t *connLayerP,
+                                      oscoreconnection_ssn_storage_t const *storageP) {
+    connLayerP->ssnStorage = storageP;
+}
+
+static size_t oscoreconnection_cbor_bstr(uint8_t *buffer, uint8_t const *data, size_t length) {
+    size_t offset = 0;
+
+    if (length < 24) {
+        buffer[offset++] = 0x40 | (uint8_t)length;
+    } else {
+        buffer[offset++] = 0x58;
+        buffer[offset++] = (uint8_t)length;
+    }
+    if (length != 0) {
+        memcpy(buffer + offset, data, length);
+    }
+    return offset + length;
+}
+
+// Partial IVs are the sequence numbers in network byte order without leading zeroes
+static size_t oscoreconnection_piv_encode(uint64_t seq, uint8_t *piv) {
+    size_t length = 1;
+    size_t i;
+
+    while (length < OSCORE_MAX_PIV_LEN && (seq >> (8 * length)) != 0) {
+        length++;
+    }
+    for (i = 0; i < length; i++) {
+        piv[i] = (uint8_t)(seq >> (8 * (length - 1 - i)));
+    }
+    return length;
+}
+
+static uint64_t oscoreconnection_piv_decode(uint8_t const *piv, size_t length) {
+    uint64_t seq = 0;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        seq = (seq << 8) | piv[i];
+    }
+    return seq;
+}
+
+// RFC 8613 section 3.2.1: info = [id, id_context, alg_aead, type, L]
+static int oscoreconnection_derive(oscoreconnection_t *oscoreConn, uint8_t const *secret, size_t secretLen,
+                                   uint8_t const *salt, size_t saltLen, uint8_t const *id, size_t idLen, bool iv,
+                                   uint8_t *out, size_t outLen) {
+    uint8_t info[OSCORE_MAX_INFO_LEN];
+    size_t infoLen = 0;
+
+    info[infoLen++] = 0x85;
+    infoLen += oscoreconnection_cbor_bstr(info + infoLen, id, idLen);
+    if (oscoreConn->idContextLen != 0) {
+        infoLen += oscoreconnection_cbor_bstr(info + infoLen, oscoreConn->idContext, oscoreConn->idContextLen);
+    } else {
+        info[infoLen++] = 0xF6; // nil
+    }
+    info[infoLen++] = OSCORE_ALG_AES_CCM_16_64_128;
+    if (iv) {
+        info[infoLen++] = 0x62;
+        info[infoLen++] = 'I';
+        info[infoLen++] = 'V';
+    } else {
+        info[infoLen++] = 0x63;
+        info[infoLen++] = 'K';
+        info[infoLen++] = 'e';
+        info[infoLen++] = 'y';
+    }
+    info[infoLen++] = (uint8_t)outLen;
+
+    return mbedtls_hkdf(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), salt, saltLen, secret, secretLen, info, infoLen,
+                        out, outLen);
+}
+
+// RFC 8613 section 5.2: the ID and the Partial IV of the nonce owner, left-padded, XORed with the Common IV
+static void oscoreconnection_nonce(oscoreconnection_t *oscoreConn, uint8_t const *id, size_t idLen,
+                                   uint8_t const *piv, size_t pivLen, uint8_t *nonce) {
+    int i;
+
+    memset(nonce, 0, OSCORE_NONCE_LEN);
+    nonce[0] = (uint8_t)idLen;
+    memcpy(nonce + 1 + OSCORE_MAX_ID_LEN - idLen, id, idLen);
+    memcpy(nonce + OSCORE_NONCE_LEN - pivLen, piv, pivLen);
+    for (i = 0; i < OSCORE_NONCE_LEN; i++) {
+        nonce[i] ^= oscoreConn->commonIv[i];
+    }
+}
+
+// RFC 8613 section 5.4: Enc_structure = ["Encrypt0", h'', external_aad], always bound to the request
+static size_t oscoreconnection_aad(uint8_t const *requestKid, size_t kidLen, uint8_t const *requestPiv,
+                                   size_t pivLen, uint8_t *aad) {
+    uint8_t external[OSCORE_MAX_AAD_LEN];
+    size_t externalLen = 0;
+    size_t aadLen = 0;
+
+    external[externalLen++] = 0x85;
+    external[externalLen++] = 0x01; // oscore_version
+    external[externalLen++] = 0x81;
+    external[externalLen++] = OSCORE_ALG_AES_CCM_16_64_128;
+    externalLen += oscoreconnection_cbor_bstr(external + externalLen, requestKid, kidLen);
+    externalLen += oscoreconnection_cbor_bstr(external + externalLen, requestPiv, pivLen);
+    external[externalLen++] = 0x40; // no Class I option
+
+    aad[aadLen++] = 0x83;
+    aad[aadLen++] = 0x68;
+    memcpy(aad + aadLen, "Encrypt0", 8);
+    aadLen += 8;
+    aad[aadLen++] = 0x40;
+    aadLen += oscoreconnection_cbor_bstr(aad + aadLen, external, externalLen);
+
+    return aadLen;
+}
+
+static oscoreexchange_t *oscoreexchange_find(oscoreexchange_t *exchanges, uint8_t const *token, uint8_t tokenLen) {
+    int i;
+
+    for (i = 0; i < OSCORE_EXCHANGE_COUNT; i++) {
+        if (exchanges[i].valid && exchanges[i].tokenLen == tokenLen &&
+            memcmp(exchanges[i].token, token, tokenLen) == 0) {
+            return exchanges + i;
+        }
+    }
+    return NULL;
+}
+
+// replace the oldest exchange, observations last
+static oscoreexchange_t *oscoreexchange_new(oscoreconnection_t *oscoreConn, oscoreexchange_t *exchanges,
+                                            uint8_t const *token, uint8_t tokenLen) {
+    oscoreexchange_t *targetP = NULL;
+    int i;
+
+    for (i = 0; i < OSCORE_EXCHANGE_COUNT; i++) {
+        oscoreexchange_t *exchangeP = exchanges + i;
+
+        if (!exchangeP->valid) {
+            targetP = exchangeP;
+            break;
+        }
+        if (targetP == NULL || (targetP->observe && !exchangeP->observe) ||
+            (targetP->observe == exchangeP->observe && exchangeP->age < targetP->age)) {
+            targetP = exchangeP;
+        }
+    }
+
+    memset(targetP, 0, sizeof(oscoreexchange_t));
+    targetP->valid = true;
+    targetP->age = ++oscoreConn->exchangeAge;
+    targetP->tokenLen = tokenLen;
+    memcpy(targetP->token, token, tokenLen);
+
+    return targetP;
+}
+
+// take the next Sender Sequence Number, reserving a new block in the storage first when needed
+static int oscoreconnection_next_piv(oscoreconnection_t *oscoreConn, uint8_t *piv, size_t *pivLen) {
+    if (oscoreConn->ssn > OSCORE_MAX_SSN) {
+        printf("OSCORE sender sequence numbers exhausted, a new security context is required\n");
+        return -1;
+    }
+    if (oscoreConn->ssn >= oscoreConn->ssnLimit) {
+        oscoreconnection_ssn_storage_t const *storageP = oscoreConn->ssnStorage;
+
+        if (storageP->storeFunc(oscoreConn->oscoreInstance, oscoreConn->ssn + OSCORE_SSN_BLOCK, storageP->userData) !=
+            0) {
+            printf("Failed to store the OSCORE sender sequence number\n");
+            return -1;
+        }
+        oscoreConn->ssnLimit = oscoreConn->ssn + OSCORE_SSN_BLOCK;
+    }
+
+    *pivLen = oscoreconnection_piv_encode(oscoreConn->ssn, piv);
+    oscoreConn->ssn++;
+    return 0;
+}
+
+static bool oscoreconnection_replay_check(oscoreconnection_t *oscoreConn, uint64_t seq) {
+    uint64_t delta;
+
+    if (!oscoreConn->replayInit || seq > oscoreConn->replayMax) {
+        return true;
+    }
+    delta = oscoreConn->replayMax - seq;
+    return delta < OSCORE_REPLAY_WINDOW && (oscoreConn->replayWindow & ((uint32_t)1 << delta)) == 0;
+}
+
+static void oscoreconnection_replay_update(oscoreconnection_t *oscoreConn, uint64_t seq) {
+    if (!oscoreConn->replayInit) {
+        // the request echoing the value is the oldest one accepted, the older ones may be replays
+        oscoreConn->replayInit = true;
+        oscoreConn->replayMax = seq;
+        oscoreConn->replayWindow = UINT32_MAX;
+    } else if (seq > oscoreConn->replayMax) {
+        uint64_t shift = seq - oscoreConn->replayMax;
+
+        oscoreConn->replayWindow = shift >= OSCORE_REPLAY_WINDOW ? 0 : oscoreConn->replayWindow << shift;
+        oscoreConn->replayWindow |= 1;
+        oscoreConn->replayMax = seq;
+    } else {
+        oscoreConn->replayWindow |= (uint32_t)1 << (oscoreConn->replayMax - seq);
+    }
+}
+
+// RFC 8613 section 6.1: flags, Partial IV, kid context and kid
+static size_t oscoreconnection_option_encode(uint8_t const *piv, size_t pivLen, uint8_t const *kidContext,
+                                             size_t kidContextLen, uint8_t const *kid, size_t kidLen, bool withKid,
+                                             uint8_t *option) {
+    size_t length = 1;
+
+    option[0] = (uint8_t)pivLen;
+    memcpy(option + length, piv, pivLen);
+    length += pivLen;
+    if (kidContextLen != 0) {
+        option[0] |= OSCORE_FLAG_KID_CONTEXT;
+        option[length++] = (uint8_t)kidContextLen;
+        memcpy(option + length, kidContext, kidContextLen);
+        length += kidContextLen;
+    }
+    if (withKid) {
+        option[0] |= OSCORE_FLAG_KID;
+        memcpy(option + length, kid, kidLen);
+        length += kidLen;
+    }
+    return length;
+}
+
+static int oscoreconnection_option_decode(uint8_t const *option, size_t length, uint8_t const **piv, size_t *pivLen,
+                                          uint8_t const **kid, size_t *kidLen, bool *withKid) {
+    size_t offset = 1;
+
+    *pivLen = 0;
+    *kidLen = 0;
+    *withKid = false;
+    if (length == 0) {
+        return 0;
+    }
+    if ((option[0] & 0xE0) != 0) {
+        return -1; // reserved flags
+    }
+
+    *pivLen = option[0] & OSCORE_FLAG_PIV_MASK;
+    if (*pivLen > OSCORE_MAX_PIV_LEN || offset + *pivLen > length) {
+        return -1;
+    }
+    *piv = option + offset;
+    offset += *pivLen;
+
+    if (option[0] & OSCORE_FLAG_KID_CONTEXT) {
+        // only one context is configured, its value is not checked
+        if (offset >= length || offset + 1 + option[offset] > length) {
+            return -1;
+        }
+        offset += 1 + option[offset];
+    }
+    if (option[0] & OSCORE_FLAG_KID) {
+        *withKid = true;
+        *kid = option + offset;
+        *kidLen = length - offset;
+    } else if (offset != length) {
+        return -1;
+    }
+    return 0;
+}
+
+// RFC 8613 section 8.2: answer unverifiable requests with an unprotected error
+static void oscoreconnection_reject(oscoreconnection_t *oscoreConn, coap_packet_t *request, uint8_t code,
+                                    const char *diagnostic) {
+    coap_packet_t response[1];
+    uint8_t buffer[COAP_HEADER_LEN + COAP_TOKEN_LEN + 8 + 32];
+    size_t length;
+
+    printf("OSCORE request rejected: %s\n", diagnostic);
+    if (request->type != COAP_TYPE_CON) {
+        return;
+    }
+
+    coap_init_message(response, COAP_TYPE_ACK, code, request->mid);
+    coap_set_header_token(response, request->token, request->token_len);
+    coap_set_header_max_age(response, 0);
+    coap_set_payload(response, diagnostic, strlen(diagnostic));
+    length = coap_serialize_message(response, buffer);
+    oscoreConn->plainSend(buffer, length, oscoreConn);
+}
+
+static int oscoreconnection_send(uint8_t const *buffer, size_t len, void *conn) {
+    oscoreconnection_t *oscoreConn = (oscoreconnection_t *)conn;
+    coap_packet_t message[1];
+    coap_packet_t outer[1];
+    oscoreexchange_t *exchangeP;
+    uint8_t piv[OSCORE_MAX_PIV_LEN];
+    size_t pivLen;
+    uint8_t option[OSCORE_MAX_OPTION_LEN];
+    size_t optionLen;
+    uint8_t nonce[OSCORE_NONCE_LEN];
+    uint8_t aad[OSCORE_MAX_AAD_LEN];
+    size_t aadLen;
+    uint8_t *plain;
+    size_t plainLen;
+    uint8_t *out;
+    size_t outLen;
+    bool isRequest;
+    bool hasObserve;
+    bool hasUriHost;
+    bool hasUriPort;
+    size_t offset;
+    int ret;
+
+    // the buffer is only read: liblwm2m does not send Location-Query, the only option parsed in place
+    if (coap_parse_message(message, (uint8_t *)buffer, (uint16_t)len) != NO_ERROR) {
+        return -1;
+    }
+    if (message->code == 0) {
+        // empty ACK and RST are never protected
+        coap_free_header(message);
+        return oscoreConn->plainSend(buffer, len, conn);
+    }
+    isRequest = message->code >= COAP_GET && message->code <= COAP_IPATCH;
+    hasObserve = IS_OPTION(message, COAP_OPTION_OBSERVE) != 0;
+    hasUriHost = IS_OPTION(message, COAP_OPTION_URI_HOST) != 0;
+    hasUriPort = IS_OPTION(message, COAP_OPTION_URI_PORT) != 0;
+
+    if (isRequest) {
+        exchangeP = oscoreexchange_find(oscoreConn->sent, message->token, message->token_len);
+        if (exchangeP == NULL || exchangeP->mid != message->mid) {
+            if (exchangeP == NULL) {
+                exchangeP = oscoreexchange_new(oscoreConn, oscoreConn->sent, message->token, message->token_len);
+            }
+            pivLen = 0;
+            if (oscoreconnection_next_piv(oscoreConn, exchangeP->piv, &pivLen) != 0) {
+                exchangeP->valid = false;
+                coap_free_header(message);
+                return -1;
+            }
+            exchangeP->pivLen = (uint8_t)pivLen;
+            exchangeP->mid = message->mid;
+            exchangeP->notified = false;
+            exchangeP->age = ++oscoreConn->exchangeAge;
+        }
+        // a retransmission keeps its Partial IV: same nonce, same plaintext, same ciphertext
+        memcpy(piv, exchangeP->piv, exchangeP->pivLen);
+        pivLen = exchangeP->pivLen;
+        oscoreconnection_nonce(oscoreConn, oscoreConn->senderId, oscoreConn->senderIdLen, piv, pivLen, nonce);
+        aadLen = oscoreconnection_aad(oscoreConn->senderId, oscoreConn->senderIdLen, piv, pivLen, aad);
+        optionLen = oscoreconnection_option_encode(piv, pivLen, oscoreConn->idContext, oscoreConn->idContextLen,
+                                                   oscoreConn->senderId, oscoreConn->senderIdLen, true, option);
+    } else {
+        exchangeP = oscoreexchange_find(oscoreConn->received, message->token, message->token_len);
+        if (exchangeP == NULL) {
+            printf("No OSCORE request matches the response, dropped\n");
+            coap_free_header(message);
+            return -1;
+        }
+        // every response carries its own Partial IV, so notifications and retransmissions get fresh nonces
+        if (oscoreconnection_next_piv(oscoreConn, piv, &pivLen) != 0) {
+            coap_free_header(message);
+            return -1;
+        }
+        oscoreconnection_nonce(oscoreConn, oscoreConn->senderId, oscoreConn->senderIdLen, piv, pivLen, nonce);
+        aadLen = oscoreconnection_aad(oscoreConn->recipientId, oscoreConn->recipientIdLen, exchangeP->piv,
+                                      exchangeP->pivLen, aad);
+        optionLen = oscoreconnection_option_encode(piv, pivLen, NULL, 0, NULL, 0, false, option);
+    }
+
+    // Class U options stay outside, everything else is encrypted
+    message->options[COAP_OPTION_URI_HOST / OPTION_MAP_SIZE] &= ~(1 << (COAP_OPTION_URI_HOST % OPTION_MAP_SIZE));
+    message->options[COAP_OPTION_URI_PORT / OPTION_MAP_SIZE] &= ~(1 << (COAP_OPTION_URI_PORT % OPTION_MAP_SIZE));
+    message->options[COAP_OPTION_PROXY_URI / OPTION_MAP_SIZE] &= ~(1 << (COAP_OPTION_PROXY_URI % OPTION_MAP_SIZE));
+
+    plain = (uint8_t *)lwm2m_malloc(coap_serialize_get_size(message) + OSCORE_TAG_LEN);
+    if (plain == NULL) {
+        coap_free_header(message);
+        return -1;
+    }
+    // the plaintext is the code followed by the serialized options and payload: write the code over
+    // the byte preceding the options
+    offset = COAP_HEADER_LEN - 1 + message->token_len;
+    plainLen = coap_serialize_message(message, plain) - offset;
+    plain[offset] = message->code;
+
+    ret = mbedtls_ccm_encrypt_and_tag(&oscoreConn->senderCcm, plainLen, nonce, OSCORE_NONCE_LEN, aad, aadLen,
+                                      plain + offset, plain + offset, plain + offset + plainLen, OSCORE_TAG_LEN);
+    if (ret != 0) {
+        ret = -1;
+        goto exit;
+    }
+
+    if (isRequest) {
+        coap_init_message(outer, message->type, hasObserve ? COAP_FETCH : COAP_POST, message->mid);
+    } else {
+        coap_init_message(outer, message->type, hasObserve ? COAP_205_CONTENT : COAP_204_CHANGED, message->mid);
+    }
+    coap_set_header_token(outer, message->token, message->token_len);
+    if (hasUriHost) {
+        outer->uri_host = message->uri_host;
+        outer->uri_host_len = message->uri_host_len;
+        SET_OPTION(outer, COAP_OPTION_URI_HOST);
+    }
+    if (hasUriPort) {
+        coap_set_header_uri_port(outer, message->uri_port);
+    }
+    if (hasObserve) {
+        coap_set_header_observe(outer, message->observe);
+    }
+    coap_set_header_oscore(outer, option, optionLen);
+    coap_set_payload(outer, plain + offset, plainLen + OSCORE_TAG_LEN);
+
+    out = (uint8_t *)lwm2m_malloc(coap_serialize_get_size(outer));
+    if (out == NULL) {
+        ret = -1;
+        goto exit;
+    }
+    outLen = coap_serialize_message(outer, out);
+    ret = oscoreConn->plainSend(out, outLen, conn);
+    lwm2m_free(out);
+
+exit:
+    // the outer message points to the Uri-Host of the inner one, released last
+    coap_free_header(message);
+    lwm2m_free(plain);
+    return ret;
+}
+
+// RFC 8613 appendix B.1.2: the replay window is lost at reboot, so any Partial IV may be a replay. A
+// verified request is only fresh once it carries the Echo value sent in a protected 4.01 (RFC 9175).
+static bool oscoreconnection_echo_verified(oscoreconnection_t *oscoreConn, uint8_t *buffer, size_t length) {
+    coap_packet_t inner[1];
+    uint8_t const *echo;
+    int echoLen;
+    bool verified;
+
+    if (oscoreConn->echoLen == 0 || coap_parse_message(inner, buffer, (uint16_t)length) != NO_ERROR) {
+        return false;
+    }
+    echoLen = coap_get_header_echo(inner, &echo);
+    verified = echoLen == oscoreConn->echoLen && memcmp(echo, oscoreConn->echo, echoLen) == 0;
+    coap_free_header(inner);
+    return verified;
+}
+
+static void oscoreconnection_challenge(oscoreconnection_t *oscoreConn, coap_packet_t *request) {
+    coap_packet_t response[1];
+    uint8_t buffer[COAP_HEADER_LEN + COAP_TOKEN_LEN + COAP_MAX_OPTION_HEADER_LEN + OSCORE_MAX_PIV_LEN];
+    size_t length;
+
+    if (oscoreConn->echoLen == 0) {
+        // the next Sender Sequence Number: persisted, it was never sent before, even before a reboot
+        oscoreConn->echoLen = (uint8_t)oscoreconnection_piv_encode(oscoreConn->ssn, oscoreConn->echo);
+    }
+    printf("OSCORE replay window not initialized, request answered with Echo\n");
+
+    coap_init_message(response, request->type == COAP_TYPE_CON ? COAP_TYPE_ACK : COAP_TYPE_NON,
+                      COAP_401_UNAUTHORIZED, request->mid);
+    coap_set_header_token(response, request->token, request->token_len);
+    coap_set_header_echo(response, oscoreConn->echo, oscoreConn->echoLen);
+    length = coap_serialize_message(response, buffer);
+    // protected like any response, the Echo option is encrypted
+    oscoreconnection_send(buffer, length, oscoreConn);
+}
+
+// hand the decrypted message to liblwm2m, with the Outer Observe of notifications
+static void oscoreconnection_deliver(lwm2m_context_t *context, oscoreconnection_t *oscoreConn, uint8_t *buffer,
+                                     size_t length, coap_packet_t *outer, bool isRequest) {
+    coap_packet_t inner[1];
+    uint8_t *fixed;
+
+    if (isRequest || !IS_OPTION(outer, COAP_OPTION_OBSERVE)) {
+        lwm2m_handle_packet(context, buffer, length, oscoreConn);
+        return;
+    }
+
+    if (coap_parse_message(inner, buffer, (uint16_t)length) != NO_ERROR) {
+        return;
+    }
+    if (IS_OPTION(inner, COAP_OPTION_OBSERVE) && inner->observe == outer->observe) {
+        coap_free_header(inner);
+        lwm2m_handle_packet(context, buffer, length, oscoreConn);
+        return;
+    }
+    coap_set_header_observe(inner, outer->observe);
+    fixed = (uint8_t *)lwm2m_malloc(coap_serialize_get_size(inner));
+    if (fixed == NULL) {
+        coap_free_header(inner);
+        return;
+    }
+    length = coap_serialize_message(inner, fixed);
+    lwm2m_handle_packet(context, fixed, length, oscoreConn);
+    lwm2m_free(fixed);
+}
+
+static int oscoreconnection_recv(lwm2m_context_t *context, uint8_t *buffer, size_t len, void *conn) {
+    oscoreconnection_t *oscoreConn = (oscoreconnection_t *)conn;
+    coap_packet_t outer[1];
+    oscoreexchange_t *exchangeP;
+    uint8_t const *option;
+    int optionLen;
+    uint8_t const *piv = NULL;
+    size_t pivLen;
+    uint8_t const *kid = NULL;
+    size_t kidLen;
+    bool withKid;
+    uint64_t seq;
+    uint8_t nonce[OSCORE_NONCE_LEN];
+    uint8_t aad[OSCORE_MAX_AAD_LEN];
+    size_t aadLen;
+    uint8_t *inner;
+    size_t offset;
+    size_t plainLen;
+    bool isRequest;
+    bool retransmission;
+
+    if (coap_parse_message(outer, buffer, (uint16_t)len) != NO_ERROR) {
+        return 0;
+    }
+    if (outer->code == 0) {
+        coap_free_header(outer);
+        lwm2m_handle_packet(context, buffer, len, conn);
+        return (int)len;
+    }
+    isRequest = outer->code >= COAP_GET && outer->code <= COAP_IPATCH;
+
+    optionLen = coap_get_header_oscore(outer, &option);
+    if (optionLen < 0) {
+        if (isRequest) {
+            oscoreconnection_reject(oscoreConn, outer, COAP_401_UNAUTHORIZED, "OSCORE required");
+        } else {
+            printf("Unprotected response %u.%02u dropped\n", outer->code >> 5, outer->code & 0x1F);
+        }
+        coap_free_header(outer);
+        return 0;
+    }
+    if (oscoreconnection_option_decode(option, (size_t)optionLen, &piv, &pivLen, &kid, &kidLen, &withKid) != 0 ||
+        outer->payload_len <= OSCORE_TAG_LEN) {
+        if (isRequest) {
+            oscoreconnection_reject(oscoreConn, outer, COAP_402_BAD_OPTION, "Failed to decode COSE");
+        }
+        coap_free_header(outer);
+        return 0;
+    }
+    seq = oscoreconnection_piv_decode(piv, pivLen);
+
+    if (isRequest) {
+        if (!withKid || kidLen != oscoreConn->recipientIdLen || memcmp(kid, oscoreConn->recipientId, kidLen) != 0) {
+            oscoreconnection_reject(oscoreConn, outer, COAP_401_UNAUTHORIZED, "Security context not found");
+            coap_free_header(outer);
+            return 0;
+        }
+        if (pivLen == 0) {
+            oscoreconnection_reject(oscoreConn, outer, COAP_402_BAD_OPTION, "Failed to decode COSE");
+            coap_free_header(outer);
+            return 0;
+        }
+        // a CoAP retransmission of the last request with this token is processed again
+        exchangeP = oscoreexchange_find(oscoreConn->received, outer->token, outer->token_len);
+        retransmission = exchangeP != NULL && exchangeP->mid == outer->mid && exchangeP->pivLen == pivLen &&
+                         memcmp(exchangeP->piv, piv, pivLen) == 0;
+        if (!retransmission && !oscoreconnection_replay_check(oscoreConn, seq)) {
+            oscoreconnection_reject(oscoreConn, outer, COAP_401_UNAUTHORIZED, "Replay detected");
+            coap_free_header(outer);
+            return 0;
+        }
+        oscoreconnection_nonce(oscoreConn, oscoreConn->recipientId, oscoreConn->recipientIdLen, piv, pivLen, nonce);
+        aadLen = oscoreconnection_aad(oscoreConn->recipientId, oscoreConn->recipientIdLen, piv, pivLen, aad);
+    } else {
+        exchangeP = oscoreexchange_find(oscoreConn->sent, outer->token, outer->token_len);
+        if (exchangeP == NULL) {
+            coap_free_header(outer);
+            return 0;
+        }
+        if (pivLen != 0) {
+            oscoreconnection_nonce(oscoreConn, oscoreConn->recipientId, oscoreConn->recipientIdLen, piv, pivLen,
+                                   nonce);
+        } else {
+            oscoreconnection_nonce(oscoreConn, oscoreConn->senderId, oscoreConn->senderIdLen, exchangeP->piv,
+                                   exchangeP->pivLen, nonce);
+        }
+        aadLen = oscoreconnection_aad(oscoreConn->senderId, oscoreConn->senderIdLen, exchangeP->piv,
+                                      exchangeP->pivLen, aad);
+    }
+
+    // decrypt right after the header and token, the code lands on the last byte before the options
+    offset = COAP_HEADER_LEN - 1 + outer->token_len;
+    plainLen = outer->payload_len - OSCORE_TAG_LEN;
+    inner = (uint8_t *)lwm2m_malloc(offset + plainLen);
+    if (inner == NULL) {
+        coap_free_header(outer);
+        return 0;
+    }
+    if (mbedtls_ccm_auth_decrypt(&oscoreConn->recipientCcm, plainLen, nonce, OSCORE_NONCE_LEN, aad, aadLen,
+                                 outer->payload, inner + offset, outer->payload + plainLen, OSCORE_TAG_LEN) != 0) {
+        if (isRequest) {
+            oscoreconnection_reject(oscoreConn, outer, COAP_400_BAD_REQUEST, "Decryption failed");
+        } else {
+            printf("OSCORE response verification failed\n");
+        }
+        lwm2m_free(inner);
+        coap_free_header(outer);
+        return 0;
+    }
+
+    inner[1] = inner[offset];
+    inner[0] = buffer[0];
+    inner[2] = buffer[2];
+    inner[3] = buffer[3];
+    memcpy(inner + COAP_HEADER_LEN, outer->token, outer->token_len);
+
+    if (isRequest) {
+        if (exchangeP == NULL) {
+            exchangeP = oscoreexchange_new(oscoreConn, oscoreConn->received, outer->token, outer->token_len);
+        }
+        exchangeP->mid = outer->mid;
+        exchangeP->pivLen = (uint8_t)pivLen;
+        memcpy(exchangeP->piv, piv, pivLen);
+        exchangeP->age = ++oscoreConn->exchangeAge;
+        if (!oscoreConn->replayInit && !oscoreconnection_echo_verified(oscoreConn, inner, offset + plainLen)) {
+            oscoreconnection_challenge(oscoreConn, outer);
+            // not a retransmission to process again once the window is initialized
+            exchangeP->valid = false;
+            lwm2m_free(inner);
+            coap_free_header(outer);
+            return 0;
+        }
+        oscoreconnection_replay_update(oscoreConn, seq);
+        // Observe is also an outer option, 0 registers and 1 cancels
+        if (IS_OPTION(outer, COAP_OPTION_OBSERVE)) {
+            exchangeP->observe = outer->observe == 0;
+        }
+    } else if (pivLen != 0 && IS_OPTION(outer, COAP_OPTION_OBSERVE)) {
+        if (exchangeP->notified && seq <= exchangeP->lastNotification) {
+            printf("Replayed OSCORE notification dropped\n");
+            lwm2m_free(inner);
+            coap_free_header(outer);
+            return 0;
+        }
+        exchangeP->notified = true;
+        exchangeP->lastNotification = seq;
+    }
+
+    oscoreconnection_deliver(context, oscoreConn, inner, offset + plainLen, outer, isRequest);
+
+    lwm2m_free(inner);
+    coap_free_header(outer);
+    return (int)len;
+}
+
+static void oscoreconnection_deinit(void *conn) {
+    oscoreconnection_t *oscoreConn = (oscoreconnection_t *)conn;
+
+    mbedtls_ccm_free(&oscoreConn->senderCcm);
+    mbedtls_ccm_free(&oscoreConn->recipientCcm);
+    mbedtls_platform_zeroize(oscoreConn->commonIv, sizeof(oscoreConn->commonIv));
+}
+
+// read the OSCORE object instance and derive the sender and recipient contexts
+static int oscoreconnection_setup(oscoreconnection_t *oscoreConn, lwm2m_context_t *ctx) {
+    uint8_t *secret = NULL;
+    size_t secretLen = 0;
+    uint8_t *salt = NULL;
+    size_t saltLen = 0;
+    uint8_t *value = NULL;
+    size_t valueLen = 0;
+    uint8_t key[OSCORE_KEY_LEN];
+    int algorithm;
+    int ret = -1;
+
+    if (object_get_int(ctx, LWM2M_OSCORE_OBJECT_ID, oscoreConn->oscoreInstance, LWM2M_OSCORE_AEAD_ALGORITHM_ID,
+                       &algorithm) == 1 &&
+        algorithm != OSCORE_ALG_AES_CCM_16_64_128) {
+        printf("Unsupported OSCORE AEAD algorithm %d\n", algorithm);
+        return -1;
+    }
+    if (object_get_int(ctx, LWM2M_OSCORE_OBJECT_ID, oscoreConn->oscoreInstance, LWM2M_OSCORE_HMAC_ALGORITHM_ID,
+                       &algorithm) == 1 &&
+        algorithm != OSCORE_ALG_HKDF_SHA_256 && algorithm != OSCORE_ALG_HMAC_256_256) {
+        printf("Unsupported OSCORE HKDF algorithm %d\n", algorithm);
+        return -1;
+    }
+
+    if (object_get_opaque(ctx, LWM2M_OSCORE_OBJECT_ID, oscoreConn->oscoreInstance, LWM2M_OSCORE_SENDER_ID_ID, &value,
+                          &valueLen) != 1 ||
+        valueLen > OSCORE_MAX_ID_LEN) {
+        goto exit;
+    }
+    if (valueLen != 0) {
+        memcpy(oscoreConn->senderId, value, valueLen);
+    }
+    oscoreConn->senderIdLen = valueLen;
+    lwm2m_free(value);
+    value = NULL;
+
+    if (object_get_opaque(ctx, LWM2M_OSCORE_OBJECT_ID, oscoreConn->oscoreInstance, LWM2M_OSCORE_RECIPIENT_ID_ID,
+                          &value, &valueLen) != 1 ||
+        valueLen > OSCORE_MAX_ID_LEN) {
+        goto exit;
+    }
+    if (valueLen != 0) {
+        memcpy(oscoreConn->recipientId, value, valueLen);
+    }
+    oscoreConn->recipientIdLen = valueLen;
+    lwm2m_free(value);
+    value = NULL;
+
+    if (object_get_opaque(ctx, LWM2M_OSCORE_OBJECT_ID, oscoreConn->oscoreInstance, LWM2M_OSCORE_ID_CONTEXT_ID,
+                          &value, &valueLen) == 1) {
+        if (valueLen > OSCORE_MAX_ID_CONTEXT_LEN) {
+            goto exit;
+        }
+        if (valueLen != 0) {
+            memcpy(oscoreConn->idContext, value, valueLen);
+        }
+        oscoreConn->idContextLen = valueLen;
+        lwm2m_free(value);
+        value = NULL;
+    }
+
+    if (object_get_opaque(ctx, LWM2M_OSCORE_OBJECT_ID, oscoreConn->oscoreInstance, LWM2M_OSCORE_MASTER_SECRET_ID,
+                          &secret, &secretLen) != 1 ||
+        secretLen == 0) {
+        goto exit;
+    }
+    // the salt is optional, HKDF then uses a string of zeroes
+    (void)object_get_opaque(ctx, LWM2M_OSCORE_OBJECT_ID, oscoreConn->oscoreInstance, LWM2M_OSCORE_MASTER_SALT_ID,
+                            &salt, &saltLen);
+
+    if (oscoreconnection_derive(oscoreConn, secret, secretLen, salt, saltLen, oscoreConn->senderId,
+                                oscoreConn->senderIdLen, false, key, sizeof(key)) != 0 ||
+        mbedtls_ccm_setkey(&oscoreConn->senderCcm, MBEDTLS_CIPHER_ID_AES, key, 8 * OSCORE_KEY_LEN) != 0) {
+        goto exit;
+    }
+    if (oscoreconnection_derive(oscoreConn, secret, secretLen, salt, saltLen, oscoreConn->recipientId,
+                                oscoreConn->recipientIdLen, false, key, sizeof(key)) != 0 ||
+        mbedtls_ccm_setkey(&oscoreConn->recipientCcm, MBEDTLS_CIPHER_ID_AES, key, 8 * OSCORE_KEY_LEN) != 0) {
+        goto exit;
+    }
+    if (oscoreconnection_derive(oscoreConn, secret, secretLen, salt, saltLen, NULL, 0, true, oscoreConn->commonIv,
+                                OSCORE_NONCE_LEN) != 0) {
+        goto exit;
+    }
+    ret = 0;
+
+exit:
+    mbedtls_platform_zeroize(key, sizeof(key));
+    if (secret != NULL) {
+        mbedtls_platform_zeroize(secret, secretLen);
+        lwm2m_free(secret);
+    }
+    lwm2m_free(salt);
+    lwm2m_free(value);
+    return ret;
+}
+
+connection_t *oscoreconnection_create(lwm2m_connection_layer_t *connLayerP, uint16_t securityInstance, int sock,
+                                      char *host, char *port, int addressFamily) {
+    oscoreconnection_t *oscoreConn;
+    uint16_t oscoreInstance;
+    oscoreconnection_ssn_storage_t const *storageP = (oscoreconnection_ssn_storage_t const *)connLayerP->ssnStorage;
+    uint64_t ssn = 0;
+
+    if (!security_get_oscore_instance(connLayerP->ctx, securityInstance, &oscoreInstance)) {
+        return NULL;
+    }
+    // RFC 8613 section 7.5.1: restarting the Sender Sequence Number would reuse nonces with the same keys
+    if (storageP == NULL || storageP->loadFunc(oscoreInstance, &ssn, storageP->userData) != 0) {
+        printf("No stored OSCORE sender sequence number for instance %d\n", oscoreInstance);
+        return NULL;
+    }
+
+    oscoreConn = (oscoreconnection_t *)lwm2m_malloc(sizeof(oscoreconnection_t));
+    if (oscoreConn == NULL) {
+        return NULL;
+    }
+    memset(oscoreConn, 0, sizeof(oscoreconnection_t));
+    if (connection_create_inplace(&oscoreConn->conn, sock, host, port, addressFamily) <= 0) {
+        lwm2m_free(oscoreConn);
+        return NULL;
+    }
+    oscoreConn->plainSend = oscoreConn->conn.sendFunc;
+    oscoreConn->conn.sendFunc = oscoreconnection_send;
+#ifdef LWM2M_VECTORED_SEND
+    // the whole message is encrypted from a single plaintext buffer
+    oscoreConn->conn.sendvFunc = NULL;
+#endif
+    oscoreConn->conn.recvFunc = oscoreconnection_recv;
+    oscoreConn->conn.deinitFunc = oscoreconnection_deinit;
+    oscoreConn->oscoreInstance = oscoreInstance;
+    oscoreConn->ssnStorage = storageP;
+    // everything below the stored value may have been used before the reboot
+    oscoreConn->ssn = ssn;
+    oscoreConn->ssnLimit = ssn;
+
+    mbedtls_ccm_init(&oscoreConn->senderCcm);
+    mbedtls_ccm_init(&oscoreConn->recipientCcm);
+    if (oscoreconnection_setup(oscoreConn, connLayerP->ctx) != 0) {
+        printf("Invalid OSCORE object instance %d\n", oscoreInstance);
+        oscoreconnection_deinit(oscoreConn);
+        lwm2m_free(oscoreConn);
+        return NULL;
+    }
+
+    connectionlayer_add_connection(connLayerP, (connection_t *)oscoreConn);
+    return (connection_t *)oscoreConn;
+}
+
+#else
+connection_t *oscoreconnection_create(lwm2m_connection_layer_t *connLayerP, uint16_t securityInstance, int sock,
+                                      char *host, char *port, int addressFamily) {
+    (void)connLayerP;
+    (void)securityInstance;
+    (void)sock;
+    (void)host;
+    (void)port;
+    (void)addressFamily;
+    return NULL;
+}
+
+void oscoreconnection_set_ssn_storage(lwm2m_connection_layer_t *connLayerP,
+                                      oscoreconnection_ssn_storage_t const *storageP) {
+    (void)connLayerP;
+    (void)storageP;
+}
+#endif
@@ -0,0 +1,62 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Eclipse Foundation and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v2.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v20.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * OSCORE (RFC 8613) connections.
+ *
+ * The messages serialized by liblwm2m are protected one by one with the
+ * security context derived from the OSCORE object instance linked by the
+ * security instance, and sent in the clear over UDP. Only AES-CCM-16-64-128
+ * with HKDF SHA-256 is supported. Unlike DTLS there is no handshake: the
+ * first Register is protected and sent right away.
+ */
+
+#ifndef OSCORE_CONNECTION_H_
+#define OSCORE_CONNECTION_H_
+
+#include "connection.h"
+#include "liblwm2m.h"
+
+#ifndef OSCORE_SSN_BLOCK
+#define OSCORE_SSN_BLOCK 64 // Sender Sequence Numbers reserved by each write to the storage
+#endif
+
+// Create a connection protected with OSCORE. Returns NULL when the security instance does not link
+// an OSCORE object instance, and when the layer has no storage for the Sender Sequence Numbers or it
+// fails to load them.
+connection_t *oscoreconnection_create(lwm2m_connection_layer_t *connLayerP, uint16_t securityInstance, int sock,
+                                      char *host, char *port, int addressFamily);
+
+// A Sender Sequence Number must never be used twice with the same keys, including across reboots
+// (RFC 8613 appendix B.1.1). The sequence numbers are reserved by blocks of OSCORE_SSN_BLOCK: store
+// is called before the first number of a block is used, and load returns the last stored value, 0
+// when nothing was stored yet for the instance. Both return 0 on success. Nothing is protected when
+// they fail.
+typedef int (*oscoreconnection_ssn_load_t)(uint16_t oscoreInstance, uint64_t *ssnP, void *userData);
+typedef int (*oscoreconnection_ssn_store_t)(uint16_t oscoreInstance, uint64_t ssn, void *userData);
+
+typedef struct {
+    oscoreconnection_ssn_load_t loadFunc;
+    oscoreconnection_ssn_store_t storeFunc;
+    void *userData;
+} oscoreconnection_ssn_storage_t;
+
+// Required before the first OSCORE connection of the layer. The storage must outlive the layer.
+void oscoreconnection_set_ssn_storage(lwm2m_connection_layer_t *connLayerP,
+                                      oscoreconnection_ssn_storage_t const *storageP);
+
+#endif
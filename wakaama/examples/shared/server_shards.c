@@ -0,0 +1,312 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Eclipse Foundation and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v2.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v20.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "server_shards.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef LWM2M_SERVER_MODE
+
+typedef struct {
+    ns_address_t addr;
+    uint8_t *buffer; // NULL when the thread is only woken up
+    size_t length;
+} server_shard_packet_t;
+
+static uint8_t prv_select_shard(server_shards_t *shardsP, ns_address_t const *addr) {
+    uint32_t hash;
+    int i;
+
+    // connections are looked up by address only, so the port must not be hashed
+    hash = 2166136261u;
+    for (i = 0; i < 16; i++) {
+        hash ^= addr->address[i];
+        hash *= 16777619u;
+    }
+
+    return (uint8_t)(hash % shardsP->count);
+}
+
+static void prv_push_event(server_shard_t *shardP, server_shard_event_type_t type, uint16_t clientID,
+                           lwm2m_uri_t *uriP, int status, lwm2m_media_type_t format, uint8_t *data,
+                           size_t dataLength, void *userData) {
+    server_shard_event_t event;
+
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.shard = shardP->index;
+    event.clientID = clientID;
+    if (uriP != NULL) {
+        event.uri = *uriP;
+    } else {
+        LWM2M_URI_RESET(&event.uri);
+    }
+    event.status = status;
+    event.format = format;
+    event.userData = userData;
+
+    // the payload only lives for the duration of the callback
+    if (data != NULL && dataLength != 0) {
+        event.data = (uint8_t *)lwm2m_malloc(dataLength);
+        if (event.data == NULL) {
+            fprintf(stderr, "#> shard %d: no memory for a %zu bytes event\r\n", shardP->index, dataLength);
+            return;
+        }
+        memcpy(event.data, data, dataLength);
+        event.dataLength = dataLength;
+    }
+
+    if (osMessageQueuePut(shardP->parentP->events, &event, 0, 0) != osOK) {
+        fprintf(stderr, "#> shard %d: event queue full, event dropped\r\n", shardP->index);
+        server_shards_event_free(&event);
+    }
+}
+
+static void prv_monitor_callback(lwm2m_context_t *contextP, uint16_t clientID, lwm2m_uri_t *uriP, int status,
+                                 block_info_t *block_info, lwm2m_media_type_t format, uint8_t *data,
+                                 size_t dataLength, void *userData) {
+    (void)contextP;
+    (void)block_info;
+
+    prv_push_event((server_shard_t *)userData, SERVER_SHARD_EVENT_MONITOR, clientID, uriP, status, format, data,
+                   dataLength, NULL);
+}
+
+static void prv_handle_packet(server_shard_t *shardP, server_shard_packet_t *packetP) {
+    osMutexAcquire(shardP->lock, osWaitForever);
+    if (connectionlayer_find_connection(shardP->connLayer, &packetP->addr) == NULL
+        && connection_new_incoming(shardP->connLayer, shardP->parentP->sock, &packetP->addr) == NULL) {
+        fprintf(stderr, "#> shard %d: no memory for a new peer, datagram dropped\r\n", shardP->index);
+    } else {
+        connectionlayer_handle_packet(shardP->connLayer, &packetP->addr, packetP->buffer, packetP->length);
+    }
+    osMutexRelease(shardP->lock);
+
+    lwm2m_free(packetP->buffer);
+}
+
+static void prv_shard_task(void *argument) {
+    server_shard_t *shardP = (server_shard_t *)argument;
+    server_shard_packet_t packet;
+
+    while (1) {
+        time_t timeout = 60;
+        int result;
+        int handled;
+
+        osMutexAcquire(shardP->lock, osWaitForever);
+        if (shardP->stopping) {
+            osMutexRelease(shardP->lock);
+            break;
+        }
+        result = lwm2m_step(shardP->ctx, &timeout);
+        osMutexRelease(shardP->lock);
+        if (result != 0) {
+            fprintf(stderr, "#> shard %d: lwm2m_step() failed: 0x%X\r\n", shardP->index, result);
+        }
+
+        // woken up early by a datagram or by server_shards_unlock()
+        if (osMessageQueueGet(shardP->packets, &packet, NULL, (uint32_t)timeout * osKernelGetTickFreq()) != osOK) {
+            continue;
+        }
+        // at most a queue worth of datagrams between two steps
+        handled = 0;
+        do {
+            if (packet.buffer != NULL) {
+                prv_handle_packet(shardP, &packet);
+            }
+        } while (++handled < SERVER_SHARDS_PACKET_QUEUE_SIZE
+                 && osMessageQueueGet(shardP->packets, &packet, NULL, 0) == osOK);
+    }
+}
+
+static void prv_wakeup(server_shard_t *shardP, uint32_t timeout) {
+    server_shard_packet_t packet;
+
+    memset(&packet, 0, sizeof(packet));
+    osMessageQueuePut(shardP->packets, &packet, 0, timeout);
+}
+
+int server_shards_start(server_shards_t *shardsP, uint8_t count, int sock) {
+    uint8_t i;
+
+    if (count == 0 || count > SERVER_SHARDS_MAX) {
+        return -1;
+    }
+
+    memset(shardsP, 0, sizeof(server_shards_t));
+    shardsP->sock = sock;
+    shardsP->count = count;
+    shardsP->events = osMessageQueueNew(SERVER_SHARDS_QUEUE_SIZE, sizeof(server_shard_event_t), NULL);
+    if (shardsP->events == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        server_shard_t *shardP = shardsP->shards + i;
+        osThreadAttr_t attr;
+
+        shardP->parentP = shardsP;
+        shardP->index = i;
+        shardP->lock = osMutexNew(NULL);
+        if (shardP->lock == NULL) {
+            goto error;
+        }
+        shardP->packets = osMessageQueueNew(SERVER_SHARDS_PACKET_QUEUE_SIZE, sizeof(server_shard_packet_t), NULL);
+        if (shardP->packets == NULL) {
+            goto error;
+        }
+
+        shardP->ctx = lwm2m_init(shardP);
+        if (shardP->ctx == NULL) {
+            goto error;
+        }
+        shardP->connLayer = connectionlayer_create(shardP->ctx);
+        if (shardP->connLayer == NULL) {
+            goto error;
+        }
+        lwm2m_set_monitoring_callback(shardP->ctx, prv_monitor_callback, shardP);
+
+        memset(&attr, 0, sizeof(attr));
+        attr.name = "lwm2mShard";
+        attr.attr_bits = osThreadJoinable;
+        shardP->thread = osThreadNew(prv_shard_task, shardP, &attr);
+        if (shardP->thread == NULL) {
+            goto error;
+        }
+    }
+
+    return 0;
+
+error:
+    // the shards started so far are stopped, the others are still zeroed
+    server_shards_stop(shardsP);
+    return -1;
+}
+
+void server_shards_stop(server_shards_t *shardsP) {
+    server_shard_packet_t packet;
+    server_shard_event_t event;
+    uint8_t i;
+
+    for (i = 0; i < shardsP->count; i++) {
+        server_shard_t *shardP = shardsP->shards + i;
+
+        if (shardP->thread != NULL) {
+            osMutexAcquire(shardP->lock, osWaitForever);
+            shardP->stopping = true;
+            osMutexRelease(shardP->lock);
+            // the thread drains its queue, waiting for room cannot block for long
+            prv_wakeup(shardP, osWaitForever);
+            osThreadJoin(shardP->thread);
+            shardP->thread = NULL;
+        }
+        if (shardP->packets != NULL) {
+            while (osMessageQueueGet(shardP->packets, &packet, NULL, 0) == osOK) {
+                lwm2m_free(packet.buffer);
+            }
+            osMessageQueueDelete(shardP->packets);
+            shardP->packets = NULL;
+        }
+        if (shardP->ctx != NULL) {
+            lwm2m_close(shardP->ctx);
+            shardP->ctx = NULL;
+        }
+        if (shardP->connLayer != NULL) {
+            connectionlayer_free(shardP->connLayer);
+            shardP->connLayer = NULL;
+        }
+        if (shardP->lock != NULL) {
+            osMutexDelete(shardP->lock);
+            shardP->lock = NULL;
+        }
+    }
+
+    if (shardsP->events != NULL) {
+        while (osMessageQueueGet(shardsP->events, &event, NULL, 0) == osOK) {
+            server_shards_event_free(&event);
+        }
+        osMessageQueueDelete(shardsP->events);
+        shardsP->events = NULL;
+    }
+    shardsP->count = 0;
+}
+
+int server_shards_handle_packet(server_shards_t *shardsP, ns_address_t *addr, uint8_t *buffer, size_t length) {
+    server_shard_t *shardP;
+    server_shard_packet_t packet;
+
+    shardP = shardsP->shards + prv_select_shard(shardsP, addr);
+
+    // handled by the thread of the shard, the receiving thread only copies the datagram
+    packet.addr = *addr;
+    packet.buffer = (uint8_t *)lwm2m_malloc(length);
+    if (packet.buffer == NULL) {
+        return -1;
+    }
+    memcpy(packet.buffer, buffer, length);
+    packet.length = length;
+
+    if (osMessageQueuePut(shardP->packets, &packet, 0, 0) != osOK) {
+        lwm2m_free(packet.buffer);
+        return -1;
+    }
+
+    return 0;
+}
+
+lwm2m_context_t *server_shards_lock(server_shards_t *shardsP, uint8_t shard) {
+    if (shard >= shardsP->count) {
+        return NULL;
+    }
+
+    osMutexAcquire(shardsP->shards[shard].lock, osWaitForever);
+    return shardsP->shards[shard].ctx;
+}
+
+void server_shards_unlock(server_shards_t *shardsP, uint8_t shard) {
+    if (shard >= shardsP->count) {
+        return;
+    }
+
+    osMutexRelease(shardsP->shards[shard].lock);
+    // the new operation may shorten the step timeout, a full queue wakes the thread up anyway
+    prv_wakeup(shardsP->shards + shard, 0);
+}
+
+void server_shards_result_callback(lwm2m_context_t *contextP, uint16_t clientID, lwm2m_uri_t *uriP, int status,
+                                   block_info_t *block_info, lwm2m_media_type_t format, uint8_t *data,
+                                   size_t dataLength, void *userData) {
+    (void)block_info;
+
+    // the shard is the userData of its context
+    prv_push_event((server_shard_t *)contextP->userData, SERVER_SHARD_EVENT_RESULT, clientID, uriP, status, format,
+                   data, dataLength, userData);
+}
+
+bool server_shards_get_event(server_shards_t *shardsP, server_shard_event_t *eventP, uint32_t timeout) {
+    return osMessageQueueGet(shardsP->events, eventP, NULL, timeout) == osOK;
+}
+
+void server_shards_event_free(server_shard_event_t *eventP) {
+    lwm2m_free(eventP->data);
+    eventP->data = NULL;
+    eventP->dataLength = 0;
+}
+
+#endif
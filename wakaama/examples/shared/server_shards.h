@@ -0,0 +1,113 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Eclipse Foundation and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v2.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v20.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Sharded LWM2M Server front-end.
+ *
+ * Peers are hashed on their address onto a fixed set of independent liblwm2m
+ * contexts, each one driven by its own thread: the datagrams of a peer are
+ * queued to the thread of its shard, which handles them between its steps. The
+ * monitoring callbacks and the results of the operations issued with
+ * server_shards_result_callback() are copied into a single queue read by the
+ * application.
+ */
+
+#ifndef SERVER_SHARDS_H_
+#define SERVER_SHARDS_H_
+
+#include <liblwm2m.h>
+#include "cmsis_os2.h"
+#include "connection.h"
+
+#ifdef LWM2M_SERVER_MODE
+
+#ifndef SERVER_SHARDS_MAX
+#define SERVER_SHARDS_MAX 16
+#endif
+
+#ifndef SERVER_SHARDS_QUEUE_SIZE
+#define SERVER_SHARDS_QUEUE_SIZE 64
+#endif
+
+// datagrams waiting for the thread of a shard
+#ifndef SERVER_SHARDS_PACKET_QUEUE_SIZE
+#define SERVER_SHARDS_PACKET_QUEUE_SIZE 32
+#endif
+
+typedef enum {
+    SERVER_SHARD_EVENT_MONITOR, // registration, update or deregistration of a client
+    SERVER_SHARD_EVENT_RESULT   // result of an operation or notification
+} server_shard_event_type_t;
+
+typedef struct {
+    server_shard_event_type_t type;
+    uint8_t shard;       // index of the context the client belongs to
+    uint16_t clientID;   // only unique within a shard
+    lwm2m_uri_t uri;     // undefined for monitoring events
+    int status;
+    lwm2m_media_type_t format;
+    uint8_t *data;       // copy of the payload, released by server_shards_event_free()
+    size_t dataLength;
+    void *userData;      // userData given to server_shards_result_callback() operations
+} server_shard_event_t;
+
+struct _server_shards_t;
+
+typedef struct {
+    struct _server_shards_t *parentP;
+    uint8_t index;
+    lwm2m_context_t *ctx;
+    lwm2m_connection_layer_t *connLayer;
+    osMutexId_t lock;
+    osMessageQueueId_t packets;
+    osThreadId_t thread;
+    bool stopping; // set under lock by server_shards_stop()
+} server_shard_t;
+
+typedef struct _server_shards_t {
+    int sock;
+    uint8_t count;
+    server_shard_t shards[SERVER_SHARDS_MAX];
+    osMessageQueueId_t events;
+} server_shards_t;
+
+// create count contexts listening on sock and start their threads, nothing is left started on failure
+int server_shards_start(server_shards_t *shardsP, uint8_t count, int sock);
+
+// join the threads and close the contexts, the socket is left open
+void server_shards_stop(server_shards_t *shardsP);
+
+// queue a copy of a datagram received on the shared socket to the shard owning the peer,
+// -1 when it is dropped because the queue of the shard is full
+int server_shards_handle_packet(server_shards_t *shardsP, ns_address_t *addr, uint8_t *buffer, size_t length);
+
+// lock a shard before calling lwm2m_dm_*() or lwm2m_observe*() on its context
+lwm2m_context_t *server_shards_lock(server_shards_t *shardsP, uint8_t shard);
+void server_shards_unlock(server_shards_t *shardsP, uint8_t shard);
+
+// result callback queuing the results into the shared event queue
+void server_shards_result_callback(lwm2m_context_t *contextP, uint16_t clientID, lwm2m_uri_t *uriP, int status,
+                                   block_info_t *block_info, lwm2m_media_type_t format, uint8_t *data,
+                                   size_t dataLength, void *userData);
+
+// wait up to timeout ticks for the next event
+bool server_shards_get_event(server_shards_t *shardsP, server_shard_event_t *eventP, uint32_t timeout);
+void server_shards_event_free(server_shard_event_t *eventP);
+
+#endif
+
+#endif
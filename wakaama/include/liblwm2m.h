@@ -85,6 +85,21 @@ extern "C" {
 #endif
 #endif
 
+#ifdef LWM2M_NOTIFY_BATCHING
+/* Batched notifications are sent as SenML JSON packs with the Send operation. */
+#ifdef LWM2M_VERSION_1_0
+#error "LWM2M_NOTIFY_BATCHING requires LWM2M 1.1 (Send)"
+#endif
+#ifndef LWM2M_SUPPORT_SENML_JSON
+#define LWM2M_SUPPORT_SENML_JSON
+#endif
+#endif
+
+#if !defined(LWM2M_VERSION_1_0) && defined(LWM2M_SUPPORT_SENML_JSON)
+/* Composite operations and Send exchange SenML JSON packs. */
+#define LWM2M_SUPPORT_COMPOSITE
+#endif
+
 #ifndef LWM2M_SUPPORT_TLV
 #if defined(LWM2M_VERSION_1_0) || defined(LWM2M_SERVER_MODE) || defined(LWM2M_BOOTSTRAP_SERVER_MODE)
 /* TLV is mandatory for LWM2M 1.0 client and server. */
@@ -93,6 +108,12 @@ extern "C" {
 #endif
 #endif
 
+#ifdef LWM2M_DATA_ARENA
+#ifndef LWM2M_DATA_ARENA_SIZE
+#define LWM2M_DATA_ARENA_SIZE 1024
+#endif
+#endif
+
 #if defined(LWM2M_BOOTSTRAP) && defined(LWM2M_BOOTSTRAP_SERVER_MODE)
 #error "LWM2M_BOOTSTRAP and LWM2M_BOOTSTRAP_SERVER_MODE cannot be defined at the same time!"
 #endif
@@ -144,6 +165,20 @@ void lwm2m_close_connection(void * sessionH, void * userData);
 // buffer, length: data to send
 // userData: parameter to lwm2m_init()
 uint8_t lwm2m_buffer_send(void * sessionH, uint8_t * buffer, size_t length, void * userData);
+#ifdef LWM2M_VECTORED_SEND
+typedef struct
+{
+    uint8_t * base;
+    size_t    length;
+} lwm2m_iovec_t;
+// Send a datagram made of several buffers to a peer, used for the responses so that
+// their payload is not copied.
+// Returns COAP_NO_ERROR or a COAP_NNN error code
+// sessionH: session handle identifying the peer (opaque to the core)
+// iov, iovCount: buffers to send, in order, as a single datagram
+// userData: parameter to lwm2m_init()
+uint8_t lwm2m_buffer_sendv(void * sessionH, lwm2m_iovec_t * iov, size_t iovCount, void * userData);
+#endif
 // Compare two session handles
 // Returns true if the two sessions identify the same peer. false otherwise.
 // userData: parameter to lwm2m_init()
@@ -159,6 +194,7 @@ bool lwm2m_session_is_equal(void * session1, void * session2, void * userData);
 
 #define COAP_201_CREATED                (uint8_t)0x41
 #define COAP_202_DELETED                (uint8_t)0x42
+#define COAP_203_VALID                  (uint8_t)0x43
 #define COAP_204_CHANGED                (uint8_t)0x44
 #define COAP_205_CONTENT                (uint8_t)0x45
 #define COAP_231_CONTINUE               (uint8_t)0x5F
@@ -171,6 +207,7 @@ bool lwm2m_session_is_equal(void * session1, void * session2, void * userData);
 #define COAP_408_REQ_ENTITY_INCOMPLETE  (uint8_t)0x88
 #define COAP_412_PRECONDITION_FAILED    (uint8_t)0x8C
 #define COAP_413_ENTITY_TOO_LARGE       (uint8_t)0x8D
+#define COAP_415_UNSUPPORTED_CONTENT_FORMAT (uint8_t)0x8F
 #define COAP_500_INTERNAL_SERVER_ERROR  (uint8_t)0xA0
 #define COAP_501_NOT_IMPLEMENTED        (uint8_t)0xA1
 #define COAP_503_SERVICE_UNAVAILABLE    (uint8_t)0xA3
@@ -204,6 +241,18 @@ bool lwm2m_session_is_equal(void * session1, void * session2, void * userData);
 #define LWM2M_SECURITY_SHORT_SERVER_ID        10
 #define LWM2M_SECURITY_HOLD_OFF_ID            11
 #define LWM2M_SECURITY_BOOTSTRAP_TIMEOUT_ID   12
+#define LWM2M_SECURITY_OSCORE_ID              17
+
+/*
+ * Resource IDs for the LWM2M OSCORE Object
+ */
+#define LWM2M_OSCORE_MASTER_SECRET_ID         0
+#define LWM2M_OSCORE_SENDER_ID_ID             1
+#define LWM2M_OSCORE_RECIPIENT_ID_ID          2
+#define LWM2M_OSCORE_AEAD_ALGORITHM_ID        3
+#define LWM2M_OSCORE_HMAC_ALGORITHM_ID        4
+#define LWM2M_OSCORE_MASTER_SALT_ID           5
+#define LWM2M_OSCORE_ID_CONTEXT_ID            6
 
 /*
  * Resource IDs for the LWM2M Server Object
@@ -343,10 +392,13 @@ typedef enum
 
 typedef struct _lwm2m_data_t lwm2m_data_t;
 
+#define LWM2M_DATA_FLAG_BORROWED 0x01  // value.asBuffer.buffer is not owned and not freed by lwm2m_data_free()
+
 struct _lwm2m_data_t
 {
     lwm2m_data_type_t type;
     uint16_t    id;
+    uint8_t     flags;
     union
     {
         bool        asBoolean;
@@ -386,11 +438,22 @@ typedef enum
 lwm2m_data_t * lwm2m_data_new(int size);
 int lwm2m_data_parse(lwm2m_uri_t * uriP, const uint8_t * buffer, size_t bufferLen, lwm2m_media_type_t format, lwm2m_data_t ** dataP);
 int lwm2m_data_serialize(lwm2m_uri_t * uriP, int size, lwm2m_data_t * dataP, lwm2m_media_type_t * formatP, uint8_t ** bufferP);
+#ifdef LWM2M_SUPPORT_SENML_JSON
+// append a timestamped value of the resource uriP to the SenML JSON pack of length bytes in buffer, which can hold
+// bufferLen bytes. The first record (length of 0) carries the base name uriP and the base time baseTime, the records
+// then carry time relative to it. The pack stays closed after each record: returns its new length, or -1 if the
+// record does not fit, the pack being left unchanged.
+int lwm2m_data_append_series(lwm2m_uri_t * uriP, time_t baseTime, time_t time, lwm2m_data_t * dataP, uint8_t * buffer, size_t length, size_t bufferLen);
+#endif
 void lwm2m_data_free(int size, lwm2m_data_t * dataP);
 
 void lwm2m_data_encode_string(const char * string, lwm2m_data_t * dataP);
 void lwm2m_data_encode_nstring(const char * string, size_t length, lwm2m_data_t * dataP);
 void lwm2m_data_encode_opaque(const uint8_t * buffer, size_t length, lwm2m_data_t * dataP);
+// Same as lwm2m_data_encode_nstring() and lwm2m_data_encode_opaque() without copying the buffer, which must stay
+// valid and unchanged until the data is freed.
+void lwm2m_data_encode_borrowed_nstring(const char * string, size_t length, lwm2m_data_t * dataP);
+void lwm2m_data_encode_borrowed_opaque(const uint8_t * buffer, size_t length, lwm2m_data_t * dataP);
 void lwm2m_data_encode_int(int64_t value, lwm2m_data_t * dataP);
 int lwm2m_data_decode_int(const lwm2m_data_t * dataP, int64_t * valueP);
 void lwm2m_data_encode_uint(uint64_t value, lwm2m_data_t * dataP);
@@ -474,6 +537,9 @@ struct _lwm2m_object_t
     lwm2m_delete_callback_t   deleteFunc;
     lwm2m_discover_callback_t discoverFunc;
     void * userData;
+#ifdef LWM2M_RESPONSE_CACHE
+    bool cacheable;     // Read and Discover responses can be cached: every change is reported with lwm2m_resource_value_changed()
+#endif
 };
 
 /*
@@ -703,6 +769,10 @@ struct _lwm2m_transaction_
     uint8_t *payload; // carries the entire payload across multiple transactions in case of a block 1 transfer
     lwm2m_transaction_callback_t callback;
     void * userData;
+#ifdef LWM2M_SEPARATE_RESPONSE
+    bool     deferred;   // separate response waiting for lwm2m_complete_response(), not sent yet. retrans_time is its deadline
+    uint16_t requestMID; // message ID of the request it answers
+#endif
 };
 
 /*
@@ -728,6 +798,14 @@ typedef struct _lwm2m_watcher_
         uint64_t asUnsigned;
         double  asFloat;
     } lastValue;
+    bool conPending;      // a confirmable notification is waiting for its ACK
+    uint16_t conMid;      // message ID of that confirmable notification
+    uint32_t nonCount;    // non-confirmable notifications sent since the last confirmable one
+    time_t lastConTime;   // time of the last confirmable notification
+#ifdef LWM2M_NOTIFY_BATCHING
+    bool batchPending;  // a notification is waiting for the batch window to close
+    time_t batchTime;   // time at which the pending notification became due
+#endif
 } lwm2m_watcher_t;
 
 typedef struct _lwm2m_observed_
@@ -738,6 +816,18 @@ typedef struct _lwm2m_observed_
     lwm2m_watcher_t * watcherList;
 } lwm2m_observed_t;
 
+#ifdef LWM2M_SUPPORT_COMPOSITE
+// Observe-Composite: one watcher over a list of paths, notified with a SenML JSON pack
+typedef struct _lwm2m_observed_composite_
+{
+    struct _lwm2m_observed_composite_ * next;
+
+    lwm2m_uri_t * uriList;
+    int uriCount;
+    lwm2m_watcher_t watcher;
+} lwm2m_observed_composite_t;
+#endif
+
 #ifdef LWM2M_CLIENT_MODE
 
 typedef enum
@@ -750,6 +840,18 @@ typedef enum
     STATE_READY
 } lwm2m_client_state_t;
 
+#ifdef LWM2M_DATA_ARENA
+// Bump allocator holding the data trees and payloads built while a request or a notification is handled
+typedef struct _lwm2m_data_arena_
+{
+    size_t   used;
+    size_t   live;    // blocks not freed yet, the arena is rewound when it drops to 0
+    size_t   depth;   // nested data_arenaBegin() calls
+    struct _lwm2m_data_arena_ * previousP; // arena bound to the thread before this one
+    uint64_t buffer[(LWM2M_DATA_ARENA_SIZE + 7) / 8];
+} lwm2m_data_arena_t;
+#endif
+
 #endif
 /*
  * LWM2M Context
@@ -779,7 +881,39 @@ struct _lwm2m_context_
     lwm2m_server_t *     bootstrapServerList;
     lwm2m_server_t *     serverList;
     lwm2m_object_t *     objectList;
+    lwm2m_object_t **    objectIndex;     // objectList as an array, for binary search on objectIds
+    uint16_t *           objectIds;
+    size_t               objectCount;
     lwm2m_observed_t *   observedList;
+    uint32_t             notifyConCount;
+    time_t               notifyConInterval;
+#ifdef LWM2M_NOTIFY_BATCHING
+    time_t               notifyBatchWindow;
+    size_t               notifyBatchMaxSize;
+#endif
+#ifdef LWM2M_QUEUE_MODE
+    time_t               queueAwakeTime;  // 0 when queue mode is disabled
+    time_t               queueSleepTime;  // date at which the client may go to sleep
+    bool                 queueSleeping;
+    bool                 queueWakeup;     // wake up requested by lwm2m_queue_wakeup()
+#endif
+#ifdef LWM2M_DATA_ARENA
+    lwm2m_data_arena_t   dataArena;
+#endif
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    lwm2m_observed_composite_t * compositeObservedList;
+#endif
+#ifdef LWM2M_RESPONSE_CACHE
+    struct _lwm2m_cache_entry_ * cacheList;
+    uint32_t             cacheGeneration;
+    bool                 cacheSeeded;     // set by lwm2m_set_cache_seed(), nothing is cached before
+#endif
+#ifdef LWM2M_SEPARATE_RESPONSE
+    void *               deferrableRequest;  // Write or Execute request being handled, NULL otherwise
+    void *               deferrableSessionH;
+    lwm2m_transaction_t * deferredP;         // separate response created for deferrableRequest
+    struct _lwm2m_separate_exchange_ * separateExchangeList; // requests whose separate response was sent
+#endif
 #endif
 #if defined(LWM2M_SERVER_MODE) || defined(LWM2M_BOOTSTRAP_SERVER_MODE)
     lwm2m_client_t *        clientList;
@@ -787,6 +921,10 @@ struct _lwm2m_context_
 #ifdef LWM2M_SERVER_MODE
     lwm2m_result_callback_t monitorCallback;
     void *                  monitorUserData;
+#ifdef LWM2M_SUPPORT_COMPOSITE
+    lwm2m_result_callback_t sendCallback;
+    void *                  sendUserData;
+#endif
 #endif
 #ifdef LWM2M_BOOTSTRAP_SERVER_MODE
     lwm2m_bootstrap_callback_t bootstrapCallback;
@@ -798,6 +936,11 @@ struct _lwm2m_context_
 };
 
 
+// Thread safety: a context is not thread-safe, calls on the same context must be serialized by the
+// application. Distinct contexts share no mutable state and can be driven from different threads,
+// provided the platform functions (lwm2m_malloc(), lwm2m_gettime(), lwm2m_buffer_send()...) are
+// thread-safe. lwm2m_set_coap_block_size() is process-wide and must be called before starting them.
+
 // initialize a liblwm2m context.
 lwm2m_context_t * lwm2m_init(void * userData);
 // close a liblwm2m context.
@@ -824,6 +967,65 @@ int lwm2m_update_registration(lwm2m_context_t * contextP, uint16_t shortServerID
 // send deregistration to all servers connected to client
 void lwm2m_deregister(lwm2m_context_t * context);
 void lwm2m_resource_value_changed(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
+// notifications are non-confirmable. Send one as confirmable every count notifications and/or
+// when interval seconds elapsed since the last confirmable one, to check the observer is still there
+// (RFC 7641 section 4.5). A watcher whose confirmable notification is not acknowledged is removed.
+// 0 disables the matching condition. Both default to 0: all notifications are non-confirmable.
+int lwm2m_set_notify_confirmable(lwm2m_context_t * contextP, uint32_t count, time_t interval);
+#ifdef LWM2M_NOTIFY_BATCHING
+// hold the notifications due to the same server until the window seconds of the oldest one elapsed,
+// then send the latest values of the observed paths in one Send operation (a SenML JSON pack POSTed
+// to /dp), split in packs of at most maxSize bytes (0 for the CoAP block size). A window of 0 disables
+// batching (the default).
+int lwm2m_set_notify_batching(lwm2m_context_t * contextP, time_t window, size_t maxSize);
+#endif
+#ifdef LWM2M_RESPONSE_CACHE
+// first ETag of the response cache. An ETag must not be reused after a reboot for another payload: seed is
+// a random value, or a value persisted and advanced at each boot. Nothing is cached until it is set.
+void lwm2m_set_cache_seed(lwm2m_context_t * contextP, uint32_t seed);
+#endif
+#ifdef LWM2M_QUEUE_MODE
+// queue mode: when all the servers use a binding with Q, the client stays awake for awakeTime seconds
+// (93 s recommended) after its last exchange with a server, then sleeps. While asleep, notifications
+// and Sends are kept pending and lwm2m_step() does nothing but report the time to the next wake up,
+// which is the next Maximum Period of an observation or the next registration update. Everything
+// pending is then sent at once. 0 disables queue mode (the default).
+int lwm2m_set_queue_mode(lwm2m_context_t * contextP, time_t awakeTime);
+// wake up at the next lwm2m_step() instead of waiting for the next scheduled wake up.
+void lwm2m_queue_wakeup(lwm2m_context_t * contextP);
+// returns true while the client sleeps. nextWakeupP (can be nil) receives the date of the next wake up,
+// in the time base of lwm2m_gettime(). The radio can be powered down until then.
+bool lwm2m_queue_is_sleeping(lwm2m_context_t * contextP, time_t * nextWakeupP);
+#endif
+#ifdef LWM2M_SUPPORT_COMPOSITE
+// Send operation: push the values of the uriList paths as a SenML JSON pack to the server specified by
+// the server short identifier or all registered servers if the ID is 0.
+// callback (can be nil) is called once per server with the status returned by the server, or
+// COAP_503_SERVICE_UNAVAILABLE if the server did not answer.
+typedef void (*lwm2m_send_callback_t)(lwm2m_context_t * contextP, uint16_t shortServerID, uint8_t status, void * userData);
+int lwm2m_send(lwm2m_context_t * contextP, uint16_t shortServerID, lwm2m_uri_t * uriList, size_t count, lwm2m_send_callback_t callback, void * userData);
+// same as lwm2m_send() with a SenML JSON pack built by the application, e.g. with lwm2m_data_append_series().
+// The pack is copied.
+int lwm2m_send_pack(lwm2m_context_t * contextP, uint16_t shortServerID, const uint8_t * buffer, size_t length, lwm2m_send_callback_t callback, void * userData);
+#endif
+#ifdef LWM2M_SUPPORT_SENML_JSON
+// send a SenML JSON pack built by the application, e.g. with lwm2m_data_append_series(), as a notification of
+// uriP to the servers observing it in SenML JSON. Returns COAP_404_NOT_FOUND if no server observes uriP so.
+int lwm2m_notify_pack(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, const uint8_t * buffer, size_t length);
+#endif
+#ifdef LWM2M_SEPARATE_RESPONSE
+// called from the write or execute callback of an object, answers the request being handled with an empty ACK
+// and lets the application send the response later as a separate confirmable message (RFC 7252 section 5.2.2).
+// Returns the identifier of the response, the same one if called again for the request, or -1 if the request
+// cannot be deferred (not a Write or an Execute, or out of memory). If the callback then returns an error, the
+// error is sent at once and the identifier is released.
+int lwm2m_defer_response(lwm2m_context_t * contextP);
+// send the separate response of a deferred request with status (e.g. COAP_204_CHANGED). Retransmissions
+// are handled by lwm2m_step(). Completed before the callback returns, the response is piggybacked on the ACK.
+// Returns COAP_404_NOT_FOUND if the response was already completed, or was answered with
+// COAP_503_SERVICE_UNAVAILABLE because it was not completed within LWM2M_SEPARATE_RESPONSE_TIMEOUT seconds.
+int lwm2m_complete_response(lwm2m_context_t * contextP, int responseID, uint8_t status);
+#endif
 #endif
 
 #ifdef LWM2M_SERVER_MODE
@@ -850,6 +1052,18 @@ int lwm2m_dm_delete(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t *
 // Information Reporting APIs
 int lwm2m_observe(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriP, lwm2m_result_callback_t callback, void * userData);
 int lwm2m_observe_cancel(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriP, lwm2m_result_callback_t callback, void * userData);
+
+#ifdef LWM2M_SUPPORT_COMPOSITE
+// Composite operations (LWM2M 1.1). Payloads are SenML JSON packs.
+// The callbacks are called with a root uriP, the records name the paths.
+int lwm2m_dm_read_composite(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriList, size_t count, lwm2m_result_callback_t callback, void * userData);
+int lwm2m_dm_write_composite(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_media_type_t format, uint8_t * buffer, size_t length, lwm2m_result_callback_t callback, void * userData);
+// Only one Observe-Composite per client. Its cancellation is passive: the next notification is rejected.
+int lwm2m_observe_composite(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriList, size_t count, lwm2m_result_callback_t callback, void * userData);
+int lwm2m_observe_composite_cancel(lwm2m_context_t * contextP, uint16_t clientID);
+// Data pushed by the clients with the Send operation is reported to callback with status COAP_NO_ERROR.
+void lwm2m_set_send_callback(lwm2m_context_t * contextP, lwm2m_result_callback_t callback, void * userData);
+#endif
 #endif
 
 #ifdef LWM2M_BOOTSTRAP_SERVER_MODE
@@ -37,6 +37,7 @@ function(target_sources_wakaama target)
     target_sources(
         ${target}
         PRIVATE ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/bootstrap.c
+                ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/cache.c
                 ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/discover.c
                 ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/internals.h
                 ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/liblwm2m.c
@@ -45,6 +46,7 @@ function(target_sources_wakaama target)
                 ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/objects.c
                 ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/observe.c
                 ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/packet.c
+                ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/queue.c
                 ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/registration.c
                 ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/uri.c
                 ${WAKAAMA_TOP_LEVEL_DIRECTORY}/core/utils.c